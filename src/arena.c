@@ -0,0 +1,154 @@
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// round size up to the next multiple of ARENA_ALIGNMENT
+static size_t arenaAlign(size_t size) {
+  return (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+}
+
+void arenaInit(Arena* a, size_t capacity) {
+  capacity = arenaAlign(capacity);
+  a->base = aligned_alloc(ARENA_ALIGNMENT, capacity);
+  if(!a->base) {
+    printf("ERROR::ARENA::FAILED_TO_ALLOCATE_BUFFER: %zu bytes\n", capacity);
+    capacity = 0;
+  }
+
+  a->capacity = capacity;
+  a->offset = 0;
+  a->lastOffset = 0;
+  a->highWater = 0;
+}
+
+void* arenaAlloc(Arena* a, size_t size) {
+  size_t aligned = arenaAlign(size);
+
+  // callers fall back to the heap when NULL is returned
+  if(aligned > a->capacity - a->offset) {
+    return NULL;
+  }
+
+  void* ptr = a->base + a->offset;
+  a->lastOffset = a->offset;
+  a->offset += aligned;
+
+  if(a->offset > a->highWater) {
+    a->highWater = a->offset;
+  }
+
+  return ptr;
+}
+
+void* arenaRealloc(Arena* a, void* ptr, size_t oldSize, size_t newSize) {
+  if(!ptr) {
+    return arenaAlloc(a, newSize);
+  }
+
+  // the most recent allocation can grow or shrink without copying
+  if((unsigned char*) ptr == a->base + a->lastOffset) {
+    size_t aligned = arenaAlign(newSize);
+    if(aligned <= a->capacity - a->lastOffset) {
+      a->offset = a->lastOffset + aligned;
+      if(a->offset > a->highWater) {
+        a->highWater = a->offset;
+      }
+      return ptr;
+    }
+    return NULL;
+  }
+
+  void* newPtr = arenaAlloc(a, newSize);
+  if(newPtr) {
+    memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+  }
+  return newPtr;
+}
+
+int arenaOwns(Arena* a, const void* ptr) {
+  const unsigned char* p = ptr;
+  return a->base && p >= a->base && p < a->base + a->capacity;
+}
+
+void arenaReset(Arena* a) {
+  a->offset = 0;
+  a->lastOffset = 0;
+}
+
+void arenaFree(Arena* a) {
+  free(a->base);
+  a->base = NULL;
+  a->capacity = 0;
+  a->offset = 0;
+  a->lastOffset = 0;
+}
+
+void frameArenaInit(FrameArena* f, unsigned int threadCount, size_t capacityPerThread, int doubleBuffered) {
+  if(threadCount > FRAME_ARENA_MAX_THREADS) {
+    printf("ERROR::ARENA::TOO_MANY_THREADS: %u\n", threadCount);
+    threadCount = FRAME_ARENA_MAX_THREADS;
+  }
+
+  f->threadCount = threadCount;
+  f->bufferCount = doubleBuffered ? 2 : 1;
+  f->frame = 0;
+
+  for(unsigned int b = 0; b < f->bufferCount; b++) {
+    for(unsigned int i = 0; i < threadCount; i++) {
+      arenaInit(&f->arenas[b][i], capacityPerThread);
+    }
+  }
+}
+
+void frameArenaBegin(FrameArena* f) {
+  f->frame++;
+
+  // only the buffer about to be written is recycled, the other one still holds last frame's data
+  unsigned int buffer = f->frame % f->bufferCount;
+  for(unsigned int i = 0; i < f->threadCount; i++) {
+    arenaReset(&f->arenas[buffer][i]);
+  }
+}
+
+// each thread must only ever pass its own index, which keeps allocation lock-free.
+// the capacity is sized for the worst frame up front, so running out is a bug and never returns NULL
+void* frameArenaAlloc(FrameArena* f, unsigned int thread, size_t size) {
+  Arena* a = &f->arenas[f->frame % f->bufferCount][thread];
+  void* ptr = arenaAlloc(a, size);
+  if(!ptr) {
+    printf("ERROR::ARENA::FRAME_ARENA_EXHAUSTED: thread %u, %zu bytes\n", thread, size);
+    abort();
+  }
+  return ptr;
+}
+
+void frameArenaGetStats(FrameArena* f, FrameArenaStats* stats) {
+  unsigned int buffer = f->frame % f->bufferCount;
+
+  stats->used = 0;
+  stats->highWater = 0;
+  stats->capacity = 0;
+
+  for(unsigned int b = 0; b < f->bufferCount; b++) {
+    for(unsigned int i = 0; i < f->threadCount; i++) {
+      Arena* a = &f->arenas[b][i];
+      if(b == buffer) {
+        stats->used += a->offset;
+      }
+      if(a->highWater > stats->highWater) {
+        stats->highWater = a->highWater;
+      }
+      stats->capacity += a->capacity;
+    }
+  }
+}
+
+void frameArenaFree(FrameArena* f) {
+  for(unsigned int b = 0; b < f->bufferCount; b++) {
+    for(unsigned int i = 0; i < f->threadCount; i++) {
+      arenaFree(&f->arenas[b][i]);
+    }
+  }
+  f->threadCount = 0;
+}
@@ -0,0 +1,54 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT 16
+#define FRAME_ARENA_MAX_THREADS 16
+
+// linear bump allocator, individual allocations are never freed
+typedef struct Arena {
+  unsigned char* base;
+  size_t capacity;
+  size_t offset; // bytes currently in use
+  size_t lastOffset; // start of the most recent allocation, lets realloc grow in place
+  size_t highWater; // largest offset ever reached
+} Arena;
+
+// per-thread arenas that are reset at the start of every frame
+typedef struct FrameArena {
+  Arena arenas[2][FRAME_ARENA_MAX_THREADS];
+  unsigned int threadCount;
+  unsigned int bufferCount; // 2 keeps last frame's allocations readable during the current frame
+  unsigned int frame;
+} FrameArena;
+
+typedef struct FrameArenaStats {
+  size_t used; // bytes allocated this frame across all threads
+  size_t highWater; // largest per-thread usage seen in any frame
+  size_t capacity; // total bytes reserved across all threads and buffers
+} FrameArenaStats;
+
+void arenaInit(Arena* a, size_t capacity);
+
+void* arenaAlloc(Arena* a, size_t size);
+
+void* arenaRealloc(Arena* a, void* ptr, size_t oldSize, size_t newSize);
+
+int arenaOwns(Arena* a, const void* ptr);
+
+void arenaReset(Arena* a);
+
+void arenaFree(Arena* a);
+
+void frameArenaInit(FrameArena* f, unsigned int threadCount, size_t capacityPerThread, int doubleBuffered);
+
+void frameArenaBegin(FrameArena* f);
+
+void* frameArenaAlloc(FrameArena* f, unsigned int thread, size_t size);
+
+void frameArenaGetStats(FrameArena* f, FrameArenaStats* stats);
+
+void frameArenaFree(FrameArena* f);
+
+#endif
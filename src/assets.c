@@ -0,0 +1,344 @@
+#include "assets.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
+
+#define ASSET_PAGE_SIZE 4096
+
+void assetLoaderInit(AssetLoader* l, Jobs* workers, Pack* pack, const char* root, unsigned int capacity, double budgetMs) {
+  memset(l, 0, sizeof(*l));
+  jobsInit(&l->io, 1);
+  l->workers = workers;
+  l->pack = pack;
+  l->root = root;
+  l->capacity = capacity;
+  l->budgetMs = budgetMs;
+  l->assets = calloc(capacity, sizeof(Asset));
+  pthread_mutex_init(&l->lock, NULL);
+  timingInit(&l->stats.readTimes);
+  timingInit(&l->stats.decodeTimes);
+  timingInit(&l->stats.sliceTimes);
+  timingInit(&l->stats.loadTimes);
+}
+
+static Asset* assetAdd(AssetLoader* l, enum AssetType type) {
+  if(l->count == l->capacity) {
+    printf("ERROR::ASSETS::FULL: %u assets\n", l->capacity);
+    return NULL;
+  }
+  Asset* a = &l->assets[l->count++];
+  memset(a, 0, sizeof(*a));
+  a->loader = l;
+  a->type = type;
+  a->stage = ASSET_WAITING;
+  a->requested = timingNow();
+  return a;
+}
+
+int assetLoadShader(AssetLoader* l, const char* vertexName, const char* fragmentName) {
+  if(strlen(vertexName) >= ASSET_NAME_LENGTH || strlen(fragmentName) >= ASSET_NAME_LENGTH) {
+    printf("ERROR::ASSETS::NAME_TOO_LONG: %s, %s\n", vertexName, fragmentName);
+    return -1;
+  }
+  Asset* a = assetAdd(l, ASSET_SHADER);
+  if(!a) {
+    return -1;
+  }
+  strcpy(a->names[0], vertexName);
+  strcpy(a->names[1], fragmentName);
+  return (int) (a - l->assets);
+}
+
+int assetLoadTexture(AssetLoader* l, const char* name, unsigned int textureUnit, int flip) {
+  if(strlen(name) >= ASSET_NAME_LENGTH) {
+    printf("ERROR::ASSETS::NAME_TOO_LONG: %s\n", name);
+    return -1;
+  }
+  Asset* a = assetAdd(l, ASSET_TEXTURE);
+  if(!a) {
+    return -1;
+  }
+  strcpy(a->names[0], name);
+  a->textureUnit = textureUnit;
+  a->flip = flip;
+  return (int) (a - l->assets);
+}
+
+int assetLoadMaterial(AssetLoader* l, int shader, const int* textures, const char** samplers, unsigned int textureCount) {
+  if(textureCount + 1 > ASSET_MAX_DEPENDENCIES) {
+    printf("ERROR::ASSETS::TOO_MANY_DEPENDENCIES: %u textures\n", textureCount);
+    return -1;
+  }
+  Asset* a = assetAdd(l, ASSET_MATERIAL);
+  if(!a) {
+    return -1;
+  }
+
+  // a dependency that could not even be queued fails the material on its first update
+  a->dependencies[a->dependencyCount++] = shader;
+  for(unsigned int i = 0; i < textureCount; i++) {
+    snprintf(a->samplers[a->dependencyCount], ASSET_SAMPLER_LENGTH, "%s", samplers[i]);
+    a->dependencies[a->dependencyCount++] = textures[i];
+  }
+  return (int) (a - l->assets);
+}
+
+enum AssetStage assetStage(AssetLoader* l, int handle) {
+  pthread_mutex_lock(&l->lock);
+  enum AssetStage stage = l->assets[handle].stage;
+  pthread_mutex_unlock(&l->lock);
+  return stage;
+}
+
+Shader* assetShader(AssetLoader* l, int handle) {
+  return &l->assets[handle].shader;
+}
+
+Texture* assetTexture(AssetLoader* l, int handle) {
+  return &l->assets[handle].texture;
+}
+
+static void assetSetStage(Asset* a, enum AssetStage stage) {
+  pthread_mutex_lock(&a->loader->lock);
+  a->stage = stage;
+  pthread_mutex_unlock(&a->loader->lock);
+}
+
+// pack entries are already mapped, touching a byte per page faults them in here instead of on a worker
+static void assetPrefault(const unsigned char* data, size_t size) {
+  volatile unsigned char sink = 0;
+  for(size_t i = 0; i < size; i += ASSET_PAGE_SIZE) {
+    sink ^= data[i];
+  }
+  (void) sink;
+}
+
+static int assetReadOne(Asset* a, int i) {
+  AssetLoader* l = a->loader;
+  PackView v;
+  if(packFind(l->pack, a->names[i], &v) == 0) {
+    assetPrefault(v.data, v.size);
+    a->data[i] = v.data;
+    a->size[i] = v.size;
+    if(a->type == ASSET_TEXTURE && v.entry->type == PACK_ENTRY_PIXELS) {
+      a->packedPixels = 1;
+      a->width = (int) v.entry->width;
+      a->height = (int) v.entry->height;
+      a->channels = (int) v.entry->channels;
+    }
+    return 0;
+  }
+
+  char path[256];
+  snprintf(path, sizeof(path), "%s%s", l->root, a->names[i]);
+  FILE* file = fopen(path, "rb");
+  if(!file) {
+    printf("ERROR::ASSETS::FILE_NOT_FOUND: %s\n", path);
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  a->owned[i] = malloc(size > 0 ? (size_t) size : 1);
+  size_t read = size > 0 ? fread(a->owned[i], 1, (size_t) size, file) : 0;
+  fclose(file);
+  if(size <= 0 || read != (size_t) size) {
+    printf("ERROR::ASSETS::FILE_NOT_SUCCESSFULLY_READ: %s\n", path);
+    return -1;
+  }
+  a->data[i] = a->owned[i];
+  a->size[i] = read;
+  return 0;
+}
+
+// runs on the I/O thread
+static void assetRead(void* arg) {
+  Asset* a = arg;
+  double start = timingNow();
+  int files = a->type == ASSET_SHADER ? 2 : 1;
+  int failed = 0;
+  for(int i = 0; i < files && !failed; i++) {
+    failed = assetReadOne(a, i) != 0;
+  }
+  a->readMs = (timingNow() - start) * 1000.0;
+  assetSetStage(a, failed ? ASSET_FAILED : ASSET_READ);
+}
+
+// runs on a worker, never calls GL
+static void assetDecode(void* arg) {
+  Asset* a = arg;
+  double start = timingNow();
+  a->pixels = textureDecodeChannels(a->data[0], a->size[0], &a->width, &a->height, &a->channels, a->flip);
+  free(a->owned[0]);
+  a->owned[0] = NULL;
+  a->decodeMs = (timingNow() - start) * 1000.0;
+  assetSetStage(a, a->pixels ? ASSET_DECODED : ASSET_FAILED);
+}
+
+// the only stage that touches GL, runs on the thread that owns the context
+static void assetUpload(AssetLoader* l, Asset* a) {
+  if(a->type == ASSET_SHADER) {
+    int status = shaderInitFromSource(&a->shader, (const char*) a->data[0], (int) a->size[0], (const char*) a->data[1], (int) a->size[1]);
+    for(int i = 0; i < 2; i++) {
+      free(a->owned[i]);
+      a->owned[i] = NULL;
+    }
+    // materials waiting on a broken program fail with it instead of binding it
+    if(status != 0) {
+      glDeleteProgram(a->shader.ID);
+      a->shader.ID = 0;
+      a->stage = ASSET_FAILED;
+      return;
+    }
+  }
+  else if(a->type == ASSET_TEXTURE) {
+    if(a->packedPixels) {
+      textureInitFromPixels(&a->texture, a->textureUnit, a->data[0], a->width, a->height, a->channels, a->flip);
+    }
+    else {
+      textureInitFromPixels(&a->texture, a->textureUnit, a->pixels, a->width, a->height, a->channels, 0);
+      free(a->pixels);
+      a->pixels = NULL;
+    }
+  }
+  else {
+    Shader* shader = &l->assets[a->dependencies[0]].shader;
+    shaderUse(shader);
+    for(unsigned int i = 1; i < a->dependencyCount; i++) {
+      Texture* texture = &l->assets[a->dependencies[i]].texture;
+      shaderSetInt(shader, a->samplers[i], (int) (texture->textureUnit - GL_TEXTURE0));
+    }
+  }
+
+  a->stage = ASSET_READY;
+  l->stats.loaded++;
+  if(a->type != ASSET_MATERIAL) {
+    timingAdd(&l->stats.readTimes, a->readMs);
+  }
+  if(a->type == ASSET_TEXTURE && !a->packedPixels) {
+    timingAdd(&l->stats.decodeTimes, a->decodeMs);
+  }
+  timingAdd(&l->stats.loadTimes, (timingNow() - a->requested) * 1000.0);
+}
+
+// a material moves on once every dependency is ready, and fails with the first that fails
+static enum AssetStage assetDependencies(AssetLoader* l, Asset* a) {
+  enum AssetStage stage = ASSET_DECODED;
+  for(unsigned int i = 0; i < a->dependencyCount; i++) {
+    int handle = a->dependencies[i];
+    if(handle < 0 || (unsigned int) handle >= l->count) {
+      return ASSET_FAILED;
+    }
+    enum AssetStage dependency = assetStage(l, handle);
+    if(dependency == ASSET_FAILED) {
+      return ASSET_FAILED;
+    }
+    if(dependency != ASSET_READY) {
+      stage = ASSET_WAITING;
+    }
+  }
+  return stage;
+}
+
+void assetLoaderUpdate(AssetLoader* l) {
+  double start = timingNow();
+  unsigned int uploads = 0;
+  int loading = 0;
+  int sliced = 0;
+
+  for(unsigned int i = 0; i < l->count; i++) {
+    Asset* a = &l->assets[i];
+    enum AssetStage stage = assetStage(l, (int) i);
+    if(stage == ASSET_READY || stage == ASSET_FAILED) {
+      continue;
+    }
+    loading = 1;
+
+    // threads only hand an asset back, what happens next is decided here
+    if(stage == ASSET_WAITING) {
+      if(a->type == ASSET_MATERIAL) {
+        stage = assetDependencies(l, a);
+        assetSetStage(a, stage);
+      }
+      else {
+        a->stage = ASSET_READING;
+        jobsSubmit(&l->io, assetRead, a);
+      }
+    }
+    else if(stage == ASSET_READ) {
+      if(a->type == ASSET_TEXTURE && !a->packedPixels) {
+        a->stage = ASSET_DECODING;
+        jobsSubmit(l->workers, assetDecode, a);
+      }
+      else {
+        stage = ASSET_DECODED;
+        assetSetStage(a, stage);
+      }
+    }
+
+    if(stage == ASSET_DECODED) {
+      if(uploads && (timingNow() - start) * 1000.0 >= l->budgetMs) {
+        sliced = 1;
+        continue;
+      }
+      assetUpload(l, a);
+      uploads++;
+    }
+  }
+
+  if(loading) {
+    l->stats.loadingFrames++;
+    l->stats.slicedFrames += sliced;
+    timingAdd(&l->stats.sliceTimes, (timingNow() - start) * 1000.0);
+  }
+}
+
+unsigned int assetLoaderPending(AssetLoader* l) {
+  unsigned int pending = 0;
+  for(unsigned int i = 0; i < l->count; i++) {
+    enum AssetStage stage = assetStage(l, (int) i);
+    pending += stage != ASSET_READY && stage != ASSET_FAILED;
+  }
+  return pending;
+}
+
+void assetLoaderReport(AssetLoader* l) {
+  AssetStats* stats = &l->stats;
+  unsigned int failed = 0;
+  for(unsigned int i = 0; i < l->count; i++) {
+    failed += assetStage(l, (int) i) == ASSET_FAILED;
+  }
+  printf("assets: %llu loaded, %u failed, %u pending, over %u frames, %u of them cut short by the %.1f ms budget\n",
+      stats->loaded, failed, assetLoaderPending(l), stats->loadingFrames, stats->slicedFrames, l->budgetMs);
+  timingReport(&stats->readTimes, "asset read");
+  timingReport(&stats->decodeTimes, "asset decode");
+  timingReport(&stats->sliceTimes, "asset GL slice");
+  timingReport(&stats->loadTimes, "asset request to ready");
+}
+
+void assetLoaderFree(AssetLoader* l) {
+  // nothing may still write into the assets once they are freed
+  jobsFree(&l->io);
+  jobsWait(l->workers);
+
+  for(unsigned int i = 0; i < l->count; i++) {
+    Asset* a = &l->assets[i];
+    if(a->stage == ASSET_READY && a->type == ASSET_SHADER) {
+      glDeleteProgram(a->shader.ID);
+    }
+    if(a->stage == ASSET_READY && a->type == ASSET_TEXTURE) {
+      glDeleteTextures(1, &a->texture.ID);
+    }
+    free(a->owned[0]);
+    free(a->owned[1]);
+    free(a->pixels);
+  }
+  free(l->assets);
+  pthread_mutex_destroy(&l->lock);
+  timingFree(&l->stats.readTimes);
+  timingFree(&l->stats.decodeTimes);
+  timingFree(&l->stats.sliceTimes);
+  timingFree(&l->stats.loadTimes);
+}
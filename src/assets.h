@@ -0,0 +1,122 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include "jobs.h"
+#include "pack.h"
+#include "shader.h"
+#include "texture.h"
+#include "timing.h"
+
+#define ASSET_NAME_LENGTH 64
+#define ASSET_MAX_DEPENDENCIES 4
+#define ASSET_SAMPLER_LENGTH 32
+
+enum AssetType {
+  ASSET_SHADER,
+  ASSET_TEXTURE,
+  ASSET_MATERIAL // a shader plus the textures bound to its samplers, ready once all of them are
+};
+
+// where an asset's task resumes, each stage runs on the thread that owns it and hands over to the next
+enum AssetStage {
+  ASSET_WAITING, // queued for the I/O thread, or a material waiting on its dependencies
+  ASSET_READING, // I/O thread
+  ASSET_READ, // bytes in memory, queued for a worker
+  ASSET_DECODING, // worker
+  ASSET_DECODED, // waiting for its slice of GL thread time
+  ASSET_READY,
+  ASSET_FAILED
+};
+
+typedef struct Asset {
+  struct AssetLoader* loader;
+  enum AssetType type;
+  enum AssetStage stage; // guarded by the loader lock while the I/O thread or a worker owns the asset
+  char names[2][ASSET_NAME_LENGTH]; // vertex and fragment source for shaders, the image for textures
+
+  // read
+  const unsigned char* data[2]; // into the pack or owned
+  size_t size[2];
+  unsigned char* owned[2]; // file contents read from the loose tree, NULL for pack views
+  int packedPixels; // the pack holds the image decoded, nothing left for a worker
+
+  // decoded
+  unsigned char* pixels;
+  int width;
+  int height;
+  int channels;
+  int flip;
+  unsigned int textureUnit;
+
+  // uploaded
+  Shader shader;
+  Texture texture;
+
+  int dependencies[ASSET_MAX_DEPENDENCIES]; // materials, the shader first, then its textures
+  char samplers[ASSET_MAX_DEPENDENCIES][ASSET_SAMPLER_LENGTH];
+  unsigned int dependencyCount;
+
+  double requested;
+  double readMs;
+  double decodeMs;
+} Asset;
+
+typedef struct AssetStats {
+  unsigned long long loaded;
+  unsigned int loadingFrames; // updates that found anything still loading
+  unsigned int slicedFrames; // updates that left uploads for a later frame to stay in budget
+  Timing readTimes; // milliseconds per asset on the I/O thread
+  Timing decodeTimes; // milliseconds per asset on a worker
+  Timing sliceTimes; // milliseconds of GL thread work per update
+  Timing loadTimes; // milliseconds from request until ready
+} AssetStats;
+
+// loads shaders and textures as resumable tasks: files are read on a dedicated I/O thread,
+// decoded on the shared workers and uploaded on the GL thread a time slice per frame,
+// so whatever is already on screen keeps rendering while the rest streams in
+typedef struct AssetLoader {
+  Jobs io;
+  Jobs* workers;
+  Pack* pack; // looked in first, then the loose tree under root
+  const char* root;
+
+  Asset* assets; // fixed at init, the threads hold pointers into it
+  unsigned int count;
+  unsigned int capacity;
+  double budgetMs; // GL thread time per update, at least one upload always goes through
+
+  pthread_mutex_t lock;
+
+  AssetStats stats;
+} AssetLoader;
+
+void assetLoaderInit(AssetLoader* l, Jobs* workers, Pack* pack, const char* root, unsigned int capacity, double budgetMs);
+
+// each returns a handle or -1
+int assetLoadShader(AssetLoader* l, const char* vertexName, const char* fragmentName);
+
+int assetLoadTexture(AssetLoader* l, const char* name, unsigned int textureUnit, int flip);
+
+// each texture is bound to its sampler uniform once the shader is linked
+int assetLoadMaterial(AssetLoader* l, int shader, const int* textures, const char** samplers, unsigned int textureCount);
+
+enum AssetStage assetStage(AssetLoader* l, int handle);
+
+Shader* assetShader(AssetLoader* l, int handle);
+
+Texture* assetTexture(AssetLoader* l, int handle);
+
+// resumes every task as far as it goes without blocking, uploads stop once the budget is spent
+void assetLoaderUpdate(AssetLoader* l);
+
+// assets not yet ready or failed
+unsigned int assetLoaderPending(AssetLoader* l);
+
+void assetLoaderReport(AssetLoader* l);
+
+// joins the I/O thread, then deletes every shader and texture it loaded
+void assetLoaderFree(AssetLoader* l);
+
+#endif
@@ -119,6 +119,30 @@ void cameraProcessKeys(Camera* c, GLFWwindow* window) {
   }
 }
 
+// scripted orbit around the cube scene for reproducible runs, t in [0, 1) covers one loop
+void cameraFollowPath(Camera* c, float t) {
+  vec3 center = {0.0f, 0.0f, -5.0f};
+  float angle = 2.0f * GLM_PIf * t;
+
+  c->cameraPos[0] = center[0] + 9.0f * sinf(angle);
+  c->cameraPos[1] = center[1] + 2.0f * sinf(2.0f * angle);
+  c->cameraPos[2] = center[2] + 9.0f * cosf(angle);
+
+  glm_vec3_sub(center, c->cameraPos, c->cameraFront);
+  glm_vec3_normalize(c->cameraFront);
+}
+
+void cameraFlyPath(Camera* c, float t, float distance) {
+  c->cameraPos[0] = 0.0f;
+  c->cameraPos[1] = 2.0f;
+  c->cameraPos[2] = -distance * t;
+
+  c->cameraFront[0] = 0.0f;
+  c->cameraFront[1] = -0.3f;
+  c->cameraFront[2] = -1.0f;
+  glm_vec3_normalize(c->cameraFront);
+}
+
 void cameraLookAt(Camera* c, mat4 view) {
   vec3 cameraTarget;
   glm_vec3_add(c->cameraPos, c->cameraFront, cameraTarget);
@@ -135,7 +159,7 @@ void cameraCustomLookAt(Camera* c, mat4 view) {
   vec3 cameraUp;
   glm_vec3_cross(cameraDirection, cameraRight, cameraUp);
 
-  mat4 translate = GLM_MAT4_IDENTITY;
+  mat4 translate = GLM_MAT4_IDENTITY_INIT;
   vec3 negatePos;
   glm_vec3_negate_to(c->cameraPos, negatePos);
   glm_translate_make(translate, negatePos);
@@ -29,6 +29,11 @@ void cameraInit(Camera* c, GLFWwindow* window);
 
 void cameraProcessKeys(Camera* c, GLFWwindow *window);
 
+void cameraFollowPath(Camera* c, float t);
+
+// straight line over the terrain, t in [0, 1] covers distance world units
+void cameraFlyPath(Camera* c, float t, float distance);
+
 void cameraLookAt(Camera* c, mat4 view);
 
 void cameraCustomLookAt(Camera* c, mat4 view);
@@ -52,10 +52,10 @@ int main() {
   shaderInit(&s, "../src/VS", "../src/FS");
 
   Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 0, 1);
+  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 0);
 
   Camera c;
   cameraInit(&c, window);
@@ -144,7 +144,7 @@ int main() {
   };
 
   for(unsigned int i = 0; i < 10; i++) {
-    mat4 model = GLM_MAT4_IDENTITY;
+    mat4 model = GLM_MAT4_IDENTITY_INIT;
     glm_translate_make(model, cubePositions[i]);
     shaderSetMatrix(&s, "model", model);
   }
@@ -153,7 +153,7 @@ int main() {
     processInput(window);
     cameraProcessKeys(&c, window);
 
-    mat4 projection = GLM_MAT4_IDENTITY;
+    mat4 projection = GLM_MAT4_IDENTITY_INIT;
     glm_perspective(glm_rad(c.fov), (float) WINDOW_WIDTH / (float) WINDOW_HEIGHT, 0.1f, 100.0f, projection); 
     shaderSetMatrix(&s, "projection", projection);
 
@@ -165,7 +165,7 @@ int main() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     for(unsigned int i = 0; i < 10; i++) {
-      mat4 model = GLM_MAT4_IDENTITY;
+      mat4 model = GLM_MAT4_IDENTITY_INIT;
       glm_translate_make(model, cubePositions[i]);
       shaderSetMatrix(&s, "model", model);
 
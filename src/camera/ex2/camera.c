@@ -135,7 +135,7 @@ void cameraCustomLookAt(Camera* c, mat4 view) {
   vec3 cameraUp;
   glm_vec3_cross(cameraDirection, cameraRight, cameraUp);
 
-  mat4 translate = GLM_MAT4_IDENTITY;
+  mat4 translate = GLM_MAT4_IDENTITY_INIT;
   vec3 negatePos;
   glm_vec3_negate_to(c->cameraPos, negatePos);
   glm_translate_make(translate, negatePos);
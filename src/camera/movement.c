@@ -55,10 +55,10 @@ int main() {
   shaderInit(&s, "../src/VS", "../src/FS");
 
   Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 0, 1);
+  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 0);
   
   float vertices[] = {
     -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
@@ -129,7 +129,7 @@ int main() {
   glEnable(GL_DEPTH_TEST);
 
   unsigned int modelLoc, viewLoc, projectionLoc;
-  mat4 projection = GLM_MAT4_IDENTITY;
+  mat4 projection = GLM_MAT4_IDENTITY_INIT;
   glm_perspective(glm_rad(45.0f), (float) WINDOW_WIDTH / (float) WINDOW_HEIGHT, 0.1f, 100.0f, projection); 
   projectionLoc = glGetUniformLocation(s.ID, "projection");
   glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, (const float*) projection);
@@ -148,7 +148,7 @@ int main() {
   };
 
   for(unsigned int i = 0; i < 10; i++) {
-    mat4 model = GLM_MAT4_IDENTITY;
+    mat4 model = GLM_MAT4_IDENTITY_INIT;
     glm_translate_make(model, cubePositions[i]);
     modelLoc = glGetUniformLocation(s.ID, "model");
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, (const float*) model);
@@ -202,7 +202,7 @@ int main() {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
     for(unsigned int i = 0; i < 10; i++) {
-      mat4 model = GLM_MAT4_IDENTITY;
+      mat4 model = GLM_MAT4_IDENTITY_INIT;
       glm_translate_make(model, cubePositions[i]);
       modelLoc = glGetUniformLocation(s.ID, "model");
       glUniformMatrix4fv(modelLoc, 1, GL_FALSE, (const float*) model);
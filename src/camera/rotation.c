@@ -54,10 +54,10 @@ int main() {
   shaderInit(&s, "../src/VS", "../src/FS");
 
   Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 0, 1);
+  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 0);
   
   float vertices[] = {
     -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
@@ -128,7 +128,7 @@ int main() {
   glEnable(GL_DEPTH_TEST);
 
   unsigned int modelLoc, viewLoc, projectionLoc;
-  mat4 projection = GLM_MAT4_IDENTITY;
+  mat4 projection = GLM_MAT4_IDENTITY_INIT;
   glm_perspective(glm_rad(45.0f), (float) WINDOW_WIDTH / (float) WINDOW_HEIGHT, 0.1f, 100.0f, projection); 
   projectionLoc = glGetUniformLocation(s.ID, "projection");
   glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, (const float*) projection);
@@ -147,7 +147,7 @@ int main() {
   };
 
   for(unsigned int i = 0; i < 10; i++) {
-    mat4 model = GLM_MAT4_IDENTITY;
+    mat4 model = GLM_MAT4_IDENTITY_INIT;
     glm_translate_make(model, cubePositions[i]);
     modelLoc = glGetUniformLocation(s.ID, "model");
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, (const float*) model);
@@ -161,14 +161,14 @@ int main() {
     glClearColor(0.0f, 0.0f, 0.0f,1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    mat4 view = GLM_MAT4_IDENTITY;
+    mat4 view = GLM_MAT4_IDENTITY_INIT;
     vec3 cameraPos = {radius * cos(glfwGetTime()), 0.0f, radius * sin(glfwGetTime())};
     glm_lookat(cameraPos, (vec3) {0.0f, 0.0f, 0.0f}, (vec3) {0.0f, 1.0f, 0.0f}, view);
     viewLoc = glGetUniformLocation(s.ID, "view");
     glUniformMatrix4fv(viewLoc, 1, GL_FALSE, (const float*) view);
 
     for(unsigned int i = 0; i < 10; i++) {
-      mat4 model = GLM_MAT4_IDENTITY;
+      mat4 model = GLM_MAT4_IDENTITY_INIT;
       glm_translate_make(model, cubePositions[i]);
       if(i % 3 == 0) {
         glm_rotate(model, glm_rad(50.0f) * (float) glfwGetTime(), (vec3) {1.0f, 0.3f, 0.5f});
@@ -0,0 +1,762 @@
+#include "capture.h"
+#include <stdio.h>
+#include <string.h>
+#include <glad/glad.h>
+#include "glext.h"
+
+// a buffer mapped through the capture layer, its contents are recorded when it is unmapped
+typedef struct CaptureMapping {
+  GLuint buffer;
+  void* pointer; // NULL when the slot is free
+  uint32_t length;
+  int write; // read mappings are unmapped without a blob
+} CaptureMapping;
+
+static FILE* captureFile;
+static GLuint boundUnpackBuffer; // pixel uploads from a PBO pass an offset, not CPU memory
+static CaptureMapping mappings[CAPTURE_MAX_MAPPINGS];
+
+// the driver entry points glad loaded, called through after each record is written
+#define CAPTURE_DECLARE_REAL(name) static __typeof__(glad_##name) real_##name;
+CAPTURE_CALLS(CAPTURE_DECLARE_REAL)
+#undef CAPTURE_DECLARE_REAL
+
+// the glext loader leaves these NULL on drivers without them, they are only wrapped when present
+#define CAPTURE_DECLARE_REAL_EXT(name) static __typeof__(glext_##name) real_##name;
+CAPTURE_EXT_CALLS(CAPTURE_DECLARE_REAL_EXT)
+#undef CAPTURE_DECLARE_REAL_EXT
+
+static const char* callNames[] = {
+#define CAPTURE_NAME(name) #name,
+  CAPTURE_CALLS(CAPTURE_NAME)
+  CAPTURE_EXT_CALLS(CAPTURE_NAME)
+#undef CAPTURE_NAME
+  "frame"
+};
+
+const char* captureCallName(unsigned int call) {
+  return call < CAPTURE_CALL_COUNT ? callNames[call] : "unknown";
+}
+
+static void captureWrite(CaptureCall call, const uint32_t* args, unsigned int argCount, const void* blob, uint32_t blobSize) {
+  CaptureRecord record;
+  record.call = (uint16_t) call;
+  record.argCount = (uint16_t) argCount;
+  record.blobSize = blob ? blobSize : 0;
+
+  fwrite(&record, sizeof(record), 1, captureFile);
+  fwrite(args, sizeof(uint32_t), argCount, captureFile);
+  if(record.blobSize) {
+    fwrite(blob, record.blobSize, 1, captureFile);
+  }
+}
+
+static uint32_t floatBits(float f) {
+  uint32_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  return bits;
+}
+
+// bytes glTexImage2D reads for an 8-bit image under the current unpack alignment
+static uint32_t imageSize(GLenum format, GLsizei width, GLsizei height) {
+  unsigned int components = 4;
+  switch(format) {
+    case GL_RED: components = 1; break;
+    case GL_RG: components = 2; break;
+    case GL_RGB: case GL_BGR: components = 3; break;
+  }
+
+  GLint alignment = 4;
+  glad_glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+  uint32_t rowSize = (width * components + alignment - 1) / alignment * alignment;
+  return rowSize * height;
+}
+
+// bytes of one element of client data, as glClearBufferData reads it
+static uint32_t elementSize(GLenum format, GLenum type) {
+  unsigned int components = 4;
+  switch(format) {
+    case GL_RED: case GL_RED_INTEGER: components = 1; break;
+    case GL_RG: case GL_RG_INTEGER: components = 2; break;
+    case GL_RGB: case GL_RGB_INTEGER: components = 3; break;
+  }
+
+  switch(type) {
+    case GL_UNSIGNED_BYTE: case GL_BYTE: return components;
+    case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: return components * 2;
+  }
+  return components * 4;
+}
+
+// syncs are pointers, split into two arguments
+static void syncWords(GLsync sync, uint32_t* words) {
+  uint64_t bits = (uint64_t) (uintptr_t) sync;
+  words[0] = (uint32_t) bits;
+  words[1] = (uint32_t) (bits >> 32);
+}
+
+// the buffer a map or unmap on target applies to
+static GLuint boundBuffer(GLenum target) {
+  GLenum binding = 0;
+  switch(target) {
+    case GL_ARRAY_BUFFER: binding = GL_ARRAY_BUFFER_BINDING; break;
+    case GL_ELEMENT_ARRAY_BUFFER: binding = GL_ELEMENT_ARRAY_BUFFER_BINDING; break;
+    case GL_PIXEL_PACK_BUFFER: binding = GL_PIXEL_PACK_BUFFER_BINDING; break;
+    case GL_PIXEL_UNPACK_BUFFER: binding = GL_PIXEL_UNPACK_BUFFER_BINDING; break;
+    case GL_UNIFORM_BUFFER: binding = GL_UNIFORM_BUFFER_BINDING; break;
+    case GL_COPY_READ_BUFFER: binding = GL_COPY_READ_BUFFER; break;
+    case GL_COPY_WRITE_BUFFER: binding = GL_COPY_WRITE_BUFFER; break;
+    case GL_DRAW_INDIRECT_BUFFER: binding = GL_DRAW_INDIRECT_BUFFER_BINDING; break;
+    case GL_SHADER_STORAGE_BUFFER: binding = GL_SHADER_STORAGE_BUFFER_BINDING; break;
+  }
+
+  GLint buffer = 0;
+  if(binding) {
+    glad_glGetIntegerv(binding, &buffer);
+  }
+  return (GLuint) buffer;
+}
+
+static void APIENTRY captureGenVertexArrays(GLsizei n, GLuint* arrays) {
+  real_glGenVertexArrays(n, arrays);
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glGenVertexArrays, args, 1, arrays, n * sizeof(GLuint));
+}
+
+static void APIENTRY captureBindVertexArray(GLuint array) {
+  uint32_t args[] = {array};
+  captureWrite(CAPTURE_CALL_glBindVertexArray, args, 1, NULL, 0);
+  real_glBindVertexArray(array);
+}
+
+static void APIENTRY captureDeleteVertexArrays(GLsizei n, const GLuint* arrays) {
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glDeleteVertexArrays, args, 1, arrays, n * sizeof(GLuint));
+  real_glDeleteVertexArrays(n, arrays);
+}
+
+static void APIENTRY captureGenBuffers(GLsizei n, GLuint* buffers) {
+  real_glGenBuffers(n, buffers);
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glGenBuffers, args, 1, buffers, n * sizeof(GLuint));
+}
+
+static void APIENTRY captureBindBuffer(GLenum target, GLuint buffer) {
+  if(target == GL_PIXEL_UNPACK_BUFFER) {
+    boundUnpackBuffer = buffer;
+  }
+  uint32_t args[] = {target, buffer};
+  captureWrite(CAPTURE_CALL_glBindBuffer, args, 2, NULL, 0);
+  real_glBindBuffer(target, buffer);
+}
+
+static void APIENTRY captureBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+  uint32_t args[] = {target, (uint32_t) size, usage};
+  captureWrite(CAPTURE_CALL_glBufferData, args, 3, data, (uint32_t) size);
+  real_glBufferData(target, size, data, usage);
+}
+
+static void APIENTRY captureBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+  uint32_t args[] = {target, (uint32_t) offset, (uint32_t) size};
+  captureWrite(CAPTURE_CALL_glBufferSubData, args, 3, data, (uint32_t) size);
+  real_glBufferSubData(target, offset, size, data);
+}
+
+static void APIENTRY captureDeleteBuffers(GLsizei n, const GLuint* buffers) {
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glDeleteBuffers, args, 1, buffers, n * sizeof(GLuint));
+  real_glDeleteBuffers(n, buffers);
+}
+
+static void APIENTRY captureVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+  uint32_t args[] = {index, size, type, normalized, stride, (uint32_t) (uintptr_t) pointer};
+  captureWrite(CAPTURE_CALL_glVertexAttribPointer, args, 6, NULL, 0);
+  real_glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+}
+
+static void APIENTRY captureEnableVertexAttribArray(GLuint index) {
+  uint32_t args[] = {index};
+  captureWrite(CAPTURE_CALL_glEnableVertexAttribArray, args, 1, NULL, 0);
+  real_glEnableVertexAttribArray(index);
+}
+
+static GLuint APIENTRY captureCreateShader(GLenum type) {
+  GLuint shader = real_glCreateShader(type);
+  uint32_t args[] = {type, shader};
+  captureWrite(CAPTURE_CALL_glCreateShader, args, 2, NULL, 0);
+  return shader;
+}
+
+// sources are stored back to back, the argument list carries each length
+static void APIENTRY captureShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
+  uint32_t args[2 + CAPTURE_MAX_SHADER_STRINGS];
+  uint32_t total = 0;
+
+  if(count > CAPTURE_MAX_SHADER_STRINGS) {
+    printf("ERROR::CAPTURE::TOO_MANY_SHADER_STRINGS: %d\n", count);
+    count = CAPTURE_MAX_SHADER_STRINGS;
+  }
+
+  args[0] = shader;
+  args[1] = count;
+  for(GLsizei i = 0; i < count; i++) {
+    args[2 + i] = (length && length[i] >= 0) ? (uint32_t) length[i] : (uint32_t) strlen(string[i]);
+    total += args[2 + i];
+  }
+
+  CaptureRecord record = {CAPTURE_CALL_glShaderSource, (uint16_t) (2 + count), total};
+  fwrite(&record, sizeof(record), 1, captureFile);
+  fwrite(args, sizeof(uint32_t), 2 + count, captureFile);
+  for(GLsizei i = 0; i < count; i++) {
+    fwrite(string[i], args[2 + i], 1, captureFile);
+  }
+
+  real_glShaderSource(shader, count, string, length);
+}
+
+static void APIENTRY captureCompileShader(GLuint shader) {
+  uint32_t args[] = {shader};
+  captureWrite(CAPTURE_CALL_glCompileShader, args, 1, NULL, 0);
+  real_glCompileShader(shader);
+}
+
+static void APIENTRY captureDeleteShader(GLuint shader) {
+  uint32_t args[] = {shader};
+  captureWrite(CAPTURE_CALL_glDeleteShader, args, 1, NULL, 0);
+  real_glDeleteShader(shader);
+}
+
+static GLuint APIENTRY captureCreateProgram() {
+  GLuint program = real_glCreateProgram();
+  uint32_t args[] = {program};
+  captureWrite(CAPTURE_CALL_glCreateProgram, args, 1, NULL, 0);
+  return program;
+}
+
+static void APIENTRY captureAttachShader(GLuint program, GLuint shader) {
+  uint32_t args[] = {program, shader};
+  captureWrite(CAPTURE_CALL_glAttachShader, args, 2, NULL, 0);
+  real_glAttachShader(program, shader);
+}
+
+static void APIENTRY captureLinkProgram(GLuint program) {
+  uint32_t args[] = {program};
+  captureWrite(CAPTURE_CALL_glLinkProgram, args, 1, NULL, 0);
+  real_glLinkProgram(program);
+}
+
+static void APIENTRY captureUseProgram(GLuint program) {
+  uint32_t args[] = {program};
+  captureWrite(CAPTURE_CALL_glUseProgram, args, 1, NULL, 0);
+  real_glUseProgram(program);
+}
+
+static void APIENTRY captureDeleteProgram(GLuint program) {
+  uint32_t args[] = {program};
+  captureWrite(CAPTURE_CALL_glDeleteProgram, args, 1, NULL, 0);
+  real_glDeleteProgram(program);
+}
+
+// the returned location is recorded so replay can map it to the location its own driver hands out
+static GLint APIENTRY captureGetUniformLocation(GLuint program, const GLchar* name) {
+  GLint location = real_glGetUniformLocation(program, name);
+  uint32_t args[] = {program, (uint32_t) location};
+  captureWrite(CAPTURE_CALL_glGetUniformLocation, args, 2, name, (uint32_t) strlen(name) + 1);
+  return location;
+}
+
+static void APIENTRY captureUniform1i(GLint location, GLint v0) {
+  uint32_t args[] = {(uint32_t) location, (uint32_t) v0};
+  captureWrite(CAPTURE_CALL_glUniform1i, args, 2, NULL, 0);
+  real_glUniform1i(location, v0);
+}
+
+static void APIENTRY captureUniform1f(GLint location, GLfloat v0) {
+  uint32_t args[] = {(uint32_t) location, floatBits(v0)};
+  captureWrite(CAPTURE_CALL_glUniform1f, args, 2, NULL, 0);
+  real_glUniform1f(location, v0);
+}
+
+static void APIENTRY captureUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+  uint32_t args[] = {(uint32_t) location, count, transpose};
+  captureWrite(CAPTURE_CALL_glUniformMatrix4fv, args, 3, value, count * 16 * sizeof(GLfloat));
+  real_glUniformMatrix4fv(location, count, transpose, value);
+}
+
+static void APIENTRY captureGenTextures(GLsizei n, GLuint* textures) {
+  real_glGenTextures(n, textures);
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glGenTextures, args, 1, textures, n * sizeof(GLuint));
+}
+
+static void APIENTRY captureActiveTexture(GLenum texture) {
+  uint32_t args[] = {texture};
+  captureWrite(CAPTURE_CALL_glActiveTexture, args, 1, NULL, 0);
+  real_glActiveTexture(texture);
+}
+
+static void APIENTRY captureBindTexture(GLenum target, GLuint texture) {
+  uint32_t args[] = {target, texture};
+  captureWrite(CAPTURE_CALL_glBindTexture, args, 2, NULL, 0);
+  real_glBindTexture(target, texture);
+}
+
+static void APIENTRY captureTexParameteri(GLenum target, GLenum pname, GLint param) {
+  uint32_t args[] = {target, pname, (uint32_t) param};
+  captureWrite(CAPTURE_CALL_glTexParameteri, args, 3, NULL, 0);
+  real_glTexParameteri(target, pname, param);
+}
+
+// the last argument is the PBO offset when one is bound, otherwise the pixels follow as the blob
+static void APIENTRY captureTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) {
+  int fromBuffer = boundUnpackBuffer != 0;
+  uint32_t args[] = {target, (uint32_t) level, (uint32_t) internalformat, width, height, (uint32_t) border, format, type, fromBuffer, fromBuffer ? (uint32_t) (uintptr_t) pixels : 0};
+  const void* blob = fromBuffer ? NULL : pixels;
+  captureWrite(CAPTURE_CALL_glTexImage2D, args, 10, blob, blob ? imageSize(format, width, height) : 0);
+  real_glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+}
+
+static void APIENTRY captureGenerateMipmap(GLenum target) {
+  uint32_t args[] = {target};
+  captureWrite(CAPTURE_CALL_glGenerateMipmap, args, 1, NULL, 0);
+  real_glGenerateMipmap(target);
+}
+
+static void APIENTRY captureDeleteTextures(GLsizei n, const GLuint* textures) {
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glDeleteTextures, args, 1, textures, n * sizeof(GLuint));
+  real_glDeleteTextures(n, textures);
+}
+
+static void APIENTRY captureEnable(GLenum cap) {
+  uint32_t args[] = {cap};
+  captureWrite(CAPTURE_CALL_glEnable, args, 1, NULL, 0);
+  real_glEnable(cap);
+}
+
+static void APIENTRY captureDisable(GLenum cap) {
+  uint32_t args[] = {cap};
+  captureWrite(CAPTURE_CALL_glDisable, args, 1, NULL, 0);
+  real_glDisable(cap);
+}
+
+static void APIENTRY captureClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+  uint32_t args[] = {floatBits(red), floatBits(green), floatBits(blue), floatBits(alpha)};
+  captureWrite(CAPTURE_CALL_glClearColor, args, 4, NULL, 0);
+  real_glClearColor(red, green, blue, alpha);
+}
+
+static void APIENTRY captureClear(GLbitfield mask) {
+  uint32_t args[] = {mask};
+  captureWrite(CAPTURE_CALL_glClear, args, 1, NULL, 0);
+  real_glClear(mask);
+}
+
+static void APIENTRY captureViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+  uint32_t args[] = {(uint32_t) x, (uint32_t) y, width, height};
+  captureWrite(CAPTURE_CALL_glViewport, args, 4, NULL, 0);
+  real_glViewport(x, y, width, height);
+}
+
+static void APIENTRY captureDrawArrays(GLenum mode, GLint first, GLsizei count) {
+  uint32_t args[] = {mode, (uint32_t) first, count};
+  captureWrite(CAPTURE_CALL_glDrawArrays, args, 3, NULL, 0);
+  real_glDrawArrays(mode, first, count);
+}
+
+// core profile draws always source indices from the bound element buffer, so the pointer is an offset
+static void APIENTRY captureDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+  uint32_t args[] = {mode, count, type, (uint32_t) (uintptr_t) indices};
+  captureWrite(CAPTURE_CALL_glDrawElements, args, 4, NULL, 0);
+  real_glDrawElements(mode, count, type, indices);
+}
+
+static void APIENTRY capturePixelStorei(GLenum pname, GLint param) {
+  uint32_t args[] = {pname, (uint32_t) param};
+  captureWrite(CAPTURE_CALL_glPixelStorei, args, 2, NULL, 0);
+  real_glPixelStorei(pname, param);
+}
+
+static void APIENTRY captureTexParameteriv(GLenum target, GLenum pname, const GLint* params) {
+  uint32_t count = (pname == GL_TEXTURE_SWIZZLE_RGBA || pname == GL_TEXTURE_BORDER_COLOR) ? 4 : 1;
+  uint32_t args[] = {target, pname};
+  captureWrite(CAPTURE_CALL_glTexParameteriv, args, 2, params, count * sizeof(GLint));
+  real_glTexParameteriv(target, pname, params);
+}
+
+// same layout as glTexImage2D, offset and size of the region first
+static void APIENTRY captureTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels) {
+  int fromBuffer = boundUnpackBuffer != 0;
+  uint32_t args[] = {target, (uint32_t) level, (uint32_t) xoffset, (uint32_t) yoffset, width, height, format, type, fromBuffer, fromBuffer ? (uint32_t) (uintptr_t) pixels : 0};
+  const void* blob = fromBuffer ? NULL : pixels;
+  captureWrite(CAPTURE_CALL_glTexSubImage2D, args, 10, blob, blob ? imageSize(format, width, height) : 0);
+  real_glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+static void APIENTRY captureVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer) {
+  uint32_t args[] = {index, size, type, stride, (uint32_t) (uintptr_t) pointer};
+  captureWrite(CAPTURE_CALL_glVertexAttribIPointer, args, 5, NULL, 0);
+  real_glVertexAttribIPointer(index, size, type, stride, pointer);
+}
+
+static void APIENTRY captureVertexAttribDivisor(GLuint index, GLuint divisor) {
+  uint32_t args[] = {index, divisor};
+  captureWrite(CAPTURE_CALL_glVertexAttribDivisor, args, 2, NULL, 0);
+  real_glVertexAttribDivisor(index, divisor);
+}
+
+static void APIENTRY captureDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {
+  uint32_t args[] = {mode, (uint32_t) first, count, instancecount};
+  captureWrite(CAPTURE_CALL_glDrawArraysInstanced, args, 4, NULL, 0);
+  real_glDrawArraysInstanced(mode, first, count, instancecount);
+}
+
+static void APIENTRY captureDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex) {
+  uint32_t args[] = {mode, count, type, (uint32_t) (uintptr_t) indices, (uint32_t) basevertex};
+  captureWrite(CAPTURE_CALL_glDrawElementsBaseVertex, args, 5, NULL, 0);
+  real_glDrawElementsBaseVertex(mode, count, type, indices, basevertex);
+}
+
+static void APIENTRY captureDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex) {
+  uint32_t args[] = {mode, count, type, (uint32_t) (uintptr_t) indices, instancecount, (uint32_t) basevertex};
+  captureWrite(CAPTURE_CALL_glDrawElementsInstancedBaseVertex, args, 6, NULL, 0);
+  real_glDrawElementsInstancedBaseVertex(mode, count, type, indices, instancecount, basevertex);
+}
+
+static void APIENTRY captureBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+  uint32_t args[] = {target, index, buffer};
+  captureWrite(CAPTURE_CALL_glBindBufferBase, args, 3, NULL, 0);
+  real_glBindBufferBase(target, index, buffer);
+}
+
+static void APIENTRY captureCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+  uint32_t args[] = {readTarget, writeTarget, (uint32_t) readOffset, (uint32_t) writeOffset, (uint32_t) size};
+  captureWrite(CAPTURE_CALL_glCopyBufferSubData, args, 5, NULL, 0);
+  real_glCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+}
+
+// the map itself carries no data, whatever the application writes is recorded by glUnmapBuffer
+static void* APIENTRY captureMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+  GLuint buffer = boundBuffer(target);
+  uint32_t args[] = {target, (uint32_t) offset, (uint32_t) length, access, buffer};
+  captureWrite(CAPTURE_CALL_glMapBufferRange, args, 5, NULL, 0);
+
+  void* pointer = real_glMapBufferRange(target, offset, length, access);
+  for(int i = 0; pointer && i < CAPTURE_MAX_MAPPINGS; i++) {
+    if(!mappings[i].pointer) {
+      mappings[i] = (CaptureMapping) {buffer, pointer, (uint32_t) length, (access & GL_MAP_WRITE_BIT) != 0};
+      return pointer;
+    }
+  }
+  if(pointer) {
+    printf("ERROR::CAPTURE::TOO_MANY_MAPPINGS: %u\n", buffer);
+  }
+  return pointer;
+}
+
+// buffers mapped outside the capture layer (glMapBuffer readbacks) are unmapped without a record
+static GLboolean APIENTRY captureUnmapBuffer(GLenum target) {
+  GLuint buffer = boundBuffer(target);
+  for(int i = 0; i < CAPTURE_MAX_MAPPINGS; i++) {
+    CaptureMapping* m = &mappings[i];
+    if(m->pointer && m->buffer == buffer) {
+      uint32_t args[] = {target, buffer};
+      captureWrite(CAPTURE_CALL_glUnmapBuffer, args, 2, m->write ? m->pointer : NULL, m->length);
+      m->pointer = NULL;
+      break;
+    }
+  }
+  return real_glUnmapBuffer(target);
+}
+
+static void APIENTRY captureUniform2f(GLint location, GLfloat v0, GLfloat v1) {
+  uint32_t args[] = {(uint32_t) location, floatBits(v0), floatBits(v1)};
+  captureWrite(CAPTURE_CALL_glUniform2f, args, 3, NULL, 0);
+  real_glUniform2f(location, v0, v1);
+}
+
+static void APIENTRY captureUniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+  uint32_t args[] = {(uint32_t) location, count};
+  captureWrite(CAPTURE_CALL_glUniform4fv, args, 2, value, count * 4 * sizeof(GLfloat));
+  real_glUniform4fv(location, count, value);
+}
+
+static void APIENTRY captureUniform1ui(GLint location, GLuint v0) {
+  uint32_t args[] = {(uint32_t) location, v0};
+  captureWrite(CAPTURE_CALL_glUniform1ui, args, 2, NULL, 0);
+  real_glUniform1ui(location, v0);
+}
+
+static void APIENTRY captureUniform2ui(GLint location, GLuint v0, GLuint v1) {
+  uint32_t args[] = {(uint32_t) location, v0, v1};
+  captureWrite(CAPTURE_CALL_glUniform2ui, args, 3, NULL, 0);
+  real_glUniform2ui(location, v0, v1);
+}
+
+static void APIENTRY captureUniform3ui(GLint location, GLuint v0, GLuint v1, GLuint v2) {
+  uint32_t args[] = {(uint32_t) location, v0, v1, v2};
+  captureWrite(CAPTURE_CALL_glUniform3ui, args, 4, NULL, 0);
+  real_glUniform3ui(location, v0, v1, v2);
+}
+
+static void APIENTRY captureColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+  uint32_t args[] = {red, green, blue, alpha};
+  captureWrite(CAPTURE_CALL_glColorMask, args, 4, NULL, 0);
+  real_glColorMask(red, green, blue, alpha);
+}
+
+static void APIENTRY captureDepthFunc(GLenum func) {
+  uint32_t args[] = {func};
+  captureWrite(CAPTURE_CALL_glDepthFunc, args, 1, NULL, 0);
+  real_glDepthFunc(func);
+}
+
+static void APIENTRY captureDepthMask(GLboolean flag) {
+  uint32_t args[] = {flag};
+  captureWrite(CAPTURE_CALL_glDepthMask, args, 1, NULL, 0);
+  real_glDepthMask(flag);
+}
+
+static void APIENTRY captureBlendFunc(GLenum sfactor, GLenum dfactor) {
+  uint32_t args[] = {sfactor, dfactor};
+  captureWrite(CAPTURE_CALL_glBlendFunc, args, 2, NULL, 0);
+  real_glBlendFunc(sfactor, dfactor);
+}
+
+// the returned sync is recorded like a generated name so replay can map it to its own
+static GLsync APIENTRY captureFenceSync(GLenum condition, GLbitfield flags) {
+  GLsync sync = real_glFenceSync(condition, flags);
+  uint32_t args[4] = {condition, flags};
+  syncWords(sync, args + 2);
+  captureWrite(CAPTURE_CALL_glFenceSync, args, 4, NULL, 0);
+  return sync;
+}
+
+static GLenum APIENTRY captureClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+  uint32_t args[5] = {0, 0, flags, (uint32_t) timeout, (uint32_t) (timeout >> 32)};
+  syncWords(sync, args);
+  captureWrite(CAPTURE_CALL_glClientWaitSync, args, 5, NULL, 0);
+  return real_glClientWaitSync(sync, flags, timeout);
+}
+
+static void APIENTRY captureDeleteSync(GLsync sync) {
+  uint32_t args[2];
+  syncWords(sync, args);
+  captureWrite(CAPTURE_CALL_glDeleteSync, args, 2, NULL, 0);
+  real_glDeleteSync(sync);
+}
+
+static void APIENTRY captureGenFramebuffers(GLsizei n, GLuint* framebuffers) {
+  real_glGenFramebuffers(n, framebuffers);
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glGenFramebuffers, args, 1, framebuffers, n * sizeof(GLuint));
+}
+
+static void APIENTRY captureBindFramebuffer(GLenum target, GLuint framebuffer) {
+  uint32_t args[] = {target, framebuffer};
+  captureWrite(CAPTURE_CALL_glBindFramebuffer, args, 2, NULL, 0);
+  real_glBindFramebuffer(target, framebuffer);
+}
+
+static void APIENTRY captureDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glDeleteFramebuffers, args, 1, framebuffers, n * sizeof(GLuint));
+  real_glDeleteFramebuffers(n, framebuffers);
+}
+
+static void APIENTRY captureGenRenderbuffers(GLsizei n, GLuint* renderbuffers) {
+  real_glGenRenderbuffers(n, renderbuffers);
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glGenRenderbuffers, args, 1, renderbuffers, n * sizeof(GLuint));
+}
+
+static void APIENTRY captureBindRenderbuffer(GLenum target, GLuint renderbuffer) {
+  uint32_t args[] = {target, renderbuffer};
+  captureWrite(CAPTURE_CALL_glBindRenderbuffer, args, 2, NULL, 0);
+  real_glBindRenderbuffer(target, renderbuffer);
+}
+
+static void APIENTRY captureRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {
+  uint32_t args[] = {target, internalformat, width, height};
+  captureWrite(CAPTURE_CALL_glRenderbufferStorage, args, 4, NULL, 0);
+  real_glRenderbufferStorage(target, internalformat, width, height);
+}
+
+static void APIENTRY captureFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {
+  uint32_t args[] = {target, attachment, renderbuffertarget, renderbuffer};
+  captureWrite(CAPTURE_CALL_glFramebufferRenderbuffer, args, 4, NULL, 0);
+  real_glFramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+}
+
+static void APIENTRY captureDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {
+  uint32_t args[] = {n};
+  captureWrite(CAPTURE_CALL_glDeleteRenderbuffers, args, 1, renderbuffers, n * sizeof(GLuint));
+  real_glDeleteRenderbuffers(n, renderbuffers);
+}
+
+// indirect commands are read from the bound GL_DRAW_INDIRECT_BUFFER, so the pointer is an offset
+static void APIENTRY captureMultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride) {
+  uint32_t args[] = {mode, type, (uint32_t) (uintptr_t) indirect, drawcount, stride};
+  captureWrite(CAPTURE_CALL_glMultiDrawElementsIndirect, args, 5, NULL, 0);
+  real_glMultiDrawElementsIndirect(mode, type, indirect, drawcount, stride);
+}
+
+static void APIENTRY captureMultiDrawArraysIndirect(GLenum mode, const void* indirect, GLsizei drawcount, GLsizei stride) {
+  uint32_t args[] = {mode, (uint32_t) (uintptr_t) indirect, drawcount, stride};
+  captureWrite(CAPTURE_CALL_glMultiDrawArraysIndirect, args, 4, NULL, 0);
+  real_glMultiDrawArraysIndirect(mode, indirect, drawcount, stride);
+}
+
+static void APIENTRY captureMultiDrawElementsIndirectCount(GLenum mode, GLenum type, const void* indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride) {
+  uint32_t args[] = {mode, type, (uint32_t) (uintptr_t) indirect, (uint32_t) drawcount, maxdrawcount, stride};
+  captureWrite(CAPTURE_CALL_glMultiDrawElementsIndirectCountARB, args, 6, NULL, 0);
+  real_glMultiDrawElementsIndirectCountARB(mode, type, indirect, drawcount, maxdrawcount, stride);
+}
+
+static void APIENTRY captureTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height) {
+  uint32_t args[] = {target, levels, internalformat, width, height};
+  captureWrite(CAPTURE_CALL_glTexStorage2D, args, 5, NULL, 0);
+  real_glTexStorage2D(target, levels, internalformat, width, height);
+}
+
+static void APIENTRY captureDispatchCompute(GLuint groupsX, GLuint groupsY, GLuint groupsZ) {
+  uint32_t args[] = {groupsX, groupsY, groupsZ};
+  captureWrite(CAPTURE_CALL_glDispatchCompute, args, 3, NULL, 0);
+  real_glDispatchCompute(groupsX, groupsY, groupsZ);
+}
+
+static void APIENTRY captureMemoryBarrier(GLbitfield barriers) {
+  uint32_t args[] = {barriers};
+  captureWrite(CAPTURE_CALL_glMemoryBarrier, args, 1, NULL, 0);
+  real_glMemoryBarrier(barriers);
+}
+
+// the clear value is one element of format and type, NULL clears to zero
+static void APIENTRY captureClearBufferData(GLenum target, GLenum internalformat, GLenum format, GLenum type, const void* data) {
+  uint32_t args[] = {target, internalformat, format, type};
+  captureWrite(CAPTURE_CALL_glClearBufferData, args, 4, data, data ? elementSize(format, type) : 0);
+  real_glClearBufferData(target, internalformat, format, type, data);
+}
+
+// swaps glad's and glext's function pointers for the recording wrappers, call after gladLoadGLLoader and glextLoad
+int captureBegin(const char* path) {
+  if(captureFile) {
+    return -1;
+  }
+
+  captureFile = fopen(path, "wb");
+  if(!captureFile) {
+    printf("ERROR::CAPTURE::FAILED_TO_OPEN_OUTPUT: %s\n", path);
+    return -1;
+  }
+  setvbuf(captureFile, NULL, _IOFBF, 1 << 20);
+
+  CaptureHeader header = {CAPTURE_MAGIC, CAPTURE_VERSION};
+  fwrite(&header, sizeof(header), 1, captureFile);
+
+  real_glGenVertexArrays = glad_glGenVertexArrays; glad_glGenVertexArrays = captureGenVertexArrays;
+  real_glBindVertexArray = glad_glBindVertexArray; glad_glBindVertexArray = captureBindVertexArray;
+  real_glDeleteVertexArrays = glad_glDeleteVertexArrays; glad_glDeleteVertexArrays = captureDeleteVertexArrays;
+  real_glGenBuffers = glad_glGenBuffers; glad_glGenBuffers = captureGenBuffers;
+  real_glBindBuffer = glad_glBindBuffer; glad_glBindBuffer = captureBindBuffer;
+  real_glBufferData = glad_glBufferData; glad_glBufferData = captureBufferData;
+  real_glBufferSubData = glad_glBufferSubData; glad_glBufferSubData = captureBufferSubData;
+  real_glDeleteBuffers = glad_glDeleteBuffers; glad_glDeleteBuffers = captureDeleteBuffers;
+  real_glVertexAttribPointer = glad_glVertexAttribPointer; glad_glVertexAttribPointer = captureVertexAttribPointer;
+  real_glEnableVertexAttribArray = glad_glEnableVertexAttribArray; glad_glEnableVertexAttribArray = captureEnableVertexAttribArray;
+  real_glCreateShader = glad_glCreateShader; glad_glCreateShader = captureCreateShader;
+  real_glShaderSource = glad_glShaderSource; glad_glShaderSource = captureShaderSource;
+  real_glCompileShader = glad_glCompileShader; glad_glCompileShader = captureCompileShader;
+  real_glDeleteShader = glad_glDeleteShader; glad_glDeleteShader = captureDeleteShader;
+  real_glCreateProgram = glad_glCreateProgram; glad_glCreateProgram = captureCreateProgram;
+  real_glAttachShader = glad_glAttachShader; glad_glAttachShader = captureAttachShader;
+  real_glLinkProgram = glad_glLinkProgram; glad_glLinkProgram = captureLinkProgram;
+  real_glUseProgram = glad_glUseProgram; glad_glUseProgram = captureUseProgram;
+  real_glDeleteProgram = glad_glDeleteProgram; glad_glDeleteProgram = captureDeleteProgram;
+  real_glGetUniformLocation = glad_glGetUniformLocation; glad_glGetUniformLocation = captureGetUniformLocation;
+  real_glUniform1i = glad_glUniform1i; glad_glUniform1i = captureUniform1i;
+  real_glUniform1f = glad_glUniform1f; glad_glUniform1f = captureUniform1f;
+  real_glUniformMatrix4fv = glad_glUniformMatrix4fv; glad_glUniformMatrix4fv = captureUniformMatrix4fv;
+  real_glGenTextures = glad_glGenTextures; glad_glGenTextures = captureGenTextures;
+  real_glActiveTexture = glad_glActiveTexture; glad_glActiveTexture = captureActiveTexture;
+  real_glBindTexture = glad_glBindTexture; glad_glBindTexture = captureBindTexture;
+  real_glTexParameteri = glad_glTexParameteri; glad_glTexParameteri = captureTexParameteri;
+  real_glTexImage2D = glad_glTexImage2D; glad_glTexImage2D = captureTexImage2D;
+  real_glGenerateMipmap = glad_glGenerateMipmap; glad_glGenerateMipmap = captureGenerateMipmap;
+  real_glDeleteTextures = glad_glDeleteTextures; glad_glDeleteTextures = captureDeleteTextures;
+  real_glEnable = glad_glEnable; glad_glEnable = captureEnable;
+  real_glDisable = glad_glDisable; glad_glDisable = captureDisable;
+  real_glClearColor = glad_glClearColor; glad_glClearColor = captureClearColor;
+  real_glClear = glad_glClear; glad_glClear = captureClear;
+  real_glViewport = glad_glViewport; glad_glViewport = captureViewport;
+  real_glDrawArrays = glad_glDrawArrays; glad_glDrawArrays = captureDrawArrays;
+  real_glDrawElements = glad_glDrawElements; glad_glDrawElements = captureDrawElements;
+  real_glPixelStorei = glad_glPixelStorei; glad_glPixelStorei = capturePixelStorei;
+  real_glTexParameteriv = glad_glTexParameteriv; glad_glTexParameteriv = captureTexParameteriv;
+  real_glTexSubImage2D = glad_glTexSubImage2D; glad_glTexSubImage2D = captureTexSubImage2D;
+  real_glVertexAttribIPointer = glad_glVertexAttribIPointer; glad_glVertexAttribIPointer = captureVertexAttribIPointer;
+  real_glVertexAttribDivisor = glad_glVertexAttribDivisor; glad_glVertexAttribDivisor = captureVertexAttribDivisor;
+  real_glDrawArraysInstanced = glad_glDrawArraysInstanced; glad_glDrawArraysInstanced = captureDrawArraysInstanced;
+  real_glDrawElementsBaseVertex = glad_glDrawElementsBaseVertex; glad_glDrawElementsBaseVertex = captureDrawElementsBaseVertex;
+  real_glDrawElementsInstancedBaseVertex = glad_glDrawElementsInstancedBaseVertex; glad_glDrawElementsInstancedBaseVertex = captureDrawElementsInstancedBaseVertex;
+  real_glBindBufferBase = glad_glBindBufferBase; glad_glBindBufferBase = captureBindBufferBase;
+  real_glCopyBufferSubData = glad_glCopyBufferSubData; glad_glCopyBufferSubData = captureCopyBufferSubData;
+  real_glMapBufferRange = glad_glMapBufferRange; glad_glMapBufferRange = captureMapBufferRange;
+  real_glUnmapBuffer = glad_glUnmapBuffer; glad_glUnmapBuffer = captureUnmapBuffer;
+  real_glUniform2f = glad_glUniform2f; glad_glUniform2f = captureUniform2f;
+  real_glUniform4fv = glad_glUniform4fv; glad_glUniform4fv = captureUniform4fv;
+  real_glUniform1ui = glad_glUniform1ui; glad_glUniform1ui = captureUniform1ui;
+  real_glUniform2ui = glad_glUniform2ui; glad_glUniform2ui = captureUniform2ui;
+  real_glUniform3ui = glad_glUniform3ui; glad_glUniform3ui = captureUniform3ui;
+  real_glColorMask = glad_glColorMask; glad_glColorMask = captureColorMask;
+  real_glDepthFunc = glad_glDepthFunc; glad_glDepthFunc = captureDepthFunc;
+  real_glDepthMask = glad_glDepthMask; glad_glDepthMask = captureDepthMask;
+  real_glBlendFunc = glad_glBlendFunc; glad_glBlendFunc = captureBlendFunc;
+  real_glFenceSync = glad_glFenceSync; glad_glFenceSync = captureFenceSync;
+  real_glClientWaitSync = glad_glClientWaitSync; glad_glClientWaitSync = captureClientWaitSync;
+  real_glDeleteSync = glad_glDeleteSync; glad_glDeleteSync = captureDeleteSync;
+  real_glGenFramebuffers = glad_glGenFramebuffers; glad_glGenFramebuffers = captureGenFramebuffers;
+  real_glBindFramebuffer = glad_glBindFramebuffer; glad_glBindFramebuffer = captureBindFramebuffer;
+  real_glDeleteFramebuffers = glad_glDeleteFramebuffers; glad_glDeleteFramebuffers = captureDeleteFramebuffers;
+  real_glGenRenderbuffers = glad_glGenRenderbuffers; glad_glGenRenderbuffers = captureGenRenderbuffers;
+  real_glBindRenderbuffer = glad_glBindRenderbuffer; glad_glBindRenderbuffer = captureBindRenderbuffer;
+  real_glRenderbufferStorage = glad_glRenderbufferStorage; glad_glRenderbufferStorage = captureRenderbufferStorage;
+  real_glFramebufferRenderbuffer = glad_glFramebufferRenderbuffer; glad_glFramebufferRenderbuffer = captureFramebufferRenderbuffer;
+  real_glDeleteRenderbuffers = glad_glDeleteRenderbuffers; glad_glDeleteRenderbuffers = captureDeleteRenderbuffers;
+
+#define CAPTURE_WRAP_EXT(name, wrapper) real_##name = glext_##name; if(real_##name) glext_##name = wrapper;
+  CAPTURE_WRAP_EXT(glMultiDrawElementsIndirect, captureMultiDrawElementsIndirect)
+  CAPTURE_WRAP_EXT(glMultiDrawArraysIndirect, captureMultiDrawArraysIndirect)
+  CAPTURE_WRAP_EXT(glMultiDrawElementsIndirectCountARB, captureMultiDrawElementsIndirectCount)
+  CAPTURE_WRAP_EXT(glTexStorage2D, captureTexStorage2D)
+  CAPTURE_WRAP_EXT(glDispatchCompute, captureDispatchCompute)
+  CAPTURE_WRAP_EXT(glMemoryBarrier, captureMemoryBarrier)
+  CAPTURE_WRAP_EXT(glClearBufferData, captureClearBufferData)
+#undef CAPTURE_WRAP_EXT
+
+  return 0;
+}
+
+void captureFrame() {
+  if(captureFile) {
+    captureWrite(CAPTURE_CALL_FRAME, NULL, 0, NULL, 0);
+  }
+}
+
+// restores the driver entry points and closes the trace
+void captureEnd() {
+  if(!captureFile) {
+    return;
+  }
+
+#define CAPTURE_RESTORE(name) glad_##name = real_##name;
+  CAPTURE_CALLS(CAPTURE_RESTORE)
+#undef CAPTURE_RESTORE
+#define CAPTURE_RESTORE_EXT(name) glext_##name = real_##name;
+  CAPTURE_EXT_CALLS(CAPTURE_RESTORE_EXT)
+#undef CAPTURE_RESTORE_EXT
+  memset(mappings, 0, sizeof(mappings));
+
+  fclose(captureFile);
+  captureFile = NULL;
+}
@@ -0,0 +1,124 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+
+#define CAPTURE_MAGIC 0x52544C47 // "GLTR"
+#define CAPTURE_VERSION 2
+#define CAPTURE_MAX_SHADER_STRINGS 14 // strings per glShaderSource call that fit in one record
+#define CAPTURE_MAX_MAPPINGS 8 // buffers mapped at the same time
+
+// every GL entry point the capture layer records, in trace id order
+#define CAPTURE_CALLS(X) \
+  X(glGenVertexArrays) \
+  X(glBindVertexArray) \
+  X(glDeleteVertexArrays) \
+  X(glGenBuffers) \
+  X(glBindBuffer) \
+  X(glBufferData) \
+  X(glBufferSubData) \
+  X(glDeleteBuffers) \
+  X(glVertexAttribPointer) \
+  X(glEnableVertexAttribArray) \
+  X(glCreateShader) \
+  X(glShaderSource) \
+  X(glCompileShader) \
+  X(glDeleteShader) \
+  X(glCreateProgram) \
+  X(glAttachShader) \
+  X(glLinkProgram) \
+  X(glUseProgram) \
+  X(glDeleteProgram) \
+  X(glGetUniformLocation) \
+  X(glUniform1i) \
+  X(glUniform1f) \
+  X(glUniformMatrix4fv) \
+  X(glGenTextures) \
+  X(glActiveTexture) \
+  X(glBindTexture) \
+  X(glTexParameteri) \
+  X(glTexImage2D) \
+  X(glGenerateMipmap) \
+  X(glDeleteTextures) \
+  X(glEnable) \
+  X(glDisable) \
+  X(glClearColor) \
+  X(glClear) \
+  X(glViewport) \
+  X(glDrawArrays) \
+  X(glDrawElements) \
+  X(glPixelStorei) \
+  X(glTexParameteriv) \
+  X(glTexSubImage2D) \
+  X(glVertexAttribIPointer) \
+  X(glVertexAttribDivisor) \
+  X(glDrawArraysInstanced) \
+  X(glDrawElementsBaseVertex) \
+  X(glDrawElementsInstancedBaseVertex) \
+  X(glBindBufferBase) \
+  X(glCopyBufferSubData) \
+  X(glMapBufferRange) \
+  X(glUnmapBuffer) \
+  X(glUniform2f) \
+  X(glUniform4fv) \
+  X(glUniform1ui) \
+  X(glUniform2ui) \
+  X(glUniform3ui) \
+  X(glColorMask) \
+  X(glDepthFunc) \
+  X(glDepthMask) \
+  X(glBlendFunc) \
+  X(glFenceSync) \
+  X(glClientWaitSync) \
+  X(glDeleteSync) \
+  X(glGenFramebuffers) \
+  X(glBindFramebuffer) \
+  X(glDeleteFramebuffers) \
+  X(glGenRenderbuffers) \
+  X(glBindRenderbuffer) \
+  X(glRenderbufferStorage) \
+  X(glFramebufferRenderbuffer) \
+  X(glDeleteRenderbuffers)
+
+// entry points newer than GL 3.3, wrapped through their glext_ pointers when the driver has them
+#define CAPTURE_EXT_CALLS(X) \
+  X(glMultiDrawElementsIndirect) \
+  X(glMultiDrawArraysIndirect) \
+  X(glMultiDrawElementsIndirectCountARB) \
+  X(glTexStorage2D) \
+  X(glDispatchCompute) \
+  X(glMemoryBarrier) \
+  X(glClearBufferData)
+
+typedef enum CaptureCall {
+#define CAPTURE_ENUM(name) CAPTURE_CALL_##name,
+  CAPTURE_CALLS(CAPTURE_ENUM)
+  CAPTURE_EXT_CALLS(CAPTURE_ENUM)
+#undef CAPTURE_ENUM
+  CAPTURE_CALL_FRAME, // end of frame marker, not a GL call
+  CAPTURE_CALL_COUNT
+} CaptureCall;
+
+typedef struct CaptureHeader {
+  uint32_t magic;
+  uint32_t version;
+} CaptureHeader;
+
+// each record is followed by argCount 32-bit arguments and blobSize bytes of
+// referenced data (buffer contents, pixels, shader source, generated names,
+// what was written into a mapping by the time it is unmapped)
+typedef struct CaptureRecord {
+  uint16_t call;
+  uint16_t argCount;
+  uint32_t blobSize;
+} CaptureRecord;
+
+int captureBegin(const char* path);
+
+void captureFrame();
+
+void captureEnd();
+
+const char* captureCallName(unsigned int call);
+
+#endif
@@ -51,13 +51,13 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/VS", "../src/FS");
+  shaderInit(&s, "../src/coordinate_systems/many_cubes/VS", "../src/coordinate_systems/many_cubes/FS");
 
   Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 0, 1);
+  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 0);
   
   float vertices[] = {
     -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
@@ -128,12 +128,12 @@ int main() {
   glEnable(GL_DEPTH_TEST);
 
   unsigned int modelLoc, viewLoc, projectionLoc;
-  mat4 view = GLM_MAT4_IDENTITY;
+  mat4 view = GLM_MAT4_IDENTITY_INIT;
   glm_translate_make(view, (vec3) {0.0f, 0.0f, -3.0f});
   viewLoc = glGetUniformLocation(s.ID, "view");
   glUniformMatrix4fv(viewLoc, 1, GL_FALSE, (const float*) view);
 
-  mat4 projection = GLM_MAT4_IDENTITY;
+  mat4 projection = GLM_MAT4_IDENTITY_INIT;
   glm_perspective(glm_rad(45.0f), (float) WINDOW_WIDTH / (float) WINDOW_HEIGHT, 0.1f, 100.0f, projection); 
   projectionLoc = glGetUniformLocation(s.ID, "projection");
   glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, (const float*) projection);
@@ -159,7 +159,7 @@ int main() {
 
     for(unsigned int i = 0; i < 10; i++)
     {
-      mat4 model = GLM_MAT4_IDENTITY;
+      mat4 model = GLM_MAT4_IDENTITY_INIT;
       glm_translate_make(model, cubePositions[i]);
       glm_rotate(model, glm_rad(20.0f * (float) i), (vec3) {1.0f, 0.3f, 0.5f});
       modelLoc = glGetUniformLocation(s.ID, "model");
@@ -51,13 +51,13 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/VS", "../src/FS");
+  shaderInit(&s, "../src/coordinate_systems/rotated_plane/VS", "../src/coordinate_systems/rotated_plane/FS");
 
   Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1, 1);
+  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1);
   
   float vertices[] = {
     0.5f, 0.5f, 0.0f, 1.0f, 1.0f, // top right
@@ -97,9 +97,9 @@ int main() {
   shaderSetInt(&s, "texture1", 0);
   shaderSetInt(&s, "texture2", 1);
 
-  mat4 model= GLM_MAT4_IDENTITY;
+  mat4 model= GLM_MAT4_IDENTITY_INIT;
   glm_rotate(model, glm_rad(-55.0f), (vec3) {1.0f, 0.0f, 0.0f});
-  mat4 view = GLM_MAT4_IDENTITY;
+  mat4 view = GLM_MAT4_IDENTITY_INIT;
   glm_translate(view, (vec3) {0.0f, 0.0f, -3.0f});
   mat4 projection;
   glm_perspective(glm_rad(45.0f), (float) WINDOW_WIDTH / (float) WINDOW_HEIGHT, 0.1f, 100.0f, projection); 
@@ -0,0 +1,115 @@
+#include "cube.h"
+
+const float cubeVertices[CUBE_VERTEX_COUNT * CUBE_VERTEX_STRIDE] = {
+  -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+   0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+  -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+   0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+   0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+  -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+  -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+  -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+  -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+   0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+   0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+   0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+   0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+   0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+  -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+  -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+   0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+   0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+  -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+  -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
+};
+
+vec3 cubePositions[CUBE_POSITION_COUNT] = {
+  {0.0f,  0.0f,  0.0f},
+  {2.0f,  5.0f, -15.0f},
+  {-1.5f, -2.2f, -2.5f},
+  {-3.8f, -2.0f, -12.3f},
+  { 2.4f, -0.4f, -3.5f},
+  {-1.7f,  3.0f, -7.5f},
+  { 1.3f, -2.0f, -2.5f},
+  { 1.5f,  2.0f, -2.5f},
+  { 1.5f,  0.2f, -1.5f},
+  {-1.3f,  1.0f, -1.5f}
+};
+
+// face normal and the two axes its grid runs along, u cross v points outwards
+static const float cubeFaces[6][3][3] = {
+  {{ 1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}},
+  {{-1.0f, 0.0f, 0.0f}, {0.0f, 0.0f,  1.0f}, {0.0f, 1.0f, 0.0f}},
+  {{0.0f,  1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, -1.0f}},
+  {{0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f,  1.0f}},
+  {{0.0f, 0.0f,  1.0f}, { 1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+  {{0.0f, 0.0f, -1.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}
+};
+
+void cubeBuildRounded(unsigned int subdivisions, float radius, float* vertices, unsigned int* indices) {
+  unsigned int side = subdivisions + 1;
+  float inner = 0.5f - radius;
+
+  for(unsigned int f = 0; f < 6; f++) {
+    const float* n = cubeFaces[f][0];
+    const float* u = cubeFaces[f][1];
+    const float* v = cubeFaces[f][2];
+
+    for(unsigned int j = 0; j < side; j++) {
+      for(unsigned int i = 0; i < side; i++) {
+        float s = (float) i / subdivisions;
+        float t = (float) j / subdivisions;
+
+        // push the point on the cube out from the nearest point of the shrunken inner box
+        vec3 onCube, core, offset;
+        for(int k = 0; k < 3; k++) {
+          onCube[k] = n[k] * 0.5f + (s - 0.5f) * u[k] + (t - 0.5f) * v[k];
+          core[k] = glm_clamp(onCube[k], -inner, inner);
+        }
+        glm_vec3_sub(onCube, core, offset);
+        glm_vec3_normalize(offset);
+
+        float* out = vertices + (size_t) ((f * side + j) * side + i) * CUBE_VERTEX_STRIDE;
+        out[0] = core[0] + offset[0] * radius;
+        out[1] = core[1] + offset[1] * radius;
+        out[2] = core[2] + offset[2] * radius;
+        out[3] = s;
+        out[4] = t;
+      }
+    }
+
+    for(unsigned int j = 0; j < subdivisions; j++) {
+      for(unsigned int i = 0; i < subdivisions; i++) {
+        unsigned int corner = (f * side + j) * side + i;
+        unsigned int* quad = indices + (size_t) ((f * subdivisions + j) * subdivisions + i) * 6;
+        quad[0] = corner;
+        quad[1] = corner + 1;
+        quad[2] = corner + side + 1;
+        quad[3] = corner;
+        quad[4] = corner + side + 1;
+        quad[5] = corner + side;
+      }
+    }
+  }
+}
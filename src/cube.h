@@ -0,0 +1,23 @@
+#ifndef CUBE_H
+#define CUBE_H
+
+#include <cglm/cglm.h>
+
+#define CUBE_VERTEX_COUNT 36
+#define CUBE_VERTEX_STRIDE 5 // position (3 floats) followed by texture coordinates (2 floats)
+#define CUBE_POSITION_COUNT 10
+
+#define CUBE_ROUNDED_VERTEX_COUNT(subdivisions) (6 * ((subdivisions) + 1) * ((subdivisions) + 1))
+#define CUBE_ROUNDED_INDEX_COUNT(subdivisions) (6 * (subdivisions) * (subdivisions) * 6)
+
+// unit cube centered on the origin, laid out as non-indexed triangles
+extern const float cubeVertices[CUBE_VERTEX_COUNT * CUBE_VERTEX_STRIDE];
+
+// world positions of the cubes in the coordinate systems and camera chapters
+extern vec3 cubePositions[CUBE_POSITION_COUNT];
+
+// unit cube with edges rounded off by radius, each face a grid of subdivisions^2 quads
+// textured 0 to 1 like cubeVertices, indexed triangles with CUBE_VERTEX_STRIDE floats per vertex
+void cubeBuildRounded(unsigned int subdivisions, float radius, float* vertices, unsigned int* indices);
+
+#endif
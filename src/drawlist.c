@@ -0,0 +1,184 @@
+#include "drawlist.h"
+#include <stdlib.h>
+#include "glext.h"
+
+// points the per-draw transform attribute at transform `first`, expects the pool VAO to be bound
+static void drawListPointTransforms(DrawList* d, unsigned int first) {
+  glBindBuffer(GL_ARRAY_BUFFER, d->transformBuffer);
+  for(unsigned int column = 0; column < 4; column++) {
+    size_t offset = first * sizeof(mat4) + column * sizeof(vec4);
+    glVertexAttribPointer(DRAW_LIST_TRANSFORM_LOCATION + column, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (void*) (uintptr_t) offset);
+  }
+}
+
+void drawListInit(DrawList* d, MeshPool* pool, unsigned int capacity, int indirect, int pull) {
+  d->commandCount = 0;
+  d->transformCount = 0;
+  d->capacity = capacity;
+  d->commands = malloc(capacity * sizeof(DrawElementsIndirectCommand));
+  d->transforms = malloc(capacity * sizeof(mat4));
+  d->pull = pull && glext.vertexPulling;
+  d->indirect = d->pull ? indirect && glext.shaderDrawParameters : indirect && glext.multiDrawIndirect;
+  d->commandBuffer = 0;
+  d->emptyVAO = 0;
+
+  glGenBuffers(1, &d->transformBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, d->transformBuffer);
+  glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(mat4), NULL, GL_STREAM_DRAW);
+
+  if(d->pull) {
+    // the shader looks up every command's baseVertex and baseInstance, so the commands are always uploaded
+    glGenVertexArrays(1, &d->emptyVAO);
+    glGenBuffers(1, &d->commandBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, d->commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, capacity * sizeof(DrawElementsIndirectCommand), NULL, GL_STREAM_DRAW);
+    return;
+  }
+
+  // instanced attributes are fetched at baseInstance + gl_InstanceID, which is how each draw finds its transform
+  glBindVertexArray(pool->VAO);
+  drawListPointTransforms(d, 0);
+  for(unsigned int column = 0; column < 4; column++) {
+    glEnableVertexAttribArray(DRAW_LIST_TRANSFORM_LOCATION + column);
+    glVertexAttribDivisor(DRAW_LIST_TRANSFORM_LOCATION + column, 1);
+  }
+  glBindVertexArray(0);
+
+  if(d->indirect) {
+    glGenBuffers(1, &d->commandBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, d->commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, capacity * sizeof(DrawElementsIndirectCommand), NULL, GL_STREAM_DRAW);
+  }
+}
+
+void drawListReset(DrawList* d) {
+  d->commandCount = 0;
+  d->transformCount = 0;
+}
+
+// consecutive draws of the same mesh collapse into one instanced command
+void drawListAdd(DrawList* d, Mesh* mesh, mat4 model) {
+  if(d->transformCount == d->capacity) {
+    d->capacity *= 2;
+    d->commands = realloc(d->commands, d->capacity * sizeof(DrawElementsIndirectCommand));
+    d->transforms = realloc(d->transforms, d->capacity * sizeof(mat4));
+  }
+
+  glm_mat4_mul(model, mesh->dequantize, d->transforms[d->transformCount]);
+
+  DrawElementsIndirectCommand* last = d->commandCount ? &d->commands[d->commandCount - 1] : NULL;
+  if(last && last->firstIndex == mesh->firstIndex && last->baseVertex == (int) mesh->baseVertex) {
+    last->instanceCount++;
+  }
+  else {
+    DrawElementsIndirectCommand* c = &d->commands[d->commandCount++];
+    c->count = mesh->indexCount;
+    c->instanceCount = 1;
+    c->firstIndex = mesh->firstIndex;
+    c->baseVertex = (int) mesh->baseVertex;
+    c->baseInstance = d->transformCount;
+  }
+  d->transformCount++;
+}
+
+// orphans the buffers every frame so the driver never waits on last frame's draws
+void drawListUpload(DrawList* d) {
+  glBindBuffer(GL_ARRAY_BUFFER, d->transformBuffer);
+  glBufferData(GL_ARRAY_BUFFER, d->capacity * sizeof(mat4), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, d->transformCount * sizeof(mat4), d->transforms);
+
+  if(d->commandBuffer) {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, d->commandBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, d->capacity * sizeof(DrawElementsIndirectCommand), NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, d->commandCount * sizeof(DrawElementsIndirectCommand), d->commands);
+  }
+}
+
+// words from the start of the vertex, as src/VS_pull indexes the pool VBO
+static unsigned int drawListAttribWord(VertexFormat* f, VertexSemantic semantic, VertexType* type) {
+  for(unsigned int i = 0; i < f->attribCount; i++) {
+    if(f->attribs[i].semantic == semantic) {
+      *type = f->attribs[i].type;
+      return f->attribs[i].offset / 4;
+    }
+  }
+  *type = VERTEX_FLOAT32;
+  return 0;
+}
+
+static void drawListPull(DrawList* d, MeshPool* pool) {
+  glBindVertexArray(d->emptyVAO);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_LIST_VERTEX_BINDING, pool->VBO);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_LIST_INDEX_BINDING, pool->EBO);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_LIST_TRANSFORM_BINDING, d->transformBuffer);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_LIST_COMMAND_BINDING, d->commandBuffer);
+
+  VertexType positionType, texCoordType;
+  unsigned int position = drawListAttribWord(&pool->format, VERTEX_POSITION, &positionType);
+  unsigned int texCoord = drawListAttribWord(&pool->format, VERTEX_TEXCOORD, &texCoordType);
+  glUniform3ui(DRAW_LIST_VERTEX_LAYOUT_LOCATION, pool->format.stride / 4, position, texCoord);
+  glUniform2ui(DRAW_LIST_VERTEX_TYPES_LOCATION, positionType, texCoordType);
+
+  if(d->indirect) {
+    // the element commands read as array commands at the same stride: count, instanceCount and
+    // first line up with firstIndex, baseVertex lands in baseInstance where no attribute reads it
+    glUniform1ui(DRAW_LIST_DRAW_OFFSET_LOCATION, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, d->commandBuffer);
+    glMultiDrawArraysIndirect(GL_TRIANGLES, NULL, d->commandCount, sizeof(DrawElementsIndirectCommand));
+  }
+  else {
+    for(unsigned int i = 0; i < d->commandCount; i++) {
+      DrawElementsIndirectCommand* c = &d->commands[i];
+      glUniform1ui(DRAW_LIST_DRAW_OFFSET_LOCATION, i);
+      glDrawArraysInstanced(GL_TRIANGLES, c->firstIndex, c->count, c->instanceCount);
+    }
+  }
+
+  glBindVertexArray(0);
+}
+
+// draws what was last uploaded, can be called once per pass
+void drawListDraw(DrawList* d, MeshPool* pool) {
+  if(d->commandCount == 0) {
+    return;
+  }
+
+  if(d->pull) {
+    drawListPull(d, pool);
+    return;
+  }
+
+  glBindVertexArray(pool->VAO);
+
+  if(d->indirect) {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, d->commandBuffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, NULL, d->commandCount, 0);
+  }
+  else {
+    // 3.3 has no baseInstance, so the transform attribute is re-pointed for every command instead
+    for(unsigned int i = 0; i < d->commandCount; i++) {
+      DrawElementsIndirectCommand* c = &d->commands[i];
+      drawListPointTransforms(d, c->baseInstance);
+      glDrawElementsInstancedBaseVertex(GL_TRIANGLES, c->count, GL_UNSIGNED_INT, (void*) (uintptr_t) (c->firstIndex * sizeof(unsigned int)), c->instanceCount, c->baseVertex);
+    }
+  }
+
+  glBindVertexArray(0);
+}
+
+void drawListSubmit(DrawList* d, MeshPool* pool) {
+  drawListUpload(d);
+  drawListDraw(d, pool);
+}
+
+void drawListFree(DrawList* d) {
+  free(d->commands);
+  free(d->transforms);
+  glDeleteBuffers(1, &d->transformBuffer);
+  if(d->commandBuffer) {
+    glDeleteBuffers(1, &d->commandBuffer);
+  }
+  if(d->emptyVAO) {
+    glDeleteVertexArrays(1, &d->emptyVAO);
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <cglm/cglm.h>
+#include "meshpool.h"
+
+#define DRAW_LIST_TRANSFORM_LOCATION 2 // per-draw mat4 attribute, takes locations 2 to 5
+
+// storage buffer bindings and uniform locations of src/VS_pull
+#define DRAW_LIST_VERTEX_BINDING 0
+#define DRAW_LIST_INDEX_BINDING 1
+#define DRAW_LIST_TRANSFORM_BINDING 2
+#define DRAW_LIST_COMMAND_BINDING 3
+#define DRAW_LIST_DRAW_OFFSET_LOCATION 0
+#define DRAW_LIST_VERTEX_LAYOUT_LOCATION 1
+#define DRAW_LIST_VERTEX_TYPES_LOCATION 2
+
+// record layout fixed by glMultiDrawElementsIndirect
+typedef struct DrawElementsIndirectCommand {
+  unsigned int count;
+  unsigned int instanceCount;
+  unsigned int firstIndex;
+  int baseVertex;
+  unsigned int baseInstance; // first transform of the draw, acts as the draw id
+} DrawElementsIndirectCommand;
+
+// one frame's draws against a mesh pool, submitted together
+typedef struct DrawList {
+  DrawElementsIndirectCommand* commands;
+  mat4* transforms;
+  unsigned int commandCount;
+  unsigned int transformCount;
+  unsigned int capacity; // transforms, there are never more commands than transforms
+  unsigned int commandBuffer;
+  unsigned int transformBuffer;
+  int indirect; // one glMultiDrawElementsIndirect call, otherwise a GL 3.3 loop over the same commands
+  int pull; // src/VS_pull fetches vertices, indices and transforms from storage buffers, GL 4.3
+  unsigned int emptyVAO; // bound for pulled draws, core profile still needs a VAO
+} DrawList;
+
+// pull needs glext.vertexPulling and the shaders loaded with src/VS_pull,
+// its single call also needs glext.shaderDrawParameters, otherwise it loops over the commands
+void drawListInit(DrawList* d, MeshPool* pool, unsigned int capacity, int indirect, int pull);
+
+void drawListReset(DrawList* d);
+
+void drawListAdd(DrawList* d, Mesh* mesh, mat4 model);
+
+void drawListUpload(DrawList* d);
+
+// pulled draws set uniforms, so the program has to be bound first
+void drawListDraw(DrawList* d, MeshPool* pool);
+
+// upload followed by draw
+void drawListSubmit(DrawList* d, MeshPool* pool);
+
+void drawListFree(DrawList* d);
+
+#endif
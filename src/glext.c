@@ -0,0 +1,50 @@
+#include "glext.h"
+#include <string.h>
+
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC glext_glMultiDrawElementsIndirect;
+PFNGLMULTIDRAWARRAYSINDIRECTPROC glext_glMultiDrawArraysIndirect;
+PFNGLTEXSTORAGE2DPROC glext_glTexStorage2D;
+PFNGLDISPATCHCOMPUTEPROC glext_glDispatchCompute;
+PFNGLMEMORYBARRIERPROC glext_glMemoryBarrier;
+PFNGLCLEARBUFFERDATAPROC glext_glClearBufferData;
+PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTARBPROC glext_glMultiDrawElementsIndirectCountARB;
+
+GLExtensions glext;
+
+static int glextVersion(int major, int minor) {
+  return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+}
+
+static int glextExtension(const char* name) {
+  GLint count = 0;
+  glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+  for(GLint i = 0; i < count; i++) {
+    const char* extension = (const char*) glGetStringi(GL_EXTENSIONS, i);
+    if(extension && !strcmp(extension, name)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void glextLoad(GLADloadproc load) {
+  // a context created for 3.3 core usually comes back as the newest core version the driver has
+  glext_glMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC) load("glMultiDrawElementsIndirect");
+  glext.multiDrawIndirect = glextVersion(4, 3) && glext_glMultiDrawElementsIndirect;
+
+  glext_glTexStorage2D = (PFNGLTEXSTORAGE2DPROC) load("glTexStorage2D");
+  glext.textureStorage = glextVersion(4, 2) && glext_glTexStorage2D;
+
+  glext_glMultiDrawArraysIndirect = (PFNGLMULTIDRAWARRAYSINDIRECTPROC) load("glMultiDrawArraysIndirect");
+  glext.vertexPulling = glextVersion(4, 3) && glext_glMultiDrawArraysIndirect;
+  // the extension rather than 4.6, it is what the #version 430 shaders check for
+  glext.shaderDrawParameters = glextExtension("GL_ARB_shader_draw_parameters");
+
+  glext_glDispatchCompute = (PFNGLDISPATCHCOMPUTEPROC) load("glDispatchCompute");
+  glext_glMemoryBarrier = (PFNGLMEMORYBARRIERPROC) load("glMemoryBarrier");
+  glext_glClearBufferData = (PFNGLCLEARBUFFERDATAPROC) load("glClearBufferData");
+  glext.computeShaders = glextVersion(4, 3) && glext_glDispatchCompute && glext_glMemoryBarrier && glext_glClearBufferData;
+
+  glext_glMultiDrawElementsIndirectCountARB = (PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTARBPROC) load("glMultiDrawElementsIndirectCountARB");
+  glext.indirectCount = glext.multiDrawIndirect && glext_glMultiDrawElementsIndirectCountARB && glextExtension("GL_ARB_indirect_parameters");
+}
@@ -0,0 +1,60 @@
+#ifndef GLEXT_H
+#define GLEXT_H
+
+#include <glad/glad.h>
+
+// entry points and enums newer than the GL 3.3 core profile glad was generated for,
+// loaded at runtime so the same binary still starts on 3.3-only drivers
+
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#define GL_DRAW_INDIRECT_BUFFER_BINDING 0x8F43
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#define GL_SHADER_STORAGE_BUFFER_BINDING 0x90D3
+#define GL_COMPUTE_SHADER 0x91B9
+#define GL_COMMAND_BARRIER_BIT 0x00000040
+#define GL_BUFFER_UPDATE_BARRIER_BIT 0x00000200
+#define GL_PARAMETER_BUFFER_ARB 0x80EE
+
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+GLAPI PFNGLMULTIDRAWELEMENTSINDIRECTPROC glext_glMultiDrawElementsIndirect;
+#define glMultiDrawElementsIndirect glext_glMultiDrawElementsIndirect
+
+typedef void (APIENTRYP PFNGLMULTIDRAWARRAYSINDIRECTPROC)(GLenum mode, const void* indirect, GLsizei drawcount, GLsizei stride);
+GLAPI PFNGLMULTIDRAWARRAYSINDIRECTPROC glext_glMultiDrawArraysIndirect;
+#define glMultiDrawArraysIndirect glext_glMultiDrawArraysIndirect
+
+typedef void (APIENTRYP PFNGLDISPATCHCOMPUTEPROC)(GLuint groupsX, GLuint groupsY, GLuint groupsZ);
+GLAPI PFNGLDISPATCHCOMPUTEPROC glext_glDispatchCompute;
+#define glDispatchCompute glext_glDispatchCompute
+
+typedef void (APIENTRYP PFNGLMEMORYBARRIERPROC)(GLbitfield barriers);
+GLAPI PFNGLMEMORYBARRIERPROC glext_glMemoryBarrier;
+#define glMemoryBarrier glext_glMemoryBarrier
+
+typedef void (APIENTRYP PFNGLCLEARBUFFERDATAPROC)(GLenum target, GLenum internalformat, GLenum format, GLenum type, const void* data);
+GLAPI PFNGLCLEARBUFFERDATAPROC glext_glClearBufferData;
+#define glClearBufferData glext_glClearBufferData
+
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTARBPROC)(GLenum mode, GLenum type, const void* indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride);
+GLAPI PFNGLMULTIDRAWELEMENTSINDIRECTCOUNTARBPROC glext_glMultiDrawElementsIndirectCountARB;
+#define glMultiDrawElementsIndirectCountARB glext_glMultiDrawElementsIndirectCountARB
+
+typedef void (APIENTRYP PFNGLTEXSTORAGE2DPROC)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+GLAPI PFNGLTEXSTORAGE2DPROC glext_glTexStorage2D;
+#define glTexStorage2D glext_glTexStorage2D
+
+typedef struct GLExtensions {
+  int multiDrawIndirect; // GL 4.3, glMultiDrawElementsIndirect with baseInstance
+  int textureStorage; // GL 4.2, immutable glTexStorage2D allocation of every mip level at once
+  int vertexPulling; // GL 4.3, shader storage buffers and glMultiDrawArraysIndirect
+  int shaderDrawParameters; // ARB_shader_draw_parameters, gl_DrawIDARB in vertex shaders
+  int computeShaders; // GL 4.3, glDispatchCompute with glMemoryBarrier and glClearBufferData
+  int indirectCount; // ARB_indirect_parameters, the draw count of a multi-draw read from a buffer
+} GLExtensions;
+
+GLAPI GLExtensions glext;
+
+// call after gladLoadGLLoader with the same loader
+void glextLoad(GLADloadproc load);
+
+#endif
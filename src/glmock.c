@@ -0,0 +1,201 @@
+#include "glmock.h"
+#include <stdlib.h>
+#include <glad/glad.h>
+#include "glext.h"
+
+static unsigned long long callCount;
+static GLuint nextName; // one namespace for every object type is enough for a mock
+static void* mapping; // handed out by every glMapBufferRange, grown to the largest range
+static size_t mappingSize;
+
+static void mockGenNames(GLsizei n, GLuint* names) {
+  for(GLsizei i = 0; i < n; i++) {
+    names[i] = ++nextName;
+  }
+  callCount++;
+}
+
+static void APIENTRY mockGenVertexArrays(GLsizei n, GLuint* arrays) { mockGenNames(n, arrays); }
+static void APIENTRY mockBindVertexArray(GLuint array) { (void) array; callCount++; }
+static void APIENTRY mockDeleteVertexArrays(GLsizei n, const GLuint* arrays) { (void) n; (void) arrays; callCount++; }
+static void APIENTRY mockGenBuffers(GLsizei n, GLuint* buffers) { mockGenNames(n, buffers); }
+static void APIENTRY mockBindBuffer(GLenum target, GLuint buffer) { (void) target; (void) buffer; callCount++; }
+static void APIENTRY mockBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) { (void) target; (void) size; (void) data; (void) usage; callCount++; }
+static void APIENTRY mockBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) { (void) target; (void) offset; (void) size; (void) data; callCount++; }
+static void APIENTRY mockDeleteBuffers(GLsizei n, const GLuint* buffers) { (void) n; (void) buffers; callCount++; }
+static void APIENTRY mockVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) { (void) index; (void) size; (void) type; (void) normalized; (void) stride; (void) pointer; callCount++; }
+static void APIENTRY mockEnableVertexAttribArray(GLuint index) { (void) index; callCount++; }
+static GLuint APIENTRY mockCreateShader(GLenum type) { (void) type; callCount++; return ++nextName; }
+static void APIENTRY mockShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) { (void) shader; (void) count; (void) string; (void) length; callCount++; }
+static void APIENTRY mockCompileShader(GLuint shader) { (void) shader; callCount++; }
+static void APIENTRY mockDeleteShader(GLuint shader) { (void) shader; callCount++; }
+static GLuint APIENTRY mockCreateProgram() { callCount++; return ++nextName; }
+static void APIENTRY mockAttachShader(GLuint program, GLuint shader) { (void) program; (void) shader; callCount++; }
+static void APIENTRY mockLinkProgram(GLuint program) { (void) program; callCount++; }
+static void APIENTRY mockUseProgram(GLuint program) { (void) program; callCount++; }
+static void APIENTRY mockDeleteProgram(GLuint program) { (void) program; callCount++; }
+static GLint APIENTRY mockGetUniformLocation(GLuint program, const GLchar* name) { (void) program; (void) name; callCount++; return 0; }
+static void APIENTRY mockUniform1i(GLint location, GLint v0) { (void) location; (void) v0; callCount++; }
+static void APIENTRY mockUniform1f(GLint location, GLfloat v0) { (void) location; (void) v0; callCount++; }
+static void APIENTRY mockUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) { (void) location; (void) count; (void) transpose; (void) value; callCount++; }
+static void APIENTRY mockGenTextures(GLsizei n, GLuint* textures) { mockGenNames(n, textures); }
+static void APIENTRY mockActiveTexture(GLenum texture) { (void) texture; callCount++; }
+static void APIENTRY mockBindTexture(GLenum target, GLuint texture) { (void) target; (void) texture; callCount++; }
+static void APIENTRY mockTexParameteri(GLenum target, GLenum pname, GLint param) { (void) target; (void) pname; (void) param; callCount++; }
+static void APIENTRY mockTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) { (void) target; (void) level; (void) internalformat; (void) width; (void) height; (void) border; (void) format; (void) type; (void) pixels; callCount++; }
+static void APIENTRY mockGenerateMipmap(GLenum target) { (void) target; callCount++; }
+static void APIENTRY mockDeleteTextures(GLsizei n, const GLuint* textures) { (void) n; (void) textures; callCount++; }
+static void APIENTRY mockEnable(GLenum cap) { (void) cap; callCount++; }
+static void APIENTRY mockDisable(GLenum cap) { (void) cap; callCount++; }
+static void APIENTRY mockClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) { (void) red; (void) green; (void) blue; (void) alpha; callCount++; }
+static void APIENTRY mockClear(GLbitfield mask) { (void) mask; callCount++; }
+static void APIENTRY mockViewport(GLint x, GLint y, GLsizei width, GLsizei height) { (void) x; (void) y; (void) width; (void) height; callCount++; }
+static void APIENTRY mockDrawArrays(GLenum mode, GLint first, GLsizei count) { (void) mode; (void) first; (void) count; callCount++; }
+static void APIENTRY mockDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) { (void) mode; (void) count; (void) type; (void) indices; callCount++; }
+static void APIENTRY mockPixelStorei(GLenum pname, GLint param) { (void) pname; (void) param; callCount++; }
+static void APIENTRY mockTexParameteriv(GLenum target, GLenum pname, const GLint* params) { (void) target; (void) pname; (void) params; callCount++; }
+static void APIENTRY mockTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels) { (void) target; (void) level; (void) xoffset; (void) yoffset; (void) width; (void) height; (void) format; (void) type; (void) pixels; callCount++; }
+static void APIENTRY mockVertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer) { (void) index; (void) size; (void) type; (void) stride; (void) pointer; callCount++; }
+static void APIENTRY mockVertexAttribDivisor(GLuint index, GLuint divisor) { (void) index; (void) divisor; callCount++; }
+static void APIENTRY mockDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) { (void) mode; (void) first; (void) count; (void) instancecount; callCount++; }
+static void APIENTRY mockDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex) { (void) mode; (void) count; (void) type; (void) indices; (void) basevertex; callCount++; }
+static void APIENTRY mockDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex) { (void) mode; (void) count; (void) type; (void) indices; (void) instancecount; (void) basevertex; callCount++; }
+static void APIENTRY mockBindBufferBase(GLenum target, GLuint index, GLuint buffer) { (void) target; (void) index; (void) buffer; callCount++; }
+static void APIENTRY mockCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) { (void) readTarget; (void) writeTarget; (void) readOffset; (void) writeOffset; (void) size; callCount++; }
+static GLboolean APIENTRY mockUnmapBuffer(GLenum target) { (void) target; callCount++; return GL_TRUE; }
+static void APIENTRY mockUniform2f(GLint location, GLfloat v0, GLfloat v1) { (void) location; (void) v0; (void) v1; callCount++; }
+static void APIENTRY mockUniform4fv(GLint location, GLsizei count, const GLfloat* value) { (void) location; (void) count; (void) value; callCount++; }
+static void APIENTRY mockUniform1ui(GLint location, GLuint v0) { (void) location; (void) v0; callCount++; }
+static void APIENTRY mockUniform2ui(GLint location, GLuint v0, GLuint v1) { (void) location; (void) v0; (void) v1; callCount++; }
+static void APIENTRY mockUniform3ui(GLint location, GLuint v0, GLuint v1, GLuint v2) { (void) location; (void) v0; (void) v1; (void) v2; callCount++; }
+static void APIENTRY mockColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) { (void) red; (void) green; (void) blue; (void) alpha; callCount++; }
+static void APIENTRY mockDepthFunc(GLenum func) { (void) func; callCount++; }
+static void APIENTRY mockDepthMask(GLboolean flag) { (void) flag; callCount++; }
+static void APIENTRY mockBlendFunc(GLenum sfactor, GLenum dfactor) { (void) sfactor; (void) dfactor; callCount++; }
+static GLsync APIENTRY mockFenceSync(GLenum condition, GLbitfield flags) { (void) condition; (void) flags; callCount++; return (GLsync) (uintptr_t) ++nextName; }
+static GLenum APIENTRY mockClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) { (void) sync; (void) flags; (void) timeout; callCount++; return GL_ALREADY_SIGNALED; }
+static void APIENTRY mockDeleteSync(GLsync sync) { (void) sync; callCount++; }
+static void APIENTRY mockGenFramebuffers(GLsizei n, GLuint* framebuffers) { mockGenNames(n, framebuffers); }
+static void APIENTRY mockBindFramebuffer(GLenum target, GLuint framebuffer) { (void) target; (void) framebuffer; callCount++; }
+static void APIENTRY mockDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) { (void) n; (void) framebuffers; callCount++; }
+static void APIENTRY mockGenRenderbuffers(GLsizei n, GLuint* renderbuffers) { mockGenNames(n, renderbuffers); }
+static void APIENTRY mockBindRenderbuffer(GLenum target, GLuint renderbuffer) { (void) target; (void) renderbuffer; callCount++; }
+static void APIENTRY mockRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) { (void) target; (void) internalformat; (void) width; (void) height; callCount++; }
+static void APIENTRY mockFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) { (void) target; (void) attachment; (void) renderbuffertarget; (void) renderbuffer; callCount++; }
+static void APIENTRY mockDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) { (void) n; (void) renderbuffers; callCount++; }
+static void APIENTRY mockMultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride) { (void) mode; (void) type; (void) indirect; (void) drawcount; (void) stride; callCount++; }
+static void APIENTRY mockMultiDrawArraysIndirect(GLenum mode, const void* indirect, GLsizei drawcount, GLsizei stride) { (void) mode; (void) indirect; (void) drawcount; (void) stride; callCount++; }
+static void APIENTRY mockMultiDrawElementsIndirectCount(GLenum mode, GLenum type, const void* indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride) { (void) mode; (void) type; (void) indirect; (void) drawcount; (void) maxdrawcount; (void) stride; callCount++; }
+static void APIENTRY mockTexStorage2D(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height) { (void) target; (void) levels; (void) internalformat; (void) width; (void) height; callCount++; }
+static void APIENTRY mockDispatchCompute(GLuint groupsX, GLuint groupsY, GLuint groupsZ) { (void) groupsX; (void) groupsY; (void) groupsZ; callCount++; }
+static void APIENTRY mockMemoryBarrier(GLbitfield barriers) { (void) barriers; callCount++; }
+static void APIENTRY mockClearBufferData(GLenum target, GLenum internalformat, GLenum format, GLenum type, const void* data) { (void) target; (void) internalformat; (void) format; (void) type; (void) data; callCount++; }
+
+// writes into the mapping have to land somewhere, every mapping shares one scratch block
+static void* APIENTRY mockMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+  (void) target; (void) offset; (void) access;
+  callCount++;
+  if((size_t) length > mappingSize) {
+    void* grown = realloc(mapping, (size_t) length);
+    if(!grown) {
+      return NULL;
+    }
+    mapping = grown;
+    mappingSize = (size_t) length;
+  }
+  return mapping;
+}
+
+static void APIENTRY mockGetIntegerv(GLenum pname, GLint* data) {
+  (void) pname;
+  *data = 4; // only GL_UNPACK_ALIGNMENT is ever queried
+  callCount++;
+}
+
+void glmockInstall() {
+  callCount = 0;
+  nextName = 0;
+
+  glad_glGenVertexArrays = mockGenVertexArrays;
+  glad_glBindVertexArray = mockBindVertexArray;
+  glad_glDeleteVertexArrays = mockDeleteVertexArrays;
+  glad_glGenBuffers = mockGenBuffers;
+  glad_glBindBuffer = mockBindBuffer;
+  glad_glBufferData = mockBufferData;
+  glad_glBufferSubData = mockBufferSubData;
+  glad_glDeleteBuffers = mockDeleteBuffers;
+  glad_glVertexAttribPointer = mockVertexAttribPointer;
+  glad_glEnableVertexAttribArray = mockEnableVertexAttribArray;
+  glad_glCreateShader = mockCreateShader;
+  glad_glShaderSource = mockShaderSource;
+  glad_glCompileShader = mockCompileShader;
+  glad_glDeleteShader = mockDeleteShader;
+  glad_glCreateProgram = mockCreateProgram;
+  glad_glAttachShader = mockAttachShader;
+  glad_glLinkProgram = mockLinkProgram;
+  glad_glUseProgram = mockUseProgram;
+  glad_glDeleteProgram = mockDeleteProgram;
+  glad_glGetUniformLocation = mockGetUniformLocation;
+  glad_glUniform1i = mockUniform1i;
+  glad_glUniform1f = mockUniform1f;
+  glad_glUniformMatrix4fv = mockUniformMatrix4fv;
+  glad_glGenTextures = mockGenTextures;
+  glad_glActiveTexture = mockActiveTexture;
+  glad_glBindTexture = mockBindTexture;
+  glad_glTexParameteri = mockTexParameteri;
+  glad_glTexImage2D = mockTexImage2D;
+  glad_glGenerateMipmap = mockGenerateMipmap;
+  glad_glDeleteTextures = mockDeleteTextures;
+  glad_glEnable = mockEnable;
+  glad_glDisable = mockDisable;
+  glad_glClearColor = mockClearColor;
+  glad_glClear = mockClear;
+  glad_glViewport = mockViewport;
+  glad_glDrawArrays = mockDrawArrays;
+  glad_glDrawElements = mockDrawElements;
+  glad_glPixelStorei = mockPixelStorei;
+  glad_glTexParameteriv = mockTexParameteriv;
+  glad_glTexSubImage2D = mockTexSubImage2D;
+  glad_glVertexAttribIPointer = mockVertexAttribIPointer;
+  glad_glVertexAttribDivisor = mockVertexAttribDivisor;
+  glad_glDrawArraysInstanced = mockDrawArraysInstanced;
+  glad_glDrawElementsBaseVertex = mockDrawElementsBaseVertex;
+  glad_glDrawElementsInstancedBaseVertex = mockDrawElementsInstancedBaseVertex;
+  glad_glBindBufferBase = mockBindBufferBase;
+  glad_glCopyBufferSubData = mockCopyBufferSubData;
+  glad_glMapBufferRange = mockMapBufferRange;
+  glad_glUnmapBuffer = mockUnmapBuffer;
+  glad_glUniform2f = mockUniform2f;
+  glad_glUniform4fv = mockUniform4fv;
+  glad_glUniform1ui = mockUniform1ui;
+  glad_glUniform2ui = mockUniform2ui;
+  glad_glUniform3ui = mockUniform3ui;
+  glad_glColorMask = mockColorMask;
+  glad_glDepthFunc = mockDepthFunc;
+  glad_glDepthMask = mockDepthMask;
+  glad_glBlendFunc = mockBlendFunc;
+  glad_glFenceSync = mockFenceSync;
+  glad_glClientWaitSync = mockClientWaitSync;
+  glad_glDeleteSync = mockDeleteSync;
+  glad_glGenFramebuffers = mockGenFramebuffers;
+  glad_glBindFramebuffer = mockBindFramebuffer;
+  glad_glDeleteFramebuffers = mockDeleteFramebuffers;
+  glad_glGenRenderbuffers = mockGenRenderbuffers;
+  glad_glBindRenderbuffer = mockBindRenderbuffer;
+  glad_glRenderbufferStorage = mockRenderbufferStorage;
+  glad_glFramebufferRenderbuffer = mockFramebufferRenderbuffer;
+  glad_glDeleteRenderbuffers = mockDeleteRenderbuffers;
+  glad_glGetIntegerv = mockGetIntegerv;
+
+  glext_glMultiDrawElementsIndirect = mockMultiDrawElementsIndirect;
+  glext_glMultiDrawArraysIndirect = mockMultiDrawArraysIndirect;
+  glext_glMultiDrawElementsIndirectCountARB = mockMultiDrawElementsIndirectCount;
+  glext_glTexStorage2D = mockTexStorage2D;
+  glext_glDispatchCompute = mockDispatchCompute;
+  glext_glMemoryBarrier = mockMemoryBarrier;
+  glext_glClearBufferData = mockClearBufferData;
+}
+
+unsigned long long glmockCallCount() {
+  return callCount;
+}
@@ -0,0 +1,11 @@
+#ifndef GLMOCK_H
+#define GLMOCK_H
+
+// fills glad's and glext's function pointers for every call in CAPTURE_CALLS and CAPTURE_EXT_CALLS
+// with no-op stubs, so traces can be replayed and GL-side code exercised without a context
+void glmockInstall();
+
+// number of calls the stubs have absorbed since glmockInstall
+unsigned long long glmockCallCount();
+
+#endif
@@ -0,0 +1,250 @@
+#include "gpucull.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "drawlist.h"
+#include "glext.h"
+
+int gpuCullInit(GpuCull* g, MeshPool* pool, Shader* program, unsigned int capacity) {
+  memset(g, 0, sizeof(*g));
+  int linked = 0;
+  if(program->ID) {
+    glGetProgramiv(program->ID, GL_LINK_STATUS, &linked);
+  }
+  if(!linked) {
+    printf("ERROR::GPUCULL::PROGRAM_NOT_LINKED\n");
+    return -1;
+  }
+
+  g->program = program;
+  g->capacity = capacity;
+  g->indirectCount = glext.indirectCount;
+  g->objects = malloc(capacity * sizeof(GpuCullObject));
+  timingInit(&g->stats.dispatchTimes);
+  timingInit(&g->stats.passTimes);
+
+  glGenBuffers(1, &g->objectBuffer);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, g->objectBuffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(GpuCullObject), NULL, GL_STATIC_DRAW);
+
+  glGenBuffers(1, &g->commandBuffer);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, g->commandBuffer);
+  glBufferData(GL_DRAW_INDIRECT_BUFFER, capacity * sizeof(DrawElementsIndirectCommand), NULL, GL_DYNAMIC_COPY);
+
+  glGenBuffers(1, &g->countBuffer);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, g->countBuffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(unsigned int), NULL, GL_DYNAMIC_COPY);
+
+  glGenBuffers(1, &g->readbackBuffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, g->readbackBuffer);
+  glBufferData(GL_COPY_WRITE_BUFFER, GPU_CULL_FRAMES * sizeof(unsigned int), NULL, GL_STREAM_READ);
+
+  glGenQueries(GPU_CULL_FRAMES, g->queries);
+
+  glGenBuffers(1, &g->transformBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, g->transformBuffer);
+  glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(mat4), NULL, GL_STATIC_DRAW);
+
+  // a VAO of its own over the pool's buffers, a DrawList on the same pool keeps its transform attribute
+  glGenVertexArrays(1, &g->VAO);
+  glBindVertexArray(g->VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, pool->VBO);
+  vertexFormatApply(&pool->format);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool->EBO);
+
+  // instanced, so each command's baseInstance picks its object's transform
+  glBindBuffer(GL_ARRAY_BUFFER, g->transformBuffer);
+  for(unsigned int column = 0; column < 4; column++) {
+    glVertexAttribPointer(GPU_CULL_TRANSFORM_LOCATION + column, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (void*) (uintptr_t) (column * sizeof(vec4)));
+    glEnableVertexAttribArray(GPU_CULL_TRANSFORM_LOCATION + column);
+    glVertexAttribDivisor(GPU_CULL_TRANSFORM_LOCATION + column, 1);
+  }
+  glBindVertexArray(0);
+  return 0;
+}
+
+void gpuCullSetObjects(GpuCull* g, const GpuCullObject* objects, mat4* transforms, unsigned int count) {
+  if(count > g->capacity) {
+    printf("ERROR::GPUCULL::TOO_MANY_OBJECTS: %u of %u\n", count, g->capacity);
+    count = g->capacity;
+  }
+
+  memcpy(g->objects, objects, count * sizeof(GpuCullObject));
+  g->objectCount = count;
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, g->objectBuffer);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, count * sizeof(GpuCullObject), objects);
+  glBindBuffer(GL_ARRAY_BUFFER, g->transformBuffer);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(mat4), transforms);
+}
+
+// takes the statistics of the frame that last used slot if the GPU is done with it, never waits
+static void gpuCullCollect(GpuCull* g, unsigned int slot) {
+  if(!g->fences[slot]) {
+    return;
+  }
+
+  GLenum status = glClientWaitSync(g->fences[slot], 0, 0);
+  if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+    unsigned int visible = 0;
+    glBindBuffer(GL_COPY_READ_BUFFER, g->readbackBuffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, slot * sizeof(unsigned int), sizeof(unsigned int), &visible);
+    g->stats.visible += visible;
+    g->stats.sampledFrames++;
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(g->queries[slot], GL_QUERY_RESULT, &elapsed);
+    timingAdd(&g->stats.passTimes, elapsed / 1000000.0);
+  }
+  glDeleteSync(g->fences[slot]);
+  g->fences[slot] = NULL;
+}
+
+void gpuCullRun(GpuCull* g, mat4 viewProjection) {
+  double start = timingNow();
+  unsigned int slot = g->frame % GPU_CULL_FRAMES;
+  gpuCullCollect(g, slot);
+
+  glm_frustum_planes(viewProjection, g->planes);
+
+  glBeginQuery(GL_TIME_ELAPSED, g->queries[slot]);
+
+  // without a GPU side draw count every command is drawn, the ones nothing appended stay zero
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, g->countBuffer);
+  glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+  if(!g->indirectCount) {
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, g->commandBuffer);
+    glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+  }
+
+  if(g->objectCount) {
+    shaderUse(g->program);
+    glUniform4fv(glGetUniformLocation(g->program->ID, "planes"), 6, (const float*) g->planes);
+    shaderSetUint(g->program, "objectCount", g->objectCount);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, g->objectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, g->commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, g->countBuffer);
+    glDispatchCompute((g->objectCount + GPU_CULL_GROUP_SIZE - 1) / GPU_CULL_GROUP_SIZE, 1, 1);
+  }
+
+  // the draws read the results as indirect arguments, the statistics copy reads the count
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+  glEndQuery(GL_TIME_ELAPSED);
+
+  glBindBuffer(GL_COPY_READ_BUFFER, g->countBuffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, g->readbackBuffer);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, slot * sizeof(unsigned int), sizeof(unsigned int));
+  g->fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  g->frame++;
+
+  timingAdd(&g->stats.dispatchTimes, (timingNow() - start) * 1000.0);
+}
+
+void gpuCullDraw(GpuCull* g) {
+  if(g->objectCount == 0) {
+    return;
+  }
+
+  glBindVertexArray(g->VAO);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, g->commandBuffer);
+  if(g->indirectCount) {
+    glBindBuffer(GL_PARAMETER_BUFFER_ARB, g->countBuffer);
+    glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, GL_UNSIGNED_INT, NULL, 0, g->objectCount, 0);
+  }
+  else {
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, NULL, g->objectCount, 0);
+  }
+  glBindVertexArray(0);
+}
+
+// a box whose furthest corner is within rounding of a plane can land on either side of it
+static int gpuCullOnPlane(vec3 box[2], vec4 planes[6]) {
+  for(int i = 0; i < 6; i++) {
+    float* p = planes[i];
+    float dp = p[0] * box[p[0] > 0.0f][0] + p[1] * box[p[1] > 0.0f][1] + p[2] * box[p[2] > 0.0f][2];
+    if(fabsf(dp + p[3]) <= 1e-5f * (fabsf(dp) + fabsf(p[3]))) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+unsigned int gpuCullValidate(GpuCull* g) {
+  unsigned int visible = 0;
+  glBindBuffer(GL_COPY_READ_BUFFER, g->countBuffer);
+  glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(unsigned int), &visible);
+  if(visible > g->objectCount) {
+    printf("ERROR::GPUCULL::INVALID_COUNT: %u of %u objects\n", visible, g->objectCount);
+    visible = g->objectCount;
+  }
+
+  DrawElementsIndirectCommand* commands = malloc((visible ? visible : 1) * sizeof(DrawElementsIndirectCommand));
+  glBindBuffer(GL_COPY_READ_BUFFER, g->commandBuffer);
+  glGetBufferSubData(GL_COPY_READ_BUFFER, 0, visible * sizeof(DrawElementsIndirectCommand), commands);
+
+  unsigned char* drawn = calloc(g->objectCount ? g->objectCount : 1, 1);
+  unsigned int mismatches = 0;
+  unsigned int boundary = 0;
+
+  // every command has to be one object drawn once with its own mesh
+  for(unsigned int i = 0; i < visible; i++) {
+    DrawElementsIndirectCommand* c = &commands[i];
+    GpuCullObject* o = c->baseInstance < g->objectCount ? &g->objects[c->baseInstance] : NULL;
+    if(!o || drawn[c->baseInstance] || c->instanceCount != 1 || c->count != o->count || c->firstIndex != o->firstIndex || c->baseVertex != o->baseVertex) {
+      mismatches++;
+      continue;
+    }
+    drawn[c->baseInstance] = 1;
+  }
+
+  for(unsigned int i = 0; i < g->objectCount; i++) {
+    vec3 box[2];
+    glm_vec3_copy(g->objects[i].boundsMin, box[0]);
+    glm_vec3_copy(g->objects[i].boundsMax, box[1]);
+    if(glm_aabb_frustum(box, g->planes) != drawn[i]) {
+      mismatches++;
+      boundary += gpuCullOnPlane(box, g->planes);
+    }
+  }
+
+  g->stats.validatedFrames++;
+  g->stats.mismatches += mismatches;
+  g->stats.boundaryMismatches += boundary;
+
+  free(commands);
+  free(drawn);
+  return mismatches;
+}
+
+void gpuCullReport(GpuCull* g) {
+  GpuCullStats* s = &g->stats;
+  printf("gpu cull: %u objects, %.1f visible per frame over %u sampled frames, %s\n", g->objectCount,
+      s->sampledFrames ? (double) s->visible / s->sampledFrames : 0.0, s->sampledFrames,
+      g->indirectCount ? "glMultiDrawElementsIndirectCountARB" : "glMultiDrawElementsIndirect over cleared commands");
+  if(s->validatedFrames) {
+    printf("gpu cull: %u frames checked against glm_aabb_frustum, %u mismatches, %u of them within rounding of a plane\n",
+        s->validatedFrames, s->mismatches, s->boundaryMismatches);
+  }
+  timingReport(&s->dispatchTimes, "gpu cull dispatch (CPU)");
+  timingReport(&s->passTimes, "gpu cull pass (GPU)");
+}
+
+void gpuCullFree(GpuCull* g) {
+  for(unsigned int i = 0; i < GPU_CULL_FRAMES; i++) {
+    if(g->fences[i]) {
+      glDeleteSync(g->fences[i]);
+    }
+  }
+  glDeleteQueries(GPU_CULL_FRAMES, g->queries);
+  glDeleteVertexArrays(1, &g->VAO);
+  glDeleteBuffers(1, &g->objectBuffer);
+  glDeleteBuffers(1, &g->transformBuffer);
+  glDeleteBuffers(1, &g->commandBuffer);
+  glDeleteBuffers(1, &g->countBuffer);
+  glDeleteBuffers(1, &g->readbackBuffer);
+  free(g->objects);
+  timingFree(&g->stats.dispatchTimes);
+  timingFree(&g->stats.passTimes);
+  memset(g, 0, sizeof(*g));
+}
@@ -0,0 +1,77 @@
+#ifndef GPUCULL_H
+#define GPUCULL_H
+
+#include <cglm/cglm.h>
+#include <glad/glad.h>
+#include "meshpool.h"
+#include "shader.h"
+#include "timing.h"
+
+#define GPU_CULL_GROUP_SIZE 64 // local_size_x of src/CS_cull
+#define GPU_CULL_FRAMES 4 // statistics readbacks in flight, each is read once its fence has passed
+#define GPU_CULL_TRANSFORM_LOCATION 2 // same per-draw mat4 attribute as src/VS_indirect
+
+// std430 layout of one object as src/CS_cull reads it
+typedef struct GpuCullObject {
+  vec4 boundsMin; // world space, w unused
+  vec4 boundsMax;
+  unsigned int count; // the mesh's index range, copied into the command when the object is visible
+  unsigned int firstIndex;
+  int baseVertex;
+  unsigned int padding;
+} GpuCullObject;
+
+typedef struct GpuCullStats {
+  unsigned long long visible; // summed over the sampled frames
+  unsigned int sampledFrames; // frames whose count was read back without waiting
+  unsigned int validatedFrames;
+  unsigned int mismatches; // objects the GPU and glm_aabb_frustum disagree on
+  unsigned int boundaryMismatches; // of those, objects within rounding of a plane
+  Timing dispatchTimes; // milliseconds of CPU time to clear and dispatch
+  Timing passTimes; // milliseconds of GPU time for the pass, from timer queries
+} GpuCullStats;
+
+// frustum culls a static set of objects in a compute pass that appends the visible ones to
+// an indirect draw buffer, nothing per object is touched on the CPU after gpuCullSetObjects
+typedef struct GpuCull {
+  Shader* program; // src/CS_cull
+  unsigned int VAO; // the pool's buffers and vertex format plus the transform attribute
+  unsigned int objectBuffer;
+  unsigned int transformBuffer; // one mat4 per object, indexed by the baseInstance of its command
+  unsigned int commandBuffer; // compacted DrawElementsIndirectCommands
+  unsigned int countBuffer; // visible objects, appended to with atomicAdd
+  unsigned int readbackBuffer; // a count per frame in flight for the statistics
+
+  GLsync fences[GPU_CULL_FRAMES];
+  unsigned int queries[GPU_CULL_FRAMES];
+  unsigned int frame;
+
+  GpuCullObject* objects; // kept to validate against
+  unsigned int objectCount;
+  unsigned int capacity;
+  int indirectCount; // count read from countBuffer, otherwise the unused commands are cleared to zero
+  vec4 planes[6];
+
+  GpuCullStats stats;
+} GpuCull;
+
+// needs glext.computeShaders and glext.multiDrawIndirect, returns -1 without creating
+// anything when the program did not link, the caller culls on the CPU instead
+int gpuCullInit(GpuCull* g, MeshPool* pool, Shader* program, unsigned int capacity);
+
+// transforms are the full model matrices, dequantization included
+void gpuCullSetObjects(GpuCull* g, const GpuCullObject* objects, mat4* transforms, unsigned int count);
+
+void gpuCullRun(GpuCull* g, mat4 viewProjection);
+
+// draws whatever the last run left visible, can be called once per pass
+void gpuCullDraw(GpuCull* g);
+
+// reads the last run's commands back and compares them with glm_aabb_frustum, stalls until the pass finishes
+unsigned int gpuCullValidate(GpuCull* g);
+
+void gpuCullReport(GpuCull* g);
+
+void gpuCullFree(GpuCull* g);
+
+#endif
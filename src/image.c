@@ -0,0 +1,28 @@
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+int imageWritePPM(const char* path, const unsigned char* rgba, int width, int height, int bottomUp) {
+  FILE* fp = fopen(path, "wb");
+  if(!fp) {
+    printf("ERROR::IMAGE::FAILED_TO_OPEN_OUTPUT: %s\n", path);
+    return -1;
+  }
+
+  unsigned char* row = malloc((size_t) width * 3);
+  fprintf(fp, "P6\n%d %d\n255\n", width, height);
+
+  for(int y = 0; y < height; y++) {
+    const unsigned char* src = rgba + (size_t) (bottomUp ? height - 1 - y : y) * width * 4;
+    for(int x = 0; x < width; x++) {
+      row[x * 3 + 0] = src[x * 4 + 0];
+      row[x * 3 + 1] = src[x * 4 + 1];
+      row[x * 3 + 2] = src[x * 4 + 2];
+    }
+    fwrite(row, (size_t) width * 3, 1, fp);
+  }
+
+  free(row);
+  fclose(fp);
+  return 0;
+}
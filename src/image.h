@@ -0,0 +1,7 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+// writes RGBA8 pixels as a binary PPM, bottomUp is set for rows read back from GL
+int imageWritePPM(const char* path, const unsigned char* rgba, int width, int height, int bottomUp);
+
+#endif
@@ -0,0 +1,111 @@
+#include "jobs.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void* jobsWorkerMain(void* arg) {
+  Jobs* j = arg;
+
+  pthread_mutex_lock(&j->lock);
+  for(;;) {
+    while(j->count == 0 && !j->stopping) {
+      pthread_cond_wait(&j->available, &j->lock);
+    }
+    if(j->count == 0) {
+      break;
+    }
+
+    Job job = j->queue[j->head];
+    j->head = (j->head + 1) % j->capacity;
+    j->count--;
+    j->running++;
+
+    pthread_mutex_unlock(&j->lock);
+    job.function(job.arg);
+    pthread_mutex_lock(&j->lock);
+
+    j->running--;
+    if(j->count == 0 && j->running == 0) {
+      pthread_cond_broadcast(&j->idle);
+    }
+  }
+  pthread_mutex_unlock(&j->lock);
+
+  return NULL;
+}
+
+void jobsInit(Jobs* j, unsigned int threadCount) {
+  memset(j, 0, sizeof(*j));
+
+  if(threadCount < 1) {
+    threadCount = 1;
+  }
+  if(threadCount > JOBS_MAX_THREADS) {
+    threadCount = JOBS_MAX_THREADS;
+  }
+
+  pthread_mutex_init(&j->lock, NULL);
+  pthread_cond_init(&j->available, NULL);
+  pthread_cond_init(&j->idle, NULL);
+
+  j->capacity = 256;
+  j->queue = malloc(j->capacity * sizeof(Job));
+
+  j->threadCount = threadCount;
+  for(unsigned int i = 0; i < threadCount; i++) {
+    pthread_create(&j->threads[i], NULL, jobsWorkerMain, j);
+  }
+}
+
+void jobsSubmit(Jobs* j, JobFunction function, void* arg) {
+  pthread_mutex_lock(&j->lock);
+
+  // unroll the ring into the front of a larger buffer
+  if(j->count == j->capacity) {
+    Job* grown = malloc(j->capacity * 2 * sizeof(Job));
+    for(unsigned int i = 0; i < j->count; i++) {
+      grown[i] = j->queue[(j->head + i) % j->capacity];
+    }
+    free(j->queue);
+    j->queue = grown;
+    j->head = 0;
+    j->capacity *= 2;
+  }
+
+  j->queue[(j->head + j->count) % j->capacity] = (Job) {function, arg};
+  j->count++;
+
+  pthread_cond_signal(&j->available);
+  pthread_mutex_unlock(&j->lock);
+}
+
+void jobsWait(Jobs* j) {
+  pthread_mutex_lock(&j->lock);
+  while(j->count > 0 || j->running > 0) {
+    pthread_cond_wait(&j->idle, &j->lock);
+  }
+  pthread_mutex_unlock(&j->lock);
+}
+
+unsigned int jobsPending(Jobs* j) {
+  pthread_mutex_lock(&j->lock);
+  unsigned int pending = j->count + j->running;
+  pthread_mutex_unlock(&j->lock);
+  return pending;
+}
+
+void jobsFree(Jobs* j) {
+  pthread_mutex_lock(&j->lock);
+  j->stopping = 1;
+  pthread_cond_broadcast(&j->available);
+  pthread_mutex_unlock(&j->lock);
+
+  for(unsigned int i = 0; i < j->threadCount; i++) {
+    pthread_join(j->threads[i], NULL);
+  }
+
+  pthread_mutex_destroy(&j->lock);
+  pthread_cond_destroy(&j->available);
+  pthread_cond_destroy(&j->idle);
+  free(j->queue);
+  memset(j, 0, sizeof(*j));
+}
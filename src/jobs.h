@@ -0,0 +1,44 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <pthread.h>
+
+#define JOBS_MAX_THREADS 32
+
+typedef void (*JobFunction)(void* arg);
+
+typedef struct Job {
+  JobFunction function;
+  void* arg;
+} Job;
+
+// persistent worker threads draining one FIFO queue, for work that outlives a single frame
+typedef struct Jobs {
+  pthread_t threads[JOBS_MAX_THREADS];
+  unsigned int threadCount;
+
+  pthread_mutex_t lock;
+  pthread_cond_t available; // signalled when a job is queued or the pool shuts down
+  pthread_cond_t idle; // signalled when the queue is empty and no job is running
+
+  Job* queue; // ring buffer
+  unsigned int head;
+  unsigned int count;
+  unsigned int capacity;
+  unsigned int running;
+  int stopping;
+} Jobs;
+
+void jobsInit(Jobs* j, unsigned int threadCount);
+
+void jobsSubmit(Jobs* j, JobFunction function, void* arg);
+
+// blocks until every submitted job has finished
+void jobsWait(Jobs* j);
+
+unsigned int jobsPending(Jobs* j);
+
+// finishes the queued jobs, then joins the workers
+void jobsFree(Jobs* j);
+
+#endif
@@ -0,0 +1,105 @@
+#include "lod.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+int lodFileRead(LodFile* f, const char* path) {
+  memset(f, 0, sizeof(*f));
+
+  FILE* file = fopen(path, "rb");
+  if(!file) {
+    printf("ERROR::LOD::FILE_NOT_FOUND: %s\n", path);
+    return -1;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  f->data = malloc(size);
+  if((long) fread(f->data, 1, size, file) != size || size < (long) sizeof(LodFileHeader)) {
+    printf("ERROR::LOD::INVALID_FILE: %s\n", path);
+    fclose(file);
+    lodFileFree(f);
+    return -1;
+  }
+  fclose(file);
+
+  memcpy(&f->header, f->data, sizeof(LodFileHeader));
+  if(f->header.magic != LOD_MAGIC || f->header.version != LOD_VERSION || f->header.levelCount == 0 || f->header.levelCount > LOD_MAX_LEVELS) {
+    printf("ERROR::LOD::INVALID_FILE: %s\n", path);
+    lodFileFree(f);
+    return -1;
+  }
+
+  for(unsigned int i = 0; i < f->header.levelCount; i++) {
+    LodFileLevel* level = &f->header.levels[i];
+    if(level->vertexOffset + (uint64_t) level->vertexCount * f->header.stride * sizeof(float) > (uint64_t) size
+        || level->indexOffset + (uint64_t) level->indexCount * sizeof(unsigned int) > (uint64_t) size) {
+      printf("ERROR::LOD::LEVEL_OUT_OF_BOUNDS: %s level %u\n", path, i);
+      lodFileFree(f);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+const float* lodFileVertices(LodFile* f, unsigned int level) {
+  return (const float*) (f->data + f->header.levels[level].vertexOffset);
+}
+
+const unsigned int* lodFileIndices(LodFile* f, unsigned int level) {
+  return (const unsigned int*) (f->data + f->header.levels[level].indexOffset);
+}
+
+void lodFileFree(LodFile* f) {
+  free(f->data);
+  f->data = NULL;
+}
+
+void lodInit(Lod* lod, LodFile* f, float hysteresis) {
+  memset(lod, 0, sizeof(*lod));
+  lod->levelCount = f->header.levelCount;
+  lod->radius = f->header.radius;
+  lod->hysteresis = hysteresis;
+
+  // a level may be drawn as long as its error covers at most LOD_PIXEL_ERROR pixels,
+  // error / (2 * radius) * size <= LOD_PIXEL_ERROR. lodgen makes level 0 the coarsest
+  // lossless mesh, in older files a later zero-error level takes over from the finer ones
+  for(unsigned int i = 0; i < lod->levelCount; i++) {
+    float error = f->header.levels[i].error;
+    lod->triangles[i] = f->header.levels[i].indexCount / 3;
+    lod->maxSize[i] = i == 0 || error <= 0.0f ? INFINITY : LOD_PIXEL_ERROR * 2.0f * lod->radius / error;
+
+    // never let a coarser level claim larger sizes than a finer one
+    if(i > 0 && lod->maxSize[i] > lod->maxSize[i - 1]) {
+      lod->maxSize[i] = lod->maxSize[i - 1];
+    }
+  }
+}
+
+float lodProjectedSize(float radius, float distance, float fovDegrees, float viewportHeight) {
+  if(distance <= radius) {
+    return INFINITY;
+  }
+  return radius / (distance * tanf(fovDegrees * (float) M_PI / 360.0f)) * viewportHeight;
+}
+
+// moving to a coarser level needs the size to drop below the threshold by the hysteresis
+// fraction, moving back needs it to rise above by the same fraction, so a size sitting on
+// a threshold does not flip levels every frame
+unsigned int lodSelect(Lod* lod, unsigned int current, float projectedSize) {
+  if(current >= lod->levelCount) {
+    current = lod->levelCount - 1;
+  }
+
+  while(current + 1 < lod->levelCount && projectedSize < lod->maxSize[current + 1] * (1.0f - lod->hysteresis)) {
+    current++;
+  }
+  while(current > 0 && projectedSize > lod->maxSize[current] * (1.0f + lod->hysteresis)) {
+    current--;
+  }
+  return current;
+}
@@ -0,0 +1,61 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <stdint.h>
+
+#define LOD_MAGIC 0x444F4C4D // "MLOD"
+#define LOD_VERSION 1
+#define LOD_MAX_LEVELS 6
+#define LOD_PIXEL_ERROR 1.0f // largest simplification error, in pixels, a level may show
+
+// on-disk layout, vertex and index data follow at the offsets of each level
+typedef struct LodFileLevel {
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint64_t vertexOffset;
+  uint64_t indexOffset;
+  float error; // object-space distance the simplifier moved the surface by, 0 for the source
+  uint32_t reserved;
+} LodFileLevel;
+
+typedef struct LodFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t levelCount;
+  uint32_t stride; // floats per vertex
+  float radius; // bounding sphere around the mesh origin
+  uint32_t reserved;
+  LodFileLevel levels[LOD_MAX_LEVELS];
+} LodFileHeader;
+
+typedef struct LodFile {
+  LodFileHeader header;
+  unsigned char* data; // the whole file
+} LodFile;
+
+// level selection for one mesh, level 0 is full detail
+typedef struct Lod {
+  unsigned int levelCount;
+  unsigned int triangles[LOD_MAX_LEVELS];
+  float maxSize[LOD_MAX_LEVELS]; // largest projected diameter, in pixels, each level can be drawn at
+  float radius;
+  float hysteresis; // how far past a threshold the size has to go before switching, as a fraction
+} Lod;
+
+int lodFileRead(LodFile* f, const char* path);
+
+const float* lodFileVertices(LodFile* f, unsigned int level);
+
+const unsigned int* lodFileIndices(LodFile* f, unsigned int level);
+
+void lodFileFree(LodFile* f);
+
+void lodInit(Lod* lod, LodFile* f, float hysteresis);
+
+// diameter of the bounding sphere on screen in pixels
+float lodProjectedSize(float radius, float distance, float fovDegrees, float viewportHeight);
+
+// returns the level to draw given the one drawn last frame
+unsigned int lodSelect(Lod* lod, unsigned int current, float projectedSize);
+
+#endif
@@ -2,14 +2,457 @@
 #include <GLFW/glfw3.h>
 #include <cglm/cglm.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "shader.h"
 #include "texture.h"
 #include "camera.h"
+#include "arena.h"
+#include "pack.h"
+#include "cube.h"
+#include "offscreen.h"
+#include "timing.h"
+#include "image.h"
+#include "capture.h"
+#include "vertex.h"
+#include "glext.h"
+#include "meshpool.h"
+#include "drawlist.h"
+#include "sort.h"
+#include "occlusion.h"
+#include "lod.h"
+#include "jobs.h"
+#include "terrain.h"
+#include "voxel.h"
+#include "voxelrender.h"
+#include "shapes.h"
+#include "sprites.h"
+#include "upload.h"
+#include "residency.h"
+#include "mipstream.h"
+#include "texcache.h"
+#include "resource.h"
+#include "assets.h"
+#include "scene.h"
+#include "gpucull.h"
 
 const unsigned int WINDOW_HEIGHT = 600;
 const unsigned int WINDOW_WIDTH = 800;
 
+// additive increment per shaded fragment in overdraw mode, 16 steps fit in an 8-bit channel
+const float OVERDRAW_STEP = 16.0f / 255.0f;
+
+// terrain streaming, the view radius in chunks keeps the terrain inside the 100 unit far plane
+const int TERRAIN_VIEW_RADIUS = 3;
+const unsigned int TERRAIN_UPLOAD_BUDGET = 2; // chunk uploads per frame
+const float TERRAIN_FLY_DISTANCE = 2000.0f; // world units covered by a headless --terrain run
+
+// voxel world size in chunks and where its corner sits, the hills top out just below the cubes
+const int VOXEL_WORLD_CHUNKS = 4;
+const int VOXEL_WORLD_HEIGHT = 2;
+vec3 voxelOrigin = {-64.0f, -48.0f, -64.0f};
+
+// texture streaming benchmark, one generated RGBA image of this size per frame
+const int STREAM_TEXTURE_SIZE = 2048;
+const size_t STREAM_UPLOAD_BUDGET = 32 * 1024 * 1024; // bytes copied into textures per frame
+const size_t MIP_STREAM_BUDGET = 4 * 1024 * 1024; // bytes of finer mip levels uploaded per frame
+const unsigned int MIP_STREAM_SWEEP = 4096; // cubes checked per frame for one nearer than the last nearest
+const size_t TEXTURE_CACHE_PIXEL_BUDGET = 16 * 1024 * 1024; // decoded pixels kept to recreate released textures
+const double ASSET_UPLOAD_BUDGET_MS = 2.0; // GL thread time per frame for background asset uploads
+const float CUBE_RADIUS = 0.87f; // bounding sphere of the unit cube
+
+typedef enum DrawPath {
+  DRAW_CLASSIC, // one glDrawArrays and uniform upload per cube
+  DRAW_INDIRECT, // mesh pool and one glMultiDrawElementsIndirect, GL 3.3 loop when 4.3 is missing
+  DRAW_FALLBACK, // mesh pool with the GL 3.3 loop forced, for comparison
+  DRAW_PULL // mesh pool read from storage buffers by src/VS_pull, no vertex attributes, GL 4.3
+} DrawPath;
+
+typedef struct Options {
+  int headless; // render into an offscreen framebuffer in an invisible window
+  unsigned int frames; // number of frames to render in headless mode
+  const char* out; // directory to dump headless frames into, NULL to skip writing
+  const char* capture; // GL trace to record for tools/replay.c, NULL to disable
+  VertexType vertexFormat; // how the cube's positions and texture coordinates are stored
+  DrawPath draw; // how the cubes are submitted
+  int sort; // submit opaque cubes front-to-back by view-space depth
+  int prepass; // depth-only pass first so the shaded pass only runs on visible fragments
+  int overdraw; // count shaded fragments per pixel with additive blending instead of texturing
+  int occlusion; // skip cubes hidden behind nearer cubes using the CPU depth buffer in occlusion.c
+  int lod; // draw the rounded cube LOD chain built by tools/lodgen.c, needs a pooled draw path
+  int terrain; // stream procedural terrain chunks around the camera, headless runs fly over it
+  int voxels; // greedy meshed voxel world under the cubes, one voxel is dug out every frame
+  unsigned int shapes; // animated 2D circles, rounded rects and lines drawn over the scene in one call
+  unsigned int sprites; // moving textured sprites through the sorted sprite batch
+  int spriteAtlas; // pack the sprite images into one atlas texture instead of binding each
+  unsigned int streamTextures; // large textures uploaded one per frame, to measure main thread stall per MB
+  int syncUploads; // stream them with a blocking glTexImage2D instead of the pixel buffer uploader
+  int streamEncoded; // stream the encoded container image instead, decoded by the uploader's workers or on the main thread
+  unsigned int textureBudget; // KB of estimated VRAM for the scene textures, 0 keeps them resident
+  int srgb; // color textures stored as sRGB and the framebuffer encodes, so lighting and blending happen in linear space
+  int mipStream; // a large generated texture replaces the container, streamed coarsest mip first as the cubes need it
+  int textureReuse; // load the container again under another path, then release and reload it, to exercise the texture cache
+  int asyncLoad; // the cube program and textures load in the background, the rest of the scene renders while they do
+  const char* scene; // compiled scene from tools/scenec.c whose objects replace the hard-coded cubes, NULL to keep them
+  int gpuCull; // frustum cull in a compute pass that writes the indirect draws, GL 4.3
+  int validateCull; // read every GPU cull result back and check it against the CPU test
+} Options;
+
+typedef struct OverdrawStats {
+  double fragments; // shaded fragments, summed over every measured frame
+  double pixels;
+  double covered; // pixels that were shaded at least once
+  unsigned int frames;
+} OverdrawStats;
+
+void parseOptions(Options* o, int argc, char** argv) {
+  o->headless = 0;
+  o->frames = 600;
+  o->out = NULL;
+  o->capture = NULL;
+  o->vertexFormat = VERTEX_SNORM16;
+  o->draw = DRAW_CLASSIC;
+  o->sort = 0;
+  o->prepass = 0;
+  o->overdraw = 0;
+  o->occlusion = 0;
+  o->lod = 0;
+  o->terrain = 0;
+  o->voxels = 0;
+  o->shapes = 0;
+  o->sprites = 0;
+  o->spriteAtlas = 0;
+  o->streamTextures = 0;
+  o->syncUploads = 0;
+  o->streamEncoded = 0;
+  o->textureBudget = 0;
+  o->srgb = 0;
+  o->mipStream = 0;
+  o->textureReuse = 0;
+  o->asyncLoad = 0;
+  o->scene = NULL;
+  o->gpuCull = 0;
+  o->validateCull = 0;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--headless")) {
+      o->headless = 1;
+    }
+    else if(!strcmp(argv[i], "--frames") && i + 1 < argc) {
+      o->frames = (unsigned int) atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--out") && i + 1 < argc) {
+      o->out = argv[++i];
+    }
+    else if(!strcmp(argv[i], "--capture") && i + 1 < argc) {
+      o->capture = argv[++i];
+    }
+    else if(!strcmp(argv[i], "--vertex-format") && i + 1 < argc) {
+      i++;
+      o->vertexFormat = !strcmp(argv[i], "float") ? VERTEX_FLOAT32 : !strcmp(argv[i], "half") ? VERTEX_FLOAT16 : VERTEX_SNORM16;
+    }
+    else if(!strcmp(argv[i], "--draw") && i + 1 < argc) {
+      i++;
+      o->draw = !strcmp(argv[i], "indirect") ? DRAW_INDIRECT : !strcmp(argv[i], "fallback") ? DRAW_FALLBACK
+          : !strcmp(argv[i], "pull") ? DRAW_PULL : DRAW_CLASSIC;
+    }
+    else if(!strcmp(argv[i], "--sort")) {
+      o->sort = 1;
+    }
+    else if(!strcmp(argv[i], "--prepass")) {
+      o->prepass = 1;
+    }
+    else if(!strcmp(argv[i], "--overdraw")) {
+      o->overdraw = 1;
+    }
+    else if(!strcmp(argv[i], "--occlusion")) {
+      o->occlusion = 1;
+    }
+    else if(!strcmp(argv[i], "--lod")) {
+      o->lod = 1;
+    }
+    else if(!strcmp(argv[i], "--terrain")) {
+      o->terrain = 1;
+    }
+    else if(!strcmp(argv[i], "--voxels")) {
+      o->voxels = 1;
+    }
+    else if(!strcmp(argv[i], "--shapes") && i + 1 < argc) {
+      o->shapes = (unsigned int) atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--sprites") && i + 1 < argc) {
+      o->sprites = (unsigned int) atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--sprite-atlas")) {
+      o->spriteAtlas = 1;
+    }
+    else if(!strcmp(argv[i], "--stream-textures") && i + 1 < argc) {
+      o->streamTextures = (unsigned int) atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--sync-uploads")) {
+      o->syncUploads = 1;
+    }
+    else if(!strcmp(argv[i], "--stream-encoded")) {
+      o->streamEncoded = 1;
+    }
+    else if(!strcmp(argv[i], "--texture-budget") && i + 1 < argc) {
+      o->textureBudget = (unsigned int) atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--srgb")) {
+      o->srgb = 1;
+    }
+    else if(!strcmp(argv[i], "--mip-stream")) {
+      o->mipStream = 1;
+    }
+    else if(!strcmp(argv[i], "--texture-reuse")) {
+      o->textureReuse = 1;
+    }
+    else if(!strcmp(argv[i], "--async-load")) {
+      o->asyncLoad = 1;
+    }
+    else if(!strcmp(argv[i], "--scene") && i + 1 < argc) {
+      o->scene = argv[++i];
+    }
+    else if(!strcmp(argv[i], "--gpu-cull")) {
+      o->gpuCull = 1;
+    }
+    else if(!strcmp(argv[i], "--validate-cull")) {
+      o->gpuCull = 1;
+      o->validateCull = 1;
+    }
+    else {
+      printf("usage: LearnOpenGL [--headless] [--frames N] [--out dir] [--capture trace] [--vertex-format float|half|snorm16] [--draw classic|indirect|fallback|pull] [--sort] [--prepass] [--overdraw] [--occlusion] [--lod] [--terrain] [--voxels] [--shapes N] [--sprites N] [--sprite-atlas] [--stream-textures N] [--sync-uploads] [--stream-encoded] [--texture-budget KB] [--srgb] [--mip-stream] [--texture-reuse] [--async-load] [--scene file.scn] [--gpu-cull] [--validate-cull]\n");
+      exit(1);
+    }
+  }
+
+  // LOD levels are indexed meshes, only the mesh pool can draw them
+  if(o->lod && o->draw == DRAW_CLASSIC) {
+    o->draw = DRAW_INDIRECT;
+  }
+
+  // under a budget the residency manager loads, and reloads, the scene textures itself
+  if(o->asyncLoad && o->textureBudget) {
+    o->asyncLoad = 0;
+  }
+
+  // the compute pass fills the mesh pool's indirect draws and replaces all per-cube CPU work,
+  // sorting, LOD selection and occlusion culling included
+  if(o->gpuCull) {
+    o->draw = DRAW_INDIRECT;
+    o->sort = 0;
+    o->lod = 0;
+    o->occlusion = 0;
+  }
+}
+
+// writes a frame that came back from the offscreen framebuffer
+void writeFrame(void* user, unsigned int frame, const unsigned char* pixels, int width, int height) {
+  const char* dir = user;
+  if(!dir) {
+    return;
+  }
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%04u.ppm", dir, frame);
+  imageWritePPM(path, pixels, width, height, 1);
+}
+
+// reads back the overdraw pass, each fragment added OVERDRAW_STEP to the red channel
+void measureOverdraw(OverdrawStats* stats) {
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  int width = viewport[2];
+  int height = viewport[3];
+
+  unsigned char* red = malloc((size_t) width * height);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(viewport[0], viewport[1], width, height, GL_RED, GL_UNSIGNED_BYTE, red);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+  unsigned int step = (unsigned int) lroundf(OVERDRAW_STEP * 255.0f);
+  for(size_t i = 0; i < (size_t) width * height; i++) {
+    unsigned int fragments = (red[i] + step / 2) / step;
+    stats->fragments += fragments;
+    stats->covered += fragments > 0;
+  }
+  stats->pixels += (double) width * height;
+  stats->frames++;
+  free(red);
+}
+
+// one pass over the frame's cubes, models are already in submission order
+void drawCubes(Options* o, Shader* program, mat4 projection, mat4 view, unsigned int VAO, mat4* models, unsigned int count, DrawList* drawList, MeshPool* pool, GpuCull* cull) {
+  shaderUse(program);
+  shaderSetMatrix(program, "projection", projection);
+  shaderSetMatrix(program, "view", view);
+
+  if(o->gpuCull) {
+    gpuCullDraw(cull);
+    return;
+  }
+
+  if(o->draw != DRAW_CLASSIC) {
+    drawListDraw(drawList, pool);
+    return;
+  }
+
+  glBindVertexArray(VAO);
+  for(unsigned int i = 0; i < count; i++) {
+    shaderSetMatrix(program, "model", models[i]);
+
+    glDrawArrays(GL_TRIANGLES, 0, CUBE_VERTEX_COUNT);
+  }
+
+  glDrawArrays(GL_TRIANGLES, 0, CUBE_VERTEX_COUNT);
+}
+
+// world bounding sphere radius for the screen size decisions. a scene object's comes from its
+// stored bounds, which carry its scale, the hard-coded cubes all use the mesh's own radius
+float objectRadius(Options* o, Scene* scene, unsigned int object, float meshRadius) {
+  if(!o->scene) {
+    return meshRadius;
+  }
+  return 0.5f * glm_vec3_distance(scene->boundsMin[object], scene->boundsMax[object]);
+}
+
+// a deterministic field of drifting shapes, cycling circle, rounded rect, line
+void buildShapes(ShapeBatch* b, unsigned int count, float time) {
+  shapeBatchBegin(b);
+  for(unsigned int i = 0; i < count; i++) {
+    uint32_t h = i * 2654435761u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+
+    float phase = (h & 0xff) / 255.0f * 2.0f * GLM_PIf;
+    vec2 center = {
+      (float) ((h >> 8) % WINDOW_WIDTH) + 20.0f * sinf(time + phase),
+      (float) ((h >> 18) % WINDOW_HEIGHT) + 20.0f * cosf(time * 1.3f + phase)
+    };
+    float size = 2.0f + (float) ((h >> 4) & 7);
+    uint32_t color = SHAPE_RGBA(h & 0xff, (h >> 8) & 0xff, (h >> 16) & 0xff, 160);
+
+    if(i % 3 == 0) {
+      shapeCircle(b, center, size, color);
+    }
+    else if(i % 3 == 1) {
+      shapeRoundedRect(b, center, (vec2) {size * 1.5f, size}, size * 0.4f, time + phase, color);
+    }
+    else {
+      vec2 to = {center[0] + 3.0f * size * cosf(time + phase), center[1] + 3.0f * size * sinf(time + phase)};
+      shapeLine(b, center, to, 1.5f, color);
+    }
+  }
+}
+
+// sprites drift across the window and spin, alternating between the two images over four layers
+void buildSprites(SpriteBatch* b, SpriteRegion regions[2], unsigned int count, float time) {
+  spriteBatchBegin(b);
+  for(unsigned int i = 0; i < count; i++) {
+    uint32_t h = i * 2654435761u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+
+    float speed = 20.0f + (h & 63);
+    vec2 position = {
+      fmodf((float) ((h >> 6) % WINDOW_WIDTH) + speed * time, (float) WINDOW_WIDTH),
+      fmodf((float) ((h >> 16) % WINDOW_HEIGHT) + speed * 0.5f * time, (float) WINDOW_HEIGHT)
+    };
+
+    SpriteRegion* region = &regions[i & 1];
+    mat3 transform;
+    glm_translate2d_make(transform, position);
+    glm_rotate2d(transform, time * ((h >> 24) / 64.0f - 2.0f));
+    glm_scale2d_uni(transform, 16.0f / region->size[0]);
+
+    spriteBatchAdd(b, region, transform, i % 4, SPRITE_RGBA(255, 255, 255, 255));
+  }
+}
+
+// a smooth colour field with a fine checker on top, big enough that the upload cost dominates
+unsigned char* buildStreamPixels(int size) {
+  unsigned char* pixels = malloc((size_t) size * size * 4);
+  for(int y = 0; y < size; y++) {
+    for(int x = 0; x < size; x++) {
+      unsigned char* p = pixels + ((size_t) y * size + x) * 4;
+      unsigned char checker = ((x >> 4) ^ (y >> 4)) & 1 ? 32 : 0;
+      p[0] = (unsigned char) (x * 223 / size + checker);
+      p[1] = (unsigned char) (y * 223 / size + checker);
+      p[2] = (unsigned char) ((x + y) * 111 / size + checker);
+      p[3] = 255;
+    }
+  }
+  return pixels;
+}
+
+// the whole of a loose file from the source tree, the caller frees it
+unsigned char* loadFile(const char* name, size_t* size) {
+  char path[256];
+  snprintf(path, sizeof(path), "../%s", name);
+  FILE* file = fopen(path, "rb");
+  if(!file) {
+    printf("ERROR::MAIN::FILE_NOT_READ: %s\n", path);
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  unsigned char* bytes = malloc(length);
+  *size = fread(bytes, 1, length, file);
+  fclose(file);
+  return bytes;
+}
+
+// RGBA pixels of a packed or loose image, for building atlases
+unsigned char* loadPixels(Pack* pack, const char* name, int* width, int* height) {
+  PackView v;
+  if(packFind(pack, name, &v) == 0) {
+    if(v.entry->type != PACK_ENTRY_PIXELS) {
+      return textureDecode(v.data, v.size, width, height, 0);
+    }
+
+    *width = v.entry->width;
+    *height = v.entry->height;
+    size_t pixelCount = (size_t) *width * *height;
+    unsigned char* pixels = malloc(pixelCount * 4);
+    unsigned int channels = v.entry->channels;
+    for(size_t i = 0; i < pixelCount; i++) {
+      const unsigned char* source = v.data + i * channels;
+      unsigned char* target = pixels + i * 4;
+      // gray fills the color channels, a second channel is alpha
+      if(channels <= 2) {
+        target[0] = target[1] = target[2] = source[0];
+        target[3] = channels == 2 ? source[1] : 255;
+      }
+      else {
+        for(unsigned int c = 0; c < 4; c++) {
+          target[c] = c < channels ? source[c] : 255;
+        }
+      }
+    }
+    return pixels;
+  }
+
+  size_t size;
+  unsigned char* bytes = loadFile(name, &size);
+  if(!bytes) {
+    return NULL;
+  }
+  unsigned char* pixels = textureDecode(bytes, size, width, height, 0);
+  free(bytes);
+  return pixels;
+}
+
+// reloads a demoted or evicted texture through the same lookup as the first load
+unsigned char* loadResidentPixels(void* user, const char* name, int* width, int* height) {
+  return loadPixels(user, name, width, height);
+}
+
 // handle when window size changes
 void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
   glViewport(0, 0, width, height);
@@ -22,7 +465,55 @@ void processInput(GLFWwindow *window) {
   }
 }
 
-int main() {
+// loads a shader from the archive when it is open, otherwise from the loose source tree
+void loadShader(Shader* s, Pack* pack, const char* vertexName, const char* fragmentName) {
+  PackView vertex, fragment;
+  if(packFind(pack, vertexName, &vertex) == 0 && packFind(pack, fragmentName, &fragment) == 0) {
+    shaderInitFromSource(s, (const char*) vertex.data, (int) vertex.size, (const char*) fragment.data, (int) fragment.size);
+    return;
+  }
+
+  char vertexPath[256], fragmentPath[256];
+  snprintf(vertexPath, sizeof(vertexPath), "../%s", vertexName);
+  snprintf(fragmentPath, sizeof(fragmentPath), "../%s", fragmentName);
+  shaderInit(s, vertexPath, fragmentPath);
+}
+
+// returns the shader's status, nonzero when it can not be read, compiled or linked
+int loadComputeShader(Shader* s, Pack* pack, const char* name) {
+  PackView compute;
+  if(packFind(pack, name, &compute) == 0) {
+    return shaderInitComputeFromSource(s, (const char*) compute.data, (int) compute.size);
+  }
+
+  char path[256];
+  snprintf(path, sizeof(path), "../%s", name);
+  return shaderInitCompute(s, path);
+}
+
+// loads a texture from the archive when it is open, otherwise from the loose source tree,
+// through the cache so the same image loaded twice shares one GL texture
+void loadTexture(Texture* t, TextureCache* cache, Pack* pack, unsigned int textureUnit, const char* name, int flip) {
+  PackView v;
+  if(packFind(pack, name, &v) == 0) {
+    if(v.entry->type == PACK_ENTRY_PIXELS) {
+      textureCacheLoadPixels(cache, t, textureUnit, v.data, v.entry->width, v.entry->height, v.entry->channels, flip);
+    }
+    else {
+      textureCacheLoadFromMemory(cache, t, textureUnit, v.data, v.size, flip);
+    }
+    return;
+  }
+
+  char path[256];
+  snprintf(path, sizeof(path), "../%s", name);
+  textureCacheLoad(cache, t, textureUnit, path, flip);
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  parseOptions(&options, argc, argv);
+
   // initalize the window
   glfwInit();
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -33,6 +524,13 @@ int main() {
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 
+  if(options.headless) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  }
+  if(options.srgb) {
+    glfwWindowHint(GLFW_SRGB_CAPABLE, GLFW_TRUE);
+  }
+
   GLFWwindow* window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "LearnOpenGL", NULL, NULL);
   if (window == NULL) {
     printf("Failed to create GLFW window\n");
@@ -46,142 +544,931 @@ int main() {
     printf("Failed to initialize GLAD\n");
     return -1;
   }
+  glextLoad((GLADloadproc) glfwGetProcAddress);
+  if(options.draw == DRAW_PULL && !glext.vertexPulling) {
+    printf("vertex pulling needs GL 4.3, drawing with --draw indirect instead\n");
+    options.draw = DRAW_INDIRECT;
+  }
+  if(options.gpuCull && !(glext.computeShaders && glext.multiDrawIndirect)) {
+    printf("gpu culling needs GL 4.3, drawing every cube instead\n");
+    options.gpuCull = 0;
+    options.validateCull = 0;
+  }
   glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
 
-  Shader s;
-  shaderInit(&s, "../src/VS", "../src/FS");
+  if(options.capture) {
+    captureBegin(options.capture);
+  }
+
+  // GL objects main owns directly, deleted once the GPU is done with the last frame that used them
+  ResourceRegistry resources;
+  resourceRegistryInit(&resources);
+  ResourceHandle programHandles[8] = {0};
+
+  // built by the `pack` target, mapped once and read in place
+  Pack pack;
+  packOpen(&pack, "assets.pack");
+
+  // every object of a scene file is drawn as a cube, its arrays are used in place out of the mapping
+  Scene scene;
+  vec3* positions = cubePositions;
+  unsigned int positionCount = CUBE_POSITION_COUNT;
+  if(options.scene) {
+    double sceneStart = timingNow();
+    if(sceneOpen(&scene, options.scene) == 0) {
+      positions = scene.positions;
+      positionCount = scene.objectCount;
+      printf("scene: %u objects, %u meshes, %u materials, mapped in %.3f ms\n", scene.objectCount, scene.meshCount,
+          scene.materialCount, (timingNow() - sceneStart) * 1000.0);
+    }
+    else {
+      options.scene = NULL;
+    }
+  }
+
+  // the pooled paths fetch transforms from a per-draw attribute instead of a uniform,
+  // the pulled path fetches those and the vertices themselves from storage buffers
+  const char* vertexName = options.draw == DRAW_CLASSIC ? "src/VS" : options.draw == DRAW_PULL ? "src/VS_pull" : "src/VS_indirect";
+
+  // loaded in the background instead when asyncLoad is set, the cubes are skipped until it arrives
+  Shader s = {0};
+  if(!options.asyncLoad) {
+    loadShader(&s, &pack, vertexName, "src/FS");
+    programHandles[0] = resourceCreate(&resources, RESOURCE_PROGRAM, s.ID, "cube program");
+  }
+
+  Shader depthShader, overdrawShader;
+  if(options.prepass) {
+    loadShader(&depthShader, &pack, vertexName, "src/FS_depth");
+    programHandles[1] = resourceCreate(&resources, RESOURCE_PROGRAM, depthShader.ID, "depth program");
+  }
+  if(options.overdraw) {
+    loadShader(&overdrawShader, &pack, vertexName, "src/FS_overdraw");
+    programHandles[2] = resourceCreate(&resources, RESOURCE_PROGRAM, overdrawShader.ID, "overdraw program");
+    shaderUse(&overdrawShader);
+    shaderSetFloat(&overdrawShader, "overdrawStep", OVERDRAW_STEP);
+  }
+
+  // terrain chunks carry their transform in the model uniform, so they always draw with src/VS
+  Shader terrainShader;
+  if(options.terrain && options.draw != DRAW_CLASSIC) {
+    loadShader(&terrainShader, &pack, "src/VS", "src/FS");
+    programHandles[3] = resourceCreate(&resources, RESOURCE_PROGRAM, terrainShader.ID, "terrain program");
+    shaderUse(&terrainShader);
+    shaderSetInt(&terrainShader, "texture1", 0);
+    shaderSetInt(&terrainShader, "texture2", 1);
+  }
+  Shader* terrainProgram = options.draw == DRAW_CLASSIC ? &s : &terrainShader;
+
+  Shader voxelShader;
+  if(options.voxels) {
+    loadShader(&voxelShader, &pack, "src/VS_voxel", "src/FS_voxel");
+    programHandles[4] = resourceCreate(&resources, RESOURCE_PROGRAM, voxelShader.ID, "voxel program");
+    shaderUse(&voxelShader);
+    shaderSetInt(&voxelShader, "texture1", 0);
+    shaderSetInt(&voxelShader, "texture2", 1);
+  }
+
+  Shader shapeShader;
+  ShapeBatch shapes;
+  Timing shapeBuildTimes, shapeSubmitTimes;
+  timingInit(&shapeBuildTimes);
+  timingInit(&shapeSubmitTimes);
+  if(options.shapes) {
+    loadShader(&shapeShader, &pack, "src/VS_shapes", "src/FS_shapes");
+    programHandles[5] = resourceCreate(&resources, RESOURCE_PROGRAM, shapeShader.ID, "shape program");
+    shapeBatchInit(&shapes, options.shapes);
+  }
+
+  textureSetSRGB(options.srgb);
 
-  Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  // under a budget the scene textures belong to the residency manager, which demotes them while unused
+  TextureResidency residency;
+  TextureCache textureCache;
+  int containerHandle = -1, smileyHandle = -1;
+  Texture container = {0}, smiley = {0};
+  if(options.textureBudget) {
+    textureResidencyInit(&residency, (size_t) options.textureBudget * 1024, loadResidentPixels, &pack);
+    containerHandle = textureResidencyAdd(&residency, "assets/container.jpg", GL_TEXTURE0, 0);
+    smileyHandle = textureResidencyAdd(&residency, "assets/awesomeface.png", GL_TEXTURE1, 1);
+    if(containerHandle >= 0) {
+      container = *textureResidencyGet(&residency, containerHandle);
+    }
+    if(smileyHandle >= 0) {
+      smiley = *textureResidencyGet(&residency, smileyHandle);
+    }
+  }
+  else if(!options.asyncLoad) {
+    textureCacheInit(&textureCache, TEXTURE_CACHE_PIXEL_BUDGET);
+    loadTexture(&container, &textureCache, &pack, GL_TEXTURE0, "assets/container.jpg", 0);
+    loadTexture(&smiley, &textureCache, &pack, GL_TEXTURE1, "assets/awesomeface.png", 1);
+    textureReport(&container, "container texture");
+    textureReport(&smiley, "smiley texture");
+
+    // the same bytes under another path share the texture, and once the last reference is
+    // released the next load recreates it from the cached pixels instead of decoding again
+    if(options.textureReuse) {
+      Texture again;
+      loadTexture(&again, &textureCache, &pack, GL_TEXTURE0, "assets/../assets/container.jpg", 0);
+      printf("texture cache: container under another path %s texture %u\n", again.ID == container.ID ? "shares" : "does not share", container.ID);
+      textureCacheRelease(&textureCache, &again);
+
+      unsigned long long pixelHits = textureCache.stats.pixelHits;
+      textureCacheRelease(&textureCache, &container);
+      loadTexture(&container, &textureCache, &pack, GL_TEXTURE0, "assets/container.jpg", 0);
+      printf("texture cache: container released and loaded again %s\n", textureCache.stats.pixelHits > pixelHits ? "from cached pixels" : "with a decode");
+    }
+  }
 
-  Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1, 1);
+  // sprites come from the cube textures directly or from an atlas holding both images
+  Shader spriteShader;
+  SpriteBatch sprites;
+  SpriteAtlas atlas;
+  SpriteRegion spriteRegions[2] = {0};
+  int spriteWhole[2] = {1, 1}; // regions drawn from the whole texture, without an atlas or when adding to it failed
+  Timing spriteAnimateTimes, spriteSortTimes, spriteWriteTimes, spriteSubmitTimes;
+  timingInit(&spriteAnimateTimes);
+  timingInit(&spriteSortTimes);
+  timingInit(&spriteWriteTimes);
+  timingInit(&spriteSubmitTimes);
+  unsigned long long spriteDraws = 0;
+  if(options.sprites) {
+    loadShader(&spriteShader, &pack, "src/VS_sprite", "src/FS_sprite");
+    programHandles[6] = resourceCreate(&resources, RESOURCE_PROGRAM, spriteShader.ID, "sprite program");
+    spriteBatchInit(&sprites, options.sprites);
+
+    if(options.spriteAtlas) {
+      spriteAtlasInit(&atlas, 1024, 1024);
+      const char* names[2] = {"assets/container.jpg", "assets/awesomeface.png"};
+      for(int i = 0; i < 2; i++) {
+        int width, height;
+        unsigned char* pixels = loadPixels(&pack, names[i], &width, &height);
+        if(pixels) {
+          spriteWhole[i] = spriteAtlasAdd(&atlas, pixels, width, height, &spriteRegions[i]) != 0;
+          free(pixels);
+        }
+      }
+    }
+
+    if(spriteWhole[0]) {
+      spriteRegionWhole(&spriteRegions[0], container.ID, 16, 16);
+    }
+    if(spriteWhole[1]) {
+      spriteRegionWhole(&spriteRegions[1], smiley.ID, 16, 16);
+
+      // the smiley was flipped for the bottom-up cube UVs, sprites run top-down
+      spriteRegions[1].uv[1] = 1.0f;
+      spriteRegions[1].uv[3] = 0.0f;
+    }
+  }
 
   Camera c;
   cameraInit(&c, window);
-  
-  float vertices[] = {
-    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
-     0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
-     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
-    -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
-
-    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
-     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
-     0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
-    -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
-    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-
-    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-    -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-    -0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-
-     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-     0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-     0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-
-    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-     0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
-     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
-     0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
-    -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-    -0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-
-    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
-     0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-     0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-    -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
-    -0.5f,  0.5f, -0.5f,  0.0f, 1.0f
-  };
 
+  // transient per-frame memory, double-buffered so the next frame can read this frame's results
+  FrameArena frameArena;
+  frameArenaInit(&frameArena, 1, 1024 * 1024 + (size_t) positionCount * 128, 1);
+  
   unsigned int VBO, VAO;
 
   glGenVertexArrays(1, &VAO);
   glGenBuffers(1, &VBO);
+  ResourceHandle cubeHandles[2] = {
+    resourceCreate(&resources, RESOURCE_VERTEX_ARRAY, VAO, "cube vertex array"),
+    resourceCreate(&resources, RESOURCE_BUFFER, VBO, "cube vertices"),
+  };
 
   glBindVertexArray(VAO);
 
   glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
 
-  // specify position for coordinates
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) 0);
-  glEnableVertexAttribArray(0);
+  // quantize the cube into the requested layout, attribute setup comes from the format descriptor
+  VertexFormat format;
+  vertexFormatInit(&format);
+  if(options.vertexFormat == VERTEX_FLOAT16) {
+    vertexFormatAdd(&format, 0, VERTEX_POSITION, VERTEX_FLOAT16, 3, 0);
+    vertexFormatAdd(&format, 1, VERTEX_TEXCOORD, VERTEX_FLOAT16, 2, 3);
+  }
+  else if(options.vertexFormat == VERTEX_SNORM16) {
+    vertexFormatAdd(&format, 0, VERTEX_POSITION, VERTEX_SNORM16, 3, 0);
+    vertexFormatAdd(&format, 1, VERTEX_TEXCOORD, VERTEX_UNORM16, 2, 3);
+  }
+  else {
+    vertexFormatAdd(&format, 0, VERTEX_POSITION, VERTEX_FLOAT32, 3, 0);
+    vertexFormatAdd(&format, 1, VERTEX_TEXCOORD, VERTEX_FLOAT32, 2, 3);
+  }
+
+  unsigned char packedVertices[sizeof(cubeVertices)];
+  VertexPackReport packReport;
+  size_t packedSize = vertexPack(&format, cubeVertices, CUBE_VERTEX_STRIDE, CUBE_VERTEX_COUNT, packedVertices, &packReport);
+  vertexPackReportPrint(&packReport, "cube vertices");
 
-  // specify position for texture coordinates
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*) (3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
+  glBufferData(GL_ARRAY_BUFFER, packedSize, packedVertices, GL_STATIC_DRAW);
+  vertexFormatApply(&format);
 
-  shaderUse(&s);
-  shaderSetInt(&s, "texture1", 0);
-  shaderSetInt(&s, "texture2", 1);
+  // the pooled path draws the same cube out of shared buffers with per-draw transforms
+  MeshPool meshPool;
+  Mesh cubeMesh;
+  DrawList drawList;
+  if(options.draw != DRAW_CLASSIC) {
+    meshPoolInit(&meshPool, &format, 64 * 1024, 256 * 1024);
+    meshPoolAdd(&meshPool, cubeVertices, CUBE_VERTEX_STRIDE, CUBE_VERTEX_COUNT, NULL, 0, &cubeMesh, NULL);
+
+    drawListInit(&drawList, &meshPool, positionCount > 256 ? positionCount : 256, options.draw != DRAW_FALLBACK, options.draw == DRAW_PULL);
+    printf("mesh pool: %u vertices, %u indices, %s\n", meshPool.vertexCount, meshPool.indexCount,
+        drawList.pull ? (drawList.indirect ? "vertex pulling, glMultiDrawArraysIndirect" : "vertex pulling, draw loop")
+        : drawList.indirect ? "glMultiDrawElementsIndirect" : "GL 3.3 draw loop");
+  }
+
+  // the cubes never move, so their bounds and transforms go up once and each frame is one dispatch
+  Shader cullShader;
+  GpuCull gpuCull;
+  cullShader.ID = 0;
+  if(options.gpuCull && (loadComputeShader(&cullShader, &pack, "src/CS_cull") != 0 || gpuCullInit(&gpuCull, &meshPool, &cullShader, positionCount) != 0)) {
+    printf("gpu culling has no working cull program, drawing every cube instead\n");
+    glDeleteProgram(cullShader.ID);
+    options.gpuCull = 0;
+    options.validateCull = 0;
+  }
+  if(options.gpuCull) {
+    programHandles[7] = resourceCreate(&resources, RESOURCE_PROGRAM, cullShader.ID, "cull program");
+
+    GpuCullObject* objects = calloc(positionCount, sizeof(GpuCullObject));
+    mat4* transforms = malloc(positionCount * sizeof(mat4));
+    for(unsigned int i = 0; i < positionCount; i++) {
+      mat4 model;
+      if(options.scene) {
+        glm_vec3_copy(scene.boundsMin[i], objects[i].boundsMin);
+        glm_vec3_copy(scene.boundsMax[i], objects[i].boundsMax);
+        sceneModel(&scene, i, model);
+      }
+      else {
+        glm_vec3_subs(positions[i], 0.5f, objects[i].boundsMin);
+        glm_vec3_adds(positions[i], 0.5f, objects[i].boundsMax);
+        glm_translate_make(model, positions[i]);
+      }
+      glm_mat4_mul(model, cubeMesh.dequantize, transforms[i]);
+      objects[i].count = cubeMesh.indexCount;
+      objects[i].firstIndex = cubeMesh.firstIndex;
+      objects[i].baseVertex = (int) cubeMesh.baseVertex;
+    }
+    gpuCullSetObjects(&gpuCull, objects, transforms, positionCount);
+    free(objects);
+    free(transforms);
+  }
+
+  // rounded cube levels written by the `lod` target, selected per cube by projected size
+  Lod lod;
+  Mesh lodMeshes[LOD_MAX_LEVELS];
+  unsigned int* lodLevels = calloc(positionCount, sizeof(unsigned int));
+  LodFile lodFile;
+  if(options.lod && lodFileRead(&lodFile, "cube.lod") == 0) {
+    lodInit(&lod, &lodFile, 0.1f);
+    for(unsigned int i = 0; i < lod.levelCount; i++) {
+      LodFileLevel* level = &lodFile.header.levels[i];
+      meshPoolAdd(&meshPool, lodFileVertices(&lodFile, i), lodFile.header.stride, level->vertexCount,
+          lodFileIndices(&lodFile, i), level->indexCount, &lodMeshes[i], NULL);
+    }
+    lodFileFree(&lodFile);
+  }
+  else {
+    options.lod = 0;
+  }
+
+  // a background loaded material binds its own samplers once it links
+  if(!options.asyncLoad) {
+    shaderUse(&s);
+    shaderSetInt(&s, "texture1", 0);
+    shaderSetInt(&s, "texture2", 1);
+  }
 
   glEnable(GL_DEPTH_TEST);
+  if(options.srgb) {
+    glEnable(GL_FRAMEBUFFER_SRGB);
+  }
 
   unsigned int modelLoc, projectionLoc, viewLoc;
 
-  vec3 cubePositions[] = {
-    {0.0f,  0.0f,  0.0f}, 
-    {2.0f,  5.0f, -15.0f}, 
-    {-1.5f, -2.2f, -2.5f},  
-    {-3.8f, -2.0f, -12.3f},  
-    { 2.4f, -0.4f, -3.5f},  
-    {-1.7f,  3.0f, -7.5f},  
-    { 1.3f, -2.0f, -2.5f},  
-    { 1.5f,  2.0f, -2.5f}, 
-    { 1.5f,  0.2f, -1.5f}, 
-    {-1.3f,  1.0f, -1.5f}  
-  };
-
-  for(unsigned int i = 0; i < 10; i++) {
-    mat4 model = GLM_MAT4_IDENTITY;
-    glm_translate_make(model, cubePositions[i]);
+  for(unsigned int i = 0; i < positionCount && !options.asyncLoad; i++) {
+    mat4 model = GLM_MAT4_IDENTITY_INIT;
+    glm_translate_make(model, positions[i]);
     shaderSetMatrix(&s, "model", model);
   }
 
-  while(!glfwWindowShouldClose(window)) {
-    processInput(window);
-    cameraProcessKeys(&c, window);
+  // headless runs render into an FBO and read every frame back through PBOs
+  Offscreen offscreen;
+  Timing frameTimes;
+  timingInit(&frameTimes);
+  // CPU time to build, upload and submit every cube pass, compares the --draw paths
+  Timing cubeSubmitTimes;
+  timingInit(&cubeSubmitTimes);
+  if(options.headless) {
+    offscreenInit(&offscreen, WINDOW_WIDTH, WINDOW_HEIGHT, options.srgb);
+    if(options.out) {
+      mkdir(options.out, 0755);
+    }
+  }
 
-    mat4 projection = GLM_MAT4_IDENTITY;
+  OverdrawStats overdraw = {0};
+  unsigned long long trianglesSubmitted = 0;
+
+  // every cube is both an occluder and a candidate, a box never hides itself
+  Occlusion occlusion;
+  unsigned long long cubesCulled = 0;
+  if(options.occlusion) {
+    occlusionInit(&occlusion, OCCLUSION_WIDTH, OCCLUSION_HEIGHT, (unsigned int) sysconf(_SC_NPROCESSORS_ONLN));
+  }
+
+  // chunks are generated on the pool workers while the main thread renders
+  Jobs jobs;
+  Terrain terrain;
+  int asyncUploads = options.streamTextures && !options.syncUploads;
+  if(options.terrain || asyncUploads || options.mipStream || options.asyncLoad) {
+    jobsInit(&jobs, (unsigned int) sysconf(_SC_NPROCESSORS_ONLN));
+  }
+  if(options.terrain) {
+    terrainInit(&terrain, &jobs, TERRAIN_VIEW_RADIUS, TERRAIN_UPLOAD_BUDGET);
+  }
+
+  // streamed textures share one generated image, workers read it while decoding into the pixel buffers.
+  // with --stream-encoded they share the container's encoded bytes, kept in the pack or read once
+  TextureUploader uploader;
+  Texture* streamed = NULL;
+  ResourceHandle* streamedHandles = NULL;
+  unsigned int streamedRetired = 0; // textures before this one were replaced and handed back to the registry
+  unsigned char* streamPixels = NULL;
+  const unsigned char* streamBytes = NULL;
+  unsigned char* streamFile = NULL;
+  size_t streamSize = 0;
+  double syncStallMs = 0.0;
+  if(options.streamTextures) {
+    streamed = calloc(options.streamTextures, sizeof(Texture));
+    streamedHandles = calloc(options.streamTextures, sizeof(ResourceHandle));
+    if(options.streamEncoded) {
+      PackView v;
+      if(packFind(&pack, "assets/container.jpg", &v) == 0 && v.entry->type != PACK_ENTRY_PIXELS) {
+        streamBytes = v.data;
+        streamSize = v.size;
+      }
+      else {
+        streamFile = loadFile("assets/container.jpg", &streamSize);
+        streamBytes = streamFile;
+      }
+    }
+    else {
+      streamPixels = buildStreamPixels(STREAM_TEXTURE_SIZE);
+    }
+  }
+  if(asyncUploads) {
+    textureUploaderInit(&uploader, &jobs, STREAM_UPLOAD_BUDGET);
+  }
+
+  // takes over texture unit 0 from the container, its chain is built on a worker
+  MipStreamer mipStreamer;
+  int mipHandle = -1;
+  unsigned int mipNearest = 0; // the nearest cube found so far and where the sweep for a nearer one continues
+  unsigned int mipSweep = 0;
+  if(options.mipStream) {
+    mipStreamInit(&mipStreamer, &jobs, 1, MIP_STREAM_BUDGET);
+    mipHandle = mipStreamAdd(&mipStreamer, GL_TEXTURE0, buildStreamPixels(STREAM_TEXTURE_SIZE), STREAM_TEXTURE_SIZE, STREAM_TEXTURE_SIZE);
+  }
+
+  // shader and textures are read on the loader's I/O thread and decoded on the pool, the material waits on all three
+  AssetLoader assets;
+  int cubeMaterial = -1;
+  int sceneReady = !options.asyncLoad;
+  if(options.asyncLoad) {
+    assetLoaderInit(&assets, &jobs, &pack, "../", 8, ASSET_UPLOAD_BUDGET_MS);
+    int textures[2] = {
+      assetLoadTexture(&assets, "assets/container.jpg", GL_TEXTURE0, 0),
+      assetLoadTexture(&assets, "assets/awesomeface.png", GL_TEXTURE1, 1),
+    };
+    const char* samplers[2] = {"texture1", "texture2"};
+    cubeMaterial = assetLoadMaterial(&assets, assetLoadShader(&assets, vertexName, "src/FS"), textures, samplers, 2);
+  }
+
+  VoxelWorld voxels;
+  VoxelRenderer voxelRenderer;
+  Timing remeshTimes;
+  timingInit(&remeshTimes);
+  if(options.voxels) {
+    voxelWorldInit(&voxels, VOXEL_WORLD_CHUNKS, VOXEL_WORLD_HEIGHT, VOXEL_WORLD_CHUNKS);
+    voxelWorldGenerate(&voxels);
+    voxelRendererInit(&voxelRenderer, &voxels);
+  }
+  uint32_t digSeed = 2463534242u;
+
+  // overdraw mode and the atlas never sample the scene textures, everything else does
+  int sceneTexturesUsed = !options.overdraw || options.terrain || options.voxels || (options.sprites && !options.spriteAtlas);
+
+  unsigned int frame = 0;
+  double frameStart = timingNow();
+  double runStart = frameStart;
+
+  while(options.headless ? frame < options.frames : !glfwWindowShouldClose(window)) {
+    frameArenaBegin(&frameArena);
+
+    if(options.textureBudget) {
+      textureResidencyUpdate(&residency);
+      if(sceneTexturesUsed && containerHandle >= 0 && !options.mipStream) {
+        textureResidencyUse(&residency, containerHandle);
+      }
+      if(sceneTexturesUsed && smileyHandle >= 0) {
+        textureResidencyUse(&residency, smileyHandle);
+      }
+    }
+
+    if(options.headless) {
+      if(options.terrain) {
+        cameraFlyPath(&c, (float) frame / (float) options.frames, TERRAIN_FLY_DISTANCE);
+      }
+      else {
+        cameraFollowPath(&c, (float) frame / (float) options.frames);
+      }
+      offscreenBind(&offscreen);
+    }
+    else {
+      processInput(window);
+      cameraProcessKeys(&c, window);
+    }
+
+    if(options.terrain) {
+      terrainUpdate(&terrain, c.cameraPos);
+    }
+
+    if(frame < options.streamTextures && (streamPixels || streamBytes)) {
+      if(options.syncUploads) {
+        double uploadStart = timingNow();
+        if(streamBytes) {
+          textureInitFromMemory(&streamed[frame], GL_TEXTURE3, streamBytes, streamSize, 0);
+        }
+        else {
+          textureInitFromPixels(&streamed[frame], GL_TEXTURE3, streamPixels, STREAM_TEXTURE_SIZE, STREAM_TEXTURE_SIZE, 4, 0);
+        }
+        syncStallMs += (timingNow() - uploadStart) * 1000.0;
+      }
+      else if(streamBytes) {
+        textureUploaderRequest(&uploader, &streamed[frame], GL_TEXTURE3, streamBytes, streamSize, 0);
+      }
+      else {
+        textureUploaderRequestPixels(&uploader, &streamed[frame], GL_TEXTURE3, streamPixels, STREAM_TEXTURE_SIZE, STREAM_TEXTURE_SIZE, 4, 0);
+      }
+      streamedHandles[frame] = resourceCreate(&resources, RESOURCE_TEXTURE, streamed[frame].ID, "streamed texture");
+    }
+    if(asyncUploads) {
+      textureUploaderUpdate(&uploader);
+    }
+
+    // only the newest streamed texture stays bound, older ones go once their copy is queued.
+    // the copy may still be in flight, so the delete waits for this frame's fence
+    unsigned int streamedCount = frame < options.streamTextures ? frame + 1 : options.streamTextures;
+    while(streamedRetired + 1 < streamedCount && !(asyncUploads && textureUploaderPending(&uploader, streamed[streamedRetired].ID))) {
+      resourceUse(&resources, streamedHandles[streamedRetired]);
+      resourceDestroy(&resources, streamedHandles[streamedRetired]);
+      streamedRetired++;
+    }
+
+    if(options.asyncLoad) {
+      assetLoaderUpdate(&assets);
+      if(!sceneReady && cubeMaterial >= 0 && assetStage(&assets, cubeMaterial) == ASSET_READY) {
+        Asset* material = &assets.assets[cubeMaterial];
+        s = *assetShader(&assets, material->dependencies[0]);
+        container = *assetTexture(&assets, material->dependencies[1]);
+        smiley = *assetTexture(&assets, material->dependencies[2]);
+        if(options.sprites) {
+          spriteRegions[0].texture = spriteWhole[0] ? container.ID : spriteRegions[0].texture;
+          spriteRegions[1].texture = spriteWhole[1] ? smiley.ID : spriteRegions[1].texture;
+        }
+
+        // the container upload took unit 0 back from the streamed texture
+        if(mipHandle >= 0) {
+          Texture* streamedTexture = mipStreamTexture(&mipStreamer, mipHandle);
+          glActiveTexture(streamedTexture->textureUnit);
+          glBindTexture(GL_TEXTURE_2D, streamedTexture->ID);
+        }
+        sceneReady = 1;
+        printf("assets: cube material ready on frame %u\n", frame);
+      }
+    }
+
+    // dig out the top voxel of a random column, only the slices around it are remeshed
+    if(options.voxels) {
+      double remeshStart = timingNow();
+      if(frame > 0) {
+        int size = VOXEL_WORLD_CHUNKS * VOXEL_CHUNK_SIZE;
+        digSeed ^= digSeed << 13;
+        digSeed ^= digSeed >> 17;
+        digSeed ^= digSeed << 5;
+        int x = (int) (digSeed % (uint32_t) size);
+        int z = (int) ((digSeed >> 16) % (uint32_t) size);
+        int y = VOXEL_WORLD_HEIGHT * VOXEL_CHUNK_SIZE - 1;
+        while(y > 0 && !voxelWorldGet(&voxels, x, y, z)) {
+          y--;
+        }
+        voxelWorldSet(&voxels, x, y, z, VOXEL_EMPTY);
+      }
+      for(int cz = 0; cz < voxels.sizeZ; cz++) {
+        for(int cy = 0; cy < voxels.sizeY; cy++) {
+          for(int cx = 0; cx < voxels.sizeX; cx++) {
+            voxelChunkMesh(&voxels, cx, cy, cz);
+          }
+        }
+      }
+      voxelRendererUpload(&voxelRenderer, &voxels);
+      timingAdd(&remeshTimes, (timingNow() - remeshStart) * 1000.0);
+    }
+
+    mat4 projection = GLM_MAT4_IDENTITY_INIT;
     glm_perspective(glm_rad(c.fov), (float) WINDOW_WIDTH / (float) WINDOW_HEIGHT, 0.1f, 100.0f, projection); 
-    shaderSetMatrix(&s, "projection", projection);
 
     mat4 view;
     cameraCustomLookAt(&c, view);
-    shaderSetMatrix(&s, "view", view);
 
     glClearColor(0.0f, 0.0f, 0.0f,1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    for(unsigned int i = 0; i < 10; i++) {
-      mat4 model = GLM_MAT4_IDENTITY;
-      glm_translate_make(model, cubePositions[i]);
-      shaderSetMatrix(&s, "model", model);
+    uint32_t* order = frameArenaAlloc(&frameArena, 0, positionCount * sizeof(uint32_t));
+    unsigned int drawCount = 0;
+    if(options.occlusion) {
+      // a scene file carries world bounds already, the hard-coded cubes are unit boxes around their positions
+      vec3* minimums = options.scene ? scene.boundsMin : frameArenaAlloc(&frameArena, 0, positionCount * sizeof(vec3));
+      vec3* maximums = options.scene ? scene.boundsMax : frameArenaAlloc(&frameArena, 0, positionCount * sizeof(vec3));
+      unsigned char* visible = frameArenaAlloc(&frameArena, 0, positionCount);
+
+      mat4 viewProjection;
+      glm_mat4_mul(projection, view, viewProjection);
+      occlusionBegin(&occlusion, viewProjection);
+      for(unsigned int i = 0; i < positionCount; i++) {
+        if(!options.scene) {
+          glm_vec3_subs(positions[i], 0.5f, minimums[i]);
+          glm_vec3_adds(positions[i], 0.5f, maximums[i]);
+        }
+        occlusionAddOccluder(&occlusion, minimums[i], maximums[i]);
+      }
+      occlusionRasterize(&occlusion);
+      occlusionCull(&occlusion, minimums, maximums, positionCount, visible);
 
-      glDrawArrays(GL_TRIANGLES, 0, 36);
+      for(unsigned int i = 0; i < positionCount; i++) {
+        if(visible[i]) {
+          order[drawCount++] = i;
+        }
+      }
+      cubesCulled += positionCount - drawCount;
+    }
+    else if(!options.gpuCull) {
+      for(unsigned int i = 0; i < positionCount; i++) {
+        order[drawCount++] = i;
+      }
     }
 
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    // front-to-back so early depth testing rejects the fragments of cubes hidden behind nearer ones
+    if(options.sort) {
+      float* depths = frameArenaAlloc(&frameArena, 0, drawCount * sizeof(float));
+      uint32_t* sorted = frameArenaAlloc(&frameArena, 0, drawCount * sizeof(uint32_t));
+      uint32_t* scratch = frameArenaAlloc(&frameArena, 0, 3 * drawCount * sizeof(uint32_t));
+      for(unsigned int i = 0; i < drawCount; i++) {
+        vec3 viewPosition;
+        glm_mat4_mulv3(view, positions[order[i]], 1.0f, viewPosition);
+        depths[i] = -viewPosition[2];
+      }
+      sortRadixFloat(depths, sorted, drawCount, scratch);
+      for(unsigned int i = 0; i < drawCount; i++) {
+        sorted[i] = order[sorted[i]];
+      }
+      order = sorted;
+    }
 
-    glfwSwapBuffers(window);
+    // the nearest cube decides how fine the streamed texture has to get. a front-to-back list starts
+    // with it, otherwise the last nearest is checked against a slice of the cubes that moves every frame
+    if(mipHandle >= 0) {
+      if(positionCount > 0) {
+        if(options.sort && drawCount > 0) {
+          mipNearest = order[0];
+        }
+        else {
+          float nearestDistance = glm_vec3_distance2(c.cameraPos, positions[mipNearest]);
+          for(unsigned int i = 0; i < MIP_STREAM_SWEEP && i < positionCount; i++) {
+            unsigned int cube = (mipSweep + i) % positionCount;
+            float distance = glm_vec3_distance2(c.cameraPos, positions[cube]);
+            if(distance < nearestDistance) {
+              mipNearest = cube;
+              nearestDistance = distance;
+            }
+          }
+          mipSweep = (mipSweep + MIP_STREAM_SWEEP) % positionCount;
+        }
+        float screenSize = lodProjectedSize(objectRadius(&options, &scene, mipNearest, CUBE_RADIUS), glm_vec3_distance(c.cameraPos, positions[mipNearest]), c.fov, (float) WINDOW_HEIGHT);
+        mipStreamSetScreenSize(&mipStreamer, mipHandle, screenSize);
+      }
+      mipStreamUpdate(&mipStreamer);
+    }
+
+    mat4* models = frameArenaAlloc(&frameArena, 0, drawCount * sizeof(mat4));
+    for(unsigned int i = 0; i < drawCount; i++) {
+      if(options.scene) {
+        sceneModel(&scene, order[i], models[i]);
+      }
+      else {
+        glm_translate_make(models[i], positions[order[i]]);
+      }
+    }
+
+    double cubeStart = timingNow();
+    if(options.draw == DRAW_CLASSIC) {
+      for(unsigned int i = 0; i < drawCount; i++) {
+        glm_mat4_mul(models[i], packReport.dequantize, models[i]);
+      }
+      trianglesSubmitted += (drawCount + 1) * CUBE_VERTEX_COUNT / 3;
+    }
+    else if(options.gpuCull) {
+      mat4 viewProjection;
+      glm_mat4_mul(projection, view, viewProjection);
+      gpuCullRun(&gpuCull, viewProjection);
+      if(options.validateCull) {
+        gpuCullValidate(&gpuCull);
+      }
+    }
+    else {
+      drawListReset(&drawList);
+      for(unsigned int i = 0; i < drawCount; i++) {
+        Mesh* mesh = &cubeMesh;
+        if(options.lod) {
+          unsigned int cube = order[i];
+          float size = lodProjectedSize(objectRadius(&options, &scene, cube, lod.radius), glm_vec3_distance(c.cameraPos, positions[cube]), c.fov, (float) WINDOW_HEIGHT);
+          lodLevels[cube] = lodSelect(&lod, lodLevels[cube], size);
+          mesh = &lodMeshes[lodLevels[cube]];
+        }
+        drawListAdd(&drawList, mesh, models[i]);
+        trianglesSubmitted += mesh->indexCount / 3;
+      }
+      drawListUpload(&drawList);
+    }
+
+    if(options.gpuCull) {
+      resourceUse(&resources, programHandles[7]);
+    }
+
+    if(options.prepass) {
+      glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+      drawCubes(&options, &depthShader, projection, view, VAO, models, drawCount, &drawList, &meshPool, &gpuCull);
+      resourceUse(&resources, programHandles[1]);
+      glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+      // depth is final, the shaded pass only needs to match it
+      glDepthFunc(GL_LEQUAL);
+      glDepthMask(GL_FALSE);
+    }
+
+    if(options.overdraw) {
+      // the fragment counts are read back raw, an sRGB encode would bend them
+      glDisable(GL_FRAMEBUFFER_SRGB);
+      glEnable(GL_BLEND);
+      glBlendFunc(GL_ONE, GL_ONE);
+      drawCubes(&options, &overdrawShader, projection, view, VAO, models, drawCount, &drawList, &meshPool, &gpuCull);
+      resourceUse(&resources, programHandles[2]);
+      glDisable(GL_BLEND);
+      measureOverdraw(&overdraw);
+      if(options.srgb) {
+        glEnable(GL_FRAMEBUFFER_SRGB);
+      }
+    }
+    else if(sceneReady) {
+      drawCubes(&options, &s, projection, view, VAO, models, drawCount, &drawList, &meshPool, &gpuCull);
+      resourceUse(&resources, programHandles[0]);
+    }
+    timingAdd(&cubeSubmitTimes, (timingNow() - cubeStart) * 1000.0);
+
+    if(options.prepass) {
+      glDepthFunc(GL_LESS);
+      glDepthMask(GL_TRUE);
+    }
+
+    if(options.terrain && (sceneReady || terrainProgram != &s)) {
+      shaderUse(terrainProgram);
+      shaderSetMatrix(terrainProgram, "projection", projection);
+      shaderSetMatrix(terrainProgram, "view", view);
+      terrainDraw(&terrain, terrainProgram);
+      resourceUse(&resources, terrainProgram == &s ? programHandles[0] : programHandles[3]);
+    }
+
+    if(options.voxels) {
+      shaderUse(&voxelShader);
+      shaderSetMatrix(&voxelShader, "projection", projection);
+      shaderSetMatrix(&voxelShader, "view", view);
+      voxelRendererDraw(&voxelRenderer, &voxels, &voxelShader, voxelOrigin);
+      resourceUse(&resources, programHandles[4]);
+    }
+
+    // the 2D overlay goes last, without depth, blended over the scene
+    if(options.shapes) {
+      double shapeStart = timingNow();
+      buildShapes(&shapes, options.shapes, frame / 60.0f);
+      double shapeBuilt = timingNow();
+      shapeBatchUpload(&shapes);
+
+      glDisable(GL_DEPTH_TEST);
+      glEnable(GL_BLEND);
+      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      shapeBatchDraw(&shapes, &shapeShader, WINDOW_WIDTH, WINDOW_HEIGHT);
+      resourceUse(&resources, programHandles[5]);
+      glDisable(GL_BLEND);
+      glEnable(GL_DEPTH_TEST);
+
+      timingAdd(&shapeBuildTimes, (shapeBuilt - shapeStart) * 1000.0);
+      timingAdd(&shapeSubmitTimes, (timingNow() - shapeBuilt) * 1000.0);
+    }
+
+    if(options.sprites) {
+      double spriteStart = timingNow();
+      buildSprites(&sprites, spriteRegions, options.sprites, frame / 60.0f);
+      timingAdd(&spriteAnimateTimes, (timingNow() - spriteStart) * 1000.0);
+
+      mat4 pixels;
+      glm_ortho(0.0f, (float) WINDOW_WIDTH, (float) WINDOW_HEIGHT, 0.0f, -1.0f, 1.0f, pixels);
+      glDisable(GL_DEPTH_TEST);
+      glEnable(GL_BLEND);
+      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      spriteBatchFlush(&sprites, &spriteShader, pixels);
+      resourceUse(&resources, programHandles[6]);
+      glDisable(GL_BLEND);
+      glEnable(GL_DEPTH_TEST);
+
+      timingAdd(&spriteSortTimes, sprites.stats.sortMs);
+      timingAdd(&spriteWriteTimes, sprites.stats.writeMs);
+      timingAdd(&spriteSubmitTimes, sprites.stats.submitMs);
+      spriteDraws += sprites.stats.draws;
+    }
+
+    if(options.headless) {
+      offscreenReadback(&offscreen, writeFrame, (void*) options.out);
+    }
+    else {
+      glfwSwapBuffers(window);
+    }
     glfwPollEvents();
+    captureFrame();
+
+    double frameEnd = timingNow();
+    timingAdd(&frameTimes, (frameEnd - frameStart) * 1000.0);
+    frameStart = frameEnd;
+
+    // programs were marked where they drew, the cube buffers are bound for every frame
+    resourceUse(&resources, cubeHandles[0]);
+    resourceUse(&resources, cubeHandles[1]);
+    resourceFrame(&resources);
+    frame++;
+  }
+
+  if(options.headless) {
+    offscreenFinish(&offscreen, writeFrame, (void*) options.out);
+    offscreenFree(&offscreen);
+    timingReport(&frameTimes, "frame time");
   }
+  timingFree(&frameTimes);
+  captureEnd();
 
-  // clean up
-  glDeleteVertexArrays(1, &VAO);
-  glDeleteBuffers(1, &VBO);
-  glDeleteProgram(s.ID);
+  if(options.gpuCull) {
+    // the compute pass decides what is drawn, its visible counts are read back on the frames they are ready
+    double visible = gpuCull.stats.sampledFrames ? (double) gpuCull.stats.visible / gpuCull.stats.sampledFrames : 0.0;
+    printf("triangles: %.0f submitted per frame, over %u frames with a visible count\n", visible * (cubeMesh.indexCount / 3), gpuCull.stats.sampledFrames);
+  }
+  else {
+    printf("triangles: %.0f submitted per frame\n", frame ? (double) trianglesSubmitted / frame : 0.0);
+  }
+  timingReport(&cubeSubmitTimes, "cube build and submit");
+  timingFree(&cubeSubmitTimes);
+
+  if(options.occlusion) {
+    printf("occlusion: %.2f of %u cubes culled per frame\n", frame ? (double) cubesCulled / frame : 0.0, positionCount);
+    occlusionFree(&occlusion);
+  }
+
+  if(options.terrain) {
+    terrainReport(&terrain, timingNow() - runStart);
+    terrainFree(&terrain);
+  }
+
+  if(options.streamTextures) {
+    unsigned int count = frame < options.streamTextures ? frame : options.streamTextures;
+    if(asyncUploads) {
+      textureUploaderFinish(&uploader);
+      textureUploaderReport(&uploader);
+      textureUploaderFree(&uploader);
+    }
+    else {
+      double bytes = 0.0;
+      for(unsigned int i = 0; i < count; i++) {
+        bytes += (double) streamed[i].width * streamed[i].height * 4;
+      }
+      double megabytes = bytes / (1024.0 * 1024.0);
+      printf("texture uploads: %u %s textures, %.1f MB through glTexImage2D\n", count, streamBytes ? "decoded" : "generated", megabytes);
+      printf("texture uploads: %.3f ms main thread stall in total, %.3f ms per MB\n", syncStallMs, megabytes > 0.0 ? syncStallMs / megabytes : 0.0);
+    }
+    for(unsigned int i = streamedRetired; i < count; i++) {
+      resourceDestroy(&resources, streamedHandles[i]);
+    }
+    free(streamed);
+    free(streamedHandles);
+    free(streamPixels);
+    free(streamFile);
+  }
+
+  if(options.mipStream) {
+    mipStreamReport(&mipStreamer);
+    mipStreamFree(&mipStreamer);
+  }
+
+  if(options.asyncLoad) {
+    assetLoaderReport(&assets);
+    assetLoaderFree(&assets);
+  }
+
+  if(options.terrain || asyncUploads || options.mipStream || options.asyncLoad) {
+    jobsFree(&jobs);
+  }
+
+  if(options.voxels) {
+    unsigned long long quads = 0;
+    for(int i = 0; i < voxels.sizeX * voxels.sizeY * voxels.sizeZ; i++) {
+      quads += voxels.chunks[i].quadCount;
+    }
+    printf("voxels: %llu greedy quads in %d chunks\n", quads, voxels.sizeX * voxels.sizeY * voxels.sizeZ);
+    timingReport(&remeshTimes, "voxel remesh and upload");
+    voxelRendererFree(&voxelRenderer);
+    voxelWorldFree(&voxels);
+  }
+  timingFree(&remeshTimes);
+
+  if(options.shapes) {
+    printf("shapes: %u per frame in one instanced draw call\n", options.shapes);
+    timingReport(&shapeBuildTimes, "shape build");
+    timingReport(&shapeSubmitTimes, "shape upload and draw");
+    shapeBatchFree(&shapes);
+  }
+  timingFree(&shapeBuildTimes);
+  timingFree(&shapeSubmitTimes);
+
+  if(options.sprites) {
+    printf("sprites: %u per frame in %.1f draw calls, %s\n", options.sprites, frame ? (double) spriteDraws / frame : 0.0,
+        options.spriteAtlas ? "atlas" : "one texture per image");
+    timingReport(&spriteAnimateTimes, "sprite animate and transform");
+    timingReport(&spriteSortTimes, "sprite sort");
+    timingReport(&spriteWriteTimes, "sprite vertex write");
+    timingReport(&spriteSubmitTimes, "sprite submit");
+    spriteBatchFree(&sprites);
+    if(options.spriteAtlas) {
+      spriteAtlasFree(&atlas);
+    }
+  }
+  timingFree(&spriteAnimateTimes);
+  timingFree(&spriteSortTimes);
+  timingFree(&spriteWriteTimes);
+  timingFree(&spriteSubmitTimes);
+
+  if(options.overdraw && overdraw.frames) {
+    printf("overdraw: %.2f shaded fragments per covered pixel, %.2f per pixel, %.1f%% coverage over %u frames\n",
+        overdraw.covered ? overdraw.fragments / overdraw.covered : 0.0, overdraw.fragments / overdraw.pixels,
+        100.0 * overdraw.covered / overdraw.pixels, overdraw.frames);
+  }
+
+  if(options.textureBudget) {
+    textureResidencyReport(&residency);
+    textureResidencyFree(&residency);
+  }
+  else if(!options.asyncLoad) {
+    textureCacheRelease(&textureCache, &container);
+    textureCacheRelease(&textureCache, &smiley);
+    textureCacheReport(&textureCache);
+    textureCacheFree(&textureCache);
+  }
+
+  // clean up, handles of programs that were never loaded are 0 and ignored
+  for(unsigned int i = 0; i < sizeof(cubeHandles) / sizeof(cubeHandles[0]); i++) {
+    resourceDestroy(&resources, cubeHandles[i]);
+  }
+  for(unsigned int i = 0; i < sizeof(programHandles) / sizeof(programHandles[0]); i++) {
+    resourceDestroy(&resources, programHandles[i]);
+  }
+  resourceReport(&resources);
+  resourceRegistryFree(&resources);
+  if(options.gpuCull) {
+    gpuCullReport(&gpuCull);
+    gpuCullFree(&gpuCull);
+  }
+  if(options.draw != DRAW_CLASSIC) {
+    drawListFree(&drawList);
+    meshPoolFree(&meshPool);
+  }
+  FrameArenaStats frameArenaStats;
+  frameArenaGetStats(&frameArena, &frameArenaStats);
+  printf("frame arena: %.2f MB high water per thread, %.2f MB reserved\n",
+      frameArenaStats.highWater / (1024.0 * 1024.0), frameArenaStats.capacity / (1024.0 * 1024.0));
+  frameArenaFree(&frameArena);
+  free(lodLevels);
+  if(options.scene) {
+    sceneClose(&scene);
+  }
+  packClose(&pack);
 
   glfwTerminate();
   return 0;
@@ -0,0 +1,100 @@
+#include "meshpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
+
+void meshPoolInit(MeshPool* p, VertexFormat* format, unsigned int vertexCapacity, unsigned int indexCapacity) {
+  p->format = *format;
+  p->vertexCapacity = vertexCapacity;
+  p->vertexCount = 0;
+  p->indexCapacity = indexCapacity;
+  p->indexCount = 0;
+
+  glGenVertexArrays(1, &p->VAO);
+  glGenBuffers(1, &p->VBO);
+  glGenBuffers(1, &p->EBO);
+
+  glBindVertexArray(p->VAO);
+
+  glBindBuffer(GL_ARRAY_BUFFER, p->VBO);
+  glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) vertexCapacity * format->stride, NULL, GL_STATIC_DRAW);
+  vertexFormatApply(&p->format);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, p->EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) indexCapacity * sizeof(unsigned int), NULL, GL_STATIC_DRAW);
+
+  glBindVertexArray(0);
+}
+
+// merges bit-identical vertices, quadratic so only meant for small hand written meshes
+unsigned int meshWeld(const float* vertices, unsigned int stride, unsigned int count, float* welded, unsigned int* indices) {
+  unsigned int unique = 0;
+  for(unsigned int i = 0; i < count; i++) {
+    const float* v = vertices + (size_t) i * stride;
+    unsigned int j = 0;
+    while(j < unique && memcmp(welded + (size_t) j * stride, v, stride * sizeof(float))) {
+      j++;
+    }
+    if(j == unique) {
+      memcpy(welded + (size_t) unique * stride, v, stride * sizeof(float));
+      unique++;
+    }
+    indices[i] = j;
+  }
+  return unique;
+}
+
+static int meshPoolUpload(MeshPool* p, const float* vertices, unsigned int sourceStride, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount, Mesh* mesh, VertexPackReport* report) {
+  if(p->vertexCount + vertexCount > p->vertexCapacity || p->indexCount + indexCount > p->indexCapacity) {
+    printf("ERROR::MESHPOOL::OUT_OF_SPACE: %u vertices, %u indices\n", vertexCount, indexCount);
+    return -1;
+  }
+
+  VertexPackReport localReport;
+  if(!report) {
+    report = &localReport;
+  }
+
+  void* packed = malloc((size_t) vertexCount * p->format.stride);
+  size_t packedSize = vertexPack(&p->format, vertices, sourceStride, vertexCount, packed, report);
+
+  mesh->baseVertex = p->vertexCount;
+  mesh->vertexCount = vertexCount;
+  mesh->firstIndex = p->indexCount;
+  mesh->indexCount = indexCount;
+  glm_mat4_copy(report->dequantize, mesh->dequantize);
+
+  // the EBO binding belongs to the VAO, indices stay mesh relative and draws add baseVertex
+  glBindVertexArray(p->VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, p->VBO);
+  glBufferSubData(GL_ARRAY_BUFFER, (GLintptr) mesh->baseVertex * p->format.stride, packedSize, packed);
+  glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr) mesh->firstIndex * sizeof(unsigned int), (GLsizeiptr) indexCount * sizeof(unsigned int), indices);
+  glBindVertexArray(0);
+  free(packed);
+
+  p->vertexCount += vertexCount;
+  p->indexCount += indexCount;
+  return 0;
+}
+
+int meshPoolAdd(MeshPool* p, const float* vertices, unsigned int sourceStride, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount, Mesh* mesh, VertexPackReport* report) {
+  if(indices) {
+    return meshPoolUpload(p, vertices, sourceStride, vertexCount, indices, indexCount, mesh, report);
+  }
+
+  float* welded = malloc((size_t) vertexCount * sourceStride * sizeof(float));
+  unsigned int* weldedIndices = malloc((size_t) vertexCount * sizeof(unsigned int));
+  unsigned int weldedCount = meshWeld(vertices, sourceStride, vertexCount, welded, weldedIndices);
+
+  int result = meshPoolUpload(p, welded, sourceStride, weldedCount, weldedIndices, vertexCount, mesh, report);
+  free(welded);
+  free(weldedIndices);
+  return result;
+}
+
+void meshPoolFree(MeshPool* p) {
+  glDeleteVertexArrays(1, &p->VAO);
+  glDeleteBuffers(1, &p->VBO);
+  glDeleteBuffers(1, &p->EBO);
+}
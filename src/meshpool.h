@@ -0,0 +1,36 @@
+#ifndef MESHPOOL_H
+#define MESHPOOL_H
+
+#include <cglm/cglm.h>
+#include "vertex.h"
+
+// where one mesh lives inside the pool's shared buffers
+typedef struct Mesh {
+  unsigned int baseVertex;
+  unsigned int vertexCount;
+  unsigned int firstIndex;
+  unsigned int indexCount;
+  mat4 dequantize; // from vertexPack, fold into every transform drawn with this mesh
+} Mesh;
+
+// every mesh is suballocated from one VBO and one EBO so a single VAO binding draws them all
+typedef struct MeshPool {
+  unsigned int VAO, VBO, EBO;
+  VertexFormat format;
+  unsigned int vertexCapacity;
+  unsigned int vertexCount;
+  unsigned int indexCapacity;
+  unsigned int indexCount;
+} MeshPool;
+
+void meshPoolInit(MeshPool* p, VertexFormat* format, unsigned int vertexCapacity, unsigned int indexCapacity);
+
+// packs float vertices into the pool's format, indices are relative to the mesh,
+// pass NULL indices to weld a non-indexed triangle list first
+int meshPoolAdd(MeshPool* p, const float* vertices, unsigned int sourceStride, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount, Mesh* mesh, VertexPackReport* report);
+
+void meshPoolFree(MeshPool* p);
+
+unsigned int meshWeld(const float* vertices, unsigned int stride, unsigned int count, float* welded, unsigned int* indices);
+
+#endif
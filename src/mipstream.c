@@ -0,0 +1,277 @@
+#include "mipstream.h"
+#include "glext.h"
+#include "sort.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+void mipStreamInit(MipStreamer* s, Jobs* jobs, unsigned int capacity, size_t budget) {
+  memset(s, 0, sizeof(*s));
+  s->jobs = jobs;
+  s->capacity = capacity;
+  s->budget = budget;
+  s->textures = calloc(capacity, sizeof(MipTexture));
+  s->keys = malloc(capacity * sizeof(float));
+  s->candidates = malloc(capacity * sizeof(uint32_t));
+  s->order = malloc(capacity * sizeof(uint32_t));
+  s->scratch = malloc(3 * capacity * sizeof(uint32_t));
+  pthread_mutex_init(&s->lock, NULL);
+  timingInit(&s->stats.firstVisible);
+  timingInit(&s->stats.complete);
+  timingInit(&s->stats.uploadTimes);
+}
+
+static int mipSize(int size, int level) {
+  size >>= level;
+  return size > 0 ? size : 1;
+}
+
+// 2x2 box filter, an odd last row or column is averaged with itself
+static void mipDownsample(const unsigned char* in, int width, int height, unsigned char* out) {
+  int outWidth = width > 1 ? width / 2 : 1;
+  int outHeight = height > 1 ? height / 2 : 1;
+  for(int y = 0; y < outHeight; y++) {
+    int y0 = 2 * y < height ? 2 * y : height - 1;
+    int y1 = 2 * y + 1 < height ? 2 * y + 1 : y0;
+    for(int x = 0; x < outWidth; x++) {
+      int x0 = 2 * x < width ? 2 * x : width - 1;
+      int x1 = 2 * x + 1 < width ? 2 * x + 1 : x0;
+      for(int c = 0; c < 4; c++) {
+        unsigned int sum = in[((size_t) y0 * width + x0) * 4 + c] + in[((size_t) y0 * width + x1) * 4 + c]
+            + in[((size_t) y1 * width + x0) * 4 + c] + in[((size_t) y1 * width + x1) * 4 + c];
+        out[((size_t) y * outWidth + x) * 4 + c] = (unsigned char) ((sum + 2) / 4);
+      }
+    }
+  }
+}
+
+// runs on a worker, builds the whole chain from the caller's pixels
+static void mipBuildChain(void* arg) {
+  MipTexture* m = arg;
+
+  size_t total = 0;
+  for(int level = 0; level < m->levels; level++) {
+    m->offsets[level] = total;
+    total += (size_t) mipSize(m->width, level) * mipSize(m->height, level) * 4;
+  }
+
+  unsigned char* chain = malloc(total);
+  memcpy(chain, m->pixels, (size_t) m->width * m->height * 4);
+  for(int level = 1; level < m->levels; level++) {
+    mipDownsample(chain + m->offsets[level - 1], mipSize(m->width, level - 1), mipSize(m->height, level - 1), chain + m->offsets[level]);
+  }
+  free(m->pixels);
+
+  pthread_mutex_lock(&m->streamer->lock);
+  m->pixels = NULL;
+  m->chain = chain;
+  m->built = 1;
+  pthread_mutex_unlock(&m->streamer->lock);
+}
+
+int mipStreamAdd(MipStreamer* s, unsigned int textureUnit, unsigned char* pixels, int width, int height) {
+  if(s->count == s->capacity) {
+    printf("ERROR::MIPSTREAM::FULL\n");
+    free(pixels);
+    return -1;
+  }
+
+  MipTexture* m = &s->textures[s->count];
+  memset(m, 0, sizeof(*m));
+  m->streamer = s;
+  m->width = width;
+  m->height = height;
+  m->levels = 1;
+  while(m->levels < MIPSTREAM_MAX_LEVELS && (mipSize(width, m->levels - 1) > 1 || mipSize(height, m->levels - 1) > 1)) {
+    m->levels++;
+  }
+  m->pixels = pixels;
+  m->residentLevel = m->levels;
+  m->screenSize = (float) (width > height ? width : height);
+  m->added = timingNow();
+
+  TextureFormat format;
+  textureChooseFormat(4, width, &format);
+
+  Texture* t = &m->texture;
+  glGenTextures(1, &t->ID);
+  t->textureUnit = textureUnit;
+  t->width = width;
+  t->height = height;
+  t->internalFormat = format.internalFormat;
+  t->bytes = textureFormatBytes(&format, width, height);
+
+  glActiveTexture(textureUnit);
+  glBindTexture(GL_TEXTURE_2D, t->ID);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  // every level is allocated now, only their contents arrive later
+  if(glext.textureStorage) {
+    glTexStorage2D(GL_TEXTURE_2D, m->levels, format.internalFormat, width, height);
+  }
+  else {
+    for(int level = 0; level < m->levels; level++) {
+      glTexImage2D(GL_TEXTURE_2D, level, format.internalFormat, mipSize(width, level), mipSize(height, level), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+  }
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, m->levels - 1);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m->levels - 1);
+
+  jobsSubmit(s->jobs, mipBuildChain, m);
+  return (int) s->count++;
+}
+
+Texture* mipStreamTexture(MipStreamer* s, int handle) {
+  return &s->textures[handle].texture;
+}
+
+void mipStreamSetScreenSize(MipStreamer* s, int handle, float pixels) {
+  s->textures[handle].screenSize = pixels;
+}
+
+// the finest level still worth uploading, one texel per pixel at the current size on screen
+static int mipNeededLevel(MipTexture* m) {
+  float size = (float) (m->width > m->height ? m->width : m->height);
+  if(m->screenSize <= 0.0f) {
+    return m->levels - 1;
+  }
+  // an infinite size means the camera is inside the bounds, which needs the finest level
+  if(!isfinite(m->screenSize)) {
+    return 0;
+  }
+  // clamped before the cast, a float outside int's range does not convert
+  float level = floorf(log2f(size / m->screenSize));
+  return level < 0.0f ? 0 : level < (float) m->levels ? (int) level : m->levels - 1;
+}
+
+// uploads one level and moves the base level down to it
+static size_t mipUploadLevel(MipStreamer* s, MipTexture* m, int level) {
+  int width = mipSize(m->width, level);
+  int height = mipSize(m->height, level);
+  size_t bytes = (size_t) width * height * 4;
+
+  glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, m->chain + m->offsets[level]);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+  m->residentLevel = level;
+
+  s->stats.levelsUploaded++;
+  s->stats.bytes += (double) bytes;
+  return bytes;
+}
+
+static void mipBind(MipTexture* m) {
+  glActiveTexture(m->texture.textureUnit);
+  glBindTexture(GL_TEXTURE_2D, m->texture.ID);
+}
+
+// the chain is only needed until the finest level is up
+static void mipCheckDone(MipStreamer* s, MipTexture* m) {
+  if(!m->complete && m->residentLevel <= mipNeededLevel(m)) {
+    m->complete = 1;
+    timingAdd(&s->stats.complete, (timingNow() - m->added) * 1000.0);
+  }
+  if(m->residentLevel == 0) {
+    free(m->chain);
+    m->chain = NULL;
+  }
+}
+
+void mipStreamUpdate(MipStreamer* s) {
+  double start = timingNow();
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  // freshly built chains get their whole tail at once so something renders right away
+  unsigned int candidateCount = 0;
+  for(unsigned int i = 0; i < s->count; i++) {
+    MipTexture* m = &s->textures[i];
+    pthread_mutex_lock(&s->lock);
+    int built = m->built;
+    pthread_mutex_unlock(&s->lock);
+    if(!built || !m->chain) {
+      continue;
+    }
+
+    if(m->residentLevel == m->levels) {
+      mipBind(m);
+      int level = m->levels - 1;
+      mipUploadLevel(s, m, level);
+      while(level > 0 && mipSize(m->width, level - 1) <= MIPSTREAM_TAIL_SIZE && mipSize(m->height, level - 1) <= MIPSTREAM_TAIL_SIZE) {
+        mipUploadLevel(s, m, --level);
+      }
+      timingAdd(&s->stats.firstVisible, (timingNow() - m->added) * 1000.0);
+      mipCheckDone(s, m);
+    }
+
+    if(m->chain && m->residentLevel > mipNeededLevel(m)) {
+      s->keys[candidateCount] = -m->screenSize;
+      s->candidates[candidateCount++] = i;
+    }
+  }
+
+  // finer levels go to the largest textures on screen first, one level each per pass
+  sortRadixFloat(s->keys, s->order, candidateCount, s->scratch);
+  size_t uploaded = 0;
+  int progress = 1;
+  while(progress) {
+    progress = 0;
+    for(unsigned int i = 0; i < candidateCount; i++) {
+      MipTexture* m = &s->textures[s->candidates[s->order[i]]];
+      if(!m->chain || m->residentLevel <= mipNeededLevel(m)) {
+        continue;
+      }
+
+      int level = m->residentLevel - 1;
+      size_t bytes = (size_t) mipSize(m->width, level) * mipSize(m->height, level) * 4;
+      if(uploaded && uploaded + bytes > s->budget) {
+        progress = 0;
+        break;
+      }
+
+      mipBind(m);
+      uploaded += mipUploadLevel(s, m, level);
+      mipCheckDone(s, m);
+      progress = 1;
+    }
+  }
+
+  timingAdd(&s->stats.uploadTimes, (timingNow() - start) * 1000.0);
+}
+
+void mipStreamReport(MipStreamer* s) {
+  MipStreamStats* stats = &s->stats;
+  unsigned int finest = 0;
+  for(unsigned int i = 0; i < s->count; i++) {
+    finest += s->textures[i].residentLevel == 0;
+  }
+  printf("mip streaming: %u textures, %u at full resolution, %llu levels and %.1f MB uploaded, %s\n",
+      s->count, finest, stats->levelsUploaded, stats->bytes / (1024.0 * 1024.0),
+      glext.textureStorage ? "glTexStorage2D" : "glTexImage2D per level");
+  timingReport(&stats->firstVisible, "mip tail visible after");
+  timingReport(&stats->complete, "needed level resident after");
+  timingReport(&stats->uploadTimes, "mip upload");
+}
+
+void mipStreamFree(MipStreamer* s) {
+  // workers may still be building chains
+  jobsWait(s->jobs);
+
+  for(unsigned int i = 0; i < s->count; i++) {
+    MipTexture* m = &s->textures[i];
+    glDeleteTextures(1, &m->texture.ID);
+    free(m->pixels);
+    free(m->chain);
+  }
+  free(s->textures);
+  free(s->keys);
+  free(s->candidates);
+  free(s->order);
+  free(s->scratch);
+  pthread_mutex_destroy(&s->lock);
+  timingFree(&s->stats.firstVisible);
+  timingFree(&s->stats.complete);
+  timingFree(&s->stats.uploadTimes);
+}
@@ -0,0 +1,73 @@
+#ifndef MIPSTREAM_H
+#define MIPSTREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "jobs.h"
+#include "texture.h"
+#include "timing.h"
+
+#define MIPSTREAM_MAX_LEVELS 16
+#define MIPSTREAM_TAIL_SIZE 64 // levels this size and smaller go up together, as soon as the chain is built
+
+typedef struct MipTexture {
+  struct MipStreamer* streamer;
+  Texture texture;
+  int width;
+  int height;
+  int levels;
+  unsigned char* pixels; // RGBA level 0 handed over by the caller, freed once the chain is built
+  unsigned char* chain; // every level back to back, finest first, built on a worker
+  size_t offsets[MIPSTREAM_MAX_LEVELS];
+  int built; // guarded by the streamer lock
+  int residentLevel; // finest level uploaded and the base level, levels while nothing is
+  float screenSize; // projected size in pixels, larger ones stream first
+  int complete; // reached the level its screen size asks for at least once
+  double added;
+} MipTexture;
+
+typedef struct MipStreamStats {
+  unsigned long long levelsUploaded;
+  double bytes;
+  Timing firstVisible; // milliseconds from add until the mip tail can be sampled
+  Timing complete; // milliseconds from add until the level the screen size asks for
+  Timing uploadTimes; // milliseconds spent uploading, one sample per update
+} MipStreamStats;
+
+// textures get storage for their whole mip chain up front and fill it coarsest level first,
+// GL_TEXTURE_BASE_LEVEL follows the finest level that has arrived so sampling never sees holes
+typedef struct MipStreamer {
+  Jobs* jobs;
+  MipTexture* textures; // fixed at init, workers hold pointers into it
+  unsigned int count;
+  unsigned int capacity;
+  size_t budget; // bytes uploaded per update past the mip tails, at least one level always goes through
+
+  float* keys; // priority sort scratch, one per texture
+  uint32_t* candidates;
+  uint32_t* order;
+  uint32_t* scratch;
+
+  pthread_mutex_t lock;
+
+  MipStreamStats stats;
+} MipStreamer;
+
+void mipStreamInit(MipStreamer* s, Jobs* jobs, unsigned int capacity, size_t budget);
+
+// takes ownership of malloc'd RGBA pixels, returns a handle or -1
+int mipStreamAdd(MipStreamer* s, unsigned int textureUnit, unsigned char* pixels, int width, int height);
+
+Texture* mipStreamTexture(MipStreamer* s, int handle);
+
+// diameter on screen in pixels, decides both the priority and how fine the texture needs to get
+void mipStreamSetScreenSize(MipStreamer* s, int handle, float pixels);
+
+void mipStreamUpdate(MipStreamer* s);
+
+void mipStreamReport(MipStreamer* s);
+
+void mipStreamFree(MipStreamer* s);
+
+#endif
@@ -0,0 +1,402 @@
+#include "occlusion.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define OCCLUSION_CULL_BATCH 64 // boxes a worker claims at a time
+
+// four lanes evaluated at once, lowered to SSE/NEON by both gcc and clang
+typedef float OcclusionFloat4 __attribute__((vector_size(16)));
+typedef int OcclusionInt4 __attribute__((vector_size(16)));
+
+typedef enum OcclusionResult {
+  OCCLUSION_VISIBLE,
+  OCCLUSION_OUTSIDE_FRUSTUM,
+  OCCLUSION_OCCLUDED
+} OcclusionResult;
+
+typedef struct OcclusionWorker {
+  Occlusion* o;
+  atomic_uint* next;
+  vec3* minimums;
+  vec3* maximums;
+  unsigned int count;
+  unsigned char* visible;
+  OcclusionStats stats;
+} OcclusionWorker;
+
+// box faces as corner quads wound counter-clockwise seen from outside, corner bit 0 is x, 1 is y, 2 is z
+static const int occlusionFaces[6][4] = {
+  {0, 4, 6, 2}, {1, 3, 7, 5},
+  {0, 1, 5, 4}, {2, 6, 7, 3},
+  {0, 2, 3, 1}, {4, 5, 7, 6}
+};
+
+void occlusionInit(Occlusion* o, int width, int height, unsigned int threadCount) {
+  memset(o, 0, sizeof(*o));
+
+  // rows are rasterized four pixels at a time
+  width = (width + 3) & ~3;
+  o->width = width;
+  o->height = height;
+
+  int w = width;
+  int h = height;
+  while(o->levelCount < OCCLUSION_MAX_LEVELS) {
+    o->levelWidth[o->levelCount] = w;
+    o->levelHeight[o->levelCount] = h;
+    o->levels[o->levelCount] = malloc((size_t) w * h * sizeof(float));
+    o->levelCount++;
+    if(w == 1 && h == 1) {
+      break;
+    }
+    w = (w + 1) / 2;
+    h = (h + 1) / 2;
+  }
+
+  if(threadCount < 1) {
+    threadCount = 1;
+  }
+  if(threadCount > OCCLUSION_MAX_THREADS) {
+    threadCount = OCCLUSION_MAX_THREADS;
+  }
+  o->threadCount = threadCount;
+}
+
+void occlusionBegin(Occlusion* o, mat4 viewProjection) {
+  glm_mat4_copy(viewProjection, o->viewProjection);
+  o->triangleCount = 0;
+  memset(&o->stats, 0, sizeof(o->stats));
+}
+
+static void occlusionCorners(Occlusion* o, vec3 minimum, vec3 maximum, vec4 clip[8]) {
+  for(int i = 0; i < 8; i++) {
+    vec4 corner = {
+      i & 1 ? maximum[0] : minimum[0],
+      i & 2 ? maximum[1] : minimum[1],
+      i & 4 ? maximum[2] : minimum[2],
+      1.0f
+    };
+    glm_mat4_mulv(o->viewProjection, corner, clip[i]);
+  }
+}
+
+void occlusionAddOccluder(Occlusion* o, vec3 minimum, vec3 maximum) {
+  vec4 clip[8];
+  occlusionCorners(o, minimum, maximum, clip);
+
+  // clipping would only make the occluder smaller, so boxes crossing the near plane are left out
+  for(int i = 0; i < 8; i++) {
+    if(clip[i][2] < -clip[i][3]) {
+      o->stats.occludersSkipped++;
+      return;
+    }
+  }
+
+  float x[8], y[8], z[8];
+  for(int i = 0; i < 8; i++) {
+    float invW = 1.0f / clip[i][3];
+    x[i] = (clip[i][0] * invW * 0.5f + 0.5f) * o->width;
+    y[i] = (0.5f - clip[i][1] * invW * 0.5f) * o->height;
+    z[i] = clip[i][2] * invW * 0.5f + 0.5f;
+  }
+
+  for(int f = 0; f < 6; f++) {
+    const int* q = occlusionFaces[f];
+
+    // with y pointing down a front face winds clockwise, back faces are hidden by the front ones anyway
+    float area = (x[q[1]] - x[q[0]]) * (y[q[2]] - y[q[0]]) - (x[q[2]] - x[q[0]]) * (y[q[1]] - y[q[0]]);
+    if(area >= 0.0f) {
+      continue;
+    }
+
+    if(o->triangleCount + 2 > o->triangleCapacity) {
+      o->triangleCapacity = o->triangleCapacity ? o->triangleCapacity * 2 : 1024;
+      o->triangles = realloc(o->triangles, o->triangleCapacity * sizeof(OcclusionTriangle));
+    }
+
+    for(int t = 0; t < 2; t++) {
+      int corners[3] = {q[0], q[1 + t], q[2 + t]};
+      OcclusionTriangle* tri = &o->triangles[o->triangleCount++];
+      for(int k = 0; k < 3; k++) {
+        tri->x[k] = x[corners[k]];
+        tri->y[k] = y[corners[k]];
+        tri->z[k] = z[corners[k]];
+      }
+    }
+  }
+  o->stats.occluders++;
+}
+
+// keeps the nearest depth of one triangle within rows [bandY0, bandY1]
+static void occlusionTriangle(Occlusion* o, const OcclusionTriangle* tri, int bandY0, int bandY1) {
+  float minY = fminf(tri->y[0], fminf(tri->y[1], tri->y[2]));
+  float maxY = fmaxf(tri->y[0], fmaxf(tri->y[1], tri->y[2]));
+  int y0 = (int) fmaxf(ceilf(minY - 0.5f), (float) bandY0);
+  int y1 = (int) fminf(floorf(maxY - 0.5f), (float) bandY1);
+  if(y0 > y1) {
+    return;
+  }
+
+  float minX = fminf(tri->x[0], fminf(tri->x[1], tri->x[2]));
+  float maxX = fmaxf(tri->x[0], fmaxf(tri->x[1], tri->x[2]));
+  int x0 = (int) fmaxf(ceilf(minX - 0.5f), 0.0f);
+  int x1 = (int) fminf(floorf(maxX - 0.5f), (float) (o->width - 1));
+  if(x0 > x1) {
+    return;
+  }
+
+  // edge i is opposite vertex i, front faces were kept so the area is always negative
+  float A[3], B[3], C[3];
+  for(int i = 0; i < 3; i++) {
+    int a = (i + 1) % 3;
+    int b = (i + 2) % 3;
+    A[i] = tri->y[b] - tri->y[a];
+    B[i] = tri->x[a] - tri->x[b];
+    C[i] = tri->y[a] * tri->x[b] - tri->x[a] * tri->y[b];
+  }
+  float area = A[0] * tri->x[0] + B[0] * tri->y[0] + C[0];
+  if(area < 1e-8f) {
+    return;
+  }
+
+  // window depth is linear in screen space, so it is a plane z = zx * x + zy * y + zc
+  float invArea = 1.0f / area;
+  float zx = (A[0] * tri->z[0] + A[1] * tri->z[1] + A[2] * tri->z[2]) * invArea;
+  float zy = (B[0] * tri->z[0] + B[1] * tri->z[1] + B[2] * tri->z[2]) * invArea;
+  float zc = (C[0] * tri->z[0] + C[1] * tri->z[1] + C[2] * tri->z[2]) * invArea;
+
+  const OcclusionFloat4 laneOffset = {0.5f, 1.5f, 2.5f, 3.5f};
+  float* depth = o->levels[0];
+  x0 &= ~3;
+
+  for(int y = y0; y <= y1; y++) {
+    float py = y + 0.5f;
+    float rowE0 = B[0] * py + C[0];
+    float rowE1 = B[1] * py + C[1];
+    float rowE2 = B[2] * py + C[2];
+    float rowZ = zy * py + zc;
+    float* row = depth + (size_t) y * o->width;
+
+    for(int x = x0; x <= x1; x += 4) {
+      OcclusionFloat4 px = (float) x + laneOffset;
+      OcclusionFloat4 e0 = A[0] * px + rowE0;
+      OcclusionFloat4 e1 = A[1] * px + rowE1;
+      OcclusionFloat4 e2 = A[2] * px + rowE2;
+      OcclusionFloat4 z = zx * px + rowZ;
+      OcclusionFloat4 current;
+      memcpy(&current, row + x, sizeof(current));
+
+      // select per lane through the bit patterns, C has no vector ternary
+      OcclusionInt4 write = (e0 >= 0.0f) & (e1 >= 0.0f) & (e2 >= 0.0f) & (z < current);
+      OcclusionInt4 result = ((OcclusionInt4) z & write) | ((OcclusionInt4) current & ~write);
+      memcpy(row + x, &result, sizeof(result));
+    }
+  }
+}
+
+// bands never share rows, so workers only need to agree on who takes the next band
+static void* occlusionRasterWorker(void* arg) {
+  OcclusionWorker* w = arg;
+  Occlusion* o = w->o;
+  unsigned int bandCount = (o->height + OCCLUSION_BAND_HEIGHT - 1) / OCCLUSION_BAND_HEIGHT;
+
+  for(;;) {
+    unsigned int band = atomic_fetch_add(w->next, 1);
+    if(band >= bandCount) {
+      break;
+    }
+
+    int y0 = band * OCCLUSION_BAND_HEIGHT;
+    int y1 = y0 + OCCLUSION_BAND_HEIGHT < o->height ? y0 + OCCLUSION_BAND_HEIGHT - 1 : o->height - 1;
+    float* depth = o->levels[0] + (size_t) y0 * o->width;
+    for(size_t i = 0; i < (size_t) (y1 - y0 + 1) * o->width; i++) {
+      depth[i] = 1.0f;
+    }
+
+    for(unsigned int i = 0; i < o->triangleCount; i++) {
+      occlusionTriangle(o, &o->triangles[i], y0, y1);
+    }
+  }
+
+  return NULL;
+}
+
+static OcclusionResult occlusionClassify(Occlusion* o, vec3 minimum, vec3 maximum) {
+  vec4 clip[8];
+  occlusionCorners(o, minimum, maximum, clip);
+
+  // entirely outside one frustum plane
+  for(int axis = 0; axis < 3; axis++) {
+    int outsidePositive = 1;
+    int outsideNegative = 1;
+    for(int i = 0; i < 8; i++) {
+      outsidePositive &= clip[i][axis] > clip[i][3];
+      outsideNegative &= clip[i][axis] < -clip[i][3];
+    }
+    if(outsidePositive || outsideNegative) {
+      return OCCLUSION_OUTSIDE_FRUSTUM;
+    }
+  }
+
+  float minX = INFINITY, minY = INFINITY, maxX = -INFINITY, maxY = -INFINITY, nearest = INFINITY;
+  for(int i = 0; i < 8; i++) {
+    // anything reaching the near plane could cover the whole screen
+    if(clip[i][2] < -clip[i][3]) {
+      return OCCLUSION_VISIBLE;
+    }
+    float invW = 1.0f / clip[i][3];
+    float x = (clip[i][0] * invW * 0.5f + 0.5f) * o->width;
+    float y = (0.5f - clip[i][1] * invW * 0.5f) * o->height;
+    minX = fminf(minX, x);
+    maxX = fmaxf(maxX, x);
+    minY = fminf(minY, y);
+    maxY = fmaxf(maxY, y);
+    nearest = fminf(nearest, clip[i][2] * invW * 0.5f + 0.5f);
+  }
+
+  // every pixel the bounds touch, not just the ones whose center they contain
+  int x0 = (int) fmaxf(floorf(minX), 0.0f);
+  int y0 = (int) fmaxf(floorf(minY), 0.0f);
+  int x1 = (int) fminf(ceilf(maxX) - 1.0f, (float) (o->width - 1));
+  int y1 = (int) fminf(ceilf(maxY) - 1.0f, (float) (o->height - 1));
+  if(x0 > x1 || y0 > y1) {
+    return OCCLUSION_OUTSIDE_FRUSTUM;
+  }
+
+  // the level where the bounds span at most about four texels keeps the loop short
+  int level = 0;
+  int extent = x1 - x0 > y1 - y0 ? x1 - x0 : y1 - y0;
+  while(level + 1 < o->levelCount && (extent >> level) > 4) {
+    level++;
+  }
+
+  float* texels = o->levels[level];
+  int levelWidth = o->levelWidth[level];
+  for(int y = y0 >> level; y <= y1 >> level; y++) {
+    for(int x = x0 >> level; x <= x1 >> level; x++) {
+      if(nearest <= texels[y * levelWidth + x]) {
+        return OCCLUSION_VISIBLE;
+      }
+    }
+  }
+  return OCCLUSION_OCCLUDED;
+}
+
+void occlusionRasterize(Occlusion* o) {
+  atomic_uint nextBand;
+  atomic_init(&nextBand, 0);
+
+  OcclusionWorker workers[OCCLUSION_MAX_THREADS];
+  pthread_t threads[OCCLUSION_MAX_THREADS];
+
+  for(unsigned int i = 0; i < o->threadCount; i++) {
+    workers[i].o = o;
+    workers[i].next = &nextBand;
+  }
+
+  // the calling thread works as worker 0
+  for(unsigned int i = 1; i < o->threadCount; i++) {
+    pthread_create(&threads[i], NULL, occlusionRasterWorker, &workers[i]);
+  }
+  occlusionRasterWorker(&workers[0]);
+  for(unsigned int i = 1; i < o->threadCount; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  // each level keeps the farthest depth of the 2x2 texels below it, odd edges repeat the last texel
+  for(int level = 1; level < o->levelCount; level++) {
+    float* below = o->levels[level - 1];
+    int belowWidth = o->levelWidth[level - 1];
+    int belowHeight = o->levelHeight[level - 1];
+    float* texels = o->levels[level];
+
+    for(int y = 0; y < o->levelHeight[level]; y++) {
+      int by0 = y * 2;
+      int by1 = by0 + 1 < belowHeight ? by0 + 1 : by0;
+      for(int x = 0; x < o->levelWidth[level]; x++) {
+        int bx0 = x * 2;
+        int bx1 = bx0 + 1 < belowWidth ? bx0 + 1 : bx0;
+        float a = fmaxf(below[by0 * belowWidth + bx0], below[by0 * belowWidth + bx1]);
+        float b = fmaxf(below[by1 * belowWidth + bx0], below[by1 * belowWidth + bx1]);
+        texels[y * o->levelWidth[level] + x] = fmaxf(a, b);
+      }
+    }
+  }
+}
+
+int occlusionTestBox(Occlusion* o, vec3 minimum, vec3 maximum) {
+  return occlusionClassify(o, minimum, maximum) == OCCLUSION_VISIBLE;
+}
+
+static void* occlusionCullWorker(void* arg) {
+  OcclusionWorker* w = arg;
+
+  for(;;) {
+    unsigned int first = atomic_fetch_add(w->next, OCCLUSION_CULL_BATCH);
+    if(first >= w->count) {
+      break;
+    }
+
+    unsigned int last = first + OCCLUSION_CULL_BATCH < w->count ? first + OCCLUSION_CULL_BATCH : w->count;
+    for(unsigned int i = first; i < last; i++) {
+      OcclusionResult result = occlusionClassify(w->o, w->minimums[i], w->maximums[i]);
+      w->visible[i] = result == OCCLUSION_VISIBLE;
+      w->stats.frustumCulled += result == OCCLUSION_OUTSIDE_FRUSTUM;
+      w->stats.occlusionCulled += result == OCCLUSION_OCCLUDED;
+      w->stats.tested++;
+    }
+  }
+
+  return NULL;
+}
+
+void occlusionCull(Occlusion* o, vec3* minimums, vec3* maximums, unsigned int count, unsigned char* visible) {
+  atomic_uint next;
+  atomic_init(&next, 0);
+
+  OcclusionWorker workers[OCCLUSION_MAX_THREADS];
+  pthread_t threads[OCCLUSION_MAX_THREADS];
+
+  // small batches are not worth waking threads for
+  unsigned int threadCount = o->threadCount;
+  if(count < threadCount * OCCLUSION_CULL_BATCH) {
+    threadCount = (count + OCCLUSION_CULL_BATCH - 1) / OCCLUSION_CULL_BATCH;
+    threadCount = threadCount ? threadCount : 1;
+  }
+
+  for(unsigned int i = 0; i < threadCount; i++) {
+    memset(&workers[i], 0, sizeof(OcclusionWorker));
+    workers[i].o = o;
+    workers[i].next = &next;
+    workers[i].minimums = minimums;
+    workers[i].maximums = maximums;
+    workers[i].count = count;
+    workers[i].visible = visible;
+  }
+
+  for(unsigned int i = 1; i < threadCount; i++) {
+    pthread_create(&threads[i], NULL, occlusionCullWorker, &workers[i]);
+  }
+  occlusionCullWorker(&workers[0]);
+  for(unsigned int i = 1; i < threadCount; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  for(unsigned int i = 0; i < threadCount; i++) {
+    o->stats.tested += workers[i].stats.tested;
+    o->stats.frustumCulled += workers[i].stats.frustumCulled;
+    o->stats.occlusionCulled += workers[i].stats.occlusionCulled;
+  }
+}
+
+void occlusionFree(Occlusion* o) {
+  for(int i = 0; i < o->levelCount; i++) {
+    free(o->levels[i]);
+  }
+  free(o->triangles);
+  memset(o, 0, sizeof(*o));
+}
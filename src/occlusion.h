@@ -0,0 +1,62 @@
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include <cglm/cglm.h>
+
+#define OCCLUSION_WIDTH 256
+#define OCCLUSION_HEIGHT 128
+#define OCCLUSION_BAND_HEIGHT 8 // rows a worker rasterizes at a time
+#define OCCLUSION_MAX_LEVELS 12
+#define OCCLUSION_MAX_THREADS 32
+
+// an occluder triangle after projection, in depth buffer pixels
+typedef struct OcclusionTriangle {
+  float x[3];
+  float y[3];
+  float z[3]; // window depth in [0, 1]
+} OcclusionTriangle;
+
+typedef struct OcclusionStats {
+  unsigned int occluders; // boxes rasterized this frame
+  unsigned int occludersSkipped; // boxes crossing the near plane, never used as occluders
+  unsigned int tested;
+  unsigned int frustumCulled;
+  unsigned int occlusionCulled;
+} OcclusionStats;
+
+// coarse software depth buffer with a max-depth pyramid, a box is hidden when its nearest
+// point is behind the farthest occluder depth everywhere it could cover
+typedef struct Occlusion {
+  int width;
+  int height;
+  float* levels[OCCLUSION_MAX_LEVELS]; // levels[0] is the depth buffer, each level above keeps the max of 2x2 texels
+  int levelWidth[OCCLUSION_MAX_LEVELS];
+  int levelHeight[OCCLUSION_MAX_LEVELS];
+  int levelCount;
+
+  mat4 viewProjection;
+  OcclusionTriangle* triangles;
+  unsigned int triangleCount;
+  unsigned int triangleCapacity;
+
+  unsigned int threadCount;
+  OcclusionStats stats;
+} Occlusion;
+
+void occlusionInit(Occlusion* o, int width, int height, unsigned int threadCount);
+
+void occlusionBegin(Occlusion* o, mat4 viewProjection);
+
+// world-space axis aligned box, only rasterized once occlusionRasterize runs
+void occlusionAddOccluder(Occlusion* o, vec3 minimum, vec3 maximum);
+
+void occlusionRasterize(Occlusion* o);
+
+int occlusionTestBox(Occlusion* o, vec3 minimum, vec3 maximum);
+
+// tests count boxes across the worker threads, visible[i] is 1 for boxes that must be drawn
+void occlusionCull(Occlusion* o, vec3* minimums, vec3* maximums, unsigned int count, unsigned char* visible);
+
+void occlusionFree(Occlusion* o);
+
+#endif
@@ -0,0 +1,84 @@
+#include "offscreen.h"
+#include <stdio.h>
+#include <glad/glad.h>
+
+void offscreenInit(Offscreen* o, int width, int height, int srgb) {
+  o->width = width;
+  o->height = height;
+  o->frame = 0;
+
+  glGenFramebuffers(1, &o->FBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, o->FBO);
+
+  glGenRenderbuffers(1, &o->colorRBO);
+  glBindRenderbuffer(GL_RENDERBUFFER, o->colorRBO);
+  glRenderbufferStorage(GL_RENDERBUFFER, srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, width, height);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, o->colorRBO);
+
+  glGenRenderbuffers(1, &o->depthRBO);
+  glBindRenderbuffer(GL_RENDERBUFFER, o->depthRBO);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, o->depthRBO);
+
+  if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    printf("ERROR::OFFSCREEN::FRAMEBUFFER_INCOMPLETE\n");
+  }
+
+  glGenBuffers(2, o->PBOs);
+  for(int i = 0; i < 2; i++) {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, o->PBOs[i]);
+    glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) width * height * 4, NULL, GL_STREAM_READ);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void offscreenBind(Offscreen* o) {
+  glBindFramebuffer(GL_FRAMEBUFFER, o->FBO);
+  glViewport(0, 0, o->width, o->height);
+}
+
+// maps the pixel buffer written one frame ago and hands it to the callback
+static void offscreenMapPrevious(Offscreen* o, OffscreenFrameCallback callback, void* user) {
+  unsigned int previous = o->frame - 1;
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, o->PBOs[previous % 2]);
+
+  const unsigned char* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  if(pixels) {
+    if(callback) {
+      callback(user, previous, pixels, o->width, o->height);
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+}
+
+// queues an asynchronous copy of the current frame and collects the previous one
+void offscreenReadback(Offscreen* o, OffscreenFrameCallback callback, void* user) {
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, o->FBO);
+  glReadBuffer(GL_COLOR_ATTACHMENT0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, o->PBOs[o->frame % 2]);
+  glReadPixels(0, 0, o->width, o->height, GL_RGBA, GL_UNSIGNED_BYTE, (void*) 0);
+
+  if(o->frame > 0) {
+    offscreenMapPrevious(o, callback, user);
+  }
+
+  o->frame++;
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// collects the last queued frame once rendering is over
+void offscreenFinish(Offscreen* o, OffscreenFrameCallback callback, void* user) {
+  if(o->frame == 0) {
+    return;
+  }
+
+  offscreenMapPrevious(o, callback, user);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void offscreenFree(Offscreen* o) {
+  glDeleteBuffers(2, o->PBOs);
+  glDeleteRenderbuffers(1, &o->colorRBO);
+  glDeleteRenderbuffers(1, &o->depthRBO);
+  glDeleteFramebuffers(1, &o->FBO);
+}
@@ -0,0 +1,30 @@
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+// framebuffer object with a pair of pixel pack buffers, so reading frame N back
+// only waits on frame N - 1, which the GPU has long finished
+typedef struct Offscreen {
+  unsigned int FBO;
+  unsigned int colorRBO;
+  unsigned int depthRBO;
+  unsigned int PBOs[2];
+  int width;
+  int height;
+  unsigned int frame; // number of frames queued for readback
+} Offscreen;
+
+// receives a finished frame, pixels are RGBA8 with the bottom row first
+typedef void (*OffscreenFrameCallback)(void* user, unsigned int frame, const unsigned char* pixels, int width, int height);
+
+// srgb makes the color buffer encode when GL_FRAMEBUFFER_SRGB is enabled
+void offscreenInit(Offscreen* o, int width, int height, int srgb);
+
+void offscreenBind(Offscreen* o);
+
+void offscreenReadback(Offscreen* o, OffscreenFrameCallback callback, void* user);
+
+void offscreenFinish(Offscreen* o, OffscreenFrameCallback callback, void* user);
+
+void offscreenFree(Offscreen* o);
+
+#endif
@@ -0,0 +1,98 @@
+#include "pack.h"
+#include "hash.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// maps the whole archive read-only, returns 0 on success
+int packOpen(Pack* p, const char* path) {
+  memset(p, 0, sizeof(*p));
+
+  int fd = open(path, O_RDONLY);
+  if(fd < 0) {
+    return -1;
+  }
+
+  struct stat st;
+  if(fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(PackHeader)) {
+    printf("ERROR::PACK::INVALID_ARCHIVE: %s\n", path);
+    close(fd);
+    return -1;
+  }
+
+  void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping keeps the file alive
+  if(base == MAP_FAILED) {
+    printf("ERROR::PACK::MMAP_FAILED: %s\n", path);
+    return -1;
+  }
+
+  const PackHeader* header = base;
+  size_t tocEnd = (size_t) header->tocOffset + (size_t) header->entryCount * sizeof(PackEntry);
+  if(header->magic != PACK_MAGIC || header->version != PACK_VERSION || tocEnd > (size_t) st.st_size) {
+    printf("ERROR::PACK::INVALID_ARCHIVE: %s\n", path);
+    munmap(base, st.st_size);
+    return -1;
+  }
+
+  p->base = base;
+  p->size = st.st_size;
+  p->header = header;
+  p->entries = (const PackEntry*) (p->base + header->tocOffset);
+  return 0;
+}
+
+// binary search of the sorted table of contents, returns 0 if found
+int packFind(Pack* p, const char* name, PackView* view) {
+  if(!p->base) {
+    return -1;
+  }
+
+  unsigned int lo = 0;
+  unsigned int hi = p->header->entryCount;
+  while(lo < hi) {
+    unsigned int mid = lo + (hi - lo) / 2;
+    const PackEntry* e = &p->entries[mid];
+    int cmp = strncmp(name, e->name, PACK_NAME_LENGTH);
+
+    if(cmp == 0) {
+      if(e->offset + e->size > p->size) {
+        printf("ERROR::PACK::ENTRY_OUT_OF_BOUNDS: %s\n", name);
+        return -1;
+      }
+      view->data = p->base + e->offset;
+      view->size = e->size;
+      view->entry = e;
+      return 0;
+    }
+
+    if(cmp < 0) {
+      hi = mid;
+    }
+    else {
+      lo = mid + 1;
+    }
+  }
+
+  return -1;
+}
+
+// rehashes the view's bytes against the table of contents, returns 0 if they match
+int packVerify(Pack* p, PackView* view) {
+  (void) p;
+  if(hash64(view->data, view->size, 0) != view->entry->hash) {
+    printf("ERROR::PACK::HASH_MISMATCH: %s\n", view->entry->name);
+    return -1;
+  }
+  return 0;
+}
+
+void packClose(Pack* p) {
+  if(p->base) {
+    munmap((void*) p->base, p->size);
+  }
+  memset(p, 0, sizeof(*p));
+}
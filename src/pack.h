@@ -0,0 +1,59 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PACK_MAGIC 0x504C474F // "OGLP"
+#define PACK_VERSION 1
+#define PACK_ALIGNMENT 64 // every entry starts on its own cache line
+#define PACK_NAME_LENGTH 64
+
+enum PackEntryType {
+  PACK_ENTRY_RAW = 0, // bytes exactly as they were on disk (shaders, meshes, encoded images)
+  PACK_ENTRY_PIXELS = 1 // image decoded at pack time, width * height * channels bytes
+};
+
+// on-disk layout, the header is followed by the table of contents at tocOffset
+typedef struct PackHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t tocOffset;
+} PackHeader;
+
+// table of contents entries are sorted by name so lookups can binary search
+typedef struct PackEntry {
+  char name[PACK_NAME_LENGTH];
+  uint64_t offset;
+  uint64_t size;
+  uint64_t hash; // hash64 of the entry's bytes
+  uint32_t type;
+  uint32_t width;
+  uint32_t height;
+  uint32_t channels;
+} PackEntry;
+
+// a zero-copy view into the mapped archive, valid until packClose
+typedef struct PackView {
+  const unsigned char* data;
+  size_t size;
+  const PackEntry* entry;
+} PackView;
+
+typedef struct Pack {
+  const unsigned char* base;
+  size_t size;
+  const PackHeader* header;
+  const PackEntry* entries;
+} Pack;
+
+int packOpen(Pack* p, const char* path);
+
+int packFind(Pack* p, const char* name, PackView* view);
+
+int packVerify(Pack* p, PackView* view);
+
+void packClose(Pack* p);
+
+#endif
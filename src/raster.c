@@ -0,0 +1,386 @@
+#include "raster.h"
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+// four lanes evaluated at once, lowered to SSE/NEON by both gcc and clang
+typedef float RasterFloat4 __attribute__((vector_size(16)));
+typedef int RasterInt4 __attribute__((vector_size(16)));
+
+// a vertex after the vertex shader, before the perspective divide
+typedef struct RasterVertex {
+  vec4 position;
+  float u;
+  float v;
+} RasterVertex;
+
+typedef struct RasterWorker {
+  Raster* r;
+  atomic_uint* nextTile;
+  RasterStats stats;
+} RasterWorker;
+
+void rasterInit(Raster* r, int width, int height, unsigned int threadCount) {
+  memset(r, 0, sizeof(*r));
+
+  r->width = width;
+  r->height = height;
+  r->tilesX = (width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+  r->tilesY = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+  r->color = malloc((size_t) width * height * 4);
+  r->depth = malloc((size_t) width * height * sizeof(float));
+  r->bins = calloc(r->tilesX * r->tilesY, sizeof(RasterBin));
+
+  if(threadCount < 1) {
+    threadCount = 1;
+  }
+  if(threadCount > RASTER_MAX_THREADS) {
+    threadCount = RASTER_MAX_THREADS;
+  }
+  r->threadCount = threadCount;
+
+  rasterClear(r, 0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+void rasterSetTexture(Raster* r, unsigned int slot, RasterTexture* texture) {
+  if(slot < 2) {
+    r->textures[slot] = *texture;
+  }
+}
+
+// starts a new frame, the framebuffer itself is cleared tile by tile during rasterFlush
+void rasterClear(Raster* r, float red, float green, float blue, float alpha) {
+  r->clearColor[0] = red;
+  r->clearColor[1] = green;
+  r->clearColor[2] = blue;
+  r->clearColor[3] = alpha;
+
+  r->triangleCount = 0;
+  for(int i = 0; i < r->tilesX * r->tilesY; i++) {
+    r->bins[i].count = 0;
+  }
+}
+
+static void rasterBinAppend(RasterBin* bin, unsigned int triangle) {
+  if(bin->count == bin->capacity) {
+    bin->capacity = bin->capacity ? bin->capacity * 2 : 64;
+    bin->triangles = realloc(bin->triangles, bin->capacity * sizeof(unsigned int));
+  }
+  bin->triangles[bin->count++] = triangle;
+}
+
+// perspective divide and viewport transform of one triangle, then bin it into every tile its bounds touch
+static void rasterSetupTriangle(Raster* r, RasterVertex* a, RasterVertex* b, RasterVertex* c) {
+  RasterVertex* verts[3] = {a, b, c};
+  RasterTriangle tri;
+
+  for(int i = 0; i < 3; i++) {
+    float invW = 1.0f / verts[i]->position[3];
+    tri.x[i] = (verts[i]->position[0] * invW * 0.5f + 0.5f) * r->width;
+    tri.y[i] = (0.5f - verts[i]->position[1] * invW * 0.5f) * r->height;
+    tri.z[i] = verts[i]->position[2] * invW * 0.5f + 0.5f;
+    tri.invW[i] = invW;
+    tri.u[i] = verts[i]->u * invW;
+    tri.v[i] = verts[i]->v * invW;
+  }
+
+  // pixel centers sit at +0.5, so only pixels whose center is inside the bounds can be covered
+  float minX = fminf(tri.x[0], fminf(tri.x[1], tri.x[2]));
+  float maxX = fmaxf(tri.x[0], fmaxf(tri.x[1], tri.x[2]));
+  float minY = fminf(tri.y[0], fminf(tri.y[1], tri.y[2]));
+  float maxY = fmaxf(tri.y[0], fmaxf(tri.y[1], tri.y[2]));
+
+  int x0 = (int) fmaxf(ceilf(minX - 0.5f), 0.0f);
+  int y0 = (int) fmaxf(ceilf(minY - 0.5f), 0.0f);
+  int x1 = (int) fminf(floorf(maxX - 0.5f), (float) (r->width - 1));
+  int y1 = (int) fminf(floorf(maxY - 0.5f), (float) (r->height - 1));
+  if(x0 > x1 || y0 > y1) {
+    return;
+  }
+
+  if(r->triangleCount == r->triangleCapacity) {
+    r->triangleCapacity = r->triangleCapacity ? r->triangleCapacity * 2 : 1024;
+    r->triangles = realloc(r->triangles, r->triangleCapacity * sizeof(RasterTriangle));
+  }
+  unsigned int index = r->triangleCount++;
+  r->triangles[index] = tri;
+
+  for(int ty = y0 / RASTER_TILE_SIZE; ty <= y1 / RASTER_TILE_SIZE; ty++) {
+    for(int tx = x0 / RASTER_TILE_SIZE; tx <= x1 / RASTER_TILE_SIZE; tx++) {
+      rasterBinAppend(&r->bins[ty * r->tilesX + tx], index);
+      r->stats.trianglesBinned++;
+    }
+  }
+}
+
+static void rasterLerpVertex(RasterVertex* a, RasterVertex* b, float t, RasterVertex* out) {
+  glm_vec4_lerp(a->position, b->position, t, out->position);
+  out->u = a->u + (b->u - a->u) * t;
+  out->v = a->v + (b->v - a->v) * t;
+}
+
+// clips against the near plane (z >= -w) and fans the result into at most two triangles
+static void rasterClipTriangle(Raster* r, RasterVertex* in) {
+  // trivially reject triangles entirely outside one of the frustum planes
+  for(int axis = 0; axis < 3; axis++) {
+    if(in[0].position[axis] > in[0].position[3] && in[1].position[axis] > in[1].position[3] && in[2].position[axis] > in[2].position[3]) {
+      return;
+    }
+    if(in[0].position[axis] < -in[0].position[3] && in[1].position[axis] < -in[1].position[3] && in[2].position[axis] < -in[2].position[3]) {
+      return;
+    }
+  }
+
+  RasterVertex out[4];
+  int outCount = 0;
+
+  for(int i = 0; i < 3; i++) {
+    RasterVertex* current = &in[i];
+    RasterVertex* next = &in[(i + 1) % 3];
+    float dCurrent = current->position[2] + current->position[3];
+    float dNext = next->position[2] + next->position[3];
+
+    if(dCurrent >= 0.0f) {
+      out[outCount++] = *current;
+    }
+    if((dCurrent >= 0.0f) != (dNext >= 0.0f)) {
+      rasterLerpVertex(current, next, dCurrent / (dCurrent - dNext), &out[outCount++]);
+    }
+  }
+
+  for(int i = 1; i + 1 < outCount; i++) {
+    rasterSetupTriangle(r, &out[0], &out[i], &out[i + 1]);
+  }
+}
+
+// vertex stage: same layout and transform as src/VS
+void rasterDrawArrays(Raster* r, const float* vertices, unsigned int first, unsigned int count, mat4 model, mat4 view, mat4 projection) {
+  mat4 viewModel, mvp;
+  glm_mat4_mul(view, model, viewModel);
+  glm_mat4_mul(projection, viewModel, mvp);
+
+  for(unsigned int i = first; i + 2 < first + count; i += 3) {
+    RasterVertex tri[3];
+    for(int k = 0; k < 3; k++) {
+      const float* v = vertices + (size_t) (i + k) * 5;
+      vec4 position = {v[0], v[1], v[2], 1.0f};
+      glm_mat4_mulv(mvp, position, tri[k].position);
+      tri[k].u = v[3];
+      tri[k].v = v[4];
+    }
+
+    r->stats.trianglesSubmitted++;
+    rasterClipTriangle(r, tri);
+  }
+}
+
+// bilinear filtering with GL_REPEAT wrapping
+static void rasterSample(const RasterTexture* t, float u, float v, float* out) {
+  if(!t->pixels) {
+    out[0] = out[1] = out[2] = 1.0f;
+    return;
+  }
+
+  float fx = u * t->width - 0.5f;
+  float fy = v * t->height - 0.5f;
+  float flx = floorf(fx);
+  float fly = floorf(fy);
+  float ax = fx - flx;
+  float ay = fy - fly;
+
+  int x0 = ((int) flx % t->width + t->width) % t->width;
+  int y0 = ((int) fly % t->height + t->height) % t->height;
+  int x1 = (x0 + 1) % t->width;
+  int y1 = (y0 + 1) % t->height;
+
+  const unsigned char* p00 = t->pixels + ((size_t) y0 * t->width + x0) * t->channels;
+  const unsigned char* p10 = t->pixels + ((size_t) y0 * t->width + x1) * t->channels;
+  const unsigned char* p01 = t->pixels + ((size_t) y1 * t->width + x0) * t->channels;
+  const unsigned char* p11 = t->pixels + ((size_t) y1 * t->width + x1) * t->channels;
+
+  for(int c = 0; c < 3; c++) {
+    int channel = c < t->channels ? c : 0;
+    float top = p00[channel] + (p10[channel] - p00[channel]) * ax;
+    float bottom = p01[channel] + (p11[channel] - p01[channel]) * ax;
+    out[c] = (top + (bottom - top) * ay) * (1.0f / 255.0f);
+  }
+}
+
+static void rasterTriangle(Raster* r, const RasterTriangle* tri, int tileX0, int tileY0, int tileX1, int tileY1, RasterStats* stats) {
+  // edge i is opposite vertex i, written as A * x + B * y + C
+  float A[3], B[3], C[3];
+  for(int i = 0; i < 3; i++) {
+    int a = (i + 1) % 3;
+    int b = (i + 2) % 3;
+    A[i] = tri->y[a] - tri->y[b];
+    B[i] = tri->x[b] - tri->x[a];
+    C[i] = tri->x[a] * tri->y[b] - tri->y[a] * tri->x[b];
+  }
+
+  // no face culling, as in main.c, so both windings are flipped to positive area
+  float area = A[2] * tri->x[2] + B[2] * tri->y[2] + C[2];
+  if(fabsf(area) < 1e-8f) {
+    return;
+  }
+  if(area < 0.0f) {
+    for(int i = 0; i < 3; i++) {
+      A[i] = -A[i];
+      B[i] = -B[i];
+      C[i] = -C[i];
+    }
+    area = -area;
+  }
+  float invArea = 1.0f / area;
+
+  float minX = fminf(tri->x[0], fminf(tri->x[1], tri->x[2]));
+  float maxX = fmaxf(tri->x[0], fmaxf(tri->x[1], tri->x[2]));
+  float minY = fminf(tri->y[0], fminf(tri->y[1], tri->y[2]));
+  float maxY = fmaxf(tri->y[0], fmaxf(tri->y[1], tri->y[2]));
+
+  int x0 = (int) fmaxf(ceilf(minX - 0.5f), (float) tileX0);
+  int y0 = (int) fmaxf(ceilf(minY - 0.5f), (float) tileY0);
+  int x1 = (int) fminf(floorf(maxX - 0.5f), (float) tileX1);
+  int y1 = (int) fminf(floorf(maxY - 0.5f), (float) tileY1);
+
+  const RasterFloat4 laneOffset = {0.5f, 1.5f, 2.5f, 3.5f};
+  const RasterFloat4 laneIndex = {0.0f, 1.0f, 2.0f, 3.0f};
+
+  for(int y = y0; y <= y1; y++) {
+    float py = y + 0.5f;
+    float rowE0 = B[0] * py + C[0];
+    float rowE1 = B[1] * py + C[1];
+    float rowE2 = B[2] * py + C[2];
+
+    for(int x = x0; x <= x1; x += 4) {
+      RasterFloat4 px = (float) x + laneOffset;
+      RasterFloat4 e0 = A[0] * px + rowE0;
+      RasterFloat4 e1 = A[1] * px + rowE1;
+      RasterFloat4 e2 = A[2] * px + rowE2;
+
+      RasterInt4 mask = (e0 >= 0.0f) & (e1 >= 0.0f) & (e2 >= 0.0f) & (laneIndex <= (float) (x1 - x));
+      if(!(mask[0] | mask[1] | mask[2] | mask[3])) {
+        continue;
+      }
+
+      RasterFloat4 b0 = e0 * invArea;
+      RasterFloat4 b1 = e1 * invArea;
+      RasterFloat4 b2 = e2 * invArea;
+      RasterFloat4 z = b0 * tri->z[0] + b1 * tri->z[1] + b2 * tri->z[2];
+      RasterFloat4 w = 1.0f / (b0 * tri->invW[0] + b1 * tri->invW[1] + b2 * tri->invW[2]);
+      RasterFloat4 u = (b0 * tri->u[0] + b1 * tri->u[1] + b2 * tri->u[2]) * w;
+      RasterFloat4 v = (b0 * tri->v[0] + b1 * tri->v[1] + b2 * tri->v[2]) * w;
+
+      for(int lane = 0; lane < 4; lane++) {
+        if(!mask[lane]) {
+          continue;
+        }
+
+        size_t index = (size_t) y * r->width + x + lane;
+        if(z[lane] < 0.0f || z[lane] >= r->depth[index]) {
+          continue;
+        }
+        r->depth[index] = z[lane];
+
+        // fragment stage: mix(texture1, texture2, 0.2) as in src/FS
+        float texel1[3], texel2[3];
+        rasterSample(&r->textures[0], u[lane], v[lane], texel1);
+        rasterSample(&r->textures[1], u[lane], v[lane], texel2);
+
+        unsigned char* out = r->color + index * 4;
+        for(int c = 0; c < 3; c++) {
+          out[c] = (unsigned char) ((texel1[c] * 0.8f + texel2[c] * 0.2f) * 255.0f + 0.5f);
+        }
+        out[3] = 255;
+        stats->pixelsShaded++;
+      }
+    }
+  }
+}
+
+static void rasterTile(Raster* r, int tile, RasterStats* stats) {
+  int x0 = (tile % r->tilesX) * RASTER_TILE_SIZE;
+  int y0 = (tile / r->tilesX) * RASTER_TILE_SIZE;
+  int x1 = (x0 + RASTER_TILE_SIZE < r->width ? x0 + RASTER_TILE_SIZE : r->width) - 1;
+  int y1 = (y0 + RASTER_TILE_SIZE < r->height ? y0 + RASTER_TILE_SIZE : r->height) - 1;
+
+  unsigned char clear[4];
+  for(int c = 0; c < 4; c++) {
+    clear[c] = (unsigned char) (r->clearColor[c] * 255.0f + 0.5f);
+  }
+
+  for(int y = y0; y <= y1; y++) {
+    for(int x = x0; x <= x1; x++) {
+      size_t index = (size_t) y * r->width + x;
+      memcpy(r->color + index * 4, clear, 4);
+      r->depth[index] = 1.0f;
+    }
+  }
+
+  // triangles were binned in submission order, which keeps results identical to GL
+  RasterBin* bin = &r->bins[tile];
+  for(unsigned int i = 0; i < bin->count; i++) {
+    rasterTriangle(r, &r->triangles[bin->triangles[i]], x0, y0, x1, y1, stats);
+  }
+}
+
+// tiles never share pixels, so workers only need to agree on who takes the next tile
+static void* rasterWorkerMain(void* arg) {
+  RasterWorker* w = arg;
+  unsigned int tileCount = w->r->tilesX * w->r->tilesY;
+
+  for(;;) {
+    unsigned int tile = atomic_fetch_add(w->nextTile, 1);
+    if(tile >= tileCount) {
+      break;
+    }
+    rasterTile(w->r, tile, &w->stats);
+  }
+
+  return NULL;
+}
+
+void rasterFlush(Raster* r) {
+  atomic_uint nextTile;
+  atomic_init(&nextTile, 0);
+
+  RasterWorker workers[RASTER_MAX_THREADS];
+  pthread_t threads[RASTER_MAX_THREADS];
+
+  for(unsigned int i = 0; i < r->threadCount; i++) {
+    workers[i].r = r;
+    workers[i].nextTile = &nextTile;
+    memset(&workers[i].stats, 0, sizeof(RasterStats));
+  }
+
+  // the calling thread works as worker 0
+  for(unsigned int i = 1; i < r->threadCount; i++) {
+    pthread_create(&threads[i], NULL, rasterWorkerMain, &workers[i]);
+  }
+  rasterWorkerMain(&workers[0]);
+  for(unsigned int i = 1; i < r->threadCount; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  for(unsigned int i = 0; i < r->threadCount; i++) {
+    r->stats.pixelsShaded += workers[i].stats.pixelsShaded;
+  }
+}
+
+int rasterWritePPM(Raster* r, const char* path) {
+  return imageWritePPM(path, r->color, r->width, r->height, 0);
+}
+
+void rasterFree(Raster* r) {
+  for(int i = 0; i < r->tilesX * r->tilesY; i++) {
+    free(r->bins[i].triangles);
+  }
+  free(r->bins);
+  free(r->triangles);
+  free(r->color);
+  free(r->depth);
+  memset(r, 0, sizeof(*r));
+}
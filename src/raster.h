@@ -0,0 +1,73 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <cglm/cglm.h>
+
+#define RASTER_TILE_SIZE 64
+#define RASTER_MAX_THREADS 32
+
+// decoded image in stb_image layout, row 0 is sampled at v = 0 just like glTexImage2D
+typedef struct RasterTexture {
+  const unsigned char* pixels;
+  int width;
+  int height;
+  int channels;
+} RasterTexture;
+
+// a clipped triangle in screen space, ready to be rasterized by any tile it overlaps
+typedef struct RasterTriangle {
+  float x[3];
+  float y[3];
+  float z[3]; // window depth in [0, 1]
+  float invW[3];
+  float u[3]; // texture coordinates pre-divided by w for perspective correction
+  float v[3];
+} RasterTriangle;
+
+typedef struct RasterBin {
+  unsigned int* triangles;
+  unsigned int count;
+  unsigned int capacity;
+} RasterBin;
+
+typedef struct RasterStats {
+  unsigned long long trianglesSubmitted;
+  unsigned long long trianglesBinned; // after clipping, one triangle may land in several tiles
+  unsigned long long pixelsShaded; // fragments that passed the depth test
+} RasterStats;
+
+// CPU implementation of src/VS + src/FS: position/uv vertices, depth test, two bilinear textures mixed 80/20
+typedef struct Raster {
+  int width;
+  int height;
+  int tilesX;
+  int tilesY;
+  unsigned char* color; // RGBA8, row 0 is the top of the image
+  float* depth;
+  float clearColor[4];
+
+  RasterTriangle* triangles;
+  unsigned int triangleCount;
+  unsigned int triangleCapacity;
+  RasterBin* bins;
+
+  RasterTexture textures[2];
+  unsigned int threadCount;
+  RasterStats stats;
+} Raster;
+
+void rasterInit(Raster* r, int width, int height, unsigned int threadCount);
+
+void rasterSetTexture(Raster* r, unsigned int slot, RasterTexture* texture);
+
+void rasterClear(Raster* r, float red, float green, float blue, float alpha);
+
+void rasterDrawArrays(Raster* r, const float* vertices, unsigned int first, unsigned int count, mat4 model, mat4 view, mat4 projection);
+
+void rasterFlush(Raster* r);
+
+int rasterWritePPM(Raster* r, const char* path);
+
+void rasterFree(Raster* r);
+
+#endif
@@ -0,0 +1,282 @@
+#include "residency.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
+
+#define RESIDENCY_TEXTURE_UNIT 4 // scratch unit, respecifying a texture never rebinds a unit something samples from
+
+size_t textureResidencyBytes(int width, int height) {
+  TextureFormat format;
+  textureChooseFormat(4, width, &format);
+  return textureFormatBytes(&format, width, height);
+}
+
+void textureResidencyInit(TextureResidency* r, size_t budget, ResidencyLoadFunction load, void* user) {
+  memset(r, 0, sizeof(*r));
+  r->budget = budget;
+  r->load = load;
+  r->user = user;
+  timingInit(&r->stats.reloadTimes);
+}
+
+// respecifies level 0 with new pixels and rebuilds the mips, the texture keeps its ID.
+// pixels is an offset when a pixel unpack buffer is bound
+static void residencyStore(TextureResidency* r, ResidentTexture* t, const unsigned char* pixels, int width, int height) {
+  TextureFormat format;
+  textureChooseFormat(4, width, &format);
+
+  glActiveTexture(GL_TEXTURE0 + RESIDENCY_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D, t->texture.ID);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+  glGenerateMipmap(GL_TEXTURE_2D);
+
+  r->residentBytes -= t->bytes;
+  t->bytes = textureFormatBytes(&format, width, height);
+  r->residentBytes += t->bytes;
+  t->texture.width = width;
+  t->texture.height = height;
+  t->texture.internalFormat = format.internalFormat;
+  t->texture.bytes = t->bytes;
+  if(r->residentBytes > r->stats.peakBytes) {
+    r->stats.peakBytes = r->residentBytes;
+  }
+}
+
+// decodes the source again and stores it at full resolution
+static int residencyLoad(TextureResidency* r, ResidentTexture* t) {
+  int width, height;
+  unsigned char* pixels = r->load(r->user, t->name, &width, &height);
+  if(!pixels) {
+    printf("ERROR::RESIDENCY::LOAD_FAILED: %s\n", t->name);
+    return -1;
+  }
+
+  if(t->flip) {
+    size_t rowSize = (size_t) width * 4;
+    unsigned char* row = malloc(rowSize);
+    for(int y = 0; y < height / 2; y++) {
+      unsigned char* top = pixels + rowSize * y;
+      unsigned char* bottom = pixels + rowSize * (height - 1 - y);
+      memcpy(row, top, rowSize);
+      memcpy(top, bottom, rowSize);
+      memcpy(bottom, row, rowSize);
+    }
+    free(row);
+  }
+
+  residencyStore(r, t, pixels, width, height);
+  free(pixels);
+
+  t->width = width;
+  t->height = height;
+  t->level = 0;
+  t->evicted = 0;
+  return 0;
+}
+
+int textureResidencyAdd(TextureResidency* r, const char* name, unsigned int textureUnit, int flip) {
+  if(strlen(name) >= RESIDENCY_NAME_LENGTH) {
+    printf("ERROR::RESIDENCY::NAME_TOO_LONG: %s\n", name);
+    return -1;
+  }
+
+  if(r->count == r->capacity) {
+    r->capacity = r->capacity ? r->capacity * 2 : 8;
+    r->textures = realloc(r->textures, r->capacity * sizeof(ResidentTexture));
+  }
+
+  ResidentTexture* t = &r->textures[r->count];
+  memset(t, 0, sizeof(*t));
+  strcpy(t->name, name);
+  t->flip = flip;
+  t->lastUsed = r->frame;
+  t->texture.textureUnit = textureUnit;
+
+  glGenTextures(1, &t->texture.ID);
+  glActiveTexture(textureUnit);
+  glBindTexture(GL_TEXTURE_2D, t->texture.ID);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  if(residencyLoad(r, t) != 0) {
+    glDeleteTextures(1, &t->texture.ID);
+    return -1;
+  }
+  return (int) r->count++;
+}
+
+Texture* textureResidencyGet(TextureResidency* r, int handle) {
+  return &r->textures[handle].texture;
+}
+
+// the readback is dropped and the texture keeps its full resolution storage
+static void residencyDemoteCancel(TextureResidency* r, ResidentTexture* t) {
+  ResidencyReadback* rb = &r->readbacks[t->demoting - 1];
+  glDeleteSync(rb->fence);
+  rb->fence = 0;
+  r->demotingBytes -= t->bytes - textureResidencyBytes(rb->width, rb->height);
+  t->demoting = 0;
+  r->stats.cancelledDemotions++;
+}
+
+void textureResidencyUse(TextureResidency* r, int handle) {
+  ResidentTexture* t = &r->textures[handle];
+  t->lastUsed = r->frame;
+  if(t->demoting) {
+    residencyDemoteCancel(r, t);
+  }
+  if(t->level == 0 && !t->evicted) {
+    return;
+  }
+
+  double start = timingNow();
+  if(residencyLoad(r, t) == 0) {
+    r->stats.reloads++;
+    timingAdd(&r->stats.reloadTimes, (timingNow() - start) * 1000.0);
+  }
+}
+
+// copies a smaller mip into a pixel pack buffer, a later update makes it the whole texture once
+// the copy is done, far cheaper than decoding the source again and without stalling on the GPU.
+// returns -1 when every readback slot is in flight
+static int residencyDemoteBegin(TextureResidency* r, ResidentTexture* t) {
+  ResidencyReadback* rb = NULL;
+  for(int i = 0; i < RESIDENCY_READBACKS && !rb; i++) {
+    if(!r->readbacks[i].fence) {
+      rb = &r->readbacks[i];
+    }
+  }
+  if(!rb) {
+    return -1;
+  }
+
+  int width = t->width >> RESIDENCY_DEMOTE_LEVELS;
+  int height = t->height >> RESIDENCY_DEMOTE_LEVELS;
+  rb->width = width > 0 ? width : 1;
+  rb->height = height > 0 ? height : 1;
+  rb->texture = (unsigned int) (t - r->textures);
+
+  size_t size = (size_t) rb->width * rb->height * 4;
+  if(!rb->PBO) {
+    glGenBuffers(1, &rb->PBO);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, rb->PBO);
+  if(rb->size < size) {
+    glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) size, NULL, GL_STREAM_COPY);
+    rb->size = size;
+  }
+
+  glActiveTexture(GL_TEXTURE0 + RESIDENCY_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D, t->texture.ID);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glGetTexImage(GL_TEXTURE_2D, RESIDENCY_DEMOTE_LEVELS, GL_RGBA, GL_UNSIGNED_BYTE, (void*) 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  rb->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  t->demoting = (int) (rb - r->readbacks) + 1;
+  r->demotingBytes += t->bytes - textureResidencyBytes(rb->width, rb->height);
+  return 0;
+}
+
+// respecifies every texture whose readback has landed, straight from the buffer
+static void residencyDemoteFinish(TextureResidency* r) {
+  for(int i = 0; i < RESIDENCY_READBACKS; i++) {
+    ResidencyReadback* rb = &r->readbacks[i];
+    if(!rb->fence) {
+      continue;
+    }
+    GLenum status = glClientWaitSync(rb->fence, 0, 0);
+    if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+      continue;
+    }
+    glDeleteSync(rb->fence);
+    rb->fence = 0;
+
+    ResidentTexture* t = &r->textures[rb->texture];
+    r->demotingBytes -= t->bytes - textureResidencyBytes(rb->width, rb->height);
+    t->demoting = 0;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, rb->PBO);
+    residencyStore(r, t, (const unsigned char*) 0, rb->width, rb->height);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    t->level = RESIDENCY_DEMOTE_LEVELS;
+    r->stats.demotions++;
+  }
+}
+
+// a single texel keeps the ID valid and sampleable
+static void residencyEvict(TextureResidency* r, ResidentTexture* t) {
+  const unsigned char placeholder[4] = {128, 128, 128, 255};
+  residencyStore(r, t, placeholder, 1, 1);
+  t->evicted = 1;
+  r->stats.evictions++;
+}
+
+void textureResidencyUpdate(TextureResidency* r) {
+  residencyDemoteFinish(r);
+
+  // anything used during the frame that just ended stays, the rest goes least recent first.
+  // demotions in flight already count as done
+  while(r->residentBytes - r->demotingBytes > r->budget) {
+    ResidentTexture* victim = NULL;
+    for(unsigned int i = 0; i < r->count; i++) {
+      ResidentTexture* t = &r->textures[i];
+      if(t->evicted || t->demoting || t->lastUsed == r->frame) {
+        continue;
+      }
+      if(!victim || t->lastUsed < victim->lastUsed) {
+        victim = t;
+      }
+    }
+
+    if(!victim) {
+      r->stats.overBudgetFrames++;
+      break;
+    }
+
+    int demotable = victim->level == 0 && (victim->width >> RESIDENCY_DEMOTE_LEVELS) > 0 && (victim->height >> RESIDENCY_DEMOTE_LEVELS) > 0;
+    if(demotable) {
+      // every readback slot is busy, the rest waits for a later frame
+      if(residencyDemoteBegin(r, victim) != 0) {
+        break;
+      }
+    }
+    else {
+      residencyEvict(r, victim);
+    }
+  }
+
+  r->frame++;
+}
+
+void textureResidencyReport(TextureResidency* r) {
+  ResidencyStats* stats = &r->stats;
+  unsigned int demoted = 0, evicted = 0;
+  for(unsigned int i = 0; i < r->count; i++) {
+    evicted += r->textures[i].evicted;
+    demoted += !r->textures[i].evicted && r->textures[i].level > 0;
+  }
+  printf("texture residency: %u textures, %.2f MB resident of a %.2f MB budget, peak %.2f MB, %u demoted, %u evicted\n",
+      r->count, r->residentBytes / (1024.0 * 1024.0), r->budget / (1024.0 * 1024.0), stats->peakBytes / (1024.0 * 1024.0), demoted, evicted);
+  printf("texture residency: %llu demotions (%llu cancelled), %llu evictions, %llu reloads, %u frames over budget\n",
+      stats->demotions, stats->cancelledDemotions, stats->evictions, stats->reloads, stats->overBudgetFrames);
+  timingReport(&stats->reloadTimes, "texture reload");
+}
+
+void textureResidencyFree(TextureResidency* r) {
+  for(int i = 0; i < RESIDENCY_READBACKS; i++) {
+    if(r->readbacks[i].fence) {
+      glDeleteSync(r->readbacks[i].fence);
+    }
+    glDeleteBuffers(1, &r->readbacks[i].PBO);
+  }
+  for(unsigned int i = 0; i < r->count; i++) {
+    glDeleteTextures(1, &r->textures[i].texture.ID);
+  }
+  free(r->textures);
+  timingFree(&r->stats.reloadTimes);
+}
@@ -0,0 +1,89 @@
+#ifndef RESIDENCY_H
+#define RESIDENCY_H
+
+#include <stddef.h>
+#include <glad/glad.h>
+#include "texture.h"
+#include "timing.h"
+
+#define RESIDENCY_NAME_LENGTH 64
+#define RESIDENCY_DEMOTE_LEVELS 2 // an idle texture first drops to quarter resolution, a sixteenth of the memory
+#define RESIDENCY_READBACKS 4 // demotions whose smaller mip can be on its way back at once
+
+// RGBA pixels with the top row first, released with free
+typedef unsigned char* (*ResidencyLoadFunction)(void* user, const char* name, int* width, int* height);
+
+typedef struct ResidentTexture {
+  char name[RESIDENCY_NAME_LENGTH];
+  Texture texture; // the ID never changes, demoting or evicting only respecifies its storage
+  int flip;
+  int width; // full resolution
+  int height;
+  int level; // mip level of the full image currently stored as level 0
+  int evicted; // storage replaced by a 1x1 placeholder
+  int demoting; // readback slot + 1 while the smaller mip is copied out, 0 otherwise
+  unsigned int lastUsed; // frame of the last textureResidencyUse
+  size_t bytes; // estimated VRAM of the current storage, mips included
+} ResidentTexture;
+
+// the smaller mip of a demotion, copied into a pixel pack buffer and used once its fence has signalled
+typedef struct ResidencyReadback {
+  unsigned int PBO;
+  size_t size;
+  GLsync fence; // 0 when the slot is free
+  unsigned int texture; // index into textures
+  int width;
+  int height;
+} ResidencyReadback;
+
+typedef struct ResidencyStats {
+  size_t peakBytes;
+  unsigned long long demotions;
+  unsigned long long cancelledDemotions; // used again before the readback arrived
+  unsigned long long evictions;
+  unsigned long long reloads;
+  unsigned int overBudgetFrames; // frames where everything over the budget was still in use
+  Timing reloadTimes; // milliseconds to bring a texture back to full resolution
+} ResidencyStats;
+
+// keeps the estimated VRAM of its textures under a budget by demoting, then evicting,
+// the least recently used ones, and reloads them from the source when they are used again
+typedef struct TextureResidency {
+  ResidentTexture* textures;
+  unsigned int count;
+  unsigned int capacity;
+  size_t budget;
+  size_t residentBytes;
+  size_t demotingBytes; // what the demotions in flight will free once they land
+  unsigned int frame;
+
+  ResidencyReadback readbacks[RESIDENCY_READBACKS];
+
+  ResidencyLoadFunction load;
+  void* user;
+
+  ResidencyStats stats;
+} TextureResidency;
+
+void textureResidencyInit(TextureResidency* r, size_t budget, ResidencyLoadFunction load, void* user);
+
+// loads at full resolution, returns a handle or -1
+int textureResidencyAdd(TextureResidency* r, const char* name, unsigned int textureUnit, int flip);
+
+Texture* textureResidencyGet(TextureResidency* r, int handle);
+
+// marks the texture as needed this frame, reloading it first when it was demoted or evicted
+void textureResidencyUse(TextureResidency* r, int handle);
+
+// starts a frame and brings the estimate back under budget with textures unused last frame
+void textureResidencyUpdate(TextureResidency* r);
+
+// bytes of a four channel image with a full mip chain
+size_t textureResidencyBytes(int width, int height);
+
+void textureResidencyReport(TextureResidency* r);
+
+// deletes every texture
+void textureResidencyFree(TextureResidency* r);
+
+#endif
@@ -0,0 +1,248 @@
+#include "resource.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RESOURCE_INDEX_MASK ((1u << RESOURCE_INDEX_BITS) - 1)
+#define RESOURCE_GENERATION_MASK ((1u << RESOURCE_GENERATION_BITS) - 1)
+#define RESOURCE_TYPE_SHIFT (RESOURCE_INDEX_BITS + RESOURCE_GENERATION_BITS)
+
+static const char* resourceTypeNames[RESOURCE_TYPE_COUNT] = {"texture", "buffer", "vertex array", "program", "framebuffer"};
+
+void resourceRegistryInit(ResourceRegistry* r) {
+  memset(r, 0, sizeof(*r));
+}
+
+static ResourceHandle resourceHandle(enum ResourceType type, uint32_t index, uint8_t generation) {
+  return (uint32_t) type << RESOURCE_TYPE_SHIFT | (uint32_t) generation << RESOURCE_INDEX_BITS | index;
+}
+
+// the live slot a handle points at, NULL when it is stale or malformed, 0 is quietly ignored
+static ResourceSlot* resourceSlot(ResourceRegistry* r, ResourceHandle h) {
+  if(!h) {
+    return NULL;
+  }
+  uint32_t type = h >> RESOURCE_TYPE_SHIFT;
+  uint32_t index = h & RESOURCE_INDEX_MASK;
+  uint32_t generation = (h >> RESOURCE_INDEX_BITS) & RESOURCE_GENERATION_MASK;
+  if(type >= RESOURCE_TYPE_COUNT || index >= r->pools[type].count) {
+    return NULL;
+  }
+
+  ResourceSlot* slot = &r->pools[type].slots[index];
+  if(slot->state != RESOURCE_LIVE || slot->generation != generation) {
+    r->stats.staleHandles++;
+    return NULL;
+  }
+  return slot;
+}
+
+ResourceHandle resourceCreate(ResourceRegistry* r, enum ResourceType type, unsigned int name, const char* label) {
+  ResourcePool* pool = &r->pools[type];
+  uint32_t index;
+  if(pool->freeHead) {
+    index = pool->freeHead - 1;
+    pool->freeHead = pool->slots[index].nextFree;
+  }
+  else {
+    if(pool->count > RESOURCE_INDEX_MASK) {
+      printf("ERROR::RESOURCE::POOL_FULL: %s\n", resourceTypeNames[type]);
+      return 0;
+    }
+    if(pool->count == pool->capacity) {
+      pool->capacity = pool->capacity ? pool->capacity * 2 : 64;
+      pool->slots = realloc(pool->slots, pool->capacity * sizeof(ResourceSlot));
+    }
+    index = pool->count++;
+    pool->slots[index].generation = 1;
+  }
+
+  ResourceSlot* slot = &pool->slots[index];
+  slot->name = name;
+  slot->state = RESOURCE_LIVE;
+  slot->nextFree = 0;
+  slot->lastUsed = r->frame;
+  snprintf(slot->label, sizeof(slot->label), "%s", label ? label : "");
+
+  pool->live++;
+  if(pool->live > pool->peakLive) {
+    pool->peakLive = pool->live;
+  }
+  r->stats.created++;
+  return resourceHandle(type, index, slot->generation);
+}
+
+unsigned int resourceGet(ResourceRegistry* r, ResourceHandle h) {
+  ResourceSlot* slot = resourceSlot(r, h);
+  return slot ? slot->name : 0;
+}
+
+void resourceUse(ResourceRegistry* r, ResourceHandle h) {
+  ResourceSlot* slot = resourceSlot(r, h);
+  if(slot) {
+    slot->lastUsed = r->frame;
+  }
+}
+
+static void resourceDeleteName(enum ResourceType type, unsigned int name) {
+  switch(type) {
+    case RESOURCE_TEXTURE:
+      glDeleteTextures(1, &name);
+      break;
+    case RESOURCE_BUFFER:
+      glDeleteBuffers(1, &name);
+      break;
+    case RESOURCE_VERTEX_ARRAY:
+      glDeleteVertexArrays(1, &name);
+      break;
+    case RESOURCE_PROGRAM:
+      glDeleteProgram(name);
+      break;
+    case RESOURCE_FRAMEBUFFER:
+      glDeleteFramebuffers(1, &name);
+      break;
+    default:
+      break;
+  }
+}
+
+// deletes the GL object and puts the slot back on its free list
+static void resourceRelease(ResourceRegistry* r, enum ResourceType type, uint32_t index) {
+  ResourcePool* pool = &r->pools[type];
+  ResourceSlot* slot = &pool->slots[index];
+  resourceDeleteName(type, slot->name);
+  slot->name = 0;
+  slot->state = RESOURCE_FREE;
+  slot->nextFree = pool->freeHead;
+  pool->freeHead = index + 1;
+  r->stats.destroyed++;
+}
+
+void resourceDestroy(ResourceRegistry* r, ResourceHandle h) {
+  if(!h) {
+    return;
+  }
+  ResourceSlot* slot = resourceSlot(r, h);
+  if(!slot) {
+    printf("ERROR::RESOURCE::STALE_HANDLE: %08x\n", h);
+    return;
+  }
+
+  enum ResourceType type = h >> RESOURCE_TYPE_SHIFT;
+  uint32_t index = h & RESOURCE_INDEX_MASK;
+  r->pools[type].live--;
+
+  // the generation moves on now so the old handle is stale even before the slot is reused, 0 is skipped
+  slot->generation = (slot->generation + 1) & RESOURCE_GENERATION_MASK;
+  slot->generation += slot->generation == 0;
+
+  if(slot->lastUsed < r->completed) {
+    resourceRelease(r, type, index);
+    return;
+  }
+
+  slot->state = RESOURCE_PENDING;
+  if(r->pendingCount == r->pendingCapacity) {
+    r->pendingCapacity = r->pendingCapacity ? r->pendingCapacity * 2 : 64;
+    r->pending = realloc(r->pending, r->pendingCapacity * sizeof(ResourceHandle));
+  }
+  r->pending[r->pendingCount++] = resourceHandle(type, index, 0);
+  r->stats.deferred++;
+  if(r->pendingCount > r->stats.peakPending) {
+    r->stats.peakPending = r->pendingCount;
+  }
+}
+
+// retires the oldest fence, blocking on it when wait is set
+static int resourceRetireFence(ResourceRegistry* r, int wait) {
+  GLsync fence = r->fences[r->fenceHead];
+  GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, wait ? 1000000000ull : 0);
+  if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+    return 0;
+  }
+  glDeleteSync(fence);
+  r->completed = r->fenceFrames[r->fenceHead] + 1;
+  r->fenceHead = (r->fenceHead + 1) % RESOURCE_MAX_FRAMES;
+  r->fenceCount--;
+  return 1;
+}
+
+// forgets the oldest fence without advancing completed, the next fence that retires covers its frame
+static void resourceDropFence(ResourceRegistry* r) {
+  glDeleteSync(r->fences[r->fenceHead]);
+  r->fenceHead = (r->fenceHead + 1) % RESOURCE_MAX_FRAMES;
+  r->fenceCount--;
+}
+
+static void resourceCollect(ResourceRegistry* r) {
+  unsigned int kept = 0;
+  for(unsigned int i = 0; i < r->pendingCount; i++) {
+    ResourceHandle h = r->pending[i];
+    enum ResourceType type = h >> RESOURCE_TYPE_SHIFT;
+    uint32_t index = h & RESOURCE_INDEX_MASK;
+    if(r->pools[type].slots[index].lastUsed < r->completed) {
+      resourceRelease(r, type, index);
+    }
+    else {
+      r->pending[kept++] = h;
+    }
+  }
+  r->pendingCount = kept;
+}
+
+void resourceFrame(ResourceRegistry* r) {
+  // the ring is full, a fence that does not signal within a second is dropped to make room
+  if(r->fenceCount == RESOURCE_MAX_FRAMES) {
+    r->stats.fenceWaits++;
+    if(!resourceRetireFence(r, 1)) {
+      resourceDropFence(r);
+    }
+  }
+  unsigned int tail = (r->fenceHead + r->fenceCount) % RESOURCE_MAX_FRAMES;
+  r->fences[tail] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  r->fenceFrames[tail] = r->frame;
+  r->fenceCount++;
+
+  while(r->fenceCount && resourceRetireFence(r, 0)) {
+  }
+  resourceCollect(r);
+  r->frame++;
+}
+
+void resourceReport(ResourceRegistry* r) {
+  ResourceStats* stats = &r->stats;
+  printf("resources: %llu created, %llu destroyed, %llu deferred to a fence, peak %u pending, %llu stale handles, %u fence waits\n",
+      stats->created, stats->destroyed, stats->deferred, stats->peakPending, stats->staleHandles, stats->fenceWaits);
+  for(int type = 0; type < RESOURCE_TYPE_COUNT; type++) {
+    ResourcePool* pool = &r->pools[type];
+    if(pool->count) {
+      printf("resources: %s, %u live, peak %u, %u slots\n", resourceTypeNames[type], pool->live, pool->peakLive, pool->count);
+    }
+  }
+}
+
+void resourceRegistryFree(ResourceRegistry* r) {
+  // nothing else gets submitted, a fence that does not signal within a second is dropped
+  while(r->fenceCount) {
+    if(!resourceRetireFence(r, 1)) {
+      resourceDropFence(r);
+    }
+  }
+  r->completed = r->frame + 1;
+  resourceCollect(r);
+
+  for(int type = 0; type < RESOURCE_TYPE_COUNT; type++) {
+    ResourcePool* pool = &r->pools[type];
+    for(uint32_t i = 0; i < pool->count; i++) {
+      if(pool->slots[i].state == RESOURCE_LIVE) {
+        printf("ERROR::RESOURCE::LEAKED: %s %u \"%s\"\n", resourceTypeNames[type], pool->slots[i].name, pool->slots[i].label);
+        resourceDeleteName(type, pool->slots[i].name);
+      }
+    }
+  }
+
+  for(int type = 0; type < RESOURCE_TYPE_COUNT; type++) {
+    free(r->pools[type].slots);
+  }
+  free(r->pending);
+}
@@ -0,0 +1,101 @@
+#ifndef RESOURCE_H
+#define RESOURCE_H
+
+#include <stdint.h>
+#include <glad/glad.h>
+
+// handle layout: type in the top 4 bits, then an 8 bit generation, then a 20 bit slot index.
+// the generation starts at 1, so 0 is never a valid handle and can mean "none"
+#define RESOURCE_INDEX_BITS 20
+#define RESOURCE_GENERATION_BITS 8
+#define RESOURCE_MAX_FRAMES 4 // frames the CPU may run ahead of the GPU before resourceFrame waits
+#define RESOURCE_LABEL_LENGTH 32
+
+typedef uint32_t ResourceHandle;
+
+enum ResourceType {
+  RESOURCE_TEXTURE,
+  RESOURCE_BUFFER,
+  RESOURCE_VERTEX_ARRAY,
+  RESOURCE_PROGRAM,
+  RESOURCE_FRAMEBUFFER,
+  RESOURCE_TYPE_COUNT
+};
+
+enum ResourceState {
+  RESOURCE_FREE,
+  RESOURCE_LIVE,
+  RESOURCE_PENDING // destroyed, the GL name waits for the GPU to finish the last frame that used it
+};
+
+typedef struct ResourceSlot {
+  unsigned int name; // GL object name
+  uint8_t generation;
+  uint8_t state;
+  uint32_t nextFree;
+  unsigned int lastUsed; // frame
+  char label[RESOURCE_LABEL_LENGTH];
+} ResourceSlot;
+
+typedef struct ResourcePool {
+  ResourceSlot* slots;
+  uint32_t count;
+  uint32_t capacity;
+  uint32_t freeHead; // slot index + 1, 0 when the free list is empty
+  unsigned int live;
+  unsigned int peakLive;
+} ResourcePool;
+
+typedef struct ResourceStats {
+  unsigned long long created;
+  unsigned long long destroyed;
+  unsigned long long deferred; // deletes that had to wait for a fence
+  unsigned long long staleHandles; // lookups and destroys through a handle whose slot was reused
+  unsigned int peakPending;
+  unsigned int fenceWaits; // frames where the CPU got RESOURCE_MAX_FRAMES ahead and blocked
+} ResourceStats;
+
+// owns GL objects behind generational handles, one pool and free list per type.
+// deletion is deferred until the fence of the last frame that used the object has signalled,
+// so a delete never forces the driver to wait on, or ghost, something still in flight
+typedef struct ResourceRegistry {
+  ResourcePool pools[RESOURCE_TYPE_COUNT];
+
+  ResourceHandle* pending;
+  unsigned int pendingCount;
+  unsigned int pendingCapacity;
+
+  GLsync fences[RESOURCE_MAX_FRAMES]; // ring, oldest at fenceHead
+  unsigned int fenceFrames[RESOURCE_MAX_FRAMES];
+  unsigned int fenceHead;
+  unsigned int fenceCount;
+
+  unsigned int frame;
+  unsigned int completed; // every frame before this one has finished on the GPU
+
+  ResourceStats stats;
+} ResourceRegistry;
+
+void resourceRegistryInit(ResourceRegistry* r);
+
+// takes ownership of an existing GL object, the label shows up in the leak report
+ResourceHandle resourceCreate(ResourceRegistry* r, enum ResourceType type, unsigned int name, const char* label);
+
+// the GL name, 0 when the handle is stale or was never valid
+unsigned int resourceGet(ResourceRegistry* r, ResourceHandle h);
+
+// the object is read by commands issued this frame
+void resourceUse(ResourceRegistry* r, ResourceHandle h);
+
+// invalidates the handle at once, the GL object goes when the GPU is done with it
+void resourceDestroy(ResourceRegistry* r, ResourceHandle h);
+
+// ends a frame: fences it, then deletes everything whose last frame has finished
+void resourceFrame(ResourceRegistry* r);
+
+void resourceReport(ResourceRegistry* r);
+
+// waits for the GPU, reports and deletes anything never destroyed
+void resourceRegistryFree(ResourceRegistry* r);
+
+#endif
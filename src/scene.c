@@ -0,0 +1,108 @@
+#include "scene.h"
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// an array of count elements at offset has to fit and keep the alignment the writer gave it
+static int sceneRangeValid(uint64_t offset, uint64_t count, uint64_t elementSize, size_t size) {
+  return offset % SCENE_ALIGNMENT == 0 && offset <= size && count * elementSize <= size - offset;
+}
+
+// every name has to end inside its slot, so the lookups can hand out pointers into the table
+static int sceneNamesValid(const unsigned char* names, uint64_t count) {
+  for(uint64_t i = 0; i < count; i++) {
+    if(!memchr(names + i * SCENE_NAME_LENGTH, 0, SCENE_NAME_LENGTH)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// maps the whole file read-only, returns 0 on success
+int sceneOpen(Scene* s, const char* path) {
+  memset(s, 0, sizeof(*s));
+
+  int fd = open(path, O_RDONLY);
+  if(fd < 0) {
+    printf("ERROR::SCENE::FILE_NOT_FOUND: %s\n", path);
+    return -1;
+  }
+
+  struct stat st;
+  if(fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(SceneFileHeader)) {
+    printf("ERROR::SCENE::INVALID_FILE: %s\n", path);
+    close(fd);
+    return -1;
+  }
+
+  void* base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd); // the mapping keeps the file alive
+  if(base == MAP_FAILED) {
+    printf("ERROR::SCENE::MMAP_FAILED: %s\n", path);
+    return -1;
+  }
+
+  const SceneFileHeader* h = base;
+  size_t size = st.st_size;
+  uint64_t objects = h->objectCount;
+  int valid = h->magic == SCENE_MAGIC && h->version == SCENE_VERSION
+      && sceneRangeValid(h->positionOffset, objects, sizeof(vec3), size)
+      && sceneRangeValid(h->rotationOffset, objects, sizeof(versor), size)
+      && sceneRangeValid(h->scaleOffset, objects, sizeof(vec3), size)
+      && sceneRangeValid(h->meshOffset, objects, sizeof(uint32_t), size)
+      && sceneRangeValid(h->materialOffset, objects, sizeof(uint32_t), size)
+      && sceneRangeValid(h->boundsMinOffset, objects, sizeof(vec3), size)
+      && sceneRangeValid(h->boundsMaxOffset, objects, sizeof(vec3), size)
+      && sceneRangeValid(h->meshNameOffset, h->meshCount, SCENE_NAME_LENGTH, size)
+      && sceneRangeValid(h->materialNameOffset, h->materialCount, SCENE_NAME_LENGTH, size);
+  valid = valid && sceneNamesValid((const unsigned char*) base + h->meshNameOffset, h->meshCount)
+      && sceneNamesValid((const unsigned char*) base + h->materialNameOffset, h->materialCount);
+  if(!valid) {
+    printf("ERROR::SCENE::INVALID_FILE: %s\n", path);
+    munmap(base, size);
+    return -1;
+  }
+
+  s->base = base;
+  s->size = size;
+  s->header = h;
+  s->objectCount = h->objectCount;
+  s->meshCount = h->meshCount;
+  s->materialCount = h->materialCount;
+
+  // the mapping is read-only, the casts only drop const for cglm's signatures
+  s->positions = (vec3*) (s->base + h->positionOffset);
+  s->rotations = (versor*) (s->base + h->rotationOffset);
+  s->scales = (vec3*) (s->base + h->scaleOffset);
+  s->meshes = (const uint32_t*) (s->base + h->meshOffset);
+  s->materials = (const uint32_t*) (s->base + h->materialOffset);
+  s->boundsMin = (vec3*) (s->base + h->boundsMinOffset);
+  s->boundsMax = (vec3*) (s->base + h->boundsMaxOffset);
+  s->meshNames = (const char*) (s->base + h->meshNameOffset);
+  s->materialNames = (const char*) (s->base + h->materialNameOffset);
+  return 0;
+}
+
+const char* sceneMeshName(Scene* s, unsigned int mesh) {
+  return mesh < s->meshCount ? s->meshNames + (size_t) mesh * SCENE_NAME_LENGTH : "";
+}
+
+const char* sceneMaterialName(Scene* s, unsigned int material) {
+  return material < s->materialCount ? s->materialNames + (size_t) material * SCENE_NAME_LENGTH : "";
+}
+
+void sceneModel(Scene* s, unsigned int object, mat4 model) {
+  glm_translate_make(model, s->positions[object]);
+  glm_quat_rotate(model, s->rotations[object], model);
+  glm_scale(model, s->scales[object]);
+}
+
+void sceneClose(Scene* s) {
+  if(s->base) {
+    munmap((void*) s->base, s->size);
+  }
+  memset(s, 0, sizeof(*s));
+}
@@ -0,0 +1,65 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cglm/cglm.h>
+
+#define SCENE_MAGIC 0x4E435353 // "SSCN"
+#define SCENE_VERSION 1
+#define SCENE_ALIGNMENT 64 // every array starts on its own cache line
+#define SCENE_NAME_LENGTH 64
+
+// on-disk layout written by tools/scenec.c. per-object data is structure of arrays,
+// objectCount entries each, so a pass over one field streams through only that field
+typedef struct SceneFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t objectCount;
+  uint32_t meshCount;
+  uint32_t materialCount;
+  uint32_t reserved;
+  uint64_t positionOffset; // vec3
+  uint64_t rotationOffset; // unit quaternion, x y z w
+  uint64_t scaleOffset; // vec3
+  uint64_t meshOffset; // uint32_t index into the mesh names
+  uint64_t materialOffset; // uint32_t index into the material names
+  uint64_t boundsMinOffset; // vec3, world space
+  uint64_t boundsMaxOffset; // vec3, world space
+  uint64_t meshNameOffset; // SCENE_NAME_LENGTH bytes each
+  uint64_t materialNameOffset;
+} SceneFileHeader;
+
+// a mapped scene file, the arrays point straight into the mapping and are never written
+typedef struct Scene {
+  const unsigned char* base;
+  size_t size;
+  const SceneFileHeader* header;
+  unsigned int objectCount;
+  unsigned int meshCount;
+  unsigned int materialCount;
+
+  vec3* positions;
+  versor* rotations;
+  vec3* scales;
+  const uint32_t* meshes;
+  const uint32_t* materials;
+  vec3* boundsMin;
+  vec3* boundsMax;
+  const char* meshNames;
+  const char* materialNames;
+} Scene;
+
+// maps the file read-only and checks the header, array ranges and names, nothing per object is read
+int sceneOpen(Scene* s, const char* path);
+
+const char* sceneMeshName(Scene* s, unsigned int mesh);
+
+const char* sceneMaterialName(Scene* s, unsigned int material);
+
+// translation, then rotation, then scale
+void sceneModel(Scene* s, unsigned int object, mat4 model);
+
+void sceneClose(Scene* s);
+
+#endif
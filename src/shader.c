@@ -1,7 +1,7 @@
 #include "shader.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <glad/glad.h>
+#include "glext.h"
 #include <cglm/cglm.h>
 
 // reads shader specified by filepath into C-string
@@ -51,27 +51,39 @@ void shaderInit(Shader* s, const char* vertexPath, const char* fragmentPath) {
     return;
   }
 
+  shaderInitFromSource(s, vertexShaderSource, -1, fragmentShaderSource, -1);
+
+  free(vertexShaderSource);
+  free(fragmentShaderSource);
+}
+
+// compiles sources already in memory, a negative length means the source is null-terminated,
+// returns 0 when both stages compiled and the program linked
+int shaderInitFromSource(Shader* s, const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength) {
   // compile shader programs
   unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-  glShaderSource(vertexShader, 1, (const char**) &vertexShaderSource, NULL);
+  glShaderSource(vertexShader, 1, &vertexSource, vertexLength < 0 ? NULL : &vertexLength);
   glCompileShader(vertexShader);
 
   int success;
+  int status = 0;
   char infoLog[512];
   glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
   if(!success) {
     glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
     printf("ERROR::SHADER::VERTEX::COMPILATION_FAILED\n%s", infoLog);
+    status = -1;
   }
 
   unsigned int fragmentShader= glCreateShader(GL_FRAGMENT_SHADER);
-  glShaderSource(fragmentShader, 1, (const char**) &fragmentShaderSource, NULL);
+  glShaderSource(fragmentShader, 1, &fragmentSource, fragmentLength < 0 ? NULL : &fragmentLength);
   glCompileShader(fragmentShader);
 
   glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
   if(!success) {
     glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
     printf("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n%s", infoLog);
+    status = -1;
   }
 
   // link shaders into shader program
@@ -86,15 +98,60 @@ void shaderInit(Shader* s, const char* vertexPath, const char* fragmentPath) {
   if(!success) {
     glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
     printf("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
+    status = -1;
   }
 
   glDeleteShader(vertexShader);
 
   glDeleteShader(fragmentShader);
-  free(vertexShaderSource);
-  free(fragmentShaderSource);
   
   s->ID = shaderProgram;
+  return status;
+}
+
+int shaderInitCompute(Shader* s, const char* computePath) {
+  char* computeShaderSource = readShader(computePath);
+  if(!computeShaderSource) {
+    return -1;
+  }
+
+  int status = shaderInitComputeFromSource(s, computeShaderSource, -1);
+
+  free(computeShaderSource);
+  return status;
+}
+
+// same status as shaderInitFromSource, the program is still created
+int shaderInitComputeFromSource(Shader* s, const char* computeSource, int computeLength) {
+  unsigned int computeShader = glCreateShader(GL_COMPUTE_SHADER);
+  glShaderSource(computeShader, 1, &computeSource, computeLength < 0 ? NULL : &computeLength);
+  glCompileShader(computeShader);
+
+  int success;
+  int status = 0;
+  char infoLog[512];
+  glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
+  if(!success) {
+    glGetShaderInfoLog(computeShader, 512, NULL, infoLog);
+    printf("ERROR::SHADER::COMPUTE::COMPILATION_FAILED\n%s", infoLog);
+    status = -1;
+  }
+
+  unsigned int shaderProgram = glCreateProgram();
+  glAttachShader(shaderProgram, computeShader);
+  glLinkProgram(shaderProgram);
+
+  glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+  if(!success) {
+    glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+    printf("ERROR::SHADER::PROGRAM::LINKING_FAILED\n%s", infoLog);
+    status = -1;
+  }
+
+  glDeleteShader(computeShader);
+
+  s->ID = shaderProgram;
+  return status;
 }
 
 void shaderUse(Shader* s) {
@@ -109,6 +166,14 @@ void shaderSetFloat(Shader* s, const char* name, float value) {
   glUniform1f(glGetUniformLocation(s->ID, name), value); 
 }
 
+void shaderSetVec2(Shader* s, const char* name, float x, float y) {
+  glUniform2f(glGetUniformLocation(s->ID, name), x, y);
+}
+
 void shaderSetMatrix(Shader* s, const char* name, mat4 mat) {
   glUniformMatrix4fv(glGetUniformLocation(s->ID, name), 1, GL_FALSE, (const float*) mat);
 }
+
+void shaderSetUint(Shader* s, const char* name, unsigned int value) {
+  glUniform1ui(glGetUniformLocation(s->ID, name), value);
+}
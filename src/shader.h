@@ -9,12 +9,25 @@ typedef struct Shader {
 
 void shaderInit(Shader* s, const char* vertexPath, const char* fragmentPath);
 
+// returns -1 when a stage fails to compile or the program fails to link, the program is still created
+int shaderInitFromSource(Shader* s, const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength);
+
+// a program with a single compute stage, GL 4.3, returns -1 when the source can not be read
+// or fails to compile or link
+int shaderInitCompute(Shader* s, const char* computePath);
+
+int shaderInitComputeFromSource(Shader* s, const char* computeSource, int computeLength);
+
 void shaderUse(Shader* s);
 
 void shaderSetInt(Shader* s, const char* name, int value);
 
 void shaderSetFloat(Shader* s, const char* name, float value);
 
+void shaderSetVec2(Shader* s, const char* name, float x, float y);
+
 void shaderSetMatrix(Shader* s, const char* name, mat4 mat);
 
+void shaderSetUint(Shader* s, const char* name, unsigned int value);
+
 #endif
@@ -49,7 +49,7 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/vertex_shader", "../src/fragment_shader");
+  shaderInit(&s, "../src/shaders/circle/vertex_shader", "../src/shaders/circle/fragment_shader");
 
   float vertices[] = {
     -10.0f, -10.0f, 0.0f,
@@ -89,7 +89,7 @@ int main() {
   // clean up
   glDeleteVertexArrays(1, &VAO);
   glDeleteBuffers(1, &VBO);
-  glDeleteProgram(s.id);
+  glDeleteProgram(s.ID);
 
   glfwTerminate();
   return 0;
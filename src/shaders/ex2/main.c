@@ -46,7 +46,7 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/vertex_shader", "../src/fragment_shader");
+  shaderInit(&s, "../src/shaders/ex2/vertex_shader", "../src/shaders/fragment_shader");
 
   float vertices[] = {
     -0.5f, -0.5f, 0.0f, 1.0f, 0.0f, 0.0f,
@@ -89,7 +89,7 @@ int main() {
   // clean up
   glDeleteVertexArrays(1, &VAO);
   glDeleteBuffers(1, &VBO);
-  glDeleteProgram(s.id);
+  glDeleteProgram(s.ID);
 
   glfwTerminate();
   return 0;
@@ -46,7 +46,7 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/vertex_shader", "../src/fragment_shader");
+  shaderInit(&s, "../src/shaders/ex3/vertex_shader", "../src/shaders/ex3/fragment_shader");
 
   float vertices[] = {
     -0.5f, -0.5f, 0.0f,
@@ -85,7 +85,7 @@ int main() {
   // clean up
   glDeleteVertexArrays(1, &VAO);
   glDeleteBuffers(1, &VBO);
-  glDeleteProgram(s.id);
+  glDeleteProgram(s.ID);
 
   glfwTerminate();
   return 0;
@@ -0,0 +1,114 @@
+#include "shapes.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <math.h>
+#include <glad/glad.h>
+
+void shapeBatchInit(ShapeBatch* b, unsigned int capacity) {
+  b->count = 0;
+  b->capacity = capacity;
+  b->bufferCapacity = capacity;
+  b->instances = malloc(capacity * sizeof(ShapeInstance));
+
+  glGenVertexArrays(1, &b->VAO);
+  glGenBuffers(1, &b->VBO);
+
+  glBindVertexArray(b->VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, b->VBO);
+  glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(ShapeInstance), NULL, GL_STREAM_DRAW);
+
+  // per-instance attributes only, the quad corners come from gl_VertexID
+  GLsizei stride = sizeof(ShapeInstance);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(ShapeInstance, center));
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(ShapeInstance, halfSize));
+  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(ShapeInstance, axis));
+  glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*) offsetof(ShapeInstance, cornerRadius));
+  glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*) offsetof(ShapeInstance, color));
+  for(unsigned int location = 0; location < 5; location++) {
+    glEnableVertexAttribArray(location);
+    glVertexAttribDivisor(location, 1);
+  }
+
+  glBindVertexArray(0);
+}
+
+void shapeBatchBegin(ShapeBatch* b) {
+  b->count = 0;
+}
+
+static ShapeInstance* shapeAdd(ShapeBatch* b) {
+  if(b->count == b->capacity) {
+    b->capacity = b->capacity ? b->capacity * 2 : 8;
+    b->instances = realloc(b->instances, b->capacity * sizeof(ShapeInstance));
+  }
+  return &b->instances[b->count++];
+}
+
+void shapeCircle(ShapeBatch* b, vec2 center, float radius, uint32_t color) {
+  ShapeInstance* shape = shapeAdd(b);
+  shape->center[0] = center[0];
+  shape->center[1] = center[1];
+  shape->halfSize[0] = radius;
+  shape->halfSize[1] = radius;
+  shape->axis[0] = 1.0f;
+  shape->axis[1] = 0.0f;
+  shape->cornerRadius = radius;
+  shape->color = color;
+}
+
+void shapeRoundedRect(ShapeBatch* b, vec2 center, vec2 halfSize, float cornerRadius, float angle, uint32_t color) {
+  ShapeInstance* shape = shapeAdd(b);
+  shape->center[0] = center[0];
+  shape->center[1] = center[1];
+  shape->halfSize[0] = halfSize[0];
+  shape->halfSize[1] = halfSize[1];
+  shape->axis[0] = cosf(angle);
+  shape->axis[1] = sinf(angle);
+  shape->cornerRadius = fminf(cornerRadius, fminf(halfSize[0], halfSize[1]));
+  shape->color = color;
+}
+
+void shapeLine(ShapeBatch* b, vec2 from, vec2 to, float thickness, uint32_t color) {
+  float dx = to[0] - from[0];
+  float dy = to[1] - from[1];
+  float length = sqrtf(dx * dx + dy * dy);
+  float radius = thickness * 0.5f;
+
+  ShapeInstance* shape = shapeAdd(b);
+  shape->center[0] = (from[0] + to[0]) * 0.5f;
+  shape->center[1] = (from[1] + to[1]) * 0.5f;
+  shape->halfSize[0] = length * 0.5f + radius;
+  shape->halfSize[1] = radius;
+  shape->axis[0] = length > 0.0f ? dx / length : 1.0f;
+  shape->axis[1] = length > 0.0f ? dy / length : 0.0f;
+  shape->cornerRadius = radius;
+  shape->color = color;
+}
+
+void shapeBatchUpload(ShapeBatch* b) {
+  glBindBuffer(GL_ARRAY_BUFFER, b->VBO);
+  if(b->bufferCapacity < b->capacity) {
+    b->bufferCapacity = b->capacity;
+  }
+  glBufferData(GL_ARRAY_BUFFER, b->bufferCapacity * sizeof(ShapeInstance), NULL, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, b->count * sizeof(ShapeInstance), b->instances);
+}
+
+void shapeBatchDraw(ShapeBatch* b, Shader* s, int width, int height) {
+  if(!b->count) {
+    return;
+  }
+
+  shaderUse(s);
+  shaderSetVec2(s, "viewport", (float) width, (float) height);
+
+  glBindVertexArray(b->VAO);
+  glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, b->count);
+  glBindVertexArray(0);
+}
+
+void shapeBatchFree(ShapeBatch* b) {
+  glDeleteVertexArrays(1, &b->VAO);
+  glDeleteBuffers(1, &b->VBO);
+  free(b->instances);
+}
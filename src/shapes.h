@@ -0,0 +1,49 @@
+#ifndef SHAPES_H
+#define SHAPES_H
+
+#include <stdint.h>
+#include <cglm/cglm.h>
+#include "shader.h"
+
+// packs 0-255 channels into the byte order of the normalized color attribute
+#define SHAPE_RGBA(r, g, b, a) ((uint32_t) (r) | (uint32_t) (g) << 8 | (uint32_t) (b) << 16 | (uint32_t) (a) << 24)
+
+// every shape is a rotated rounded box: a circle is a box whose corner radius equals its half
+// size, a line is a capsule around the segment. coordinates are pixels from the top left corner
+typedef struct ShapeInstance {
+  float center[2];
+  float halfSize[2]; // extent from the center along the shape's own axes, corners included
+  float axis[2]; // cosine and sine of the rotation
+  float cornerRadius;
+  uint32_t color; // SHAPE_RGBA
+} ShapeInstance;
+
+// builds a frame of 2D shapes on the CPU and draws them all as one instanced call
+typedef struct ShapeBatch {
+  ShapeInstance* instances;
+  unsigned int count;
+  unsigned int capacity; // instances, grows when a frame needs more
+  unsigned int bufferCapacity; // instances the GPU buffer was allocated for
+  unsigned int VAO;
+  unsigned int VBO;
+} ShapeBatch;
+
+void shapeBatchInit(ShapeBatch* b, unsigned int capacity);
+
+void shapeBatchBegin(ShapeBatch* b);
+
+void shapeCircle(ShapeBatch* b, vec2 center, float radius, uint32_t color);
+
+void shapeRoundedRect(ShapeBatch* b, vec2 center, vec2 halfSize, float cornerRadius, float angle, uint32_t color);
+
+void shapeLine(ShapeBatch* b, vec2 from, vec2 to, float thickness, uint32_t color);
+
+// orphans and fills the instance buffer
+void shapeBatchUpload(ShapeBatch* b);
+
+// expects src/VS_shapes with alpha blending enabled, one draw call for the whole batch
+void shapeBatchDraw(ShapeBatch* b, Shader* s, int width, int height);
+
+void shapeBatchFree(ShapeBatch* b);
+
+#endif
@@ -0,0 +1,481 @@
+#include "simplify.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define SIMPLIFY_MAX_WEDGES 8 // copies of one position with different attributes, 3 at a cube corner
+
+// symmetric 4x4 matrix, the sum of squared distances to a set of planes
+typedef struct Quadric {
+  double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+} Quadric;
+
+typedef struct Collapse {
+  double cost;
+  unsigned int from;
+  unsigned int to;
+  unsigned int fromVersion; // stale once either vertex changed after this was queued
+  unsigned int toVersion;
+} Collapse;
+
+typedef struct CollapseHeap {
+  Collapse* items;
+  unsigned int count;
+  unsigned int capacity;
+} CollapseHeap;
+
+// where each copy of the collapsing position goes, so every corner keeps attributes from its own side of a seam
+typedef struct WedgeMap {
+  unsigned int count;
+  unsigned int from[SIMPLIFY_MAX_WEDGES];
+  unsigned int to[SIMPLIFY_MAX_WEDGES];
+} WedgeMap;
+
+typedef struct TriangleList {
+  unsigned int* triangles;
+  unsigned int count;
+  unsigned int capacity;
+} TriangleList;
+
+typedef struct Simplifier {
+  const float* vertices;
+  unsigned int stride;
+  unsigned int* indices;
+  unsigned int* positions; // first vertex with the same position, topology and costs work on these
+  unsigned char* triangleDead;
+  Quadric* quadrics; // indexed by position, as are the three below
+  TriangleList* adjacency; // triangles around each position, may hold dead ones
+  unsigned int* versions;
+  unsigned char* locked;
+  CollapseHeap heap;
+} Simplifier;
+
+static const float* simplifyPosition(Simplifier* s, unsigned int vertex) {
+  return s->vertices + (size_t) vertex * s->stride;
+}
+
+static unsigned int simplifyCorner(Simplifier* s, unsigned int triangle, int k) {
+  return s->positions[s->indices[triangle * 3 + k]];
+}
+
+// vertices that only differ in their attributes are one vertex to the topology, so texture
+// seams are not mistaken for open edges and can be simplified along their length
+static void simplifyWeld(Simplifier* s, unsigned int vertexCount) {
+  unsigned int buckets = 1;
+  while(buckets < vertexCount * 2) {
+    buckets *= 2;
+  }
+  unsigned int* table = malloc(buckets * sizeof(unsigned int));
+  memset(table, 0xff, buckets * sizeof(unsigned int));
+
+  for(unsigned int v = 0; v < vertexCount; v++) {
+    const float* p = simplifyPosition(s, v);
+    uint32_t bits[3];
+    memcpy(bits, p, sizeof(bits));
+    unsigned int hash = (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+
+    unsigned int slot = hash & (buckets - 1);
+    while(table[slot] != 0xffffffffu && memcmp(simplifyPosition(s, table[slot]), p, 3 * sizeof(float)) != 0) {
+      slot = (slot + 1) & (buckets - 1);
+    }
+    if(table[slot] == 0xffffffffu) {
+      table[slot] = v;
+    }
+    s->positions[v] = table[slot];
+  }
+
+  free(table);
+}
+
+static void quadricAddPlane(Quadric* q, double a, double b, double c, double d, double weight) {
+  q->a2 += weight * a * a; q->ab += weight * a * b; q->ac += weight * a * c; q->ad += weight * a * d;
+  q->b2 += weight * b * b; q->bc += weight * b * c; q->bd += weight * b * d;
+  q->c2 += weight * c * c; q->cd += weight * c * d;
+  q->d2 += weight * d * d;
+}
+
+static void quadricAdd(Quadric* q, const Quadric* other) {
+  q->a2 += other->a2; q->ab += other->ab; q->ac += other->ac; q->ad += other->ad;
+  q->b2 += other->b2; q->bc += other->bc; q->bd += other->bd;
+  q->c2 += other->c2; q->cd += other->cd;
+  q->d2 += other->d2;
+}
+
+static double quadricError(const Quadric* q, const float* p) {
+  double x = p[0], y = p[1], z = p[2];
+  double error = q->a2 * x * x + 2.0 * q->ab * x * y + 2.0 * q->ac * x * z + 2.0 * q->ad * x
+      + q->b2 * y * y + 2.0 * q->bc * y * z + 2.0 * q->bd * y
+      + q->c2 * z * z + 2.0 * q->cd * z
+      + q->d2;
+  return error > 0.0 ? error : 0.0;
+}
+
+static void heapPush(CollapseHeap* h, Collapse c) {
+  if(h->count == h->capacity) {
+    h->capacity = h->capacity ? h->capacity * 2 : 1024;
+    h->items = realloc(h->items, h->capacity * sizeof(Collapse));
+  }
+
+  unsigned int i = h->count++;
+  while(i > 0 && h->items[(i - 1) / 2].cost > c.cost) {
+    h->items[i] = h->items[(i - 1) / 2];
+    i = (i - 1) / 2;
+  }
+  h->items[i] = c;
+}
+
+static Collapse heapPop(CollapseHeap* h) {
+  Collapse top = h->items[0];
+  Collapse last = h->items[--h->count];
+
+  unsigned int i = 0;
+  for(;;) {
+    unsigned int child = i * 2 + 1;
+    if(child >= h->count) {
+      break;
+    }
+    if(child + 1 < h->count && h->items[child + 1].cost < h->items[child].cost) {
+      child++;
+    }
+    if(h->items[child].cost >= last.cost) {
+      break;
+    }
+    h->items[i] = h->items[child];
+    i = child;
+  }
+  if(h->count > 0) {
+    h->items[i] = last;
+  }
+  return top;
+}
+
+static void triangleListAppend(TriangleList* l, unsigned int triangle) {
+  if(l->count == l->capacity) {
+    l->capacity = l->capacity ? l->capacity * 2 : 8;
+    l->triangles = realloc(l->triangles, l->capacity * sizeof(unsigned int));
+  }
+  l->triangles[l->count++] = triangle;
+}
+
+static void simplifyQueue(Simplifier* s, unsigned int from, unsigned int to) {
+  if(s->locked[from]) {
+    return;
+  }
+
+  Quadric q = s->quadrics[from];
+  quadricAdd(&q, &s->quadrics[to]);
+
+  Collapse c;
+  c.cost = quadricError(&q, simplifyPosition(s, to));
+  c.from = from;
+  c.to = to;
+  c.fromVersion = s->versions[from];
+  c.toVersion = s->versions[to];
+  heapPush(&s->heap, c);
+}
+
+// queues both directions of every edge around a vertex
+static void simplifyQueueAround(Simplifier* s, unsigned int vertex) {
+  TriangleList* l = &s->adjacency[vertex];
+  for(unsigned int i = 0; i < l->count; i++) {
+    unsigned int t = l->triangles[i];
+    if(s->triangleDead[t]) {
+      continue;
+    }
+    for(int k = 0; k < 3; k++) {
+      unsigned int other = simplifyCorner(s, t, k);
+      if(other != vertex) {
+        simplifyQueue(s, vertex, other);
+        simplifyQueue(s, other, vertex);
+      }
+    }
+  }
+}
+
+static int simplifyHasNeighbour(Simplifier* s, unsigned int vertex, unsigned int neighbour) {
+  TriangleList* l = &s->adjacency[vertex];
+  for(unsigned int i = 0; i < l->count; i++) {
+    unsigned int t = l->triangles[i];
+    if(s->triangleDead[t]) {
+      continue;
+    }
+    for(int k = 0; k < 3; k++) {
+      if(simplifyCorner(s, t, k) == neighbour) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// each copy of `from` has to move onto the copy of `to` it shares a triangle with, a copy
+// with none would end up with another side's attributes, so seams only collapse along themselves
+static int simplifyMapWedges(Simplifier* s, unsigned int from, unsigned int to, WedgeMap* map) {
+  TriangleList* l = &s->adjacency[from];
+  map->count = 0;
+
+  for(unsigned int i = 0; i < l->count; i++) {
+    unsigned int t = l->triangles[i];
+    if(s->triangleDead[t]) {
+      continue;
+    }
+
+    unsigned int* tri = s->indices + t * 3;
+    unsigned int wedge = tri[0];
+    unsigned int target = 0xffffffffu;
+    for(int k = 0; k < 3; k++) {
+      if(s->positions[tri[k]] == from) {
+        wedge = tri[k];
+      }
+      else if(s->positions[tri[k]] == to) {
+        target = tri[k];
+      }
+    }
+
+    unsigned int j = 0;
+    while(j < map->count && map->from[j] != wedge) {
+      j++;
+    }
+    if(j == map->count) {
+      if(map->count == SIMPLIFY_MAX_WEDGES) {
+        return 0;
+      }
+      map->from[map->count] = wedge;
+      map->to[map->count] = 0xffffffffu;
+      map->count++;
+    }
+    if(target != 0xffffffffu) {
+      map->to[j] = target;
+    }
+  }
+
+  for(unsigned int j = 0; j < map->count; j++) {
+    if(map->to[j] == 0xffffffffu) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// rejects collapses that would pinch the surface, flip a triangle around `from` or tear a seam
+static int simplifyCanCollapse(Simplifier* s, unsigned int from, unsigned int to, WedgeMap* map) {
+  TriangleList* l = &s->adjacency[from];
+  unsigned int shared = 0;
+  unsigned int counted[64];
+
+  if(!simplifyMapWedges(s, from, to, map)) {
+    return 0;
+  }
+
+  for(unsigned int i = 0; i < l->count; i++) {
+    unsigned int t = l->triangles[i];
+    if(s->triangleDead[t]) {
+      continue;
+    }
+
+    unsigned int tri[3] = {simplifyCorner(s, t, 0), simplifyCorner(s, t, 1), simplifyCorner(s, t, 2)};
+    int hasTo = tri[0] == to || tri[1] == to || tri[2] == to;
+
+    // link condition: an interior edge is shared by exactly two triangles, so
+    // exactly two vertices may neighbour both ends of it
+    for(int k = 0; k < 3; k++) {
+      unsigned int v = tri[k];
+      if(v == from || v == to || !simplifyHasNeighbour(s, to, v)) {
+        continue;
+      }
+      unsigned int j = 0;
+      while(j < shared && counted[j] != v) {
+        j++;
+      }
+      if(j == shared) {
+        if(shared == 64) {
+          return 0;
+        }
+        counted[shared++] = v;
+      }
+    }
+
+    if(hasTo) {
+      continue;
+    }
+
+    int corner = tri[0] == from ? 0 : tri[1] == from ? 1 : 2;
+    const float* a = simplifyPosition(s, tri[corner]);
+    const float* b = simplifyPosition(s, tri[(corner + 1) % 3]);
+    const float* c = simplifyPosition(s, tri[(corner + 2) % 3]);
+    const float* moved = simplifyPosition(s, to);
+
+    float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    float f1[3] = {b[0] - moved[0], b[1] - moved[1], b[2] - moved[2]};
+    float f2[3] = {c[0] - moved[0], c[1] - moved[1], c[2] - moved[2]};
+    float before[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+    float after[3] = {f1[1] * f2[2] - f1[2] * f2[1], f1[2] * f2[0] - f1[0] * f2[2], f1[0] * f2[1] - f1[1] * f2[0]};
+    if(before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0f) {
+      return 0;
+    }
+  }
+
+  return shared <= 2;
+}
+
+unsigned int simplifyMesh(const float* vertices, unsigned int stride, unsigned int vertexCount, unsigned int* indices, unsigned int indexCount, unsigned int targetIndexCount, float targetError, float* maxError) {
+  Simplifier s;
+  unsigned int triangleCount = indexCount / 3;
+  s.vertices = vertices;
+  s.stride = stride;
+  s.indices = indices;
+  s.positions = malloc(vertexCount * sizeof(unsigned int));
+  s.triangleDead = calloc(triangleCount, 1);
+  s.quadrics = calloc(vertexCount, sizeof(Quadric));
+  s.adjacency = calloc(vertexCount, sizeof(TriangleList));
+  s.versions = calloc(vertexCount, sizeof(unsigned int));
+  s.locked = calloc(vertexCount, 1);
+  memset(&s.heap, 0, sizeof(s.heap));
+  simplifyWeld(&s, vertexCount);
+
+  // each position starts with the planes of the triangles around it
+  for(unsigned int t = 0; t < triangleCount; t++) {
+    unsigned int tri[3] = {simplifyCorner(&s, t, 0), simplifyCorner(&s, t, 1), simplifyCorner(&s, t, 2)};
+    const float* a = simplifyPosition(&s, tri[0]);
+    const float* b = simplifyPosition(&s, tri[1]);
+    const float* c = simplifyPosition(&s, tri[2]);
+
+    double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    double e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+    double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if(length > 0.0) {
+      n[0] /= length;
+      n[1] /= length;
+      n[2] /= length;
+      double d = -(n[0] * a[0] + n[1] * a[1] + n[2] * a[2]);
+      for(int k = 0; k < 3; k++) {
+        quadricAddPlane(&s.quadrics[tri[k]], n[0], n[1], n[2], d, 1.0);
+      }
+    }
+
+    for(int k = 0; k < 3; k++) {
+      triangleListAppend(&s.adjacency[tri[k]], t);
+    }
+  }
+
+  // an edge used by only one triangle is an open edge, its vertices stay put
+  for(unsigned int t = 0; t < triangleCount; t++) {
+    for(int k = 0; k < 3; k++) {
+      unsigned int a = simplifyCorner(&s, t, k);
+      unsigned int b = simplifyCorner(&s, t, (k + 1) % 3);
+      TriangleList* l = &s.adjacency[a];
+      unsigned int uses = 0;
+      for(unsigned int i = 0; i < l->count; i++) {
+        unsigned int other = l->triangles[i];
+        uses += simplifyCorner(&s, other, 0) == b || simplifyCorner(&s, other, 1) == b || simplifyCorner(&s, other, 2) == b;
+      }
+      if(uses < 2) {
+        s.locked[a] = 1;
+        s.locked[b] = 1;
+      }
+    }
+  }
+
+  for(unsigned int v = 0; v < vertexCount; v++) {
+    if(s.positions[v] == v) {
+      simplifyQueueAround(&s, v);
+    }
+  }
+
+  double worst = 0.0;
+  unsigned int liveIndices = triangleCount * 3;
+
+  while(liveIndices > targetIndexCount && s.heap.count > 0) {
+    Collapse c = heapPop(&s.heap);
+    if(c.fromVersion != s.versions[c.from] || c.toVersion != s.versions[c.to]) {
+      continue;
+    }
+    // the heap is ordered by cost, so every later collapse would be worse too
+    if(c.cost > (double) targetError * targetError) {
+      break;
+    }
+    WedgeMap map;
+    if(!simplifyCanCollapse(&s, c.from, c.to, &map)) {
+      continue;
+    }
+
+    TriangleList* l = &s.adjacency[c.from];
+    for(unsigned int i = 0; i < l->count; i++) {
+      unsigned int t = l->triangles[i];
+      if(s.triangleDead[t]) {
+        continue;
+      }
+
+      unsigned int* tri = indices + t * 3;
+      if(simplifyCorner(&s, t, 0) == c.to || simplifyCorner(&s, t, 1) == c.to || simplifyCorner(&s, t, 2) == c.to) {
+        s.triangleDead[t] = 1;
+        liveIndices -= 3;
+        continue;
+      }
+      for(int k = 0; k < 3; k++) {
+        for(unsigned int j = 0; j < map.count; j++) {
+          if(tri[k] == map.from[j]) {
+            tri[k] = map.to[j];
+            break;
+          }
+        }
+      }
+      triangleListAppend(&s.adjacency[c.to], t);
+    }
+
+    quadricAdd(&s.quadrics[c.to], &s.quadrics[c.from]);
+    s.versions[c.from]++;
+    s.versions[c.to]++;
+    if(c.cost > worst) {
+      worst = c.cost;
+    }
+
+    simplifyQueueAround(&s, c.to);
+  }
+
+  unsigned int written = 0;
+  for(unsigned int t = 0; t < triangleCount; t++) {
+    if(!s.triangleDead[t]) {
+      memmove(indices + written, indices + t * 3, 3 * sizeof(unsigned int));
+      written += 3;
+    }
+  }
+
+  if(maxError) {
+    *maxError = (float) sqrt(worst);
+  }
+
+  for(unsigned int v = 0; v < vertexCount; v++) {
+    free(s.adjacency[v].triangles);
+  }
+  free(s.adjacency);
+  free(s.positions);
+  free(s.triangleDead);
+  free(s.quadrics);
+  free(s.versions);
+  free(s.locked);
+  free(s.heap.items);
+  return written;
+}
+
+unsigned int simplifyCompact(const float* vertices, unsigned int stride, unsigned int vertexCount, unsigned int* indices, unsigned int indexCount, float* compacted) {
+  unsigned int* remap = malloc(vertexCount * sizeof(unsigned int));
+  memset(remap, 0xff, vertexCount * sizeof(unsigned int));
+
+  unsigned int count = 0;
+  for(unsigned int i = 0; i < indexCount; i++) {
+    unsigned int v = indices[i];
+    if(remap[v] == 0xffffffffu) {
+      remap[v] = count;
+      memcpy(compacted + (size_t) count * stride, vertices + (size_t) v * stride, stride * sizeof(float));
+      count++;
+    }
+    indices[i] = remap[v];
+  }
+
+  free(remap);
+  return count;
+}
@@ -0,0 +1,17 @@
+#ifndef SIMPLIFY_H
+#define SIMPLIFY_H
+
+// quadric error metric edge collapse simplifier for indexed triangle lists, vertices start
+// with a float3 position and may carry any other attributes after it
+
+// collapses edges until at most targetIndexCount indices remain, or the next collapse would
+// move the surface by more than targetError, returns the new index count. A vertex is only ever moved onto a neighbour so its
+// attributes stay valid. Vertices sharing a position are welded for the topology, so texture seams only collapse along
+// themselves and vertices on open edges never move.
+// maxError receives the approximate geometric error of the worst collapse, may be NULL
+unsigned int simplifyMesh(const float* vertices, unsigned int stride, unsigned int vertexCount, unsigned int* indices, unsigned int indexCount, unsigned int targetIndexCount, float targetError, float* maxError);
+
+// copies the referenced vertices into compacted and remaps indices in place, returns the vertex count
+unsigned int simplifyCompact(const float* vertices, unsigned int stride, unsigned int vertexCount, unsigned int* indices, unsigned int indexCount, float* compacted);
+
+#endif
@@ -0,0 +1,77 @@
+#include "sort.h"
+#include <string.h>
+
+// maps float bits to unsigned integers with the same ordering: negative floats have every
+// bit flipped so larger magnitudes sort first, positive floats just get the sign bit set
+static uint32_t sortFloatKey(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint32_t mask = (uint32_t) -(int32_t) (bits >> 31) | 0x80000000u;
+  return bits ^ mask;
+}
+
+// sorts the unsigned keys the caller already wrote to the start of scratch
+static void sortRadix(uint32_t* order, uint32_t count, uint32_t* scratch) {
+  uint32_t* keysIn = scratch;
+  uint32_t* keysOut = scratch + count;
+  uint32_t* orderIn = order;
+  uint32_t* orderOut = scratch + 2 * count;
+
+  // all four digit histograms in one read over the keys
+  uint32_t histograms[4][256];
+  memset(histograms, 0, sizeof(histograms));
+  for(uint32_t i = 0; i < count; i++) {
+    uint32_t key = keysIn[i];
+    orderIn[i] = i;
+    for(int digit = 0; digit < 4; digit++) {
+      histograms[digit][(key >> (digit * 8)) & 0xff]++;
+    }
+  }
+
+  for(int digit = 0; digit < 4; digit++) {
+    uint32_t* histogram = histograms[digit];
+    uint32_t shift = digit * 8;
+
+    // a digit every key shares does not change the order
+    if(count == 0 || histogram[(keysIn[0] >> shift) & 0xff] == count) {
+      continue;
+    }
+
+    uint32_t offset = 0;
+    for(int bucket = 0; bucket < 256; bucket++) {
+      uint32_t n = histogram[bucket];
+      histogram[bucket] = offset;
+      offset += n;
+    }
+
+    for(uint32_t i = 0; i < count; i++) {
+      uint32_t key = keysIn[i];
+      uint32_t destination = histogram[(key >> shift) & 0xff]++;
+      keysOut[destination] = key;
+      orderOut[destination] = orderIn[i];
+    }
+
+    uint32_t* swap = keysIn;
+    keysIn = keysOut;
+    keysOut = swap;
+    swap = orderIn;
+    orderIn = orderOut;
+    orderOut = swap;
+  }
+
+  if(orderIn != order) {
+    memcpy(order, orderIn, count * sizeof(uint32_t));
+  }
+}
+
+void sortRadixFloat(const float* keys, uint32_t* order, uint32_t count, uint32_t* scratch) {
+  for(uint32_t i = 0; i < count; i++) {
+    scratch[i] = sortFloatKey(keys[i]);
+  }
+  sortRadix(order, count, scratch);
+}
+
+void sortRadixUint32(const uint32_t* keys, uint32_t* order, uint32_t count, uint32_t* scratch) {
+  memcpy(scratch, keys, count * sizeof(uint32_t));
+  sortRadix(order, count, scratch);
+}
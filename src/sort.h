@@ -0,0 +1,13 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <stdint.h>
+
+// fills order with the indices of keys in ascending key order using an LSD radix sort,
+// stable, handles negative keys, scratch must hold 3 * count values
+void sortRadixFloat(const float* keys, uint32_t* order, uint32_t count, uint32_t* scratch);
+
+// same for unsigned keys, e.g. packed material and layer ids
+void sortRadixUint32(const uint32_t* keys, uint32_t* order, uint32_t count, uint32_t* scratch);
+
+#endif
@@ -0,0 +1,251 @@
+#include "sprites.h"
+#include "sort.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <glad/glad.h>
+
+void spriteRegionWhole(SpriteRegion* r, unsigned int texture, int width, int height) {
+  r->texture = texture;
+  r->uv[0] = 0.0f;
+  r->uv[1] = 0.0f;
+  r->uv[2] = 1.0f;
+  r->uv[3] = 1.0f;
+  r->size[0] = (float) width;
+  r->size[1] = (float) height;
+}
+
+void spriteAtlasInit(SpriteAtlas* a, int width, int height) {
+  a->width = width;
+  a->height = height;
+  a->shelfX = 0;
+  a->shelfY = 0;
+  a->shelfHeight = 0;
+
+  glGenTextures(1, &a->texture);
+  glActiveTexture(GL_TEXTURE0 + SPRITE_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D, a->texture);
+
+  // no mipmaps, neighbouring entries would bleed into each other's smaller levels
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  // cleared to transparent, texels no entry covers are never sampled undefined
+  unsigned char* clear = calloc((size_t) width * height, 4);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, clear);
+  free(clear);
+}
+
+// each entry takes a cell with its edge pixels repeated into the padding around it, so
+// linear filtering at the border of a region only ever blends in the region's own colors
+int spriteAtlasAdd(SpriteAtlas* a, const unsigned char* pixels, int width, int height, SpriteRegion* region) {
+  int cellWidth = width + 2 * SPRITE_ATLAS_PADDING;
+  int cellHeight = height + 2 * SPRITE_ATLAS_PADDING;
+  if(a->shelfX + cellWidth > a->width) {
+    a->shelfX = 0;
+    a->shelfY += a->shelfHeight;
+    a->shelfHeight = 0;
+  }
+  if(cellWidth > a->width || a->shelfY + cellHeight > a->height) {
+    printf("ERROR::SPRITES::ATLAS_FULL: %dx%d\n", width, height);
+    return -1;
+  }
+
+  unsigned char* cell = malloc((size_t) cellWidth * cellHeight * 4);
+  for(int y = 0; y < cellHeight; y++) {
+    int sourceY = y - SPRITE_ATLAS_PADDING;
+    sourceY = sourceY < 0 ? 0 : sourceY >= height ? height - 1 : sourceY;
+    for(int x = 0; x < cellWidth; x++) {
+      int sourceX = x - SPRITE_ATLAS_PADDING;
+      sourceX = sourceX < 0 ? 0 : sourceX >= width ? width - 1 : sourceX;
+      memcpy(cell + ((size_t) y * cellWidth + x) * 4, pixels + ((size_t) sourceY * width + sourceX) * 4, 4);
+    }
+  }
+
+  glActiveTexture(GL_TEXTURE0 + SPRITE_TEXTURE_UNIT);
+  glBindTexture(GL_TEXTURE_2D, a->texture);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, a->shelfX, a->shelfY, cellWidth, cellHeight, GL_RGBA, GL_UNSIGNED_BYTE, cell);
+  free(cell);
+
+  int x = a->shelfX + SPRITE_ATLAS_PADDING;
+  int y = a->shelfY + SPRITE_ATLAS_PADDING;
+  region->texture = a->texture;
+  region->uv[0] = (float) x / a->width;
+  region->uv[1] = (float) y / a->height;
+  region->uv[2] = (float) (x + width) / a->width;
+  region->uv[3] = (float) (y + height) / a->height;
+  region->size[0] = (float) width;
+  region->size[1] = (float) height;
+
+  a->shelfX += cellWidth;
+  a->shelfHeight = cellHeight > a->shelfHeight ? cellHeight : a->shelfHeight;
+  return 0;
+}
+
+void spriteAtlasFree(SpriteAtlas* a) {
+  glDeleteTextures(1, &a->texture);
+}
+
+void spriteBatchInit(SpriteBatch* b, unsigned int capacity) {
+  memset(b, 0, sizeof(*b));
+  b->capacity = capacity;
+  b->vertices = malloc((size_t) capacity * 4 * sizeof(SpriteVertex));
+  b->keys = malloc(capacity * sizeof(uint32_t));
+  b->order = malloc(capacity * sizeof(uint32_t));
+  b->scratch = malloc((size_t) capacity * 3 * sizeof(uint32_t));
+
+  glGenVertexArrays(1, &b->VAO);
+  glGenBuffers(1, &b->VBO);
+  glGenBuffers(1, &b->EBO);
+
+  glBindVertexArray(b->VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, b->VBO);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*) offsetof(SpriteVertex, position));
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*) offsetof(SpriteVertex, uv));
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteVertex), (void*) offsetof(SpriteVertex, color));
+  glEnableVertexAttribArray(2);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, b->EBO);
+  glBindVertexArray(0);
+}
+
+void spriteBatchBegin(SpriteBatch* b) {
+  b->count = 0;
+}
+
+void spriteBatchAdd(SpriteBatch* b, const SpriteRegion* region, mat3 transform, unsigned int layer, uint32_t color) {
+  if(b->count == b->capacity) {
+    b->capacity *= 2;
+    b->vertices = realloc(b->vertices, (size_t) b->capacity * 4 * sizeof(SpriteVertex));
+    b->keys = realloc(b->keys, b->capacity * sizeof(uint32_t));
+    b->order = realloc(b->order, b->capacity * sizeof(uint32_t));
+    b->scratch = realloc(b->scratch, (size_t) b->capacity * 3 * sizeof(uint32_t));
+  }
+
+  // only the 2x3 affine part matters, the corners are transformed once here
+  float halfX = region->size[0] * 0.5f;
+  float halfY = region->size[1] * 0.5f;
+  const float corners[4][2] = {{-halfX, -halfY}, {halfX, -halfY}, {halfX, halfY}, {-halfX, halfY}};
+  const float uvs[4][2] = {
+    {region->uv[0], region->uv[1]}, {region->uv[2], region->uv[1]},
+    {region->uv[2], region->uv[3]}, {region->uv[0], region->uv[3]}
+  };
+
+  SpriteVertex* v = b->vertices + (size_t) b->count * 4;
+  for(int i = 0; i < 4; i++) {
+    v[i].position[0] = transform[0][0] * corners[i][0] + transform[1][0] * corners[i][1] + transform[2][0];
+    v[i].position[1] = transform[0][1] * corners[i][0] + transform[1][1] * corners[i][1] + transform[2][1];
+    v[i].uv[0] = uvs[i][0];
+    v[i].uv[1] = uvs[i][1];
+    v[i].color = color;
+  }
+
+  // stable sort, so sprites sharing a layer and texture keep their submission order
+  b->keys[b->count] = (layer % SPRITE_MAX_LAYERS) << 20 | (region->texture & 0xfffff);
+  b->count++;
+}
+
+static void spriteBatchGrowIndices(SpriteBatch* b, unsigned int sprites) {
+  unsigned int* indices = malloc((size_t) sprites * 6 * sizeof(unsigned int));
+  for(unsigned int q = 0; q < sprites; q++) {
+    unsigned int* quad = indices + q * 6;
+    quad[0] = q * 4;
+    quad[1] = q * 4 + 1;
+    quad[2] = q * 4 + 2;
+    quad[3] = q * 4;
+    quad[4] = q * 4 + 2;
+    quad[5] = q * 4 + 3;
+  }
+
+  // VAO bound by the caller, the element buffer binding is part of it
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) sprites * 6 * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+  free(indices);
+  b->indexSprites = sprites;
+}
+
+void spriteBatchFlush(SpriteBatch* b, Shader* s, mat4 projection) {
+  memset(&b->stats, 0, sizeof(b->stats));
+  b->stats.sprites = b->count;
+  if(!b->count) {
+    return;
+  }
+
+  double start = timingNow();
+  sortRadixUint32(b->keys, b->order, b->count, b->scratch);
+  double sorted = timingNow();
+
+  glBindVertexArray(b->VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, b->VBO);
+  if(b->count > b->indexSprites) {
+    spriteBatchGrowIndices(b, b->capacity);
+  }
+
+  // a ring of frames in one buffer, written unsynchronized and orphaned when it wraps
+  if(b->count > b->bufferSprites) {
+    b->bufferSprites = b->capacity * 3;
+    b->bufferOffset = b->bufferSprites;
+  }
+  if(b->bufferOffset + b->count > b->bufferSprites) {
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) b->bufferSprites * 4 * sizeof(SpriteVertex), NULL, GL_STREAM_DRAW);
+    b->bufferOffset = 0;
+  }
+
+  size_t spriteSize = 4 * sizeof(SpriteVertex);
+  SpriteVertex* mapped = glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr) (b->bufferOffset * spriteSize), (GLsizeiptr) (b->count * spriteSize),
+      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  if(!mapped) {
+    printf("ERROR::SPRITES::MAP_FAILED\n");
+    glBindVertexArray(0);
+    return;
+  }
+  for(unsigned int i = 0; i < b->count; i++) {
+    memcpy(mapped + (size_t) i * 4, b->vertices + (size_t) b->order[i] * 4, spriteSize);
+  }
+  glUnmapBuffer(GL_ARRAY_BUFFER);
+  double written = timingNow();
+
+  shaderUse(s);
+  shaderSetInt(s, "sprite", SPRITE_TEXTURE_UNIT);
+  shaderSetMatrix(s, "projection", projection);
+  glActiveTexture(GL_TEXTURE0 + SPRITE_TEXTURE_UNIT);
+
+  // layers are already in order, so a run only breaks where the texture changes
+  unsigned int first = 0;
+  while(first < b->count) {
+    unsigned int texture = b->keys[b->order[first]] & 0xfffff;
+    unsigned int last = first + 1;
+    while(last < b->count && (b->keys[b->order[last]] & 0xfffff) == texture) {
+      last++;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glDrawElementsBaseVertex(GL_TRIANGLES, (last - first) * 6, GL_UNSIGNED_INT, 0, (b->bufferOffset + first) * 4);
+    b->stats.draws++;
+    first = last;
+  }
+
+  glBindVertexArray(0);
+  b->bufferOffset += b->count;
+
+  double submitted = timingNow();
+  b->stats.sortMs = (sorted - start) * 1000.0;
+  b->stats.writeMs = (written - sorted) * 1000.0;
+  b->stats.submitMs = (submitted - written) * 1000.0;
+}
+
+void spriteBatchFree(SpriteBatch* b) {
+  glDeleteVertexArrays(1, &b->VAO);
+  glDeleteBuffers(1, &b->VBO);
+  glDeleteBuffers(1, &b->EBO);
+  free(b->vertices);
+  free(b->keys);
+  free(b->order);
+  free(b->scratch);
+}
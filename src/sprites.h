@@ -0,0 +1,85 @@
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <stdint.h>
+#include <cglm/cglm.h>
+#include "shader.h"
+
+#define SPRITE_TEXTURE_UNIT 2 // units 0 and 1 hold the cube textures
+#define SPRITE_MAX_LAYERS 4096 // layer occupies the top 12 bits of the sort key
+#define SPRITE_ATLAS_PADDING 2 // edge pixels repeated around each atlas entry so linear filtering does not bleed
+
+#define SPRITE_RGBA(r, g, b, a) ((uint32_t) (r) | (uint32_t) (g) << 8 | (uint32_t) (b) << 16 | (uint32_t) (a) << 24)
+
+// part of a texture a sprite shows, a whole texture or an atlas entry
+typedef struct SpriteRegion {
+  unsigned int texture;
+  float uv[4]; // u0, v0, u1, v1
+  float size[2]; // pixels, the unit quad is scaled by it before the sprite transform
+} SpriteRegion;
+
+// shelf packed RGBA texture, images go left to right and start a new shelf when a row is full
+typedef struct SpriteAtlas {
+  unsigned int texture;
+  int width;
+  int height;
+  int shelfX;
+  int shelfY;
+  int shelfHeight;
+} SpriteAtlas;
+
+typedef struct SpriteVertex {
+  float position[2];
+  float uv[2];
+  uint32_t color; // SPRITE_RGBA, multiplied with the texel
+} SpriteVertex;
+
+typedef struct SpriteStats {
+  unsigned int sprites;
+  unsigned int draws;
+  double sortMs;
+  double writeMs; // copying sorted vertices into the mapped buffer
+  double submitMs;
+} SpriteStats;
+
+// collects transformed quads for a frame, sorts them by layer then texture and draws each
+// run sharing a texture with one call out of a streaming vertex buffer
+typedef struct SpriteBatch {
+  SpriteVertex* vertices; // four per sprite, in submission order
+  uint32_t* keys;
+  uint32_t* order;
+  uint32_t* scratch;
+  unsigned int count;
+  unsigned int capacity; // sprites
+
+  unsigned int VAO, VBO, EBO;
+  unsigned int bufferSprites; // sprites the vertex buffer holds before it is orphaned
+  unsigned int bufferOffset; // sprites already written since the last orphan
+  unsigned int indexSprites; // sprites the quad index buffer covers
+
+  SpriteStats stats; // of the last flush
+} SpriteBatch;
+
+void spriteRegionWhole(SpriteRegion* r, unsigned int texture, int width, int height);
+
+void spriteAtlasInit(SpriteAtlas* a, int width, int height);
+
+// copies RGBA pixels into the atlas, returns -1 when there is no room left
+int spriteAtlasAdd(SpriteAtlas* a, const unsigned char* pixels, int width, int height, SpriteRegion* region);
+
+void spriteAtlasFree(SpriteAtlas* a);
+
+void spriteBatchInit(SpriteBatch* b, unsigned int capacity);
+
+void spriteBatchBegin(SpriteBatch* b);
+
+// transform is a cglm affine2d matrix applied to the region sized quad centred on the origin,
+// higher layers draw over lower ones
+void spriteBatchAdd(SpriteBatch* b, const SpriteRegion* region, mat3 transform, unsigned int layer, uint32_t color);
+
+// expects src/VS_sprite with alpha blending enabled, projection maps pixels to clip space
+void spriteBatchFlush(SpriteBatch* b, Shader* s, mat4 projection);
+
+void spriteBatchFree(SpriteBatch* b);
+
+#endif
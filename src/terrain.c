@@ -0,0 +1,277 @@
+#include "terrain.h"
+#include "sort.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <glad/glad.h>
+
+#define TERRAIN_OCTAVES 5
+#define TERRAIN_BASE -18.0f // world height of the zero noise level, below the cubes
+#define TERRAIN_AMPLITUDE 10.0f
+#define TERRAIN_FREQUENCY 0.015f
+#define TERRAIN_TEXTURE_REPEAT 8.0f // world units per texture repeat
+
+// fractal sum of perlin octaves, y of the noise input stays fixed so the 3D noise acts as 2D
+float terrainHeight(float x, float z) {
+  float height = 0.0f;
+  float amplitude = 1.0f;
+  float frequency = TERRAIN_FREQUENCY;
+  for(int octave = 0; octave < TERRAIN_OCTAVES; octave++) {
+    vec3 p = {x * frequency, 0.5f + octave * 17.0f, z * frequency};
+    height += glm_perlin_vec3(p) * amplitude;
+    amplitude *= 0.5f;
+    frequency *= 2.0f;
+  }
+  return TERRAIN_BASE + height * TERRAIN_AMPLITUDE;
+}
+
+// runs on a worker, only touches the chunk it was handed
+static void terrainGenerate(void* arg) {
+  TerrainChunk* chunk = arg;
+  Terrain* t = chunk->terrain;
+  double start = timingNow();
+
+  float originX = (float) chunk->x * TERRAIN_CHUNK_QUADS;
+  float originZ = (float) chunk->z * TERRAIN_CHUNK_QUADS;
+  for(int j = 0; j <= TERRAIN_CHUNK_QUADS; j++) {
+    for(int i = 0; i <= TERRAIN_CHUNK_QUADS; i++) {
+      float* v = chunk->vertices + (size_t) (j * (TERRAIN_CHUNK_QUADS + 1) + i) * TERRAIN_VERTEX_STRIDE;
+      v[0] = (float) i;
+      v[1] = terrainHeight(originX + i, originZ + j);
+      v[2] = (float) j;
+      v[3] = (originX + i) / TERRAIN_TEXTURE_REPEAT;
+      v[4] = (originZ + j) / TERRAIN_TEXTURE_REPEAT;
+    }
+  }
+  chunk->generateMs = (timingNow() - start) * 1000.0;
+
+  pthread_mutex_lock(&t->lock);
+  t->completed[t->completedCount++] = (unsigned int) (chunk - t->chunks);
+  pthread_mutex_unlock(&t->lock);
+}
+
+void terrainInit(Terrain* t, Jobs* jobs, int viewRadius, unsigned int uploadBudget) {
+  memset(t, 0, sizeof(*t));
+  t->jobs = jobs;
+  t->viewRadius = viewRadius;
+  t->uploadBudget = uploadBudget;
+  t->maxInFlight = jobs->threadCount * 2 + uploadBudget;
+
+  // one ring more than the view needs, so chunks just behind the camera survive a turn around
+  int side = 2 * (viewRadius + 1) + 1;
+  t->chunkCount = side * side;
+  t->chunks = calloc(t->chunkCount, sizeof(TerrainChunk));
+  for(unsigned int i = 0; i < t->chunkCount; i++) {
+    t->chunks[i].terrain = t;
+    t->chunks[i].vertices = malloc(TERRAIN_CHUNK_VERTICES * TERRAIN_VERTEX_STRIDE * sizeof(float));
+  }
+  t->completed = malloc(t->chunkCount * sizeof(unsigned int));
+  pthread_mutex_init(&t->lock, NULL);
+  timingInit(&t->stats.uploadTimes);
+
+  // every chunk has the same grid, so one index buffer serves all of them through baseVertex
+  unsigned int* indices = malloc(TERRAIN_CHUNK_INDICES * sizeof(unsigned int));
+  unsigned int* quad = indices;
+  for(int j = 0; j < TERRAIN_CHUNK_QUADS; j++) {
+    for(int i = 0; i < TERRAIN_CHUNK_QUADS; i++) {
+      unsigned int corner = j * (TERRAIN_CHUNK_QUADS + 1) + i;
+      quad[0] = corner;
+      quad[1] = corner + TERRAIN_CHUNK_QUADS + 1;
+      quad[2] = corner + 1;
+      quad[3] = corner + 1;
+      quad[4] = corner + TERRAIN_CHUNK_QUADS + 1;
+      quad[5] = corner + TERRAIN_CHUNK_QUADS + 2;
+      quad += 6;
+    }
+  }
+
+  glGenVertexArrays(1, &t->VAO);
+  glGenBuffers(1, &t->VBO);
+  glGenBuffers(1, &t->EBO);
+  glBindVertexArray(t->VAO);
+
+  size_t chunkBytes = TERRAIN_CHUNK_VERTICES * TERRAIN_VERTEX_STRIDE * sizeof(float);
+  glBindBuffer(GL_ARRAY_BUFFER, t->VBO);
+  glBufferData(GL_ARRAY_BUFFER, chunkBytes * t->chunkCount, NULL, GL_DYNAMIC_DRAW);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, TERRAIN_VERTEX_STRIDE * sizeof(float), (void*) 0);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, TERRAIN_VERTEX_STRIDE * sizeof(float), (void*) (3 * sizeof(float)));
+  glEnableVertexAttribArray(1);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, t->EBO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, TERRAIN_CHUNK_INDICES * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+  glBindVertexArray(0);
+  free(indices);
+
+  printf("terrain: %u chunk slots, %.1f MB of vertices\n", t->chunkCount, chunkBytes * t->chunkCount / (1024.0 * 1024.0));
+}
+
+static int terrainInRange(Terrain* t, int x, int z) {
+  int dx = x - t->centerX;
+  int dz = z - t->centerZ;
+  return dx * dx + dz * dz <= t->viewRadius * t->viewRadius;
+}
+
+// a free slot, otherwise the least recently used chunk that is out of range
+static TerrainChunk* terrainAcquire(Terrain* t) {
+  TerrainChunk* oldest = NULL;
+  for(unsigned int i = 0; i < t->chunkCount; i++) {
+    TerrainChunk* chunk = &t->chunks[i];
+    if(chunk->state == TERRAIN_CHUNK_FREE) {
+      return chunk;
+    }
+    if(chunk->state != TERRAIN_CHUNK_GENERATING && chunk->lastUsed != t->frame && (!oldest || chunk->lastUsed < oldest->lastUsed)) {
+      oldest = chunk;
+    }
+  }
+
+  if(oldest) {
+    t->stats.evicted++;
+  }
+  return oldest;
+}
+
+void terrainUpdate(Terrain* t, vec3 cameraPosition) {
+  t->frame++;
+  t->centerX = (int) floorf(cameraPosition[0] / TERRAIN_CHUNK_QUADS);
+  t->centerZ = (int) floorf(cameraPosition[2] / TERRAIN_CHUNK_QUADS);
+
+  // collect what the workers finished since last frame
+  unsigned int finished[t->chunkCount];
+  pthread_mutex_lock(&t->lock);
+  unsigned int finishedCount = t->completedCount;
+  memcpy(finished, t->completed, finishedCount * sizeof(unsigned int));
+  t->completedCount = 0;
+  pthread_mutex_unlock(&t->lock);
+
+  for(unsigned int i = 0; i < finishedCount; i++) {
+    TerrainChunk* chunk = &t->chunks[finished[i]];
+    t->stats.generated++;
+    t->stats.generateMs += chunk->generateMs;
+    t->inFlight--;
+    if(terrainInRange(t, chunk->x, chunk->z)) {
+      chunk->state = TERRAIN_CHUNK_READY;
+    }
+    else {
+      chunk->state = TERRAIN_CHUNK_FREE;
+      t->stats.discarded++;
+    }
+  }
+
+  // a window over the view circle mapping chunk coordinates to slots
+  int side = 2 * t->viewRadius + 1;
+  int window[side * side];
+  for(int i = 0; i < side * side; i++) {
+    window[i] = -1;
+  }
+  for(unsigned int i = 0; i < t->chunkCount; i++) {
+    TerrainChunk* chunk = &t->chunks[i];
+    if(chunk->state == TERRAIN_CHUNK_FREE || !terrainInRange(t, chunk->x, chunk->z)) {
+      continue;
+    }
+    chunk->lastUsed = t->frame;
+    window[(chunk->z - t->centerZ + t->viewRadius) * side + chunk->x - t->centerX + t->viewRadius] = (int) i;
+  }
+
+  // request missing chunks nearest first
+  unsigned int missingCount = 0;
+  float distances[side * side];
+  uint32_t missing[side * side], order[side * side], scratch[3 * side * side];
+  for(int dz = -t->viewRadius; dz <= t->viewRadius; dz++) {
+    for(int dx = -t->viewRadius; dx <= t->viewRadius; dx++) {
+      int index = (dz + t->viewRadius) * side + dx + t->viewRadius;
+      if(dx * dx + dz * dz <= t->viewRadius * t->viewRadius && window[index] < 0) {
+        distances[missingCount] = (float) (dx * dx + dz * dz);
+        missing[missingCount++] = index;
+      }
+    }
+  }
+  sortRadixFloat(distances, order, missingCount, scratch);
+
+  for(unsigned int i = 0; i < missingCount && t->inFlight < t->maxInFlight; i++) {
+    TerrainChunk* chunk = terrainAcquire(t);
+    if(!chunk) {
+      break;
+    }
+    int index = missing[order[i]];
+    chunk->x = index % side - t->viewRadius + t->centerX;
+    chunk->z = index / side - t->viewRadius + t->centerZ;
+    chunk->state = TERRAIN_CHUNK_GENERATING;
+    chunk->lastUsed = t->frame;
+    t->inFlight++;
+    jobsSubmit(t->jobs, terrainGenerate, chunk);
+  }
+
+  // uploads are the only part that can stall the frame, so they are capped and timed
+  double start = timingNow();
+  size_t chunkBytes = TERRAIN_CHUNK_VERTICES * TERRAIN_VERTEX_STRIDE * sizeof(float);
+  unsigned int uploads = 0;
+  int backlog = 0;
+
+  glBindBuffer(GL_ARRAY_BUFFER, t->VBO);
+  for(unsigned int ring = 0; ring <= (unsigned int) t->viewRadius; ring++) {
+    for(unsigned int i = 0; i < t->chunkCount; i++) {
+      TerrainChunk* chunk = &t->chunks[i];
+      int dx = abs(chunk->x - t->centerX);
+      int dz = abs(chunk->z - t->centerZ);
+      if(chunk->state != TERRAIN_CHUNK_READY || (unsigned int) (dx > dz ? dx : dz) != ring) {
+        continue;
+      }
+      if(uploads == t->uploadBudget) {
+        backlog = 1;
+        break;
+      }
+      glBufferSubData(GL_ARRAY_BUFFER, (GLintptr) (chunkBytes * i), chunkBytes, chunk->vertices);
+      chunk->state = TERRAIN_CHUNK_RESIDENT;
+      uploads++;
+    }
+  }
+  t->stats.uploaded += uploads;
+  t->stats.backlogFrames += backlog;
+  timingAdd(&t->stats.uploadTimes, (timingNow() - start) * 1000.0);
+}
+
+void terrainDraw(Terrain* t, Shader* s) {
+  glBindVertexArray(t->VAO);
+
+  for(unsigned int i = 0; i < t->chunkCount; i++) {
+    TerrainChunk* chunk = &t->chunks[i];
+    if(chunk->state != TERRAIN_CHUNK_RESIDENT || !terrainInRange(t, chunk->x, chunk->z)) {
+      continue;
+    }
+
+    mat4 model;
+    glm_translate_make(model, (vec3) {(float) chunk->x * TERRAIN_CHUNK_QUADS, 0.0f, (float) chunk->z * TERRAIN_CHUNK_QUADS});
+    shaderSetMatrix(s, "model", model);
+    glDrawElementsBaseVertex(GL_TRIANGLES, TERRAIN_CHUNK_INDICES, GL_UNSIGNED_INT, 0, i * TERRAIN_CHUNK_VERTICES);
+  }
+
+  glBindVertexArray(0);
+}
+
+void terrainReport(Terrain* t, double seconds) {
+  TerrainStats* stats = &t->stats;
+  printf("terrain: %llu chunks generated, %.3f ms each on a worker, %.1f chunks/s over %.1f s\n",
+      stats->generated, stats->generated ? stats->generateMs / stats->generated : 0.0, seconds > 0.0 ? stats->generated / seconds : 0.0, seconds);
+  printf("terrain: %llu uploaded, %llu evicted, %llu discarded, %u frames left a backlog\n",
+      stats->uploaded, stats->evicted, stats->discarded, stats->backlogFrames);
+  timingReport(&stats->uploadTimes, "terrain upload");
+}
+
+void terrainFree(Terrain* t) {
+  // workers may still be writing into chunk staging
+  jobsWait(t->jobs);
+
+  glDeleteVertexArrays(1, &t->VAO);
+  glDeleteBuffers(1, &t->VBO);
+  glDeleteBuffers(1, &t->EBO);
+
+  for(unsigned int i = 0; i < t->chunkCount; i++) {
+    free(t->chunks[i].vertices);
+  }
+  free(t->chunks);
+  free(t->completed);
+  pthread_mutex_destroy(&t->lock);
+  timingFree(&t->stats.uploadTimes);
+}
@@ -0,0 +1,79 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <cglm/cglm.h>
+#include <pthread.h>
+#include "jobs.h"
+#include "shader.h"
+#include "timing.h"
+
+#define TERRAIN_CHUNK_QUADS 32 // quads along each side of a chunk, one world unit each
+#define TERRAIN_CHUNK_VERTICES ((TERRAIN_CHUNK_QUADS + 1) * (TERRAIN_CHUNK_QUADS + 1))
+#define TERRAIN_CHUNK_INDICES (TERRAIN_CHUNK_QUADS * TERRAIN_CHUNK_QUADS * 6)
+#define TERRAIN_VERTEX_STRIDE 5 // position and texture coordinates, floats
+
+typedef enum TerrainChunkState {
+  TERRAIN_CHUNK_FREE,
+  TERRAIN_CHUNK_GENERATING, // owned by a worker until it shows up in the completed list
+  TERRAIN_CHUNK_READY, // vertices generated, waiting for an upload slot in the frame budget
+  TERRAIN_CHUNK_RESIDENT
+} TerrainChunkState;
+
+// one fixed slot of the vertex buffer, reused for whichever chunk needs it
+typedef struct TerrainChunk {
+  struct Terrain* terrain;
+  int x;
+  int z;
+  TerrainChunkState state;
+  unsigned int lastUsed; // last frame the chunk was in range, the least recent one is evicted first
+  float* vertices; // staging written by the worker
+  double generateMs;
+} TerrainChunk;
+
+typedef struct TerrainStats {
+  unsigned long long generated;
+  unsigned long long uploaded;
+  unsigned long long evicted;
+  unsigned long long discarded; // generated after the camera had already moved away
+  double generateMs; // summed over every worker
+  unsigned int backlogFrames; // frames that ended with generated chunks still waiting for upload
+  Timing uploadTimes; // milliseconds spent uploading, one sample per frame
+} TerrainStats;
+
+// unbounded heightmap streamed around the camera with a fixed number of chunk slots
+typedef struct Terrain {
+  TerrainChunk* chunks;
+  unsigned int chunkCount;
+  int viewRadius; // in chunks
+  unsigned int uploadBudget; // chunk uploads per frame
+  unsigned int maxInFlight; // chunks queued on the workers at once
+  unsigned int inFlight;
+  unsigned int frame;
+  int centerX;
+  int centerZ;
+
+  unsigned int VAO, VBO, EBO;
+  Jobs* jobs;
+
+  pthread_mutex_t lock; // guards completed
+  unsigned int* completed;
+  unsigned int completedCount;
+
+  TerrainStats stats;
+} Terrain;
+
+void terrainInit(Terrain* t, Jobs* jobs, int viewRadius, unsigned int uploadBudget);
+
+float terrainHeight(float x, float z);
+
+// queues missing chunks around the camera, evicts old ones and uploads within the budget
+void terrainUpdate(Terrain* t, vec3 cameraPosition);
+
+// expects a shader taking a `model` uniform, like src/VS
+void terrainDraw(Terrain* t, Shader* s);
+
+void terrainReport(Terrain* t, double seconds);
+
+void terrainFree(Terrain* t);
+
+#endif
@@ -0,0 +1,269 @@
+#include "texcache.h"
+#include "hash.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/glad.h>
+
+// flags folded into the hash seed, the same bytes loaded differently are different textures
+#define TEXCACHE_FLIP 1
+#define TEXCACHE_SRGB 2
+#define TEXCACHE_PIXELS 4
+
+void textureCacheInit(TextureCache* c, size_t pixelBudget) {
+  memset(c, 0, sizeof(*c));
+  c->pixelBudget = pixelBudget;
+}
+
+static uint64_t cacheKey(TextureCache* c, const unsigned char* bytes, size_t size, uint64_t seed) {
+  double start = timingNow();
+  uint64_t key = hash64(bytes, size, seed);
+  c->stats.hashMs += (timingNow() - start) * 1000.0;
+  c->stats.hashedBytes += (double) size;
+  return key;
+}
+
+static uint64_t cacheFlags(int flip) {
+  return (flip ? TEXCACHE_FLIP : 0) | (textureGetSRGB() ? TEXCACHE_SRGB : 0);
+}
+
+static void cacheRehash(TextureCache* c, unsigned int slotCount) {
+  free(c->slots);
+  c->slots = calloc(slotCount, sizeof(uint32_t));
+  c->slotCount = slotCount;
+  for(unsigned int i = 0; i < c->count; i++) {
+    unsigned int slot = (unsigned int) c->entries[i].key & (slotCount - 1);
+    while(c->slots[slot]) {
+      slot = (slot + 1) & (slotCount - 1);
+    }
+    c->slots[slot] = i + 1;
+  }
+}
+
+static TextureCacheEntry* cacheFind(TextureCache* c, uint64_t key) {
+  if(!c->slotCount) {
+    return NULL;
+  }
+  unsigned int slot = (unsigned int) key & (c->slotCount - 1);
+  while(c->slots[slot]) {
+    TextureCacheEntry* e = &c->entries[c->slots[slot] - 1];
+    if(e->key == key) {
+      return e;
+    }
+    slot = (slot + 1) & (c->slotCount - 1);
+  }
+  return NULL;
+}
+
+static TextureCacheEntry* cacheInsert(TextureCache* c, uint64_t key) {
+  if(c->count == c->capacity) {
+    c->capacity = c->capacity ? c->capacity * 2 : 16;
+    c->entries = realloc(c->entries, c->capacity * sizeof(TextureCacheEntry));
+  }
+  TextureCacheEntry* e = &c->entries[c->count++];
+  memset(e, 0, sizeof(*e));
+  e->key = key;
+
+  if(c->count * 2 > c->slotCount) {
+    cacheRehash(c, c->slotCount ? c->slotCount * 2 : 32);
+  }
+  else {
+    unsigned int slot = (unsigned int) key & (c->slotCount - 1);
+    while(c->slots[slot]) {
+      slot = (slot + 1) & (c->slotCount - 1);
+    }
+    c->slots[slot] = c->count;
+  }
+  return e;
+}
+
+static void cacheDropPixels(TextureCache* c, TextureCacheEntry* e) {
+  free(e->pixels);
+  e->pixels = NULL;
+  c->pixelBytes -= e->pixelBytes;
+  e->pixelBytes = 0;
+}
+
+// drops the least recently requested pixels until the budget holds, keep is never dropped
+static void cacheTrimPixels(TextureCache* c, TextureCacheEntry* keep) {
+  while(c->pixelBytes > c->pixelBudget) {
+    TextureCacheEntry* oldest = NULL;
+    for(unsigned int i = 0; i < c->count; i++) {
+      TextureCacheEntry* e = &c->entries[i];
+      if(e->pixels && e != keep && (!oldest || e->lastUsed < oldest->lastUsed)) {
+        oldest = e;
+      }
+    }
+    if(!oldest) {
+      break;
+    }
+    cacheDropPixels(c, oldest);
+    c->stats.pixelEvictions++;
+  }
+}
+
+// hands out the entry's texture on the requested unit and takes a reference
+static void cacheShare(TextureCacheEntry* e, Texture* t, unsigned int textureUnit) {
+  e->refCount++;
+  *t = e->texture;
+  t->textureUnit = textureUnit;
+  glActiveTexture(textureUnit);
+  glBindTexture(GL_TEXTURE_2D, t->ID);
+}
+
+// the lookup every load goes through, returns the entry when it already has a texture or
+// could recreate one from cached pixels, otherwise the caller uploads into the returned miss
+static TextureCacheEntry* cacheLookup(TextureCache* c, Texture* t, unsigned int textureUnit, uint64_t key, int* hit) {
+  c->stats.requests++;
+  TextureCacheEntry* e = cacheFind(c, key);
+  if(!e) {
+    e = cacheInsert(c, key);
+  }
+  e->lastUsed = c->tick++;
+
+  *hit = 1;
+  if(e->texture.ID) {
+    c->stats.textureHits++;
+    cacheShare(e, t, textureUnit);
+    return e;
+  }
+  if(e->pixels) {
+    c->stats.pixelHits++;
+    textureInitFromPixels(&e->texture, textureUnit, e->pixels, e->width, e->height, e->channels, 0);
+    cacheShare(e, t, textureUnit);
+    return e;
+  }
+  *hit = 0;
+  return e;
+}
+
+int textureCacheLoadFromMemory(TextureCache* c, Texture* t, unsigned int textureUnit, const unsigned char* bytes, size_t size, int flip) {
+  int hit;
+  TextureCacheEntry* e = cacheLookup(c, t, textureUnit, cacheKey(c, bytes, size, cacheFlags(flip)), &hit);
+  if(hit) {
+    return 0;
+  }
+
+  double start = timingNow();
+  int width, height, channels;
+  unsigned char* pixels = textureDecodeChannels(bytes, size, &width, &height, &channels, flip);
+  if(!pixels) {
+    c->stats.failed++;
+    memset(t, 0, sizeof(*t));
+    return -1;
+  }
+  textureInitFromPixels(&e->texture, textureUnit, pixels, width, height, channels, 0);
+  c->stats.decodeMs += (timingNow() - start) * 1000.0;
+  c->stats.decodes++;
+
+  size_t pixelBytes = (size_t) width * height * channels;
+  if(pixelBytes <= c->pixelBudget) {
+    e->pixels = pixels;
+    e->width = width;
+    e->height = height;
+    e->channels = channels;
+    e->pixelBytes = pixelBytes;
+    c->pixelBytes += pixelBytes;
+    cacheTrimPixels(c, e);
+  }
+  else {
+    free(pixels);
+  }
+
+  cacheShare(e, t, textureUnit);
+  return 0;
+}
+
+int textureCacheLoad(TextureCache* c, Texture* t, unsigned int textureUnit, const char* path, int flip) {
+  FILE* file = fopen(path, "rb");
+  if(!file) {
+    printf("ERROR::TEXCACHE::FILE_NOT_FOUND: %s\n", path);
+    c->stats.failed++;
+    memset(t, 0, sizeof(*t));
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  unsigned char* bytes = malloc(size > 0 ? (size_t) size : 1);
+  int read = size > 0 && fread(bytes, 1, (size_t) size, file) == (size_t) size;
+  fclose(file);
+  if(!read) {
+    printf("ERROR::TEXCACHE::FILE_NOT_SUCCESSFULLY_READ: %s\n", path);
+    free(bytes);
+    c->stats.failed++;
+    memset(t, 0, sizeof(*t));
+    return -1;
+  }
+
+  int result = textureCacheLoadFromMemory(c, t, textureUnit, bytes, (size_t) size, flip);
+  free(bytes);
+  return result;
+}
+
+int textureCacheLoadPixels(TextureCache* c, Texture* t, unsigned int textureUnit, const unsigned char* pixels, int width, int height, int channels, int flip) {
+  // the dimensions are part of the key, the same bytes read at another width are another image
+  uint64_t seed = cacheFlags(flip) | TEXCACHE_PIXELS | (uint64_t) channels << 4 | (uint64_t) height << 8 | (uint64_t) width << 36;
+  int hit;
+  TextureCacheEntry* e = cacheLookup(c, t, textureUnit, cacheKey(c, pixels, (size_t) width * height * channels, seed), &hit);
+  if(hit) {
+    return 0;
+  }
+
+  textureInitFromPixels(&e->texture, textureUnit, pixels, width, height, channels, flip);
+  cacheShare(e, t, textureUnit);
+  return 0;
+}
+
+void textureCacheRelease(TextureCache* c, Texture* t) {
+  if(!t->ID) {
+    return;
+  }
+  for(unsigned int i = 0; i < c->count; i++) {
+    TextureCacheEntry* e = &c->entries[i];
+    if(e->texture.ID != t->ID) {
+      continue;
+    }
+    if(--e->refCount == 0) {
+      glDeleteTextures(1, &e->texture.ID);
+      e->texture.ID = 0;
+    }
+    t->ID = 0;
+    return;
+  }
+  printf("ERROR::TEXCACHE::NOT_CACHED: texture %u\n", t->ID);
+}
+
+void textureCacheReport(TextureCache* c) {
+  TextureCacheStats* stats = &c->stats;
+  unsigned long long hits = stats->textureHits + stats->pixelHits;
+  unsigned int live = 0;
+  size_t bytes = 0;
+  for(unsigned int i = 0; i < c->count; i++) {
+    if(c->entries[i].texture.ID) {
+      live++;
+      bytes += c->entries[i].texture.bytes;
+    }
+  }
+  printf("texture cache: %llu requests, %llu shared textures, %llu from cached pixels, %llu decodes, %llu failed, %.1f%% hit rate\n",
+      stats->requests, stats->textureHits, stats->pixelHits, stats->decodes, stats->failed,
+      stats->requests ? 100.0 * hits / stats->requests : 0.0);
+  printf("texture cache: %u live textures, %.2f MB, %.2f MB pixels cached of %.2f MB, %llu pixel evictions\n",
+      live, bytes / (1024.0 * 1024.0), c->pixelBytes / (1024.0 * 1024.0), c->pixelBudget / (1024.0 * 1024.0), stats->pixelEvictions);
+  printf("texture cache: %.2f MB hashed in %.3f ms, %.2f ms decode each\n",
+      stats->hashedBytes / (1024.0 * 1024.0), stats->hashMs, stats->decodes ? stats->decodeMs / stats->decodes : 0.0);
+}
+
+void textureCacheFree(TextureCache* c) {
+  for(unsigned int i = 0; i < c->count; i++) {
+    TextureCacheEntry* e = &c->entries[i];
+    if(e->texture.ID) {
+      glDeleteTextures(1, &e->texture.ID);
+    }
+    free(e->pixels);
+  }
+  free(c->entries);
+  free(c->slots);
+}
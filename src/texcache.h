@@ -0,0 +1,68 @@
+#ifndef TEXCACHE_H
+#define TEXCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "texture.h"
+
+typedef struct TextureCacheEntry {
+  uint64_t key; // content hash of the source folded with the load flags
+  Texture texture; // ID 0 once every reference was released
+  unsigned int refCount;
+  unsigned char* pixels; // decoded copy kept for the CPU cache, laid out for textureInitFromPixels, NULL when dropped
+  int width;
+  int height;
+  int channels;
+  size_t pixelBytes;
+  unsigned int lastUsed; // request counter, the oldest cached pixels are dropped first
+} TextureCacheEntry;
+
+typedef struct TextureCacheStats {
+  unsigned long long requests;
+  unsigned long long textureHits; // handed out an existing GL texture
+  unsigned long long pixelHits; // recreated the GL texture from cached pixels, no decode
+  unsigned long long decodes;
+  unsigned long long failed;
+  unsigned long long pixelEvictions;
+  double hashedBytes;
+  double hashMs;
+  double decodeMs;
+} TextureCacheStats;
+
+// shares one refcounted GL texture between every load of the same image bytes with the same flags,
+// and keeps recently decoded pixels under a byte budget so a released texture comes back without a decode
+typedef struct TextureCache {
+  TextureCacheEntry* entries;
+  unsigned int count;
+  unsigned int capacity;
+
+  uint32_t* slots; // open addressing on the key, entry index + 1, 0 is empty
+  unsigned int slotCount; // power of two, kept at least twice the entry count
+
+  size_t pixelBudget; // 0 keeps no pixels
+  size_t pixelBytes;
+  unsigned int tick;
+
+  TextureCacheStats stats;
+} TextureCache;
+
+void textureCacheInit(TextureCache* c, size_t pixelBudget);
+
+// reads and hashes the file, t is left zeroed when it can not be loaded
+int textureCacheLoad(TextureCache* c, Texture* t, unsigned int textureUnit, const char* path, int flip);
+
+// an encoded image (png, jpg, ...) already in memory, e.g. a pack view
+int textureCacheLoadFromMemory(TextureCache* c, Texture* t, unsigned int textureUnit, const unsigned char* bytes, size_t size, int flip);
+
+// pixels decoded ahead of time, they stay with the caller and are never copied into the CPU cache
+int textureCacheLoadPixels(TextureCache* c, Texture* t, unsigned int textureUnit, const unsigned char* pixels, int width, int height, int channels, int flip);
+
+// drops one reference, the GL texture is deleted with the last one
+void textureCacheRelease(TextureCache* c, Texture* t);
+
+void textureCacheReport(TextureCache* c);
+
+// deletes every texture still referenced
+void textureCacheFree(TextureCache* c);
+
+#endif
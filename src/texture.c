@@ -1,24 +1,64 @@
 #include "texture.h"
-
-#define STB_IMAGE_IMPLEMENTATION // modifies stb_image.h to only include relevant source code definitions
-#include "stb_image.h"
+#include "arena.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <glad/glad.h>
 
-void textureInit(Texture* t, unsigned int textureUnit, const char* textureSource, int flip, int transparent) {
-  int width;
-  int height;
-  int nrChannels;
+#define TEXTURE_LOAD_ARENA_SIZE (32 * 1024 * 1024)
 
-  stbi_set_flip_vertically_on_load(flip);
+// scratch memory for image decoding, reset after every upload so decodes never fragment the heap
+static Arena loadArena;
 
-  unsigned char* data = stbi_load(textureSource, &width, &height, &nrChannels, 0);
+// store 3 and 4 channel images as sRGB, off by default so existing scenes keep their look
+static int textureSRGB;
 
-  if(!data) {
-    printf("Failed to load texture: %s\n", textureSource);
-    return;
+// set on worker threads, their decodes go to the heap so they never touch the main thread's arena
+static _Thread_local int loadOnHeap;
+
+static void* textureLoadAlloc(size_t size) {
+  if(loadOnHeap) {
+    return malloc(size);
+  }
+  if(!loadArena.base) {
+    arenaInit(&loadArena, TEXTURE_LOAD_ARENA_SIZE);
+  }
+
+  void* ptr = arenaAlloc(&loadArena, size);
+  return ptr ? ptr : malloc(size);
+}
+
+static void* textureLoadRealloc(void* ptr, size_t oldSize, size_t newSize) {
+  if(loadOnHeap || (ptr && !arenaOwns(&loadArena, ptr))) {
+    return realloc(ptr, newSize);
+  }
+
+  void* newPtr = arenaRealloc(&loadArena, ptr, oldSize, newSize);
+  if(!newPtr) {
+    // arena is exhausted, move the block to the heap
+    newPtr = malloc(newSize);
+    if(newPtr && ptr) {
+      memcpy(newPtr, ptr, oldSize < newSize ? oldSize : newSize);
+    }
+  }
+  return newPtr;
+}
+
+static void textureLoadFree(void* ptr) {
+  if(loadOnHeap || !arenaOwns(&loadArena, ptr)) {
+    free(ptr);
   }
+}
+
+#define STBI_MALLOC(sz) textureLoadAlloc(sz)
+#define STBI_REALLOC_SIZED(p, oldsz, newsz) textureLoadRealloc(p, oldsz, newsz)
+#define STBI_FREE(p) textureLoadFree(p)
+
+#define STB_IMAGE_IMPLEMENTATION // modifies stb_image.h to only include relevant source code definitions
+#include "stb_image.h"
 
+// generates the texture object on the given unit with the default sampling, leaves it bound
+static unsigned int textureCreate(unsigned int textureUnit) {
   unsigned int texture;
   glGenTextures(1, &texture);
 
@@ -30,17 +70,300 @@ void textureInit(Texture* t, unsigned int textureUnit, const char* textureSource
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  return texture;
+}
+
+void textureSetSRGB(int enabled) {
+  textureSRGB = enabled;
+}
 
-  if(transparent) {
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+int textureGetSRGB() {
+  return textureSRGB;
+}
+
+// largest alignment up to 8 that every row satisfies, rows start at multiples of the row size
+static int textureAlignment(size_t rowSize) {
+  for(int alignment = 8; alignment > 1; alignment /= 2) {
+    if(rowSize % alignment == 0) {
+      return alignment;
+    }
   }
-  else {
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+  return 1;
+}
+
+// gray and gray-alpha get the tightest formats, RGB is padded to RGBA because drivers store
+// it as four bytes anyway and convert on the CPU when handed three. core GL has no single or
+// two channel sRGB format, so those stay linear
+void textureChooseFormat(int channels, int width, TextureFormat* f) {
+  switch(channels) {
+    case 1:
+      f->internalFormat = GL_R8;
+      f->format = GL_RED;
+      f->channels = 1;
+      break;
+    case 2:
+      f->internalFormat = GL_RG8;
+      f->format = GL_RG;
+      f->channels = 2;
+      break;
+    default:
+      f->internalFormat = textureSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+      f->format = GL_RGBA;
+      f->channels = 4;
+      break;
+  }
+  f->bytesPerTexel = f->channels;
+  f->alignment = textureAlignment((size_t) width * f->channels);
+}
+
+size_t textureFormatBytes(TextureFormat* f, int width, int height) {
+  size_t bytes = 0;
+  for(;;) {
+    bytes += (size_t) width * height * f->bytesPerTexel;
+    if(width == 1 && height == 1) {
+      return bytes;
+    }
+    width = width > 1 ? width / 2 : 1;
+    height = height > 1 ? height / 2 : 1;
+  }
+}
+
+const char* textureFormatName(unsigned int internalFormat) {
+  switch(internalFormat) {
+    case GL_R8: return "R8";
+    case GL_RG8: return "RG8";
+    case GL_RGB8: return "RGB8";
+    case GL_RGBA8: return "RGBA8";
+    case GL_SRGB8_ALPHA8: return "SRGB8_ALPHA8";
+  }
+  return "unknown";
+}
+
+// single channel images read as gray, two channel ones as gray with alpha
+static void textureSwizzle(int channels) {
+  if(channels == 1) {
+    GLint swizzle[4] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
   }
+  else if(channels == 2) {
+    GLint swizzle[4] = {GL_RED, GL_RED, GL_RED, GL_GREEN};
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+  }
+}
+
+// creates the GL texture object and uploads decoded pixels laid out as textureChooseFormat asked
+static void textureUpload(Texture* t, unsigned int textureUnit, const unsigned char* data, int width, int height, TextureFormat* f) {
+  unsigned int texture = textureCreate(textureUnit);
+  textureSwizzle(f->channels);
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, f->alignment);
+  glTexImage2D(GL_TEXTURE_2D, 0, f->internalFormat, width, height, 0, f->format, GL_UNSIGNED_BYTE, data);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
   glGenerateMipmap(GL_TEXTURE_2D);
 
+  t->ID = texture;
+  t->textureUnit = textureUnit;
+  t->width = width;
+  t->height = height;
+  t->internalFormat = f->internalFormat;
+  t->bytes = textureFormatBytes(f, width, height);
+}
+
+// the decoded channel count decides whether alpha is kept
+void textureInit(Texture* t, unsigned int textureUnit, const char* textureSource, int flip) {
+  int width;
+  int height;
+  int nrChannels;
+
+  if(!stbi_info(textureSource, &width, &height, &nrChannels)) {
+    printf("Failed to load texture: %s\n", textureSource);
+    return;
+  }
+  TextureFormat format;
+  textureChooseFormat(nrChannels, width, &format);
+
+  stbi_set_flip_vertically_on_load_thread(flip);
+
+  unsigned char* data = stbi_load(textureSource, &width, &height, &nrChannels, format.channels);
+
+  if(!data) {
+    printf("Failed to load texture: %s\n", textureSource);
+    arenaReset(&loadArena);
+    return;
+  }
+
+  textureUpload(t, textureUnit, data, width, height, &format);
+
   stbi_image_free(data);
+  arenaReset(&loadArena);
+}
 
-  t->ID = texture;
+// decodes an encoded image (png, jpg, ...) that is already in memory, e.g. a pack view
+void textureInitFromMemory(Texture* t, unsigned int textureUnit, const unsigned char* bytes, size_t size, int flip) {
+  int width;
+  int height;
+  int nrChannels;
+
+  if(!stbi_info_from_memory(bytes, (int) size, &width, &height, &nrChannels)) {
+    printf("Failed to load texture from memory\n");
+    return;
+  }
+  TextureFormat format;
+  textureChooseFormat(nrChannels, width, &format);
+
+  stbi_set_flip_vertically_on_load_thread(flip);
+
+  unsigned char* data = stbi_load_from_memory(bytes, (int) size, &width, &height, &nrChannels, format.channels);
+
+  if(!data) {
+    printf("Failed to load texture from memory\n");
+    arenaReset(&loadArena);
+    return;
+  }
+
+  textureUpload(t, textureUnit, data, width, height, &format);
+
+  stbi_image_free(data);
+  arenaReset(&loadArena);
+}
+
+// uploads pixels decoded ahead of time, a vertical flip or RGB padding needs one scratch copy
+void textureInitFromPixels(Texture* t, unsigned int textureUnit, const unsigned char* pixels, int width, int height, int channels, int flip) {
+  TextureFormat format;
+  textureChooseFormat(channels, width, &format);
+  const unsigned char* data = pixels;
+
+  int copy = flip || format.channels != channels;
+  if(copy) {
+    size_t rowSize = (size_t) width * channels;
+    size_t outRowSize = (size_t) width * format.channels;
+    unsigned char* out = textureLoadAlloc(outRowSize * height);
+    for(int y = 0; y < height; y++) {
+      const unsigned char* in = pixels + rowSize * (flip ? height - 1 - y : y);
+      unsigned char* row = out + outRowSize * y;
+      if(format.channels == channels) {
+        memcpy(row, in, rowSize);
+        continue;
+      }
+      for(int x = 0; x < width; x++) {
+        row[x * 4] = in[x * 3];
+        row[x * 4 + 1] = in[x * 3 + 1];
+        row[x * 4 + 2] = in[x * 3 + 2];
+        row[x * 4 + 3] = 255;
+      }
+    }
+    data = out;
+  }
+
+  textureUpload(t, textureUnit, data, width, height, &format);
+
+  if(copy) {
+    textureLoadFree((void*) data);
+  }
+  arenaReset(&loadArena);
+}
+
+// decodes to tightly packed RGBA in a heap block of its own, for callers that build their own textures
+unsigned char* textureDecode(const unsigned char* bytes, size_t size, int* width, int* height, int flip) {
+  int nrChannels;
+
+  stbi_set_flip_vertically_on_load_thread(flip);
+
+  unsigned char* data = stbi_load_from_memory(bytes, (int) size, width, height, &nrChannels, 4);
+
+  if(!data) {
+    printf("Failed to decode texture from memory\n");
+    arenaReset(&loadArena);
+    return NULL;
+  }
+
+  size_t pixelSize = (size_t) *width * *height * 4;
+  unsigned char* pixels = malloc(pixelSize);
+  memcpy(pixels, data, pixelSize);
+
+  stbi_image_free(data);
+  arenaReset(&loadArena);
+  return pixels;
+}
+
+// decodes to the channel count textureChooseFormat uploads, in a heap block of its own,
+// so textureInitFromPixels takes the result without another copy. safe to call from worker threads
+unsigned char* textureDecodeChannels(const unsigned char* bytes, size_t size, int* width, int* height, int* channels, int flip) {
+  // on the heap stb's own block is the result, released with free like any other
+  int onHeap = loadOnHeap;
+  loadOnHeap = 1;
+
+  int nrChannels;
+  unsigned char* data = NULL;
+  if(stbi_info_from_memory(bytes, (int) size, width, height, &nrChannels)) {
+    TextureFormat format;
+    textureChooseFormat(nrChannels, *width, &format);
+
+    stbi_set_flip_vertically_on_load_thread(flip);
+    data = stbi_load_from_memory(bytes, (int) size, width, height, &nrChannels, format.channels);
+    *channels = format.channels;
+  }
+  loadOnHeap = onHeap;
+
+  if(!data) {
+    printf("Failed to decode texture from memory\n");
+  }
+  return data;
+}
+
+// level 0 storage without pixels, filled in later from a pixel unpack buffer
+void textureAllocate(Texture* t, unsigned int textureUnit, int width, int height) {
+  TextureFormat format;
+  textureChooseFormat(4, width, &format);
+
+  t->ID = textureCreate(textureUnit);
   t->textureUnit = textureUnit;
+  t->width = width;
+  t->height = height;
+  t->internalFormat = format.internalFormat;
+  t->bytes = textureFormatBytes(&format, width, height);
+  glTexImage2D(GL_TEXTURE_2D, 0, format.internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+}
+
+// dimensions from the image header alone, without decoding. whatever stb took from the load
+// arena to parse the header is handed back, a load already using the arena keeps its blocks
+int textureInfo(const unsigned char* bytes, size_t size, int* width, int* height) {
+  int nrChannels;
+  size_t mark = loadArena.offset;
+  int valid = stbi_info_from_memory(bytes, (int) size, width, height, &nrChannels);
+  loadArena.offset = mark;
+  if(!valid) {
+    printf("ERROR::TEXTURE::UNSUPPORTED_IMAGE\n");
+    return -1;
+  }
+  return 0;
+}
+
+// decodes to tightly packed RGBA at out, which holds width * height * 4 bytes.
+// safe to call from worker threads
+int textureDecodeInto(const unsigned char* bytes, size_t size, unsigned char* out, int width, int height, int flip) {
+  int decodedWidth;
+  int decodedHeight;
+  int nrChannels;
+
+  int onHeap = loadOnHeap;
+  loadOnHeap = 1;
+  stbi_set_flip_vertically_on_load_thread(flip);
+  unsigned char* data = stbi_load_from_memory(bytes, (int) size, &decodedWidth, &decodedHeight, &nrChannels, 4);
+
+  int status = 0;
+  if(!data || decodedWidth != width || decodedHeight != height) {
+    printf("ERROR::TEXTURE::DECODE_FAILED\n");
+    status = -1;
+  }
+  else {
+    memcpy(out, data, (size_t) width * height * 4);
+  }
+  stbi_image_free(data);
+  loadOnHeap = onHeap;
+  return status;
+}
+
+void textureReport(Texture* t, const char* label) {
+  printf("%s: %dx%d %s, %.1f KB with mips\n", label, t->width, t->height, textureFormatName(t->internalFormat), t->bytes / 1024.0);
 }
@@ -1,11 +1,54 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
+#include <stddef.h>
+
 typedef struct Texture {
   unsigned int ID;
   unsigned int textureUnit;
+  int width;
+  int height;
+  unsigned int internalFormat;
+  size_t bytes; // estimated VRAM, mips included
 } Texture;
 
-void textureInit(Texture* t, unsigned int textureUnit, const char* textureSource, int flip, int transparent);
+// how decoded pixels are uploaded and stored
+typedef struct TextureFormat {
+  unsigned int internalFormat;
+  unsigned int format; // of the uploaded pixels
+  int channels; // uploaded channels, three channel images are padded to four
+  int bytesPerTexel;
+  int alignment; // GL_UNPACK_ALIGNMENT that matches the uploaded rows
+} TextureFormat;
+
+void textureSetSRGB(int enabled);
+
+int textureGetSRGB();
+
+// the tightest correct format for an image with this many decoded channels, needs no GL context
+void textureChooseFormat(int channels, int width, TextureFormat* f);
+
+size_t textureFormatBytes(TextureFormat* f, int width, int height);
+
+const char* textureFormatName(unsigned int internalFormat);
+
+void textureInit(Texture* t, unsigned int textureUnit, const char* textureSource, int flip);
+
+void textureInitFromMemory(Texture* t, unsigned int textureUnit, const unsigned char* bytes, size_t size, int flip);
+
+void textureInitFromPixels(Texture* t, unsigned int textureUnit, const unsigned char* pixels, int width, int height, int channels, int flip);
+
+// RGBA pixels, release with free
+unsigned char* textureDecode(const unsigned char* bytes, size_t size, int* width, int* height, int flip);
+
+unsigned char* textureDecodeChannels(const unsigned char* bytes, size_t size, int* width, int* height, int* channels, int flip);
+
+void textureAllocate(Texture* t, unsigned int textureUnit, int width, int height);
+
+int textureInfo(const unsigned char* bytes, size_t size, int* width, int* height);
+
+int textureDecodeInto(const unsigned char* bytes, size_t size, unsigned char* out, int width, int height, int flip);
+
+void textureReport(Texture* t, const char* label);
 
 #endif
@@ -50,13 +50,13 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/VS", "../src/FS");
+  shaderInit(&s, "../src/textures/ex1/VS", "../src/textures/ex1/FS");
 
   Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1, 1);
+  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1);
   
   float vertices[] = {
     0.5f, 0.5, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
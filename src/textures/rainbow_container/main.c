@@ -50,10 +50,10 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/VS", "../src/FS");
+  shaderInit(&s, "../src/textures/rainbow_container/VS", "../src/textures/rainbow_container/FS");
 
   Texture t;
-  textureInit(&t, "../assets/container.jpg");
+  textureInit(&t, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   float vertices[] = {
     0.5f, 0.5, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
@@ -0,0 +1,64 @@
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// monotonic wall clock in seconds
+double timingNow() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void timingInit(Timing* t) {
+  t->samples = NULL;
+  t->count = 0;
+  t->capacity = 0;
+}
+
+void timingAdd(Timing* t, double milliseconds) {
+  if(t->count == t->capacity) {
+    t->capacity = t->capacity ? t->capacity * 2 : 256;
+    t->samples = realloc(t->samples, t->capacity * sizeof(double));
+  }
+  t->samples[t->count++] = milliseconds;
+}
+
+static int compareDoubles(const void* a, const void* b) {
+  double x = *(const double*) a;
+  double y = *(const double*) b;
+  return (x > y) - (x < y);
+}
+
+// nearest-rank percentile, percentile in [0, 100]
+double timingPercentile(Timing* t, double percentile) {
+  if(t->count == 0) {
+    return 0.0;
+  }
+
+  double* sorted = malloc(t->count * sizeof(double));
+  memcpy(sorted, t->samples, t->count * sizeof(double));
+  qsort(sorted, t->count, sizeof(double), compareDoubles);
+
+  unsigned int rank = (unsigned int) (percentile / 100.0 * (t->count - 1) + 0.5);
+  double value = sorted[rank];
+  free(sorted);
+  return value;
+}
+
+void timingReport(Timing* t, const char* label) {
+  double sum = 0.0;
+  for(unsigned int i = 0; i < t->count; i++) {
+    sum += t->samples[i];
+  }
+
+  printf("%s: %u samples, mean %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+      label, t->count, t->count ? sum / t->count : 0.0,
+      timingPercentile(t, 50.0), timingPercentile(t, 90.0), timingPercentile(t, 99.0), timingPercentile(t, 100.0));
+}
+
+void timingFree(Timing* t) {
+  free(t->samples);
+  timingInit(t);
+}
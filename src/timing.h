@@ -0,0 +1,23 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+// collects per-frame durations so runs can be summarized as percentiles
+typedef struct Timing {
+  double* samples; // milliseconds
+  unsigned int count;
+  unsigned int capacity;
+} Timing;
+
+double timingNow();
+
+void timingInit(Timing* t);
+
+void timingAdd(Timing* t, double milliseconds);
+
+double timingPercentile(Timing* t, double percentile);
+
+void timingReport(Timing* t, const char* label);
+
+void timingFree(Timing* t);
+
+#endif
@@ -51,13 +51,13 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/VS", "../src/FS");
+  shaderInit(&s, "../src/transforms/ex2/VS", "../src/transforms/ex2/FS");
 
   Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1, 1);
+  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1);
   
   float vertices[] = {
     0.5f, 0.5, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, // top right
@@ -107,7 +107,7 @@ int main() {
     glClearColor(0.0f, 0.0f, 0.0f,1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
-    mat4 trans = GLM_MAT4_IDENTITY;
+    mat4 trans = GLM_MAT4_IDENTITY_INIT;
     glm_translate(trans, (vec3) {0.5f, -0.5f, 0.0f});
     glm_rotate_z(trans, (float) glfwGetTime(), trans);
     unsigned int transformLoc = glGetUniformLocation(s.ID, "transform");
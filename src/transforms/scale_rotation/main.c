@@ -51,13 +51,13 @@ int main() {
   glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
   Shader s;
-  shaderInit(&s, "../src/VS", "../src/FS");
+  shaderInit(&s, "../src/transforms/scale_rotation/VS", "../src/transforms/scale_rotation/FS");
 
   Texture container;
-  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0, 0);
+  textureInit(&container, GL_TEXTURE0, "../assets/container.jpg", 0);
 
   Texture smiley;
-  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1, 1);
+  textureInit(&smiley, GL_TEXTURE1, "../assets/awesomeface.png", 1);
   
   float vertices[] = {
     0.5f, 0.5, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, // top right
@@ -102,7 +102,7 @@ int main() {
   shaderSetInt(&s, "texture2", 1);
 
   vec4 vec = {1.0f, 0.0f, 0.0f, 1.0f};
-  mat4 trans = GLM_MAT4_IDENTITY;
+  mat4 trans = GLM_MAT4_IDENTITY_INIT;
   glm_rotate_z(trans, glm_rad(90.0f), trans);
   glm_scale(trans, (vec3) {0.5f, 0.5f, 0.5f});
   glm_mat4_mulv(trans, vec, vec);
@@ -0,0 +1,253 @@
+#include "upload.h"
+#include <stdio.h>
+#include <string.h>
+
+// the unit textures are bound to for the copy, kept away from the ones the scene samples
+#define UPLOAD_TEXTURE_UNIT 3
+
+void textureUploaderInit(TextureUploader* u, Jobs* jobs, size_t budget) {
+  memset(u, 0, sizeof(*u));
+  u->jobs = jobs;
+  u->budget = budget;
+  pthread_mutex_init(&u->lock, NULL);
+  timingInit(&u->stats.latency);
+
+  for(int i = 0; i < UPLOAD_BUFFER_COUNT; i++) {
+    glGenBuffers(1, &u->buffers[i].PBO);
+  }
+  for(int i = 0; i < UPLOAD_MAX_REQUESTS; i++) {
+    u->uploads[i].uploader = u;
+  }
+}
+
+// expands raw pixels to RGBA rows in the mapped buffer, missing channels become 255
+static void uploadConvert(Upload* up) {
+  size_t rowSize = (size_t) up->width * up->channels;
+  for(int y = 0; y < up->height; y++) {
+    const unsigned char* in = up->source + rowSize * (up->flip ? up->height - 1 - y : y);
+    unsigned char* out = up->mapped + (size_t) y * up->width * 4;
+    if(up->channels == 4) {
+      memcpy(out, in, rowSize);
+      continue;
+    }
+    for(int x = 0; x < up->width; x++) {
+      for(int c = 0; c < 4; c++) {
+        out[x * 4 + c] = c < up->channels ? in[x * up->channels + c] : 255;
+      }
+    }
+  }
+}
+
+// runs on a worker, only touches the mapped memory and never calls GL
+static void uploadDecode(void* arg) {
+  Upload* up = arg;
+  double start = timingNow();
+
+  int failed = 0;
+  if(up->channels) {
+    uploadConvert(up);
+  }
+  else {
+    failed = textureDecodeInto(up->source, up->size, up->mapped, up->width, up->height, up->flip) != 0;
+  }
+
+  pthread_mutex_lock(&up->uploader->lock);
+  up->decodeMs = (timingNow() - start) * 1000.0;
+  up->failed = failed;
+  up->state = UPLOAD_DECODED;
+  pthread_mutex_unlock(&up->uploader->lock);
+}
+
+static int uploadQueue(TextureUploader* u, Texture* t, unsigned int textureUnit, const unsigned char* source, size_t size, int width, int height, int channels, int flip) {
+  Upload* up = NULL;
+  for(int i = 0; i < UPLOAD_MAX_REQUESTS && !up; i++) {
+    if(u->uploads[i].state == UPLOAD_FREE) {
+      up = &u->uploads[i];
+    }
+  }
+  if(!up) {
+    printf("ERROR::UPLOAD::QUEUE_FULL\n");
+    return -1;
+  }
+
+  textureAllocate(t, textureUnit, width, height);
+
+  up->state = UPLOAD_WAITING;
+  up->sequence = u->nextSequence++;
+  up->texture = t->ID;
+  up->source = source;
+  up->size = size;
+  up->width = width;
+  up->height = height;
+  up->channels = channels;
+  up->flip = flip;
+  up->buffer = -1;
+  up->mapped = NULL;
+  up->failed = 0;
+  up->requested = timingNow();
+  u->pending++;
+  return 0;
+}
+
+int textureUploaderRequest(TextureUploader* u, Texture* t, unsigned int textureUnit, const unsigned char* bytes, size_t size, int flip) {
+  double start = timingNow();
+  int width, height;
+  int result = -1;
+  if(textureInfo(bytes, size, &width, &height) == 0) {
+    result = uploadQueue(u, t, textureUnit, bytes, size, width, height, 0, flip);
+  }
+  u->stats.stallMs += (timingNow() - start) * 1000.0;
+  return result;
+}
+
+int textureUploaderRequestPixels(TextureUploader* u, Texture* t, unsigned int textureUnit, const unsigned char* pixels, int width, int height, int channels, int flip) {
+  double start = timingNow();
+  int result = uploadQueue(u, t, textureUnit, pixels, (size_t) width * height * channels, width, height, channels, flip);
+  u->stats.stallMs += (timingNow() - start) * 1000.0;
+  return result;
+}
+
+static Upload* uploadOldestWaiting(TextureUploader* u) {
+  Upload* oldest = NULL;
+  pthread_mutex_lock(&u->lock);
+  for(int i = 0; i < UPLOAD_MAX_REQUESTS; i++) {
+    Upload* up = &u->uploads[i];
+    if(up->state == UPLOAD_WAITING && (!oldest || up->sequence < oldest->sequence)) {
+      oldest = up;
+    }
+  }
+  pthread_mutex_unlock(&u->lock);
+  return oldest;
+}
+
+void textureUploaderUpdate(TextureUploader* u) {
+  double start = timingNow();
+
+  // a buffer can be written again once the GPU has pulled the last copy out of it
+  for(int i = 0; i < UPLOAD_BUFFER_COUNT; i++) {
+    UploadBuffer* b = &u->buffers[i];
+    if(!b->fence) {
+      continue;
+    }
+    GLenum status = glClientWaitSync(b->fence, 0, 0);
+    if(status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+      glDeleteSync(b->fence);
+      b->fence = NULL;
+      b->busy = 0;
+    }
+  }
+
+  // copies are sourced from the buffer, glTexSubImage2D returns without touching the pixels
+  size_t copied = 0;
+  glActiveTexture(GL_TEXTURE0 + UPLOAD_TEXTURE_UNIT);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  for(int i = 0; i < UPLOAD_MAX_REQUESTS; i++) {
+    Upload* up = &u->uploads[i];
+    pthread_mutex_lock(&u->lock);
+    int decoded = up->state == UPLOAD_DECODED;
+    pthread_mutex_unlock(&u->lock);
+
+    size_t bytes = (size_t) up->width * up->height * 4;
+    if(!decoded || (copied && copied + bytes > u->budget)) {
+      continue;
+    }
+
+    UploadBuffer* b = &u->buffers[up->buffer];
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, b->PBO);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    if(up->failed) {
+      b->busy = 0;
+      u->stats.failed++;
+    }
+    else {
+      glBindTexture(GL_TEXTURE_2D, up->texture);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, up->width, up->height, GL_RGBA, GL_UNSIGNED_BYTE, (void*) 0);
+      glGenerateMipmap(GL_TEXTURE_2D);
+      b->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+      copied += bytes;
+      u->stats.uploads++;
+      u->stats.bytes += (double) bytes;
+      timingAdd(&u->stats.latency, (timingNow() - up->requested) * 1000.0);
+    }
+    u->stats.decodeMs += up->decodeMs;
+    up->state = UPLOAD_FREE;
+    u->pending--;
+  }
+
+  // hand idle buffers to the oldest waiting requests, a signalled fence makes the unsynchronized map safe
+  for(int i = 0; i < UPLOAD_BUFFER_COUNT; i++) {
+    UploadBuffer* b = &u->buffers[i];
+    Upload* up = b->busy ? NULL : uploadOldestWaiting(u);
+    if(!up) {
+      continue;
+    }
+
+    size_t bytes = (size_t) up->width * up->height * 4;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, b->PBO);
+    if(b->size < bytes) {
+      glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) bytes, NULL, GL_STREAM_DRAW);
+      b->size = bytes;
+    }
+    up->mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) bytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if(!up->mapped) {
+      printf("ERROR::UPLOAD::MAP_FAILED: %dx%d\n", up->width, up->height);
+      up->state = UPLOAD_FREE;
+      u->pending--;
+      u->stats.failed++;
+      continue;
+    }
+
+    b->busy = 1;
+    up->buffer = i;
+    up->state = UPLOAD_DECODING;
+    jobsSubmit(u->jobs, uploadDecode, up);
+  }
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  u->stats.stallMs += (timingNow() - start) * 1000.0;
+}
+
+int textureUploaderPending(TextureUploader* u, unsigned int texture) {
+  int pending = 0;
+  pthread_mutex_lock(&u->lock);
+  for(int i = 0; i < UPLOAD_MAX_REQUESTS && !pending; i++) {
+    pending = u->uploads[i].state != UPLOAD_FREE && u->uploads[i].texture == texture;
+  }
+  pthread_mutex_unlock(&u->lock);
+  return pending;
+}
+
+void textureUploaderFinish(TextureUploader* u) {
+  while(u->pending) {
+    // fences are polled without a flush, nothing else submits commands while this spins
+    glFlush();
+    jobsWait(u->jobs);
+    textureUploaderUpdate(u);
+  }
+}
+
+void textureUploaderReport(TextureUploader* u) {
+  UploadStats* stats = &u->stats;
+  double megabytes = stats->bytes / (1024.0 * 1024.0);
+  printf("texture uploads: %llu textures, %.1f MB, %llu failed, %.2f ms decode each on a worker\n",
+      stats->uploads, megabytes, stats->failed, stats->uploads ? stats->decodeMs / stats->uploads : 0.0);
+  printf("texture uploads: %.3f ms main thread stall in total, %.3f ms per MB\n",
+      stats->stallMs, megabytes > 0.0 ? stats->stallMs / megabytes : 0.0);
+  timingReport(&stats->latency, "texture upload latency");
+}
+
+void textureUploaderFree(TextureUploader* u) {
+  textureUploaderFinish(u);
+
+  for(int i = 0; i < UPLOAD_BUFFER_COUNT; i++) {
+    if(u->buffers[i].fence) {
+      glDeleteSync(u->buffers[i].fence);
+    }
+    glDeleteBuffers(1, &u->buffers[i].PBO);
+  }
+  pthread_mutex_destroy(&u->lock);
+  timingFree(&u->stats.latency);
+}
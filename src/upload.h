@@ -0,0 +1,91 @@
+#ifndef UPLOAD_H
+#define UPLOAD_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include <glad/glad.h>
+#include "jobs.h"
+#include "texture.h"
+#include "timing.h"
+
+#define UPLOAD_BUFFER_COUNT 4 // pixel unpack buffers cycling between workers and the GPU
+#define UPLOAD_MAX_REQUESTS 64
+
+typedef enum UploadState {
+  UPLOAD_FREE,
+  UPLOAD_WAITING, // texture storage exists, waiting for an idle pixel buffer
+  UPLOAD_DECODING, // a worker is writing into the mapped pixel buffer
+  UPLOAD_DECODED // ready for glTexSubImage2D on the main thread
+} UploadState;
+
+// a pixel unpack buffer, idle once the fence after its last copy has signalled
+typedef struct UploadBuffer {
+  unsigned int PBO;
+  size_t size;
+  GLsync fence;
+  int busy; // mapped for a decode or waiting on its fence
+} UploadBuffer;
+
+typedef struct Upload {
+  struct TextureUploader* uploader;
+  UploadState state;
+  unsigned long long sequence; // requests start in the order they were made
+  unsigned int texture;
+  const unsigned char* source; // encoded image, or raw pixels when channels is set, kept alive by the caller
+  size_t size;
+  int width;
+  int height;
+  int channels; // 0 for encoded images
+  int flip;
+  int buffer;
+  unsigned char* mapped;
+  int failed;
+  double requested;
+  double decodeMs;
+} Upload;
+
+typedef struct UploadStats {
+  unsigned long long uploads;
+  unsigned long long failed;
+  double bytes; // RGBA bytes copied into textures
+  double stallMs; // main thread time spent in textureUploaderRequest and textureUploaderUpdate
+  double decodeMs; // summed over every worker
+  Timing latency; // milliseconds from request to the texture copy being queued
+} UploadStats;
+
+// streams textures in through a pool of pixel unpack buffers: workers decode straight into
+// the mapped buffer and the main thread only issues the copy, so big images never block a frame
+typedef struct TextureUploader {
+  Jobs* jobs;
+  UploadBuffer buffers[UPLOAD_BUFFER_COUNT];
+  Upload uploads[UPLOAD_MAX_REQUESTS];
+  unsigned long long nextSequence;
+  size_t budget; // bytes copied into textures per update, at least one upload always goes through
+  unsigned int pending;
+
+  pthread_mutex_t lock; // guards the DECODING to DECODED transition
+
+  UploadStats stats;
+} TextureUploader;
+
+void textureUploaderInit(TextureUploader* u, Jobs* jobs, size_t budget);
+
+// allocates the texture right away so t can be bound, its pixels arrive in a later update
+int textureUploaderRequest(TextureUploader* u, Texture* t, unsigned int textureUnit, const unsigned char* bytes, size_t size, int flip);
+
+int textureUploaderRequestPixels(TextureUploader* u, Texture* t, unsigned int textureUnit, const unsigned char* pixels, int width, int height, int channels, int flip);
+
+// once per frame: recycles signalled buffers, copies decoded images and starts waiting ones
+void textureUploaderUpdate(TextureUploader* u);
+
+// whether the texture still waits for its copy, it must not be deleted before then
+int textureUploaderPending(TextureUploader* u, unsigned int texture);
+
+// blocks until every request has been copied into its texture
+void textureUploaderFinish(TextureUploader* u);
+
+void textureUploaderReport(TextureUploader* u);
+
+void textureUploaderFree(TextureUploader* u);
+
+#endif
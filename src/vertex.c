@@ -0,0 +1,297 @@
+#include "vertex.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <glad/glad.h>
+
+static unsigned int vertexTypeSize(VertexType type, unsigned int components) {
+  switch(type) {
+    case VERTEX_FLOAT32: return 4 * components;
+    case VERTEX_FLOAT16: return 2 * components;
+    case VERTEX_SNORM16: return 2 * components;
+    case VERTEX_UNORM16: return 2 * components;
+    case VERTEX_OCT16: return 4;
+  }
+  return 0;
+}
+
+void vertexFormatInit(VertexFormat* f) {
+  memset(f, 0, sizeof(*f));
+}
+
+// appends an attribute after the previous one, padding it to a 4-byte boundary
+void vertexFormatAdd(VertexFormat* f, unsigned int location, VertexSemantic semantic, VertexType type, unsigned int components, unsigned int sourceOffset) {
+  if(f->attribCount == VERTEX_MAX_ATTRIBS) {
+    printf("ERROR::VERTEX::TOO_MANY_ATTRIBUTES\n");
+    return;
+  }
+
+  VertexAttrib* a = &f->attribs[f->attribCount++];
+  a->location = location;
+  a->components = components;
+  a->semantic = semantic;
+  a->type = type;
+  a->offset = f->stride;
+  a->sourceOffset = sourceOffset;
+
+  f->stride += (vertexTypeSize(type, components) + 3) & ~3u;
+}
+
+// replaces the hand written glVertexAttribPointer calls, expects the VAO and VBO to be bound
+void vertexFormatApply(VertexFormat* f) {
+  for(unsigned int i = 0; i < f->attribCount; i++) {
+    VertexAttrib* a = &f->attribs[i];
+    void* offset = (void*) (uintptr_t) a->offset;
+
+    switch(a->type) {
+      case VERTEX_FLOAT32:
+        glVertexAttribPointer(a->location, a->components, GL_FLOAT, GL_FALSE, f->stride, offset);
+        break;
+      case VERTEX_FLOAT16:
+        glVertexAttribPointer(a->location, a->components, GL_HALF_FLOAT, GL_FALSE, f->stride, offset);
+        break;
+      case VERTEX_SNORM16:
+        glVertexAttribPointer(a->location, a->components, GL_SHORT, GL_TRUE, f->stride, offset);
+        break;
+      case VERTEX_UNORM16:
+        glVertexAttribPointer(a->location, a->components, GL_UNSIGNED_SHORT, GL_TRUE, f->stride, offset);
+        break;
+      case VERTEX_OCT16:
+        glVertexAttribPointer(a->location, 2, GL_SHORT, GL_TRUE, f->stride, offset);
+        break;
+    }
+    glEnableVertexAttribArray(a->location);
+  }
+}
+
+uint16_t vertexFloatToHalf(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint32_t sign = (bits >> 16) & 0x8000;
+  uint32_t biased = (bits >> 23) & 0xff;
+  int exponent = (int) biased - 127 + 15;
+  uint32_t mantissa = bits & 0x7fffff;
+
+  // infinity and nan
+  if(biased == 0xff) {
+    return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+  }
+
+  // too large for a half
+  if(exponent >= 31) {
+    return sign | 0x7c00;
+  }
+
+  // subnormal half, or too small and flushed to zero
+  if(exponent <= 0) {
+    if(exponent < -10) {
+      return sign;
+    }
+    mantissa |= 0x800000;
+    uint32_t shift = 14 - exponent;
+    uint32_t half = mantissa >> shift;
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if(remainder > halfway || (remainder == halfway && (half & 1))) {
+      half++;
+    }
+    return sign | half;
+  }
+
+  // round to nearest even, a carry correctly bumps the exponent
+  uint32_t half = ((uint32_t) exponent << 10) | (mantissa >> 13);
+  uint32_t remainder = mantissa & 0x1fff;
+  if(remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+    half++;
+  }
+  return sign | half;
+}
+
+float vertexHalfToFloat(uint16_t value) {
+  uint32_t sign = (uint32_t) (value & 0x8000) << 16;
+  uint32_t exponent = (value >> 10) & 0x1f;
+  uint32_t mantissa = value & 0x3ff;
+  uint32_t bits;
+
+  if(exponent == 0) {
+    float f = ldexpf((float) mantissa, -24);
+    return sign ? -f : f;
+  }
+
+  if(exponent == 31) {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  }
+  else {
+    bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+  }
+
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+static int16_t snorm16(float value) {
+  value = glm_clamp(value, -1.0f, 1.0f);
+  return (int16_t) lroundf(value * 32767.0f);
+}
+
+// GL maps snorm16 back with max(c / 32767, -1)
+static float snorm16Decode(int16_t value) {
+  return fmaxf(value / 32767.0f, -1.0f);
+}
+
+static uint16_t unorm16(float value) {
+  value = glm_clamp(value, 0.0f, 1.0f);
+  return (uint16_t) lroundf(value * 65535.0f);
+}
+
+static float signNotZero(float value) {
+  return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+// octahedral mapping: project onto the L1 unit sphere and fold the lower hemisphere outwards
+void vertexOctEncode(vec3 normal, int16_t out[2]) {
+  float l1 = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+  float x = normal[0] / l1;
+  float y = normal[1] / l1;
+
+  if(normal[2] < 0.0f) {
+    float foldedX = (1.0f - fabsf(y)) * signNotZero(x);
+    float foldedY = (1.0f - fabsf(x)) * signNotZero(y);
+    x = foldedX;
+    y = foldedY;
+  }
+
+  out[0] = snorm16(x);
+  out[1] = snorm16(y);
+}
+
+void vertexOctDecode(const int16_t in[2], vec3 normal) {
+  float x = snorm16Decode(in[0]);
+  float y = snorm16Decode(in[1]);
+  float z = 1.0f - fabsf(x) - fabsf(y);
+
+  if(z < 0.0f) {
+    float unfoldedX = (1.0f - fabsf(y)) * signNotZero(x);
+    float unfoldedY = (1.0f - fabsf(x)) * signNotZero(y);
+    x = unfoldedX;
+    y = unfoldedY;
+  }
+
+  normal[0] = x;
+  normal[1] = y;
+  normal[2] = z;
+  glm_vec3_normalize(normal);
+}
+
+// converts float vertices into the packed layout and measures what the quantization cost
+size_t vertexPack(VertexFormat* f, const float* source, unsigned int sourceStride, unsigned int count, void* packed, VertexPackReport* report) {
+  memset(report, 0, sizeof(*report));
+  glm_mat4_identity(report->dequantize);
+
+  // snorm16 positions are stored relative to the mesh bounds so the full range is used
+  vec3 center = {0.0f, 0.0f, 0.0f};
+  vec3 extent = {1.0f, 1.0f, 1.0f};
+  for(unsigned int i = 0; i < f->attribCount; i++) {
+    VertexAttrib* a = &f->attribs[i];
+    if(a->semantic != VERTEX_POSITION || a->type != VERTEX_SNORM16 || count == 0) {
+      continue;
+    }
+
+    vec3 minimum = {INFINITY, INFINITY, INFINITY};
+    vec3 maximum = {-INFINITY, -INFINITY, -INFINITY};
+    for(unsigned int v = 0; v < count; v++) {
+      const float* p = source + (size_t) v * sourceStride + a->sourceOffset;
+      for(unsigned int c = 0; c < a->components && c < 3; c++) {
+        minimum[c] = fminf(minimum[c], p[c]);
+        maximum[c] = fmaxf(maximum[c], p[c]);
+      }
+    }
+
+    for(unsigned int c = 0; c < a->components && c < 3; c++) {
+      center[c] = (minimum[c] + maximum[c]) * 0.5f;
+      extent[c] = (maximum[c] - minimum[c]) * 0.5f;
+      if(extent[c] <= 0.0f) {
+        extent[c] = 1.0f;
+      }
+    }
+
+    glm_translate_make(report->dequantize, center);
+    glm_scale(report->dequantize, extent);
+  }
+
+  unsigned char* out = packed;
+  for(unsigned int v = 0; v < count; v++) {
+    const float* src = source + (size_t) v * sourceStride;
+    unsigned char* dst = out + (size_t) v * f->stride;
+    memset(dst, 0, f->stride);
+
+    for(unsigned int i = 0; i < f->attribCount; i++) {
+      VertexAttrib* a = &f->attribs[i];
+      const float* in = src + a->sourceOffset;
+      unsigned char* attribOut = dst + a->offset;
+      float error = 0.0f;
+
+      if(a->type == VERTEX_OCT16) {
+        int16_t encoded[2];
+        vec3 n = {in[0], in[1], in[2]};
+        vec3 decoded;
+        glm_vec3_normalize(n);
+        vertexOctEncode(n, encoded);
+        vertexOctDecode(encoded, decoded);
+        memcpy(attribOut, encoded, sizeof(encoded));
+        error = acosf(glm_clamp(glm_vec3_dot(n, decoded), -1.0f, 1.0f));
+      }
+
+      for(unsigned int c = 0; c < a->components && a->type != VERTEX_OCT16; c++) {
+        float decoded = in[c];
+
+        if(a->type == VERTEX_FLOAT32) {
+          memcpy(attribOut + c * 4, &in[c], 4);
+        }
+        else if(a->type == VERTEX_FLOAT16) {
+          uint16_t h = vertexFloatToHalf(in[c]);
+          memcpy(attribOut + c * 2, &h, 2);
+          decoded = vertexHalfToFloat(h);
+        }
+        else if(a->type == VERTEX_SNORM16) {
+          int remap = a->semantic == VERTEX_POSITION && c < 3;
+          float value = remap ? (in[c] - center[c]) / extent[c] : in[c];
+          int16_t s = snorm16(value);
+          memcpy(attribOut + c * 2, &s, 2);
+          decoded = remap ? snorm16Decode(s) * extent[c] + center[c] : snorm16Decode(s);
+        }
+        else if(a->type == VERTEX_UNORM16) {
+          // coordinates outside [0, 1] clamp, repeating UVs need FLOAT16 instead
+          uint16_t u = unorm16(in[c]);
+          memcpy(attribOut + c * 2, &u, 2);
+          decoded = u / 65535.0f;
+        }
+
+        error = fmaxf(error, fabsf(decoded - in[c]));
+      }
+
+      if(a->semantic == VERTEX_POSITION) {
+        report->maxPositionError = fmaxf(report->maxPositionError, error);
+      }
+      else if(a->semantic == VERTEX_TEXCOORD) {
+        report->maxTexCoordError = fmaxf(report->maxTexCoordError, error);
+      }
+      else {
+        report->maxNormalError = fmaxf(report->maxNormalError, error);
+      }
+    }
+  }
+
+  report->sourceBytes = (size_t) count * sourceStride * sizeof(float);
+  report->packedBytes = (size_t) count * f->stride;
+  return report->packedBytes;
+}
+
+void vertexPackReportPrint(VertexPackReport* report, const char* label) {
+  double saved = report->sourceBytes ? 100.0 * (1.0 - (double) report->packedBytes / report->sourceBytes) : 0.0;
+  printf("%s: %zu -> %zu bytes (%.1f%% less vertex bandwidth), max error position %g, uv %g, normal %g rad\n",
+      label, report->sourceBytes, report->packedBytes, saved,
+      report->maxPositionError, report->maxTexCoordError, report->maxNormalError);
+}
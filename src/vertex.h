@@ -0,0 +1,67 @@
+#ifndef VERTEX_H
+#define VERTEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cglm/cglm.h>
+
+#define VERTEX_MAX_ATTRIBS 8
+
+typedef enum VertexSemantic {
+  VERTEX_POSITION,
+  VERTEX_TEXCOORD,
+  VERTEX_NORMAL
+} VertexSemantic;
+
+typedef enum VertexType {
+  VERTEX_FLOAT32,
+  VERTEX_FLOAT16,
+  VERTEX_SNORM16, // positions are remapped to the mesh bounds, see VertexPackReport.dequantize
+  VERTEX_UNORM16,
+  VERTEX_OCT16 // unit normal as two snorm16 octahedral coordinates, decode with octDecode in the shader
+} VertexType;
+
+typedef struct VertexAttrib {
+  unsigned int location;
+  unsigned int components; // components in the source data, an OCT16 normal stores 3 as 2
+  VertexSemantic semantic;
+  VertexType type;
+  unsigned int offset; // bytes from the start of the packed vertex
+  unsigned int sourceOffset; // floats from the start of the source vertex
+} VertexAttrib;
+
+// describes one interleaved vertex layout, attribute setup is generated from it
+typedef struct VertexFormat {
+  VertexAttrib attribs[VERTEX_MAX_ATTRIBS];
+  unsigned int attribCount;
+  unsigned int stride; // bytes per packed vertex, each attribute is 4-byte aligned
+} VertexFormat;
+
+typedef struct VertexPackReport {
+  size_t sourceBytes;
+  size_t packedBytes;
+  float maxPositionError; // object-space units, after dequantization
+  float maxTexCoordError;
+  float maxNormalError; // radians
+  mat4 dequantize; // fold into the model matrix to undo position quantization
+} VertexPackReport;
+
+void vertexFormatInit(VertexFormat* f);
+
+void vertexFormatAdd(VertexFormat* f, unsigned int location, VertexSemantic semantic, VertexType type, unsigned int components, unsigned int sourceOffset);
+
+void vertexFormatApply(VertexFormat* f);
+
+size_t vertexPack(VertexFormat* f, const float* source, unsigned int sourceStride, unsigned int count, void* packed, VertexPackReport* report);
+
+void vertexPackReportPrint(VertexPackReport* report, const char* label);
+
+uint16_t vertexFloatToHalf(float value);
+
+float vertexHalfToFloat(uint16_t value);
+
+void vertexOctEncode(vec3 normal, int16_t out[2]);
+
+void vertexOctDecode(const int16_t in[2], vec3 normal);
+
+#endif
@@ -0,0 +1,296 @@
+#include "voxel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cglm/cglm.h>
+
+// chunk voxels with a one voxel border copied from the neighbours, so the mesher needs no bounds checks
+#define VOXEL_PADDED (VOXEL_CHUNK_SIZE + 2)
+#define VOXEL_PADDED_INDEX(x, y, z) ((((z) + 1) * VOXEL_PADDED + (y) + 1) * VOXEL_PADDED + (x) + 1)
+
+static const int paddedSteps[3] = {1, VOXEL_PADDED, VOXEL_PADDED * VOXEL_PADDED};
+
+void voxelWorldInit(VoxelWorld* w, int sizeX, int sizeY, int sizeZ) {
+  w->sizeX = sizeX;
+  w->sizeY = sizeY;
+  w->sizeZ = sizeZ;
+  w->chunks = calloc((size_t) sizeX * sizeY * sizeZ, sizeof(VoxelChunk));
+  for(int i = 0; i < sizeX * sizeY * sizeZ; i++) {
+    voxelChunkInvalidate(&w->chunks[i]);
+  }
+}
+
+VoxelChunk* voxelWorldChunk(VoxelWorld* w, int chunkX, int chunkY, int chunkZ) {
+  if(chunkX < 0 || chunkY < 0 || chunkZ < 0 || chunkX >= w->sizeX || chunkY >= w->sizeY || chunkZ >= w->sizeZ) {
+    return NULL;
+  }
+  return &w->chunks[(chunkZ * w->sizeY + chunkY) * w->sizeX + chunkX];
+}
+
+void voxelWorldGenerate(VoxelWorld* w) {
+  int height = w->sizeY * VOXEL_CHUNK_SIZE;
+  uint32_t seed = 12345;
+
+  for(int cz = 0; cz < w->sizeZ; cz++) {
+    for(int cy = 0; cy < w->sizeY; cy++) {
+      for(int cx = 0; cx < w->sizeX; cx++) {
+        VoxelChunk* c = voxelWorldChunk(w, cx, cy, cz);
+        for(int z = 0; z < VOXEL_CHUNK_SIZE; z++) {
+          for(int x = 0; x < VOXEL_CHUNK_SIZE; x++) {
+            float worldX = (float) (cx * VOXEL_CHUNK_SIZE + x);
+            float worldZ = (float) (cz * VOXEL_CHUNK_SIZE + z);
+            vec3 p = {worldX * 0.02f, 0.5f, worldZ * 0.02f};
+            float surface = height * (0.45f + 0.3f * glm_perlin_vec3(p));
+
+            for(int y = 0; y < VOXEL_CHUNK_SIZE; y++) {
+              float worldY = (float) (cy * VOXEL_CHUNK_SIZE + y);
+              vec3 q = {worldX * 0.06f, worldY * 0.06f, worldZ * 0.06f};
+              uint8_t material = VOXEL_EMPTY;
+              if(worldY <= surface && glm_perlin_vec3(q) < 0.35f) {
+                seed = seed * 1664525u + 1013904223u;
+                material = (seed >> 24) < 8 ? VOXEL_SMILEY : VOXEL_CONTAINER;
+              }
+              c->voxels[VOXEL_INDEX(x, y, z)] = material;
+            }
+          }
+        }
+        voxelChunkInvalidate(c);
+      }
+    }
+  }
+}
+
+static int voxelFloor(int value) {
+  return value >= 0 ? value / VOXEL_CHUNK_SIZE : (value + 1) / VOXEL_CHUNK_SIZE - 1;
+}
+
+uint8_t voxelWorldGet(VoxelWorld* w, int x, int y, int z) {
+  int cx = voxelFloor(x), cy = voxelFloor(y), cz = voxelFloor(z);
+  VoxelChunk* c = voxelWorldChunk(w, cx, cy, cz);
+  if(!c) {
+    return VOXEL_EMPTY;
+  }
+  return c->voxels[VOXEL_INDEX(x - cx * VOXEL_CHUNK_SIZE, y - cy * VOXEL_CHUNK_SIZE, z - cz * VOXEL_CHUNK_SIZE)];
+}
+
+// slice -1 and VOXEL_CHUNK_SIZE belong to the neighbouring chunk along the axis
+static void voxelMarkSlice(VoxelWorld* w, int chunk[3], int axis, int direction, int slice) {
+  int neighbour[3] = {chunk[0], chunk[1], chunk[2]};
+  if(slice < 0) {
+    neighbour[axis]--;
+    slice += VOXEL_CHUNK_SIZE;
+  }
+  else if(slice >= VOXEL_CHUNK_SIZE) {
+    neighbour[axis]++;
+    slice -= VOXEL_CHUNK_SIZE;
+  }
+
+  VoxelChunk* c = voxelWorldChunk(w, neighbour[0], neighbour[1], neighbour[2]);
+  if(c) {
+    c->dirty[direction] |= 1u << slice;
+  }
+}
+
+void voxelWorldSet(VoxelWorld* w, int x, int y, int z, uint8_t material) {
+  int position[3] = {x, y, z};
+  int chunk[3] = {voxelFloor(x), voxelFloor(y), voxelFloor(z)};
+  VoxelChunk* c = voxelWorldChunk(w, chunk[0], chunk[1], chunk[2]);
+  if(!c) {
+    return;
+  }
+
+  int local[3];
+  for(int axis = 0; axis < 3; axis++) {
+    local[axis] = position[axis] - chunk[axis] * VOXEL_CHUNK_SIZE;
+  }
+
+  uint8_t* voxel = &c->voxels[VOXEL_INDEX(local[0], local[1], local[2])];
+  if(*voxel == material) {
+    return;
+  }
+  *voxel = material;
+
+  // the voxel's own faces, and the faces of the neighbours that it covers or uncovers
+  for(int axis = 0; axis < 3; axis++) {
+    voxelMarkSlice(w, chunk, axis, 2 * axis, local[axis]);
+    voxelMarkSlice(w, chunk, axis, 2 * axis, local[axis] - 1);
+    voxelMarkSlice(w, chunk, axis, 2 * axis + 1, local[axis]);
+    voxelMarkSlice(w, chunk, axis, 2 * axis + 1, local[axis] + 1);
+  }
+}
+
+void voxelChunkInvalidate(VoxelChunk* c) {
+  for(int direction = 0; direction < VOXEL_DIRECTIONS; direction++) {
+    c->dirty[direction] = 0xffffffffu;
+  }
+}
+
+static void voxelPad(VoxelWorld* w, int chunkX, int chunkY, int chunkZ, uint8_t* padded) {
+  VoxelChunk* c = voxelWorldChunk(w, chunkX, chunkY, chunkZ);
+  for(int z = 0; z < VOXEL_CHUNK_SIZE; z++) {
+    for(int y = 0; y < VOXEL_CHUNK_SIZE; y++) {
+      memcpy(&padded[VOXEL_PADDED_INDEX(0, y, z)], &c->voxels[VOXEL_INDEX(0, y, z)], VOXEL_CHUNK_SIZE);
+    }
+  }
+
+  // the border shell, only the faces of the shell matter since edges never touch a chunk face
+  int baseX = chunkX * VOXEL_CHUNK_SIZE, baseY = chunkY * VOXEL_CHUNK_SIZE, baseZ = chunkZ * VOXEL_CHUNK_SIZE;
+  for(int a = 0; a < VOXEL_CHUNK_SIZE; a++) {
+    for(int b = 0; b < VOXEL_CHUNK_SIZE; b++) {
+      padded[VOXEL_PADDED_INDEX(-1, a, b)] = voxelWorldGet(w, baseX - 1, baseY + a, baseZ + b);
+      padded[VOXEL_PADDED_INDEX(VOXEL_CHUNK_SIZE, a, b)] = voxelWorldGet(w, baseX + VOXEL_CHUNK_SIZE, baseY + a, baseZ + b);
+      padded[VOXEL_PADDED_INDEX(a, -1, b)] = voxelWorldGet(w, baseX + a, baseY - 1, baseZ + b);
+      padded[VOXEL_PADDED_INDEX(a, VOXEL_CHUNK_SIZE, b)] = voxelWorldGet(w, baseX + a, baseY + VOXEL_CHUNK_SIZE, baseZ + b);
+      padded[VOXEL_PADDED_INDEX(a, b, -1)] = voxelWorldGet(w, baseX + a, baseY + b, baseZ - 1);
+      padded[VOXEL_PADDED_INDEX(a, b, VOXEL_CHUNK_SIZE)] = voxelWorldGet(w, baseX + a, baseY + b, baseZ + VOXEL_CHUNK_SIZE);
+    }
+  }
+}
+
+static uint32_t voxelPack(int position[3], int direction, uint8_t material) {
+  return (uint32_t) position[0] | (uint32_t) position[1] << VOXEL_VERTEX_POSITION_BITS | (uint32_t) position[2] << (2 * VOXEL_VERTEX_POSITION_BITS)
+      | (uint32_t) direction << VOXEL_VERTEX_DIRECTION_SHIFT | (uint32_t) material << VOXEL_VERTEX_MATERIAL_SHIFT;
+}
+
+static void voxelSectionAdd(VoxelSection* s, uint32_t vertices[4]) {
+  if(s->quadCount == s->capacity) {
+    s->capacity = s->capacity ? s->capacity * 2 : 16;
+    s->vertices = realloc(s->vertices, s->capacity * 4 * sizeof(uint32_t));
+  }
+  memcpy(s->vertices + s->quadCount * 4, vertices, 4 * sizeof(uint32_t));
+  s->quadCount++;
+}
+
+// greedy meshing of one slice: visible faces form a 2D material mask, which is covered by
+// rectangles grown first along u and then along v
+static void voxelMeshSection(VoxelSection* s, const uint8_t* padded, int direction, int slice) {
+  int axis = direction / 2;
+  int positive = direction % 2 == 0;
+  int u = (axis + 1) % 3;
+  int v = (axis + 2) % 3;
+  int facing = positive ? paddedSteps[axis] : -paddedSteps[axis];
+
+  uint8_t mask[VOXEL_CHUNK_SIZE][VOXEL_CHUNK_SIZE];
+  int position[3];
+  position[axis] = slice;
+  for(int j = 0; j < VOXEL_CHUNK_SIZE; j++) {
+    for(int i = 0; i < VOXEL_CHUNK_SIZE; i++) {
+      position[u] = i;
+      position[v] = j;
+      int index = VOXEL_PADDED_INDEX(position[0], position[1], position[2]);
+      uint8_t material = padded[index];
+      mask[j][i] = material && !padded[index + facing] ? material : VOXEL_EMPTY;
+    }
+  }
+
+  s->quadCount = 0;
+  for(int j = 0; j < VOXEL_CHUNK_SIZE; j++) {
+    for(int i = 0; i < VOXEL_CHUNK_SIZE; ) {
+      uint8_t material = mask[j][i];
+      if(!material) {
+        i++;
+        continue;
+      }
+
+      int width = 1;
+      while(i + width < VOXEL_CHUNK_SIZE && mask[j][i + width] == material) {
+        width++;
+      }
+
+      int height = 1;
+      for(; j + height < VOXEL_CHUNK_SIZE; height++) {
+        int k = 0;
+        while(k < width && mask[j + height][i + k] == material) {
+          k++;
+        }
+        if(k < width) {
+          break;
+        }
+      }
+
+      for(int row = 0; row < height; row++) {
+        memset(&mask[j + row][i], VOXEL_EMPTY, width);
+      }
+
+      // e_u x e_v = e_axis, so the corners run counter-clockwise seen from the positive side
+      int corners[4][2] = {{i, j}, {i + width, j}, {i + width, j + height}, {i, j + height}};
+      uint32_t vertices[4];
+      position[axis] = slice + positive;
+      for(int corner = 0; corner < 4; corner++) {
+        int k = positive ? corner : (4 - corner) % 4;
+        position[u] = corners[k][0];
+        position[v] = corners[k][1];
+        vertices[corner] = voxelPack(position, direction, material);
+      }
+      position[axis] = slice;
+      voxelSectionAdd(s, vertices);
+
+      i += width;
+    }
+  }
+}
+
+unsigned int voxelChunkMesh(VoxelWorld* w, int chunkX, int chunkY, int chunkZ) {
+  VoxelChunk* c = voxelWorldChunk(w, chunkX, chunkY, chunkZ);
+  if(!c) {
+    printf("ERROR::VOXEL::CHUNK_OUT_OF_RANGE: %d %d %d\n", chunkX, chunkY, chunkZ);
+    return 0;
+  }
+
+  unsigned int rebuilt = 0;
+  for(int direction = 0; direction < VOXEL_DIRECTIONS; direction++) {
+    rebuilt += __builtin_popcount(c->dirty[direction]);
+  }
+  if(!rebuilt) {
+    return 0;
+  }
+
+  uint8_t padded[VOXEL_PADDED * VOXEL_PADDED * VOXEL_PADDED];
+  voxelPad(w, chunkX, chunkY, chunkZ, padded);
+
+  unsigned int quadCount = 0;
+  for(int direction = 0; direction < VOXEL_DIRECTIONS; direction++) {
+    for(uint32_t dirty = c->dirty[direction]; dirty; dirty &= dirty - 1) {
+      int slice = __builtin_ctz(dirty);
+      voxelMeshSection(&c->sections[direction][slice], padded, direction, slice);
+    }
+    c->dirty[direction] = 0;
+
+    for(int slice = 0; slice < VOXEL_CHUNK_SIZE; slice++) {
+      quadCount += c->sections[direction][slice].quadCount;
+    }
+  }
+
+  // clean slices are copied as they are, only the dirty ones paid for meshing
+  if(quadCount > c->capacity) {
+    c->capacity = quadCount;
+    c->vertices = realloc(c->vertices, c->capacity * 4 * sizeof(uint32_t));
+  }
+  c->quadCount = 0;
+  for(int direction = 0; direction < VOXEL_DIRECTIONS; direction++) {
+    for(int slice = 0; slice < VOXEL_CHUNK_SIZE; slice++) {
+      VoxelSection* s = &c->sections[direction][slice];
+      if(!s->quadCount) {
+        continue;
+      }
+      memcpy(c->vertices + c->quadCount * 4, s->vertices, s->quadCount * 4 * sizeof(uint32_t));
+      c->quadCount += s->quadCount;
+    }
+  }
+  c->changed = 1;
+
+  return rebuilt;
+}
+
+void voxelWorldFree(VoxelWorld* w) {
+  for(int i = 0; i < w->sizeX * w->sizeY * w->sizeZ; i++) {
+    VoxelChunk* c = &w->chunks[i];
+    for(int direction = 0; direction < VOXEL_DIRECTIONS; direction++) {
+      for(int slice = 0; slice < VOXEL_CHUNK_SIZE; slice++) {
+        free(c->sections[direction][slice].vertices);
+      }
+    }
+    free(c->vertices);
+  }
+  free(w->chunks);
+}
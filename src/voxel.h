@@ -0,0 +1,75 @@
+#ifndef VOXEL_H
+#define VOXEL_H
+
+#include <stdint.h>
+
+#define VOXEL_CHUNK_SIZE 32
+#define VOXEL_CHUNK_VOXELS (VOXEL_CHUNK_SIZE * VOXEL_CHUNK_SIZE * VOXEL_CHUNK_SIZE)
+#define VOXEL_DIRECTIONS 6 // +x, -x, +y, -y, +z, -z
+
+// the largest mesh a chunk can produce, a 3D checkerboard exposes every face of half the voxels
+#define VOXEL_MAX_QUADS (VOXEL_CHUNK_VOXELS / 2 * VOXEL_DIRECTIONS)
+
+// packed vertex, one uint32: x, y, z in 6 bits each, direction in 3 bits, material in 8 bits
+#define VOXEL_VERTEX_POSITION_BITS 6
+#define VOXEL_VERTEX_DIRECTION_SHIFT 18
+#define VOXEL_VERTEX_MATERIAL_SHIFT 21
+
+#define VOXEL_INDEX(x, y, z) (((z) * VOXEL_CHUNK_SIZE + (y)) * VOXEL_CHUNK_SIZE + (x))
+
+typedef enum VoxelMaterial {
+  VOXEL_EMPTY,
+  VOXEL_CONTAINER, // assets/container.jpg
+  VOXEL_SMILEY // assets/container.jpg with assets/awesomeface.png on top, like src/FS
+} VoxelMaterial;
+
+// faces of one slice that point the same way, the unit of incremental remeshing
+typedef struct VoxelSection {
+  uint32_t* vertices; // four packed vertices per quad
+  unsigned int quadCount;
+  unsigned int capacity; // quads
+} VoxelSection;
+
+typedef struct VoxelChunk {
+  uint8_t voxels[VOXEL_CHUNK_VOXELS]; // VoxelMaterial, indexed with VOXEL_INDEX
+  VoxelSection sections[VOXEL_DIRECTIONS][VOXEL_CHUNK_SIZE];
+  uint32_t dirty[VOXEL_DIRECTIONS]; // one bit per slice that needs remeshing
+
+  uint32_t* vertices; // every section back to back, ready for upload
+  unsigned int quadCount;
+  unsigned int capacity; // quads
+  int changed; // vertices were rebuilt since the renderer last looked
+} VoxelChunk;
+
+// a fixed box of chunks, faces between neighbouring chunks are culled like interior ones
+typedef struct VoxelWorld {
+  VoxelChunk* chunks;
+  int sizeX;
+  int sizeY;
+  int sizeZ;
+} VoxelWorld;
+
+void voxelWorldInit(VoxelWorld* w, int sizeX, int sizeY, int sizeZ);
+
+// rolling perlin hills of containers with caves and a sprinkling of smiley blocks
+void voxelWorldGenerate(VoxelWorld* w);
+
+// NULL outside the world
+VoxelChunk* voxelWorldChunk(VoxelWorld* w, int chunkX, int chunkY, int chunkZ);
+
+// empty outside the world
+uint8_t voxelWorldGet(VoxelWorld* w, int x, int y, int z);
+
+// marks the slices the change can affect, including those of a neighbouring chunk across a border
+void voxelWorldSet(VoxelWorld* w, int x, int y, int z, uint8_t material);
+
+// marks every slice of a chunk for remeshing, after writing chunk->voxels directly
+void voxelChunkInvalidate(VoxelChunk* c);
+
+// rebuilds the dirty slices and gathers the chunk vertices, returns the number of slices rebuilt.
+// reads neighbouring chunks, so chunks can be meshed in parallel as long as no voxel is written meanwhile
+unsigned int voxelChunkMesh(VoxelWorld* w, int chunkX, int chunkY, int chunkZ);
+
+void voxelWorldFree(VoxelWorld* w);
+
+#endif
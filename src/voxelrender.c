@@ -0,0 +1,110 @@
+#include "voxelrender.h"
+#include <stdlib.h>
+#include <glad/glad.h>
+
+void voxelRendererInit(VoxelRenderer* r, VoxelWorld* w) {
+  r->chunkCount = (unsigned int) (w->sizeX * w->sizeY * w->sizeZ);
+  r->VAOs = malloc(r->chunkCount * sizeof(unsigned int));
+  r->VBOs = malloc(r->chunkCount * sizeof(unsigned int));
+  r->capacities = calloc(r->chunkCount, sizeof(unsigned int));
+  r->indexQuads = 0;
+
+  glGenVertexArrays(r->chunkCount, r->VAOs);
+  glGenBuffers(r->chunkCount, r->VBOs);
+  glGenBuffers(1, &r->EBO);
+
+  for(unsigned int i = 0; i < r->chunkCount; i++) {
+    glBindVertexArray(r->VAOs[i]);
+    glBindBuffer(GL_ARRAY_BUFFER, r->VBOs[i]);
+    glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*) 0);
+    glEnableVertexAttribArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, r->EBO);
+  }
+  glBindVertexArray(0);
+}
+
+// quads are four vertices each, so one index pattern serves every chunk
+static void voxelRendererGrowIndices(VoxelRenderer* r, unsigned int VAO, unsigned int quads) {
+  unsigned int capacity = r->indexQuads ? r->indexQuads : 1024;
+  while(capacity < quads) {
+    capacity *= 2;
+  }
+
+  unsigned int* indices = malloc((size_t) capacity * 6 * sizeof(unsigned int));
+  for(unsigned int q = 0; q < capacity; q++) {
+    unsigned int* quad = indices + q * 6;
+    quad[0] = q * 4;
+    quad[1] = q * 4 + 1;
+    quad[2] = q * 4 + 2;
+    quad[3] = q * 4;
+    quad[4] = q * 4 + 2;
+    quad[5] = q * 4 + 3;
+  }
+
+  // the EBO binding belongs to the VAO, bind one that already references it
+  glBindVertexArray(VAO);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr) capacity * 6 * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+  free(indices);
+  r->indexQuads = capacity;
+}
+
+unsigned int voxelRendererUpload(VoxelRenderer* r, VoxelWorld* w) {
+  unsigned int uploaded = 0;
+
+  for(unsigned int i = 0; i < r->chunkCount; i++) {
+    VoxelChunk* c = &w->chunks[i];
+    if(!c->changed) {
+      continue;
+    }
+    c->changed = 0;
+    uploaded++;
+
+    if(c->quadCount > r->indexQuads) {
+      voxelRendererGrowIndices(r, r->VAOs[i], c->quadCount);
+    }
+
+    GLsizeiptr size = (GLsizeiptr) c->quadCount * 4 * sizeof(uint32_t);
+    glBindBuffer(GL_ARRAY_BUFFER, r->VBOs[i]);
+    if(c->quadCount > r->capacities[i]) {
+      // some headroom so digging a few voxels does not reallocate every time
+      r->capacities[i] = c->quadCount + c->quadCount / 4;
+      glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) r->capacities[i] * 4 * sizeof(uint32_t), NULL, GL_DYNAMIC_DRAW);
+    }
+    if(size) {
+      glBufferSubData(GL_ARRAY_BUFFER, 0, size, c->vertices);
+    }
+  }
+
+  glBindVertexArray(0);
+  return uploaded;
+}
+
+void voxelRendererDraw(VoxelRenderer* r, VoxelWorld* w, Shader* s, vec3 origin) {
+  for(int z = 0; z < w->sizeZ; z++) {
+    for(int y = 0; y < w->sizeY; y++) {
+      for(int x = 0; x < w->sizeX; x++) {
+        unsigned int i = (unsigned int) ((z * w->sizeY + y) * w->sizeX + x);
+        if(!w->chunks[i].quadCount) {
+          continue;
+        }
+
+        mat4 model;
+        glm_translate_make(model, (vec3) {origin[0] + x * VOXEL_CHUNK_SIZE, origin[1] + y * VOXEL_CHUNK_SIZE, origin[2] + z * VOXEL_CHUNK_SIZE});
+        shaderSetMatrix(s, "model", model);
+
+        glBindVertexArray(r->VAOs[i]);
+        glDrawElements(GL_TRIANGLES, w->chunks[i].quadCount * 6, GL_UNSIGNED_INT, 0);
+      }
+    }
+  }
+  glBindVertexArray(0);
+}
+
+void voxelRendererFree(VoxelRenderer* r) {
+  glDeleteVertexArrays(r->chunkCount, r->VAOs);
+  glDeleteBuffers(r->chunkCount, r->VBOs);
+  glDeleteBuffers(1, &r->EBO);
+  free(r->VAOs);
+  free(r->VBOs);
+  free(r->capacities);
+}
@@ -0,0 +1,29 @@
+#ifndef VOXELRENDER_H
+#define VOXELRENDER_H
+
+#include <cglm/cglm.h>
+#include "voxel.h"
+#include "shader.h"
+
+// one VAO and VBO of packed vertices per chunk, every chunk shares one quad index buffer
+typedef struct VoxelRenderer {
+  unsigned int* VAOs;
+  unsigned int* VBOs;
+  unsigned int* capacities; // quads each VBO can hold
+  unsigned int chunkCount;
+
+  unsigned int EBO;
+  unsigned int indexQuads; // quads the shared index buffer covers, grown on demand
+} VoxelRenderer;
+
+void voxelRendererInit(VoxelRenderer* r, VoxelWorld* w);
+
+// uploads the chunks remeshed since the last call, returns how many were uploaded
+unsigned int voxelRendererUpload(VoxelRenderer* r, VoxelWorld* w);
+
+// expects src/VS_voxel, origin is the world position of voxel (0, 0, 0)
+void voxelRendererDraw(VoxelRenderer* r, VoxelWorld* w, Shader* s, vec3 origin);
+
+void voxelRendererFree(VoxelRenderer* r);
+
+#endif
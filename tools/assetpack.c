@@ -0,0 +1,251 @@
+// bundles loose asset files into a single mmap-able archive (see src/pack.h)
+//
+// usage:
+//   assetpack [--decode] <out.pack> <root> <file>...
+//   assetpack --bench <archive.pack> <root> <file>...
+//
+// entries are named by their path relative to <root>, e.g. "src/VS" or "assets/container.jpg".
+// --decode stores images as raw pixels so the runtime skips stb_image entirely.
+// --bench compares opening and reading the loose files against the archive.
+
+#include "pack.h"
+#include "hash.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#define BENCH_ITERATIONS 50
+
+typedef struct PackInput {
+  PackEntry entry;
+  unsigned char* data;
+} PackInput;
+
+static unsigned char* readFile(const char* path, size_t* size) {
+  FILE* fp = fopen(path, "rb");
+  if(!fp) {
+    printf("ERROR::ASSETPACK::FILE_NOT_SUCCESSFULLY_READ: %s\n", path);
+    return NULL;
+  }
+
+  fseek(fp, 0L, SEEK_END);
+  long length = ftell(fp);
+  rewind(fp);
+
+  unsigned char* buffer = malloc(length > 0 ? length : 1);
+  if(!buffer || (length > 0 && fread(buffer, length, 1, fp) != 1)) {
+    printf("ERROR::ASSETPACK::FILE_NOT_SUCCESSFULLY_READ: %s\n", path);
+    free(buffer);
+    fclose(fp);
+    return NULL;
+  }
+
+  fclose(fp);
+  *size = length;
+  return buffer;
+}
+
+static int isImage(const char* name) {
+  const char* ext = strrchr(name, '.');
+  return ext && (!strcmp(ext, ".png") || !strcmp(ext, ".jpg") || !strcmp(ext, ".jpeg"));
+}
+
+static int compareInputs(const void* a, const void* b) {
+  return strncmp(((const PackInput*) a)->entry.name, ((const PackInput*) b)->entry.name, PACK_NAME_LENGTH);
+}
+
+static size_t alignUp(size_t offset) {
+  return (offset + PACK_ALIGNMENT - 1) & ~((size_t) PACK_ALIGNMENT - 1);
+}
+
+static int writePack(const char* outPath, const char* root, char** files, int fileCount, int decode) {
+  PackInput* inputs = calloc(fileCount, sizeof(PackInput));
+
+  for(int i = 0; i < fileCount; i++) {
+    PackEntry* e = &inputs[i].entry;
+    if(strlen(files[i]) >= PACK_NAME_LENGTH) {
+      printf("ERROR::ASSETPACK::NAME_TOO_LONG: %s\n", files[i]);
+      return 1;
+    }
+    strncpy(e->name, files[i], PACK_NAME_LENGTH - 1);
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", root, files[i]);
+
+    size_t size;
+    unsigned char* data = readFile(path, &size);
+    if(!data) {
+      return 1;
+    }
+
+    e->type = PACK_ENTRY_RAW;
+    if(decode && isImage(files[i])) {
+      int width, height, channels;
+      unsigned char* pixels = stbi_load_from_memory(data, (int) size, &width, &height, &channels, 0);
+      if(!pixels) {
+        printf("ERROR::ASSETPACK::FAILED_TO_DECODE: %s\n", path);
+        return 1;
+      }
+      free(data);
+      data = pixels;
+      size = (size_t) width * height * channels;
+      e->type = PACK_ENTRY_PIXELS;
+      e->width = width;
+      e->height = height;
+      e->channels = channels;
+    }
+
+    e->size = size;
+    e->hash = hash64(data, size, 0);
+    inputs[i].data = data;
+  }
+
+  // sorted names let packFind binary search the table of contents
+  qsort(inputs, fileCount, sizeof(PackInput), compareInputs);
+
+  PackHeader header = {0};
+  header.magic = PACK_MAGIC;
+  header.version = PACK_VERSION;
+  header.entryCount = fileCount;
+  header.tocOffset = alignUp(sizeof(PackHeader));
+
+  size_t offset = alignUp(header.tocOffset + fileCount * sizeof(PackEntry));
+  for(int i = 0; i < fileCount; i++) {
+    inputs[i].entry.offset = offset;
+    offset = alignUp(offset + inputs[i].entry.size);
+  }
+
+  FILE* fp = fopen(outPath, "wb");
+  if(!fp) {
+    printf("ERROR::ASSETPACK::FAILED_TO_OPEN_OUTPUT: %s\n", outPath);
+    return 1;
+  }
+
+  static const unsigned char padding[PACK_ALIGNMENT];
+  fwrite(&header, sizeof(header), 1, fp);
+  fwrite(padding, header.tocOffset - sizeof(header), 1, fp);
+  for(int i = 0; i < fileCount; i++) {
+    fwrite(&inputs[i].entry, sizeof(PackEntry), 1, fp);
+  }
+
+  for(int i = 0; i < fileCount; i++) {
+    long position = ftell(fp);
+    fwrite(padding, inputs[i].entry.offset - position, 1, fp);
+    fwrite(inputs[i].data, inputs[i].entry.size, 1, fp);
+    printf("%-40s %10llu bytes  %s  %016llx\n", inputs[i].entry.name,
+        (unsigned long long) inputs[i].entry.size,
+        inputs[i].entry.type == PACK_ENTRY_PIXELS ? "pixels" : "raw   ",
+        (unsigned long long) inputs[i].entry.hash);
+    free(inputs[i].data);
+  }
+
+  fclose(fp);
+  free(inputs);
+  return 0;
+}
+
+// time loading every asset the way the samples do it today against one mapped archive
+static int bench(const char* packPath, const char* root, char** files, int fileCount) {
+  volatile uint64_t sink = 0;
+
+  double start = timingNow();
+  for(int iter = 0; iter < BENCH_ITERATIONS; iter++) {
+    for(int i = 0; i < fileCount; i++) {
+      char path[1024];
+      snprintf(path, sizeof(path), "%s/%s", root, files[i]);
+
+      size_t size;
+      unsigned char* data = readFile(path, &size);
+      if(!data) {
+        return 1;
+      }
+
+      if(isImage(files[i])) {
+        int width, height, channels;
+        unsigned char* pixels = stbi_load_from_memory(data, (int) size, &width, &height, &channels, 0);
+        sink += pixels ? pixels[0] : 0;
+        stbi_image_free(pixels);
+      }
+      else {
+        sink += hash64(data, size, 0);
+      }
+      free(data);
+    }
+  }
+  double looseTime = (timingNow() - start) / BENCH_ITERATIONS;
+
+  start = timingNow();
+  for(int iter = 0; iter < BENCH_ITERATIONS; iter++) {
+    Pack p;
+    if(packOpen(&p, packPath) != 0) {
+      printf("ERROR::ASSETPACK::FAILED_TO_OPEN_ARCHIVE: %s\n", packPath);
+      return 1;
+    }
+
+    for(int i = 0; i < fileCount; i++) {
+      PackView v;
+      if(packFind(&p, files[i], &v) != 0) {
+        printf("ERROR::ASSETPACK::MISSING_ENTRY: %s\n", files[i]);
+        return 1;
+      }
+
+      if(v.entry->type == PACK_ENTRY_PIXELS) {
+        // pre-decoded pixels are used in place, touching them faults the pages in
+        sink += hash64(v.data, v.size, 0);
+      }
+      else if(isImage(files[i])) {
+        int width, height, channels;
+        unsigned char* pixels = stbi_load_from_memory(v.data, (int) v.size, &width, &height, &channels, 0);
+        sink += pixels ? pixels[0] : 0;
+        stbi_image_free(pixels);
+      }
+      else {
+        sink += hash64(v.data, v.size, 0);
+      }
+    }
+
+    packClose(&p);
+  }
+  double packTime = (timingNow() - start) / BENCH_ITERATIONS;
+
+  printf("loose files: %8.3f ms per load\n", looseTime * 1000.0);
+  printf("pack:        %8.3f ms per load\n", packTime * 1000.0);
+  printf("speedup:     %8.2fx\n", looseTime / packTime);
+  printf("note: run after dropping the page cache for true cold-start numbers\n");
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  int decode = 0;
+  int benchMode = 0;
+  int arg = 1;
+
+  while(arg < argc && !strncmp(argv[arg], "--", 2)) {
+    if(!strcmp(argv[arg], "--decode")) {
+      decode = 1;
+    }
+    else if(!strcmp(argv[arg], "--bench")) {
+      benchMode = 1;
+    }
+    else {
+      printf("ERROR::ASSETPACK::UNKNOWN_OPTION: %s\n", argv[arg]);
+      return 1;
+    }
+    arg++;
+  }
+
+  if(argc - arg < 3) {
+    printf("usage: assetpack [--decode] <out.pack> <root> <file>...\n");
+    printf("       assetpack --bench <archive.pack> <root> <file>...\n");
+    return 1;
+  }
+
+  if(benchMode) {
+    return bench(argv[arg], argv[arg + 1], argv + arg + 2, argc - arg - 2);
+  }
+  return writePack(argv[arg], argv[arg + 1], argv + arg + 2, argc - arg - 2, decode);
+}
@@ -0,0 +1,175 @@
+// walks a camera down the streets of a dense city of boxes and measures the software
+// occlusion culler (see src/occlusion.h): occluder rasterization, culling time and cull rate
+//
+// usage:
+//   cullbench [--threads N] [--frames N] [--grid N] [--occluders N] [--out depth.ppm]
+
+#include "occlusion.h"
+#include "sort.h"
+#include "timing.h"
+#include "image.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define CITY_CELL 3.0f // one building and its share of the street
+#define CITY_BUILDING 2.0f
+#define CITY_NEAR 0.1f
+#define CITY_FAR 300.0f
+
+typedef struct City {
+  vec3* minimums;
+  vec3* maximums;
+  unsigned int count;
+} City;
+
+static void cityInit(City* c, unsigned int grid) {
+  c->count = grid * grid;
+  c->minimums = malloc(c->count * sizeof(vec3));
+  c->maximums = malloc(c->count * sizeof(vec3));
+
+  // fixed seed so every run measures the same skyline
+  uint32_t seed = 12345;
+  for(unsigned int z = 0; z < grid; z++) {
+    for(unsigned int x = 0; x < grid; x++) {
+      seed = seed * 1664525u + 1013904223u;
+      float height = 2.0f + (seed >> 8) / (float) (1 << 24) * 18.0f;
+      unsigned int i = z * grid + x;
+      glm_vec3_copy((vec3) {x * CITY_CELL, 0.0f, -(z * CITY_CELL)}, c->minimums[i]);
+      glm_vec3_copy((vec3) {x * CITY_CELL + CITY_BUILDING, height, -(z * CITY_CELL) + CITY_BUILDING}, c->maximums[i]);
+    }
+  }
+}
+
+static void cityFree(City* c) {
+  free(c->minimums);
+  free(c->maximums);
+}
+
+// linear depth as grey, near is white
+static void writeDepth(Occlusion* o, const char* path) {
+  unsigned char* rgba = malloc((size_t) o->width * o->height * 4);
+  for(int i = 0; i < o->width * o->height; i++) {
+    float ndc = o->levels[0][i] * 2.0f - 1.0f;
+    float linear = 2.0f * CITY_NEAR * CITY_FAR / (CITY_FAR + CITY_NEAR - ndc * (CITY_FAR - CITY_NEAR));
+    unsigned char grey = (unsigned char) (255.0f * (1.0f - glm_clamp(linear / 100.0f, 0.0f, 1.0f)));
+    rgba[i * 4 + 0] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = grey;
+    rgba[i * 4 + 3] = 255;
+  }
+  imageWritePPM(path, rgba, o->width, o->height, 0);
+  free(rgba);
+}
+
+int main(int argc, char** argv) {
+  unsigned int threads = (unsigned int) sysconf(_SC_NPROCESSORS_ONLN);
+  int frames = 200;
+  unsigned int grid = 128;
+  unsigned int occluders = 64;
+  const char* out = NULL;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--frames") && i + 1 < argc) {
+      frames = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--grid") && i + 1 < argc) {
+      grid = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--occluders") && i + 1 < argc) {
+      occluders = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--out") && i + 1 < argc) {
+      out = argv[++i];
+    }
+    else {
+      printf("usage: cullbench [--threads N] [--frames N] [--grid N] [--occluders N] [--out depth.ppm]\n");
+      return 1;
+    }
+  }
+
+  City city;
+  cityInit(&city, grid);
+
+  Occlusion o;
+  occlusionInit(&o, OCCLUSION_WIDTH, OCCLUSION_HEIGHT, threads);
+
+  float* distances = malloc(city.count * sizeof(float));
+  uint32_t* order = malloc(city.count * sizeof(uint32_t));
+  uint32_t* scratch = malloc(3 * city.count * sizeof(uint32_t));
+  unsigned char* visible = malloc(city.count);
+
+  mat4 projection;
+  glm_perspective(glm_rad(60.0f), (float) OCCLUSION_WIDTH / (float) OCCLUSION_HEIGHT, CITY_NEAR, CITY_FAR, projection);
+
+  Timing rasterTimes, cullTimes;
+  timingInit(&rasterTimes);
+  timingInit(&cullTimes);
+  unsigned long long culled = 0, occluded = 0, tested = 0, occludersUsed = 0;
+
+  for(int frame = 0; frame < frames; frame++) {
+    // eye height down the middle street, swaying left and right
+    float t = (float) frame / (float) frames;
+    float streetX = (grid / 2) * CITY_CELL - (CITY_CELL - CITY_BUILDING) * 0.5f;
+    vec3 eye = {streetX, 1.7f, 10.0f - t * grid * CITY_CELL * 0.5f};
+    float yaw = sinf(t * 12.0f) * 0.6f;
+    vec3 center = {eye[0] + sinf(yaw), eye[1], eye[2] - cosf(yaw)};
+
+    mat4 view, viewProjection;
+    glm_lookat(eye, center, (vec3) {0.0f, 1.0f, 0.0f}, view);
+    glm_mat4_mul(projection, view, viewProjection);
+
+    double start = timingNow();
+    occlusionBegin(&o, viewProjection);
+
+    // the nearest buildings in front of the camera are the best occluders
+    for(unsigned int i = 0; i < city.count; i++) {
+      vec3 middle, viewMiddle;
+      glm_vec3_center(city.minimums[i], city.maximums[i], middle);
+      glm_mat4_mulv3(view, middle, 1.0f, viewMiddle);
+      distances[i] = viewMiddle[2] < 0.0f ? glm_vec3_norm(viewMiddle) : INFINITY;
+    }
+    sortRadixFloat(distances, order, city.count, scratch);
+    for(unsigned int i = 0; i < occluders && i < city.count && distances[order[i]] < INFINITY; i++) {
+      occlusionAddOccluder(&o, city.minimums[order[i]], city.maximums[order[i]]);
+    }
+    occlusionRasterize(&o);
+
+    double rasterized = timingNow();
+    occlusionCull(&o, city.minimums, city.maximums, city.count, visible);
+    double end = timingNow();
+
+    timingAdd(&rasterTimes, (rasterized - start) * 1000.0);
+    timingAdd(&cullTimes, (end - rasterized) * 1000.0);
+    tested += o.stats.tested;
+    culled += o.stats.frustumCulled;
+    occluded += o.stats.occlusionCulled;
+    occludersUsed += o.stats.occluders;
+
+    if(out && frame == frames / 2) {
+      writeDepth(&o, out);
+    }
+  }
+
+  printf("%u buildings, %d frames, %ux%d depth buffer on %u threads\n", city.count, frames, o.width, o.height, o.threadCount);
+  timingReport(&rasterTimes, "occluders");
+  timingReport(&cullTimes, "cull");
+  printf("occluders:    %.1f per frame\n", (double) occludersUsed / frames);
+  printf("frustum:      %.1f%% culled\n", 100.0 * culled / tested);
+  printf("occlusion:    %.1f%% culled, %.1f%% of the frustum survivors\n",
+      100.0 * occluded / tested, tested > culled ? 100.0 * occluded / (tested - culled) : 0.0);
+  printf("submitted:    %.1f of %u per frame\n", (double) (tested - culled - occluded) / frames, city.count);
+
+  timingFree(&rasterTimes);
+  timingFree(&cullTimes);
+  free(distances);
+  free(order);
+  free(scratch);
+  free(visible);
+  occlusionFree(&o);
+  cityFree(&city);
+  return 0;
+}
@@ -0,0 +1,257 @@
+// headless, GPU-free benchmark over the engine's CPU hot paths: sorting, hashing, vertex
+// packing, simplification, occlusion culling, software rasterization and voxel meshing.
+// fixed seeds and sizes, so it doubles as the training run for profile-guided builds
+//
+// usage:
+//   enginebench [--threads N] [--iterations N]
+
+#include "sort.h"
+#include "hash.h"
+#include "vertex.h"
+#include "simplify.h"
+#include "occlusion.h"
+#include "raster.h"
+#include "voxel.h"
+#include "cube.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct Bench {
+  unsigned int threads;
+  uint32_t seed;
+  float* floats;
+  uint32_t* order;
+  uint32_t* scratch;
+  unsigned char* bytes;
+  float* rounded;
+  unsigned int* roundedIndices;
+  unsigned int* indices;
+  void* packed;
+  Occlusion occlusion;
+  vec3* minimums;
+  vec3* maximums;
+  unsigned char* visible;
+  Raster raster;
+  unsigned char* checker;
+  VoxelWorld world;
+} Bench;
+
+#define BENCH_SORT_COUNT (1 << 20)
+#define BENCH_HASH_BYTES (64 << 20)
+#define BENCH_SUBDIVISIONS 32
+#define BENCH_CITY 64 // boxes along each side
+#define BENCH_OCCLUDERS 256
+
+static uint32_t benchRandom(Bench* b) {
+  b->seed = b->seed * 1664525u + 1013904223u;
+  return b->seed >> 8;
+}
+
+static void benchSort(Bench* b) {
+  for(unsigned int i = 0; i < BENCH_SORT_COUNT; i++) {
+    b->floats[i] = (float) benchRandom(b) / (1 << 24) * 200.0f - 100.0f;
+  }
+  sortRadixFloat(b->floats, b->order, BENCH_SORT_COUNT, b->scratch);
+}
+
+static void benchHash(Bench* b) {
+  volatile uint64_t h = hash64(b->bytes, BENCH_HASH_BYTES, 0);
+  (void) h;
+}
+
+static void benchVertexPack(Bench* b) {
+  VertexFormat format;
+  vertexFormatInit(&format);
+  vertexFormatAdd(&format, 0, VERTEX_POSITION, VERTEX_SNORM16, 3, 0);
+  vertexFormatAdd(&format, 1, VERTEX_TEXCOORD, VERTEX_UNORM16, 2, 3);
+
+  VertexPackReport report;
+  for(int i = 0; i < 16; i++) {
+    vertexPack(&format, b->rounded, CUBE_VERTEX_STRIDE, CUBE_ROUNDED_VERTEX_COUNT(BENCH_SUBDIVISIONS), b->packed, &report);
+  }
+}
+
+static void benchSimplify(Bench* b) {
+  unsigned int indexCount = CUBE_ROUNDED_INDEX_COUNT(BENCH_SUBDIVISIONS);
+  memcpy(b->indices, b->roundedIndices, indexCount * sizeof(unsigned int));
+  float error;
+  simplifyMesh(b->rounded, CUBE_VERTEX_STRIDE, CUBE_ROUNDED_VERTEX_COUNT(BENCH_SUBDIVISIONS), b->indices, indexCount, indexCount / 12 * 3, 0.05f, &error);
+}
+
+// a camera walking down a grid of boxes, the nearest ones occlude
+static void benchOcclusion(Bench* b) {
+  mat4 projection, view, viewProjection;
+  glm_perspective(glm_rad(60.0f), 2.0f, 0.1f, 300.0f, projection);
+  for(int frame = 0; frame < 8; frame++) {
+    vec3 eye = {BENCH_CITY * 1.5f, 1.7f, 2.0f - frame * 3.0f};
+    glm_lookat(eye, (vec3) {eye[0] + 10.0f, 1.7f, eye[2] - 40.0f}, (vec3) {0.0f, 1.0f, 0.0f}, view);
+    glm_mat4_mul(projection, view, viewProjection);
+
+    occlusionBegin(&b->occlusion, viewProjection);
+    for(unsigned int i = 0; i < BENCH_OCCLUDERS; i++) {
+      occlusionAddOccluder(&b->occlusion, b->minimums[i], b->maximums[i]);
+    }
+    occlusionRasterize(&b->occlusion);
+    occlusionCull(&b->occlusion, b->minimums, b->maximums, BENCH_CITY * BENCH_CITY, b->visible);
+  }
+}
+
+static void benchRaster(Bench* b) {
+  mat4 view, projection;
+  glm_translate_make(view, (vec3) {0.0f, 0.0f, -3.0f});
+  glm_perspective(glm_rad(45.0f), 4.0f / 3.0f, 0.1f, 100.0f, projection);
+
+  for(int frame = 0; frame < 4; frame++) {
+    rasterClear(&b->raster, 0.0f, 0.0f, 0.0f, 1.0f);
+    for(unsigned int i = 0; i < CUBE_POSITION_COUNT; i++) {
+      mat4 model;
+      glm_translate_make(model, cubePositions[i]);
+      glm_rotate(model, glm_rad(20.0f * i + frame), (vec3) {1.0f, 0.3f, 0.5f});
+      rasterDrawArrays(&b->raster, cubeVertices, 0, CUBE_VERTEX_COUNT, model, view, projection);
+    }
+    rasterFlush(&b->raster);
+  }
+}
+
+static void benchVoxels(Bench* b) {
+  voxelWorldGenerate(&b->world);
+  for(int z = 0; z < b->world.sizeZ; z++) {
+    for(int y = 0; y < b->world.sizeY; y++) {
+      for(int x = 0; x < b->world.sizeX; x++) {
+        voxelChunkMesh(&b->world, x, y, z);
+      }
+    }
+  }
+}
+
+static void benchInit(Bench* b, unsigned int threads) {
+  memset(b, 0, sizeof(*b));
+  b->threads = threads;
+  b->seed = 12345;
+
+  b->floats = malloc(BENCH_SORT_COUNT * sizeof(float));
+  b->order = malloc(BENCH_SORT_COUNT * sizeof(uint32_t));
+  b->scratch = malloc(3 * BENCH_SORT_COUNT * sizeof(uint32_t));
+
+  b->bytes = malloc(BENCH_HASH_BYTES);
+  for(unsigned int i = 0; i < BENCH_HASH_BYTES; i++) {
+    b->bytes[i] = (unsigned char) (i * 31 + (i >> 11));
+  }
+
+  unsigned int vertexCount = CUBE_ROUNDED_VERTEX_COUNT(BENCH_SUBDIVISIONS);
+  unsigned int indexCount = CUBE_ROUNDED_INDEX_COUNT(BENCH_SUBDIVISIONS);
+  b->rounded = malloc((size_t) vertexCount * CUBE_VERTEX_STRIDE * sizeof(float));
+  b->roundedIndices = malloc(indexCount * sizeof(unsigned int));
+  b->indices = malloc(indexCount * sizeof(unsigned int));
+  b->packed = malloc((size_t) vertexCount * CUBE_VERTEX_STRIDE * sizeof(float));
+  cubeBuildRounded(BENCH_SUBDIVISIONS, 0.1f, b->rounded, b->roundedIndices);
+
+  occlusionInit(&b->occlusion, OCCLUSION_WIDTH, OCCLUSION_HEIGHT, threads);
+  b->minimums = malloc(BENCH_CITY * BENCH_CITY * sizeof(vec3));
+  b->maximums = malloc(BENCH_CITY * BENCH_CITY * sizeof(vec3));
+  b->visible = malloc(BENCH_CITY * BENCH_CITY);
+  for(unsigned int z = 0; z < BENCH_CITY; z++) {
+    for(unsigned int x = 0; x < BENCH_CITY; x++) {
+      unsigned int i = z * BENCH_CITY + x;
+      float height = 2.0f + (float) (benchRandom(b) % 18);
+      glm_vec3_copy((vec3) {x * 3.0f, 0.0f, -(z * 3.0f)}, b->minimums[i]);
+      glm_vec3_copy((vec3) {x * 3.0f + 2.0f, height, -(z * 3.0f) + 2.0f}, b->maximums[i]);
+    }
+  }
+
+  // a procedural checkerboard stands in for the image files so the run needs no assets
+  int size = 256;
+  b->checker = malloc((size_t) size * size * 3);
+  for(int y = 0; y < size; y++) {
+    for(int x = 0; x < size; x++) {
+      unsigned char value = ((x >> 5) ^ (y >> 5)) & 1 ? 220 : 40;
+      memset(b->checker + ((size_t) y * size + x) * 3, value, 3);
+    }
+  }
+  RasterTexture checker = {b->checker, size, size, 3};
+  rasterInit(&b->raster, 400, 300, threads);
+  rasterSetTexture(&b->raster, 0, &checker);
+  rasterSetTexture(&b->raster, 1, &checker);
+
+  voxelWorldInit(&b->world, 4, 2, 4);
+}
+
+static void benchFree(Bench* b) {
+  free(b->floats);
+  free(b->order);
+  free(b->scratch);
+  free(b->bytes);
+  free(b->rounded);
+  free(b->roundedIndices);
+  free(b->indices);
+  free(b->packed);
+  occlusionFree(&b->occlusion);
+  free(b->minimums);
+  free(b->maximums);
+  free(b->visible);
+  rasterFree(&b->raster);
+  free(b->checker);
+  voxelWorldFree(&b->world);
+}
+
+typedef struct BenchCase {
+  const char* name;
+  void (*run)(Bench* b);
+} BenchCase;
+
+static const BenchCase benchCases[] = {
+  {"radix sort 1M floats", benchSort},
+  {"hash64 64 MB", benchHash},
+  {"vertex pack 16x rounded cube", benchVertexPack},
+  {"simplify rounded cube to 25%", benchSimplify},
+  {"occlusion 8 frames", benchOcclusion},
+  {"software raster 4 frames", benchRaster},
+  {"voxel generate and mesh 32 chunks", benchVoxels},
+};
+
+int main(int argc, char** argv) {
+  unsigned int threads = (unsigned int) sysconf(_SC_NPROCESSORS_ONLN);
+  int iterations = 5;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = (unsigned int) atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--iterations") && i + 1 < argc) {
+      iterations = atoi(argv[++i]);
+    }
+    else {
+      printf("usage: enginebench [--threads N] [--iterations N]\n");
+      return 1;
+    }
+  }
+  if(threads == 0 || iterations <= 0) {
+    printf("usage: enginebench [--threads N] [--iterations N]\n");
+    return 1;
+  }
+
+  Bench b;
+  benchInit(&b, threads);
+
+  double total = 0.0;
+  for(unsigned int c = 0; c < sizeof(benchCases) / sizeof(benchCases[0]); c++) {
+    Timing times;
+    timingInit(&times);
+    for(int i = 0; i < iterations; i++) {
+      double start = timingNow();
+      benchCases[c].run(&b);
+      timingAdd(&times, (timingNow() - start) * 1000.0);
+    }
+    double best = timingPercentile(&times, 0.0);
+    total += best;
+    printf("%-36s best %8.2f ms, p50 %8.2f ms\n", benchCases[c].name, best, timingPercentile(&times, 50.0));
+    timingFree(&times);
+  }
+  printf("%-36s best %8.2f ms\n", "total", total);
+
+  benchFree(&b);
+  return 0;
+}
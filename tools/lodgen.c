@@ -0,0 +1,206 @@
+// builds the LOD chain of the rounded cube offline with the quadric simplifier (src/simplify.h),
+// or replays a camera flight over a field of them to compare triangles submitted with and without LOD
+//
+// usage:
+//   lodgen [--subdivisions N] [--radius R] out.lod
+//   lodgen --bench [--objects N] [--frames N] [--hysteresis H] file.lod
+
+#include "lod.h"
+#include "simplify.h"
+#include "cube.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// fraction of the level 0 triangles each level aims for
+static const float levelRatios[LOD_MAX_LEVELS] = {1.0f, 0.5f, 0.25f, 0.125f, 0.0625f, 0.03125f};
+
+// object-space error past which a level is no longer worth drawing at any size
+#define LODGEN_MAX_ERROR 0.05f
+
+// collapses below this move the surface by float rounding only, level 0 takes all of them
+#define LODGEN_LOSSLESS_ERROR 1e-6f
+
+static int generate(const char* out, unsigned int subdivisions, float radius) {
+  unsigned int vertexCount = CUBE_ROUNDED_VERTEX_COUNT(subdivisions);
+  unsigned int indexCount = CUBE_ROUNDED_INDEX_COUNT(subdivisions);
+  float* vertices = malloc((size_t) vertexCount * CUBE_VERTEX_STRIDE * sizeof(float));
+  unsigned int* source = malloc(indexCount * sizeof(unsigned int));
+  cubeBuildRounded(subdivisions, radius, vertices, source);
+
+  FILE* file = fopen(out, "wb");
+  if(!file) {
+    printf("ERROR::LODGEN::FILE_NOT_WRITTEN: %s\n", out);
+    free(vertices);
+    free(source);
+    return -1;
+  }
+
+  LodFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = LOD_MAGIC;
+  header.version = LOD_VERSION;
+  header.stride = CUBE_VERTEX_STRIDE;
+  for(unsigned int v = 0; v < vertexCount; v++) {
+    float* p = vertices + (size_t) v * CUBE_VERTEX_STRIDE;
+    float distance = sqrtf(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+    header.radius = fmaxf(header.radius, distance);
+  }
+  fwrite(&header, sizeof(header), 1, file);
+
+  // every level starts again from the source so errors do not compound through the chain.
+  // level 0 is the coarsest lossless mesh, the flat faces need far fewer triangles than the
+  // grid has, and a further lossless level would never be drawn
+  unsigned int* indices = malloc(indexCount * sizeof(unsigned int));
+  float* compacted = malloc((size_t) vertexCount * CUBE_VERTEX_STRIDE * sizeof(float));
+  unsigned int previousCount = 0;
+  unsigned int baseTriangles = 0;
+
+  for(unsigned int level = 0; level < LOD_MAX_LEVELS; level++) {
+    memcpy(indices, source, indexCount * sizeof(unsigned int));
+    unsigned int target = (unsigned int) (baseTriangles * levelRatios[level]) * 3;
+    float error = 0.0f;
+    unsigned int count = simplifyMesh(vertices, CUBE_VERTEX_STRIDE, vertexCount, indices, indexCount, target,
+        level == 0 ? LODGEN_LOSSLESS_ERROR : LODGEN_MAX_ERROR, &error);
+
+    // the simplifier ran out of collapses, a further level would be identical or no coarser
+    if(level > 0 && (count >= previousCount || error <= LODGEN_LOSSLESS_ERROR)) {
+      break;
+    }
+    if(level == 0) {
+      baseTriangles = count / 3;
+      error = 0.0f;
+    }
+    previousCount = count;
+
+    unsigned int used = simplifyCompact(vertices, CUBE_VERTEX_STRIDE, vertexCount, indices, count, compacted);
+
+    LodFileLevel* l = &header.levels[header.levelCount++];
+    l->vertexCount = used;
+    l->indexCount = count;
+    l->error = error;
+    l->vertexOffset = (uint64_t) ftell(file);
+    fwrite(compacted, sizeof(float) * CUBE_VERTEX_STRIDE, used, file);
+    l->indexOffset = (uint64_t) ftell(file);
+    fwrite(indices, sizeof(unsigned int), count, file);
+
+    printf("level %u: %6u triangles, %6u vertices, error %.5f\n", level, count / 3, used, error);
+  }
+
+  fseek(file, 0, SEEK_SET);
+  fwrite(&header, sizeof(header), 1, file);
+  fclose(file);
+
+  free(vertices);
+  free(source);
+  free(indices);
+  free(compacted);
+  return 0;
+}
+
+// objects on a grid, the camera flies low over them and back, level switches count as pops
+static int bench(const char* path, unsigned int objects, int frames, float hysteresis) {
+  LodFile f;
+  if(lodFileRead(&f, path) != 0) {
+    return -1;
+  }
+
+  Lod lod, noHysteresis;
+  lodInit(&lod, &f, hysteresis);
+  lodInit(&noHysteresis, &f, 0.0f);
+
+  unsigned int grid = (unsigned int) ceilf(sqrtf((float) objects));
+  unsigned int* levels = calloc(objects, sizeof(unsigned int));
+  unsigned int* levelsNoHysteresis = calloc(objects, sizeof(unsigned int));
+
+  const float fov = 45.0f;
+  const float viewportHeight = 600.0f;
+  const float spacing = 3.0f;
+
+  unsigned long long fullTriangles = 0, lodTriangles = 0, switches = 0, switchesNoHysteresis = 0;
+  unsigned long long perLevel[LOD_MAX_LEVELS] = {0};
+
+  for(int frame = 0; frame < frames; frame++) {
+    float t = (float) frame / (float) frames;
+    float sweep = 0.5f - 0.5f * cosf(t * 2.0f * (float) M_PI);
+    vec3 eye = {grid * spacing * 0.5f, 2.0f + 3.0f * sinf(t * 17.0f), 5.0f - sweep * grid * spacing};
+
+    for(unsigned int i = 0; i < objects; i++) {
+      vec3 position = {(i % grid) * spacing, 0.0f, -(float) (i / grid) * spacing};
+      float size = lodProjectedSize(lod.radius, glm_vec3_distance(eye, position), fov, viewportHeight);
+
+      unsigned int level = lodSelect(&lod, levels[i], size);
+      switches += frame > 0 && level != levels[i];
+      levels[i] = level;
+
+      unsigned int levelNoHysteresis = lodSelect(&noHysteresis, levelsNoHysteresis[i], size);
+      switchesNoHysteresis += frame > 0 && levelNoHysteresis != levelsNoHysteresis[i];
+      levelsNoHysteresis[i] = levelNoHysteresis;
+
+      fullTriangles += lod.triangles[0];
+      lodTriangles += lod.triangles[level];
+      perLevel[level]++;
+    }
+  }
+
+  printf("%u objects, %d frames, %u levels, hysteresis %.0f%%\n", objects, frames, lod.levelCount, hysteresis * 100.0f);
+  printf("triangles:    %llu per frame without LOD, %llu with LOD (%.1f%%)\n",
+      fullTriangles / frames, lodTriangles / frames, 100.0 * lodTriangles / fullTriangles);
+  for(unsigned int i = 0; i < lod.levelCount; i++) {
+    printf("level %u:      %6u triangles, drawn up to %8.1f px, %5.1f%% of draws\n",
+        i, lod.triangles[i], lod.maxSize[i], 100.0 * perLevel[i] / ((double) objects * frames));
+  }
+  printf("switches:     %.2f per frame, %.2f without hysteresis\n", (double) switches / frames, (double) switchesNoHysteresis / frames);
+
+  free(levels);
+  free(levelsNoHysteresis);
+  lodFileFree(&f);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  int benchmark = 0;
+  unsigned int subdivisions = 24;
+  float radius = 0.1f;
+  unsigned int objects = 4096;
+  int frames = 600;
+  float hysteresis = 0.1f;
+  const char* path = NULL;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--bench")) {
+      benchmark = 1;
+    }
+    else if(!strcmp(argv[i], "--subdivisions") && i + 1 < argc) {
+      subdivisions = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--radius") && i + 1 < argc) {
+      radius = atof(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--objects") && i + 1 < argc) {
+      objects = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--frames") && i + 1 < argc) {
+      frames = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--hysteresis") && i + 1 < argc) {
+      hysteresis = atof(argv[++i]);
+    }
+    else if(!path && argv[i][0] != '-') {
+      path = argv[i];
+    }
+    else {
+      path = NULL;
+      break;
+    }
+  }
+
+  if(!path || subdivisions == 0 || frames <= 0) {
+    printf("usage: lodgen [--subdivisions N] [--radius R] out.lod\n");
+    printf("       lodgen --bench [--objects N] [--frames N] [--hysteresis H] file.lod\n");
+    return 1;
+  }
+
+  return (benchmark ? bench(path, objects, frames, hysteresis) : generate(path, subdivisions, radius)) == 0 ? 0 : 1;
+}
@@ -0,0 +1,510 @@
+// re-executes a GL trace written by src/capture.c and reports where the time went
+//
+// usage:
+//   replay [--mock] [--loops N] trace.gltrace
+//
+// --mock replays against no-op stubs (src/glmock.c) to measure decode and dispatch overhead
+// without a driver, otherwise an invisible 800x600 window provides the context.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "capture.h"
+#include "glext.h"
+#include "glmock.h"
+#include "timing.h"
+
+typedef struct NameMap {
+  GLuint* names; // indexed by the name the captured driver returned
+  unsigned int capacity;
+} NameMap;
+
+typedef struct LocationMapping {
+  uint32_t program;
+  int32_t captured;
+  GLint replayed;
+} LocationMapping;
+
+typedef struct SyncMapping {
+  uint64_t captured;
+  GLsync replayed;
+} SyncMapping;
+
+// a buffer mapped by the trace, the recorded contents are copied in when it is unmapped
+typedef struct BufferMapping {
+  uint32_t buffer; // captured name
+  void* pointer; // NULL when the slot is free
+} BufferMapping;
+
+typedef struct Replay {
+  NameMap vertexArrays;
+  NameMap buffers;
+  NameMap programs; // shaders and programs share a namespace
+  NameMap textures;
+  NameMap framebuffers;
+  NameMap renderbuffers;
+  LocationMapping* locations;
+  unsigned int locationCount;
+  uint32_t currentProgram;
+  SyncMapping* syncs;
+  unsigned int syncCount;
+  BufferMapping mappings[CAPTURE_MAX_MAPPINGS];
+
+  unsigned long long skipped; // records of calls this driver does not have
+  unsigned long long callCounts[CAPTURE_CALL_COUNT];
+  double callTimes[CAPTURE_CALL_COUNT]; // seconds
+} Replay;
+
+static void nameMapSet(NameMap* m, uint32_t captured, GLuint replayed) {
+  if(captured >= m->capacity) {
+    unsigned int capacity = m->capacity ? m->capacity : 64;
+    while(capacity <= captured) {
+      capacity *= 2;
+    }
+    m->names = realloc(m->names, capacity * sizeof(GLuint));
+    memset(m->names + m->capacity, 0, (capacity - m->capacity) * sizeof(GLuint));
+    m->capacity = capacity;
+  }
+  m->names[captured] = replayed;
+}
+
+static GLuint nameMapGet(NameMap* m, uint32_t captured) {
+  return captured < m->capacity ? m->names[captured] : 0;
+}
+
+// locations that were never queried are explicit layout locations, the same on every driver
+static GLint locationGet(Replay* r, int32_t captured) {
+  if(captured < 0) {
+    return captured;
+  }
+
+  for(unsigned int i = 0; i < r->locationCount; i++) {
+    if(r->locations[i].program == r->currentProgram && r->locations[i].captured == captured) {
+      return r->locations[i].replayed;
+    }
+  }
+  return captured;
+}
+
+static void locationSet(Replay* r, uint32_t program, int32_t captured, GLint replayed) {
+  for(unsigned int i = 0; i < r->locationCount; i++) {
+    if(r->locations[i].program == program && r->locations[i].captured == captured) {
+      r->locations[i].replayed = replayed;
+      return;
+    }
+  }
+
+  r->locations = realloc(r->locations, (r->locationCount + 1) * sizeof(LocationMapping));
+  r->locations[r->locationCount].program = program;
+  r->locations[r->locationCount].captured = captured;
+  r->locations[r->locationCount].replayed = replayed;
+  r->locationCount++;
+}
+
+static uint64_t syncCaptured(const uint32_t* words) {
+  return (uint64_t) words[0] | ((uint64_t) words[1] << 32);
+}
+
+static void syncSet(Replay* r, uint64_t captured, GLsync replayed) {
+  for(unsigned int i = 0; i < r->syncCount; i++) {
+    if(r->syncs[i].captured == captured) {
+      r->syncs[i].replayed = replayed;
+      return;
+    }
+  }
+
+  r->syncs = realloc(r->syncs, (r->syncCount + 1) * sizeof(SyncMapping));
+  r->syncs[r->syncCount].captured = captured;
+  r->syncs[r->syncCount].replayed = replayed;
+  r->syncCount++;
+}
+
+// deleted syncs stay in the table, the driver may hand the same pointer out again and syncSet overwrites it
+static GLsync syncGet(Replay* r, uint64_t captured) {
+  for(unsigned int i = 0; i < r->syncCount; i++) {
+    if(r->syncs[i].captured == captured) {
+      return r->syncs[i].replayed;
+    }
+  }
+  return NULL;
+}
+
+static void replayMap(Replay* r, const uint32_t* a) {
+  void* pointer = glMapBufferRange(a[0], a[1], a[2], a[3]);
+  for(int i = 0; pointer && i < CAPTURE_MAX_MAPPINGS; i++) {
+    if(!r->mappings[i].pointer) {
+      r->mappings[i].buffer = a[4];
+      r->mappings[i].pointer = pointer;
+      return;
+    }
+  }
+}
+
+static void replayUnmap(Replay* r, const uint32_t* a, const unsigned char* blob, uint32_t blobSize) {
+  for(int i = 0; i < CAPTURE_MAX_MAPPINGS; i++) {
+    BufferMapping* m = &r->mappings[i];
+    if(m->pointer && m->buffer == a[1]) {
+      memcpy(m->pointer, blob, blobSize);
+      m->pointer = NULL;
+      break;
+    }
+  }
+  glUnmapBuffer(a[0]);
+}
+
+static float bitsFloat(uint32_t bits) {
+  float f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+// generated names come back in the blob, the replay driver's names are mapped onto them
+static void replayGen(NameMap* m, void (APIENTRYP gen)(GLsizei, GLuint*), const uint32_t* args, const unsigned char* blob) {
+  GLsizei n = args[0];
+  GLuint* names = malloc(n * sizeof(GLuint));
+  gen(n, names);
+  for(GLsizei i = 0; i < n; i++) {
+    uint32_t captured;
+    memcpy(&captured, blob + i * sizeof(uint32_t), sizeof(captured));
+    nameMapSet(m, captured, names[i]);
+  }
+  free(names);
+}
+
+static void replayDelete(NameMap* m, void (APIENTRYP del)(GLsizei, const GLuint*), const uint32_t* args, const unsigned char* blob) {
+  GLsizei n = args[0];
+  GLuint* names = malloc(n * sizeof(GLuint));
+  for(GLsizei i = 0; i < n; i++) {
+    uint32_t captured;
+    memcpy(&captured, blob + i * sizeof(uint32_t), sizeof(captured));
+    names[i] = nameMapGet(m, captured);
+  }
+  del(n, names);
+  free(names);
+}
+
+// the newer entry points are NULL on drivers without them, their records are skipped
+static int replayAvailable(uint16_t call) {
+  switch(call) {
+#define REPLAY_AVAILABLE(name) case CAPTURE_CALL_##name: return glext_##name != NULL;
+    CAPTURE_EXT_CALLS(REPLAY_AVAILABLE)
+#undef REPLAY_AVAILABLE
+  }
+  return 1;
+}
+
+// a bound unpack buffer was read at the recorded offset, otherwise the pixels are the blob or were NULL
+static const void* replayPixels(const uint32_t* a, const unsigned char* blob, uint32_t blobSize) {
+  if(a[8]) {
+    return (const void*) (uintptr_t) a[9];
+  }
+  return blobSize ? (const void*) blob : NULL;
+}
+
+static void replayCall(Replay* r, uint16_t call, const uint32_t* a, const unsigned char* blob, uint32_t blobSize) {
+  switch(call) {
+    case CAPTURE_CALL_glGenVertexArrays: replayGen(&r->vertexArrays, glad_glGenVertexArrays, a, blob); break;
+    case CAPTURE_CALL_glBindVertexArray: glBindVertexArray(nameMapGet(&r->vertexArrays, a[0])); break;
+    case CAPTURE_CALL_glDeleteVertexArrays: replayDelete(&r->vertexArrays, glad_glDeleteVertexArrays, a, blob); break;
+    case CAPTURE_CALL_glGenBuffers: replayGen(&r->buffers, glad_glGenBuffers, a, blob); break;
+    case CAPTURE_CALL_glBindBuffer: glBindBuffer(a[0], nameMapGet(&r->buffers, a[1])); break;
+    // an empty blob was a NULL pointer at capture, storage allocated without contents
+    case CAPTURE_CALL_glBufferData: glBufferData(a[0], a[1], blobSize ? (const void*) blob : NULL, a[2]); break;
+    case CAPTURE_CALL_glBufferSubData: glBufferSubData(a[0], a[1], a[2], blobSize ? (const void*) blob : NULL); break;
+    case CAPTURE_CALL_glDeleteBuffers: replayDelete(&r->buffers, glad_glDeleteBuffers, a, blob); break;
+    case CAPTURE_CALL_glVertexAttribPointer: glVertexAttribPointer(a[0], a[1], a[2], (GLboolean) a[3], a[4], (const void*) (uintptr_t) a[5]); break;
+    case CAPTURE_CALL_glEnableVertexAttribArray: glEnableVertexAttribArray(a[0]); break;
+    case CAPTURE_CALL_glCreateShader: nameMapSet(&r->programs, a[1], glCreateShader(a[0])); break;
+    case CAPTURE_CALL_glShaderSource: {
+      GLsizei count = a[1];
+      const GLchar* strings[CAPTURE_MAX_SHADER_STRINGS];
+      GLint lengths[CAPTURE_MAX_SHADER_STRINGS];
+      const unsigned char* p = blob;
+      for(GLsizei i = 0; i < count; i++) {
+        strings[i] = (const GLchar*) p;
+        lengths[i] = a[2 + i];
+        p += a[2 + i];
+      }
+      glShaderSource(nameMapGet(&r->programs, a[0]), count, strings, lengths);
+      break;
+    }
+    case CAPTURE_CALL_glCompileShader: glCompileShader(nameMapGet(&r->programs, a[0])); break;
+    case CAPTURE_CALL_glDeleteShader: glDeleteShader(nameMapGet(&r->programs, a[0])); break;
+    case CAPTURE_CALL_glCreateProgram: nameMapSet(&r->programs, a[0], glCreateProgram()); break;
+    case CAPTURE_CALL_glAttachShader: glAttachShader(nameMapGet(&r->programs, a[0]), nameMapGet(&r->programs, a[1])); break;
+    case CAPTURE_CALL_glLinkProgram: glLinkProgram(nameMapGet(&r->programs, a[0])); break;
+    case CAPTURE_CALL_glUseProgram:
+      r->currentProgram = a[0];
+      glUseProgram(nameMapGet(&r->programs, a[0]));
+      break;
+    case CAPTURE_CALL_glDeleteProgram: glDeleteProgram(nameMapGet(&r->programs, a[0])); break;
+    case CAPTURE_CALL_glGetUniformLocation:
+      locationSet(r, a[0], (int32_t) a[1], glGetUniformLocation(nameMapGet(&r->programs, a[0]), (const GLchar*) blob));
+      break;
+    case CAPTURE_CALL_glUniform1i: glUniform1i(locationGet(r, (int32_t) a[0]), (GLint) a[1]); break;
+    case CAPTURE_CALL_glUniform1f: glUniform1f(locationGet(r, (int32_t) a[0]), bitsFloat(a[1])); break;
+    case CAPTURE_CALL_glUniformMatrix4fv: {
+      // the blob is only 4-byte aligned inside the trace, copy before handing it to GL
+      GLfloat values[16 * 64];
+      GLsizei count = a[1] < 64 ? a[1] : 64;
+      memcpy(values, blob, count * 16 * sizeof(GLfloat));
+      glUniformMatrix4fv(locationGet(r, (int32_t) a[0]), count, (GLboolean) a[2], values);
+      break;
+    }
+    case CAPTURE_CALL_glGenTextures: replayGen(&r->textures, glad_glGenTextures, a, blob); break;
+    case CAPTURE_CALL_glActiveTexture: glActiveTexture(a[0]); break;
+    case CAPTURE_CALL_glBindTexture: glBindTexture(a[0], nameMapGet(&r->textures, a[1])); break;
+    case CAPTURE_CALL_glTexParameteri: glTexParameteri(a[0], a[1], (GLint) a[2]); break;
+    case CAPTURE_CALL_glTexImage2D:
+      glTexImage2D(a[0], (GLint) a[1], (GLint) a[2], a[3], a[4], (GLint) a[5], a[6], a[7], replayPixels(a, blob, blobSize));
+      break;
+    case CAPTURE_CALL_glGenerateMipmap: glGenerateMipmap(a[0]); break;
+    case CAPTURE_CALL_glDeleteTextures: replayDelete(&r->textures, glad_glDeleteTextures, a, blob); break;
+    case CAPTURE_CALL_glEnable: glEnable(a[0]); break;
+    case CAPTURE_CALL_glDisable: glDisable(a[0]); break;
+    case CAPTURE_CALL_glClearColor: glClearColor(bitsFloat(a[0]), bitsFloat(a[1]), bitsFloat(a[2]), bitsFloat(a[3])); break;
+    case CAPTURE_CALL_glClear: glClear(a[0]); break;
+    case CAPTURE_CALL_glViewport: glViewport((GLint) a[0], (GLint) a[1], a[2], a[3]); break;
+    case CAPTURE_CALL_glDrawArrays: glDrawArrays(a[0], (GLint) a[1], a[2]); break;
+    case CAPTURE_CALL_glDrawElements: glDrawElements(a[0], a[1], a[2], (const void*) (uintptr_t) a[3]); break;
+    case CAPTURE_CALL_glPixelStorei: glPixelStorei(a[0], (GLint) a[1]); break;
+    case CAPTURE_CALL_glTexParameteriv: {
+      GLint params[4] = {0};
+      memcpy(params, blob, blobSize < sizeof(params) ? blobSize : sizeof(params));
+      glTexParameteriv(a[0], a[1], params);
+      break;
+    }
+    case CAPTURE_CALL_glTexSubImage2D:
+      glTexSubImage2D(a[0], (GLint) a[1], (GLint) a[2], (GLint) a[3], a[4], a[5], a[6], a[7], replayPixels(a, blob, blobSize));
+      break;
+    case CAPTURE_CALL_glVertexAttribIPointer: glVertexAttribIPointer(a[0], a[1], a[2], a[3], (const void*) (uintptr_t) a[4]); break;
+    case CAPTURE_CALL_glVertexAttribDivisor: glVertexAttribDivisor(a[0], a[1]); break;
+    case CAPTURE_CALL_glDrawArraysInstanced: glDrawArraysInstanced(a[0], (GLint) a[1], a[2], a[3]); break;
+    case CAPTURE_CALL_glDrawElementsBaseVertex: glDrawElementsBaseVertex(a[0], a[1], a[2], (const void*) (uintptr_t) a[3], (GLint) a[4]); break;
+    case CAPTURE_CALL_glDrawElementsInstancedBaseVertex:
+      glDrawElementsInstancedBaseVertex(a[0], a[1], a[2], (const void*) (uintptr_t) a[3], a[4], (GLint) a[5]);
+      break;
+    case CAPTURE_CALL_glBindBufferBase: glBindBufferBase(a[0], a[1], nameMapGet(&r->buffers, a[2])); break;
+    case CAPTURE_CALL_glCopyBufferSubData: glCopyBufferSubData(a[0], a[1], a[2], a[3], a[4]); break;
+    case CAPTURE_CALL_glMapBufferRange: replayMap(r, a); break;
+    case CAPTURE_CALL_glUnmapBuffer: replayUnmap(r, a, blob, blobSize); break;
+    case CAPTURE_CALL_glUniform2f: glUniform2f(locationGet(r, (int32_t) a[0]), bitsFloat(a[1]), bitsFloat(a[2])); break;
+    case CAPTURE_CALL_glUniform4fv: {
+      GLfloat values[4 * 64];
+      GLsizei count = a[1] < 64 ? a[1] : 64;
+      memcpy(values, blob, count * 4 * sizeof(GLfloat));
+      glUniform4fv(locationGet(r, (int32_t) a[0]), count, values);
+      break;
+    }
+    case CAPTURE_CALL_glUniform1ui: glUniform1ui(locationGet(r, (int32_t) a[0]), a[1]); break;
+    case CAPTURE_CALL_glUniform2ui: glUniform2ui(locationGet(r, (int32_t) a[0]), a[1], a[2]); break;
+    case CAPTURE_CALL_glUniform3ui: glUniform3ui(locationGet(r, (int32_t) a[0]), a[1], a[2], a[3]); break;
+    case CAPTURE_CALL_glColorMask: glColorMask((GLboolean) a[0], (GLboolean) a[1], (GLboolean) a[2], (GLboolean) a[3]); break;
+    case CAPTURE_CALL_glDepthFunc: glDepthFunc(a[0]); break;
+    case CAPTURE_CALL_glDepthMask: glDepthMask((GLboolean) a[0]); break;
+    case CAPTURE_CALL_glBlendFunc: glBlendFunc(a[0], a[1]); break;
+    case CAPTURE_CALL_glFenceSync: syncSet(r, syncCaptured(a + 2), glFenceSync(a[0], a[1])); break;
+    case CAPTURE_CALL_glClientWaitSync:
+      glClientWaitSync(syncGet(r, syncCaptured(a)), a[2], (GLuint64) a[3] | ((GLuint64) a[4] << 32));
+      break;
+    case CAPTURE_CALL_glDeleteSync: glDeleteSync(syncGet(r, syncCaptured(a))); break;
+    case CAPTURE_CALL_glGenFramebuffers: replayGen(&r->framebuffers, glad_glGenFramebuffers, a, blob); break;
+    case CAPTURE_CALL_glBindFramebuffer: glBindFramebuffer(a[0], nameMapGet(&r->framebuffers, a[1])); break;
+    case CAPTURE_CALL_glDeleteFramebuffers: replayDelete(&r->framebuffers, glad_glDeleteFramebuffers, a, blob); break;
+    case CAPTURE_CALL_glGenRenderbuffers: replayGen(&r->renderbuffers, glad_glGenRenderbuffers, a, blob); break;
+    case CAPTURE_CALL_glBindRenderbuffer: glBindRenderbuffer(a[0], nameMapGet(&r->renderbuffers, a[1])); break;
+    case CAPTURE_CALL_glRenderbufferStorage: glRenderbufferStorage(a[0], a[1], a[2], a[3]); break;
+    case CAPTURE_CALL_glFramebufferRenderbuffer: glFramebufferRenderbuffer(a[0], a[1], a[2], nameMapGet(&r->renderbuffers, a[3])); break;
+    case CAPTURE_CALL_glDeleteRenderbuffers: replayDelete(&r->renderbuffers, glad_glDeleteRenderbuffers, a, blob); break;
+    case CAPTURE_CALL_glMultiDrawElementsIndirect: glMultiDrawElementsIndirect(a[0], a[1], (const void*) (uintptr_t) a[2], a[3], a[4]); break;
+    case CAPTURE_CALL_glMultiDrawArraysIndirect: glMultiDrawArraysIndirect(a[0], (const void*) (uintptr_t) a[1], a[2], a[3]); break;
+    case CAPTURE_CALL_glMultiDrawElementsIndirectCountARB:
+      glMultiDrawElementsIndirectCountARB(a[0], a[1], (const void*) (uintptr_t) a[2], a[3], a[4], a[5]);
+      break;
+    case CAPTURE_CALL_glTexStorage2D: glTexStorage2D(a[0], a[1], a[2], a[3], a[4]); break;
+    case CAPTURE_CALL_glDispatchCompute: glDispatchCompute(a[0], a[1], a[2]); break;
+    case CAPTURE_CALL_glMemoryBarrier: glMemoryBarrier(a[0]); break;
+    case CAPTURE_CALL_glClearBufferData: glClearBufferData(a[0], a[1], a[2], a[3], blobSize ? (const void*) blob : NULL); break;
+  }
+}
+
+static unsigned char* readTrace(const char* path, size_t* size) {
+  FILE* fp = fopen(path, "rb");
+  if(!fp) {
+    printf("ERROR::REPLAY::FILE_NOT_SUCCESSFULLY_READ: %s\n", path);
+    return NULL;
+  }
+
+  fseek(fp, 0L, SEEK_END);
+  long length = ftell(fp);
+  rewind(fp);
+
+  unsigned char* buffer = malloc(length);
+  if(!buffer || fread(buffer, length, 1, fp) != 1) {
+    printf("ERROR::REPLAY::FILE_NOT_SUCCESSFULLY_READ: %s\n", path);
+    free(buffer);
+    fclose(fp);
+    return NULL;
+  }
+
+  fclose(fp);
+  *size = length;
+  return buffer;
+}
+
+static void report(Replay* r, Timing* frameTimes) {
+  int order[CAPTURE_CALL_COUNT];
+  double total = 0.0;
+  for(int i = 0; i < CAPTURE_CALL_COUNT; i++) {
+    order[i] = i;
+    total += r->callTimes[i];
+  }
+
+  // insertion sort by descending total time, the list is tiny
+  for(int i = 1; i < CAPTURE_CALL_COUNT; i++) {
+    for(int j = i; j > 0 && r->callTimes[order[j]] > r->callTimes[order[j - 1]]; j--) {
+      int tmp = order[j];
+      order[j] = order[j - 1];
+      order[j - 1] = tmp;
+    }
+  }
+
+  printf("%-28s %10s %12s %10s %7s\n", "call", "count", "total ms", "avg us", "share");
+  for(int i = 0; i < CAPTURE_CALL_COUNT; i++) {
+    int call = order[i];
+    if(!r->callCounts[call] || call == CAPTURE_CALL_FRAME) {
+      continue;
+    }
+    printf("%-28s %10llu %12.3f %10.3f %6.1f%%\n", captureCallName(call), r->callCounts[call],
+        r->callTimes[call] * 1000.0, r->callTimes[call] * 1e6 / r->callCounts[call],
+        total > 0.0 ? 100.0 * r->callTimes[call] / total : 0.0);
+  }
+
+  if(r->skipped) {
+    printf("skipped %llu calls this driver does not support\n", r->skipped);
+  }
+  if(frameTimes->count) {
+    timingReport(frameTimes, "replayed frame time");
+  }
+  printf("note: timings are CPU submission cost, GPU execution overlaps asynchronously\n");
+}
+
+int main(int argc, char** argv) {
+  int mock = 0;
+  int loops = 1;
+  const char* path = NULL;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--mock")) {
+      mock = 1;
+    }
+    else if(!strcmp(argv[i], "--loops") && i + 1 < argc) {
+      loops = atoi(argv[++i]);
+    }
+    else {
+      path = argv[i];
+    }
+  }
+
+  if(!path) {
+    printf("usage: replay [--mock] [--loops N] trace.gltrace\n");
+    return 1;
+  }
+
+  size_t size;
+  unsigned char* trace = readTrace(path, &size);
+  if(!trace) {
+    return 1;
+  }
+
+  const CaptureHeader* header = (const CaptureHeader*) trace;
+  if(size < sizeof(CaptureHeader) || header->magic != CAPTURE_MAGIC || header->version != CAPTURE_VERSION) {
+    printf("ERROR::REPLAY::INVALID_TRACE: %s\n", path);
+    return 1;
+  }
+
+  GLFWwindow* window = NULL;
+  if(mock) {
+    glmockInstall();
+  }
+  else {
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    window = glfwCreateWindow(800, 600, "replay", NULL, NULL);
+    if(window == NULL) {
+      printf("Failed to create GLFW window\n");
+      glfwTerminate();
+      return -1;
+    }
+    glfwMakeContextCurrent(window);
+
+    if(!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress)) {
+      printf("Failed to initialize GLAD\n");
+      return -1;
+    }
+    glextLoad((GLADloadproc) glfwGetProcAddress);
+  }
+
+  Replay r;
+  memset(&r, 0, sizeof(r));
+  Timing frameTimes;
+  timingInit(&frameTimes);
+
+  for(int loop = 0; loop < loops; loop++) {
+    const unsigned char* p = trace + sizeof(CaptureHeader);
+    const unsigned char* end = trace + size;
+    double frameStart = timingNow();
+
+    while(p + sizeof(CaptureRecord) <= end) {
+      CaptureRecord record;
+      memcpy(&record, p, sizeof(record));
+      const uint32_t* args = (const uint32_t*) (p + sizeof(record));
+      const unsigned char* blob = p + sizeof(record) + record.argCount * sizeof(uint32_t);
+      p = blob + record.blobSize;
+
+      if(p > end || record.call >= CAPTURE_CALL_COUNT) {
+        printf("ERROR::REPLAY::TRUNCATED_TRACE\n");
+        break;
+      }
+
+      if(record.call == CAPTURE_CALL_FRAME) {
+        if(window) {
+          glfwSwapBuffers(window);
+          glfwPollEvents();
+        }
+        double now = timingNow();
+        timingAdd(&frameTimes, (now - frameStart) * 1000.0);
+        frameStart = now;
+        continue;
+      }
+
+      if(!replayAvailable(record.call)) {
+        r.skipped++;
+        continue;
+      }
+
+      double start = timingNow();
+      replayCall(&r, record.call, args, blob, record.blobSize);
+      r.callTimes[record.call] += timingNow() - start;
+      r.callCounts[record.call]++;
+    }
+  }
+
+  report(&r, &frameTimes);
+
+  timingFree(&frameTimes);
+  free(trace);
+  if(window) {
+    glfwTerminate();
+  }
+  return 0;
+}
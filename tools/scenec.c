@@ -0,0 +1,414 @@
+// compiles the text scene format into the binary one src/scene.h maps, or benchmarks loading
+// a generated scene of many objects both ways
+//
+// text form, one statement per line, # starts a comment:
+//   mesh <name> <min x y z> <max x y z>       local bounding box
+//   material <name>
+//   object <mesh> <material> <x y z> [rotate <axis x y z> <degrees>] [scale <x y z>]
+//
+// usage:
+//   scenec in.scene out.scn
+//   scenec --bench [--objects N] [--runs N] file.scn
+
+#include "scene.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCENEC_MAX_MESHES 256
+#define SCENEC_MAX_MATERIALS 256
+
+typedef struct SceneBuilder {
+  char meshNames[SCENEC_MAX_MESHES][SCENE_NAME_LENGTH];
+  vec3 meshMin[SCENEC_MAX_MESHES];
+  vec3 meshMax[SCENEC_MAX_MESHES];
+  unsigned int meshCount;
+  char materialNames[SCENEC_MAX_MATERIALS][SCENE_NAME_LENGTH];
+  unsigned int materialCount;
+
+  vec3* positions;
+  versor* rotations;
+  vec3* scales;
+  uint32_t* meshes;
+  uint32_t* materials;
+  vec3* boundsMin;
+  vec3* boundsMax;
+  unsigned int count;
+  unsigned int capacity;
+} SceneBuilder;
+
+static void builderInit(SceneBuilder* b) {
+  memset(b, 0, sizeof(*b));
+}
+
+static void builderFree(SceneBuilder* b) {
+  free(b->positions);
+  free(b->rotations);
+  free(b->scales);
+  free(b->meshes);
+  free(b->materials);
+  free(b->boundsMin);
+  free(b->boundsMax);
+}
+
+static int builderFind(char (*names)[SCENE_NAME_LENGTH], unsigned int count, const char* name) {
+  for(unsigned int i = 0; i < count; i++) {
+    if(!strcmp(names[i], name)) {
+      return (int) i;
+    }
+  }
+  return -1;
+}
+
+static int builderMesh(SceneBuilder* b, const char* name, vec3 min, vec3 max) {
+  if(b->meshCount == SCENEC_MAX_MESHES || strlen(name) >= SCENE_NAME_LENGTH || builderFind(b->meshNames, b->meshCount, name) >= 0) {
+    return -1;
+  }
+  strcpy(b->meshNames[b->meshCount], name);
+  glm_vec3_copy(min, b->meshMin[b->meshCount]);
+  glm_vec3_copy(max, b->meshMax[b->meshCount]);
+  return (int) b->meshCount++;
+}
+
+static int builderMaterial(SceneBuilder* b, const char* name) {
+  if(b->materialCount == SCENEC_MAX_MATERIALS || strlen(name) >= SCENE_NAME_LENGTH || builderFind(b->materialNames, b->materialCount, name) >= 0) {
+    return -1;
+  }
+  strcpy(b->materialNames[b->materialCount], name);
+  return (int) b->materialCount++;
+}
+
+static void builderAdd(SceneBuilder* b, unsigned int mesh, unsigned int material, vec3 position, versor rotation, vec3 scale) {
+  if(b->count == b->capacity) {
+    b->capacity = b->capacity ? b->capacity * 2 : 1024;
+    b->positions = realloc(b->positions, b->capacity * sizeof(vec3));
+    b->rotations = realloc(b->rotations, b->capacity * sizeof(versor));
+    b->scales = realloc(b->scales, b->capacity * sizeof(vec3));
+    b->meshes = realloc(b->meshes, b->capacity * sizeof(uint32_t));
+    b->materials = realloc(b->materials, b->capacity * sizeof(uint32_t));
+    b->boundsMin = realloc(b->boundsMin, b->capacity * sizeof(vec3));
+    b->boundsMax = realloc(b->boundsMax, b->capacity * sizeof(vec3));
+  }
+
+  unsigned int i = b->count++;
+  glm_vec3_copy(position, b->positions[i]);
+  glm_vec4_copy(rotation, b->rotations[i]);
+  glm_vec3_copy(scale, b->scales[i]);
+  b->meshes[i] = mesh;
+  b->materials[i] = material;
+
+  // the local box's center moves with the transform, its half extents through the absolute rotation
+  mat4 model;
+  glm_translate_make(model, position);
+  glm_quat_rotate(model, rotation, model);
+  glm_scale(model, scale);
+
+  vec3 center, extent;
+  glm_vec3_center(b->meshMin[mesh], b->meshMax[mesh], center);
+  glm_vec3_sub(b->meshMax[mesh], center, extent);
+  vec3 worldCenter;
+  glm_mat4_mulv3(model, center, 1.0f, worldCenter);
+  for(int r = 0; r < 3; r++) {
+    float worldExtent = fabsf(model[0][r]) * extent[0] + fabsf(model[1][r]) * extent[1] + fabsf(model[2][r]) * extent[2];
+    b->boundsMin[i][r] = worldCenter[r] - worldExtent;
+    b->boundsMax[i][r] = worldCenter[r] + worldExtent;
+  }
+}
+
+// reads the whole text into memory with a terminating 0, the parser works line by line in place
+static char* readText(const char* path, size_t* size) {
+  FILE* file = fopen(path, "rb");
+  if(!file) {
+    printf("ERROR::SCENEC::FILE_NOT_FOUND: %s\n", path);
+    return NULL;
+  }
+  fseek(file, 0, SEEK_END);
+  long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  char* text = malloc((size_t) length + 1);
+  *size = fread(text, 1, (size_t) length, file);
+  text[*size] = 0;
+  fclose(file);
+  return text;
+}
+
+static int builderParse(SceneBuilder* b, char* text, const char* path) {
+  unsigned int lineNumber = 0;
+  char* save = NULL;
+  for(char* line = strtok_r(text, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+    lineNumber++;
+    char* comment = strchr(line, '#');
+    if(comment) {
+      *comment = 0;
+    }
+
+    char keyword[16], first[SCENE_NAME_LENGTH], second[SCENE_NAME_LENGTH];
+    int consumed = 0;
+    if(sscanf(line, " %15s%n", keyword, &consumed) != 1) {
+      continue;
+    }
+    char* rest = line + consumed;
+
+    if(!strcmp(keyword, "mesh")) {
+      vec3 min, max;
+      if(sscanf(rest, " %63s %f %f %f %f %f %f", first, &min[0], &min[1], &min[2], &max[0], &max[1], &max[2]) != 7 || builderMesh(b, first, min, max) < 0) {
+        printf("ERROR::SCENEC::BAD_MESH: %s:%u\n", path, lineNumber);
+        return -1;
+      }
+    }
+    else if(!strcmp(keyword, "material")) {
+      if(sscanf(rest, " %63s", first) != 1 || builderMaterial(b, first) < 0) {
+        printf("ERROR::SCENEC::BAD_MATERIAL: %s:%u\n", path, lineNumber);
+        return -1;
+      }
+    }
+    else if(!strcmp(keyword, "object")) {
+      vec3 position;
+      if(sscanf(rest, " %63s %63s %f %f %f%n", first, second, &position[0], &position[1], &position[2], &consumed) != 5) {
+        printf("ERROR::SCENEC::BAD_OBJECT: %s:%u\n", path, lineNumber);
+        return -1;
+      }
+      int mesh = builderFind(b->meshNames, b->meshCount, first);
+      int material = builderFind(b->materialNames, b->materialCount, second);
+      if(mesh < 0 || material < 0) {
+        printf("ERROR::SCENEC::UNKNOWN_REFERENCE: %s:%u %s %s\n", path, lineNumber, first, second);
+        return -1;
+      }
+
+      versor rotation = GLM_QUAT_IDENTITY_INIT;
+      vec3 scale = {1.0f, 1.0f, 1.0f};
+      rest += consumed;
+      while(sscanf(rest, " %15s%n", keyword, &consumed) == 1) {
+        rest += consumed;
+        vec3 axis;
+        float degrees;
+        if(!strcmp(keyword, "rotate") && sscanf(rest, " %f %f %f %f%n", &axis[0], &axis[1], &axis[2], &degrees, &consumed) == 4) {
+          glm_quatv(rotation, glm_rad(degrees), axis);
+        }
+        else if(!strcmp(keyword, "scale") && sscanf(rest, " %f %f %f%n", &scale[0], &scale[1], &scale[2], &consumed) == 3) {
+        }
+        else {
+          printf("ERROR::SCENEC::BAD_OBJECT: %s:%u %s\n", path, lineNumber, keyword);
+          return -1;
+        }
+        rest += consumed;
+      }
+      builderAdd(b, (unsigned int) mesh, (unsigned int) material, position, rotation, scale);
+    }
+    else {
+      printf("ERROR::SCENEC::UNKNOWN_STATEMENT: %s:%u %s\n", path, lineNumber, keyword);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+// appends an array at the next aligned offset and records where it went
+static void writeArray(FILE* file, uint64_t* offset, const void* data, size_t size) {
+  static const unsigned char zeros[SCENE_ALIGNMENT] = {0};
+  long position = ftell(file);
+  long padding = (SCENE_ALIGNMENT - position % SCENE_ALIGNMENT) % SCENE_ALIGNMENT;
+  fwrite(zeros, 1, (size_t) padding, file);
+  *offset = (uint64_t) (position + padding);
+  fwrite(data, 1, size, file);
+}
+
+static int builderWrite(SceneBuilder* b, const char* path) {
+  FILE* file = fopen(path, "wb");
+  if(!file) {
+    printf("ERROR::SCENEC::FILE_NOT_WRITTEN: %s\n", path);
+    return -1;
+  }
+
+  SceneFileHeader header;
+  memset(&header, 0, sizeof(header));
+  header.magic = SCENE_MAGIC;
+  header.version = SCENE_VERSION;
+  header.objectCount = b->count;
+  header.meshCount = b->meshCount;
+  header.materialCount = b->materialCount;
+  fwrite(&header, sizeof(header), 1, file);
+
+  writeArray(file, &header.positionOffset, b->positions, b->count * sizeof(vec3));
+  writeArray(file, &header.rotationOffset, b->rotations, b->count * sizeof(versor));
+  writeArray(file, &header.scaleOffset, b->scales, b->count * sizeof(vec3));
+  writeArray(file, &header.meshOffset, b->meshes, b->count * sizeof(uint32_t));
+  writeArray(file, &header.materialOffset, b->materials, b->count * sizeof(uint32_t));
+  writeArray(file, &header.boundsMinOffset, b->boundsMin, b->count * sizeof(vec3));
+  writeArray(file, &header.boundsMaxOffset, b->boundsMax, b->count * sizeof(vec3));
+  writeArray(file, &header.meshNameOffset, b->meshNames, b->meshCount * SCENE_NAME_LENGTH);
+  writeArray(file, &header.materialNameOffset, b->materialNames, b->materialCount * SCENE_NAME_LENGTH);
+
+  fseek(file, 0, SEEK_SET);
+  fwrite(&header, sizeof(header), 1, file);
+  int failed = ferror(file);
+  fclose(file);
+  if(failed) {
+    printf("ERROR::SCENEC::FILE_NOT_WRITTEN: %s\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+static int compile(const char* in, const char* out) {
+  size_t size;
+  char* text = readText(in, &size);
+  if(!text) {
+    return -1;
+  }
+
+  SceneBuilder b;
+  builderInit(&b);
+  int result = builderParse(&b, text, in);
+  if(result == 0) {
+    result = builderWrite(&b, out);
+  }
+  if(result == 0) {
+    printf("%s: %u objects, %u meshes, %u materials\n", out, b.count, b.meshCount, b.materialCount);
+  }
+  free(text);
+  builderFree(&b);
+  return result;
+}
+
+// objects scattered over a square field with random rotations and scales, written both ways
+static int generate(const char* binaryPath, const char* textPath, unsigned int objects) {
+  SceneBuilder b;
+  builderInit(&b);
+  vec3 min = {-0.5f, -0.5f, -0.5f}, max = {0.5f, 0.5f, 0.5f};
+  builderMesh(&b, "cube", min, max);
+  builderMesh(&b, "rounded_cube", min, max);
+  builderMaterial(&b, "container");
+  builderMaterial(&b, "smiley");
+
+  FILE* text = fopen(textPath, "w");
+  if(!text) {
+    printf("ERROR::SCENEC::FILE_NOT_WRITTEN: %s\n", textPath);
+    builderFree(&b);
+    return -1;
+  }
+  fprintf(text, "mesh cube -0.5 -0.5 -0.5 0.5 0.5 0.5\nmesh rounded_cube -0.5 -0.5 -0.5 0.5 0.5 0.5\nmaterial container\nmaterial smiley\n");
+
+  uint32_t seed = 1;
+  float side = sqrtf((float) objects) * 2.0f;
+  for(unsigned int i = 0; i < objects; i++) {
+    float r[7];
+    for(int k = 0; k < 7; k++) {
+      seed = seed * 1664525u + 1013904223u;
+      r[k] = (float) (seed >> 8) / (1 << 24);
+    }
+    vec3 position = {(r[0] - 0.5f) * side, r[1] * 4.0f, (r[2] - 0.5f) * side};
+    vec3 axis = {r[3] - 0.5f, r[4] - 0.5f, 0.25f};
+    float degrees = r[5] * 360.0f;
+    vec3 scale = {0.5f + r[6], 0.5f + r[6], 0.5f + r[6]};
+    versor rotation;
+    glm_quatv(rotation, glm_rad(degrees), axis);
+    builderAdd(&b, i & 1, (i >> 1) & 1, position, rotation, scale);
+    fprintf(text, "object %s %s %.3f %.3f %.3f rotate %.3f %.3f %.3f %.2f scale %.3f %.3f %.3f\n",
+        b.meshNames[i & 1], b.materialNames[(i >> 1) & 1], position[0], position[1], position[2],
+        axis[0], axis[1], axis[2], degrees, scale[0], scale[1], scale[2]);
+  }
+  fclose(text);
+
+  int result = builderWrite(&b, binaryPath);
+  builderFree(&b);
+  return result;
+}
+
+// the work a frame would do first: every object's world bounds, read straight out of the mapping
+static float touchBounds(Scene* s) {
+  float sum = 0.0f;
+  for(unsigned int i = 0; i < s->objectCount; i++) {
+    sum += s->boundsMax[i][1] - s->boundsMin[i][1];
+  }
+  return sum;
+}
+
+static int bench(const char* path, unsigned int objects, int runs) {
+  char textPath[512];
+  snprintf(textPath, sizeof(textPath), "%s.txt", path);
+  double start = timingNow();
+  if(generate(path, textPath, objects) != 0) {
+    return -1;
+  }
+  printf("generated %u objects in %.1f ms\n", objects, (timingNow() - start) * 1000.0);
+
+  Timing openTimes, touchTimes, parseTimes;
+  timingInit(&openTimes);
+  timingInit(&touchTimes);
+  timingInit(&parseTimes);
+  float checksum = 0.0f;
+
+  for(int run = 0; run < runs; run++) {
+    Scene s;
+    start = timingNow();
+    if(sceneOpen(&s, path) != 0) {
+      return -1;
+    }
+    double opened = timingNow();
+    checksum += touchBounds(&s);
+    double touched = timingNow();
+    sceneClose(&s);
+    timingAdd(&openTimes, (opened - start) * 1000.0);
+    timingAdd(&touchTimes, (touched - opened) * 1000.0);
+
+    // the text form has to be read and parsed back into the same arrays
+    start = timingNow();
+    size_t size;
+    char* text = readText(textPath, &size);
+    SceneBuilder b;
+    builderInit(&b);
+    if(!text || builderParse(&b, text, textPath) != 0) {
+      free(text);
+      builderFree(&b);
+      return -1;
+    }
+    timingAdd(&parseTimes, (timingNow() - start) * 1000.0);
+    free(text);
+    builderFree(&b);
+  }
+
+  timingReport(&openTimes, "binary open (mmap and validate)");
+  timingReport(&touchTimes, "binary first pass over bounds");
+  timingReport(&parseTimes, "text read and parse");
+  double best = timingPercentile(&openTimes, 0.0) + timingPercentile(&touchTimes, 0.0);
+  printf("binary: %.1f M objects/s to open and read every bound, text: %.2f M objects/s (checksum %.1f)\n",
+      best > 0.0 ? objects / best / 1000.0 : 0.0, objects / timingPercentile(&parseTimes, 0.0) / 1000.0, checksum);
+
+  timingFree(&openTimes);
+  timingFree(&touchTimes);
+  timingFree(&parseTimes);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  int benchmark = 0;
+  unsigned int objects = 1000000;
+  int runs = 5;
+  const char* paths[2] = {NULL, NULL};
+  int pathCount = 0;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--bench")) {
+      benchmark = 1;
+    }
+    else if(!strcmp(argv[i], "--objects") && i + 1 < argc) {
+      objects = (unsigned int) atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--runs") && i + 1 < argc) {
+      runs = atoi(argv[++i]);
+    }
+    else if(pathCount < 2) {
+      paths[pathCount++] = argv[i];
+    }
+  }
+
+  if(pathCount != (benchmark ? 1 : 2) || runs < 1) {
+    printf("usage: scenec in.scene out.scn\n");
+    printf("       scenec --bench [--objects N] [--runs N] file.scn\n");
+    return 1;
+  }
+
+  return (benchmark ? bench(paths[0], objects, runs) : compile(paths[0], paths[1])) == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// renders the many-cubes scene on the CPU rasterizer (see src/raster.h) and reports throughput
+//
+// usage:
+//   swraster [--threads N] [--frames N] [--size WxH] [--out image.ppm]
+
+#include "raster.h"
+#include "cube.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+static int loadTexture(RasterTexture* t, const char* path, int flip) {
+  stbi_set_flip_vertically_on_load(flip);
+  t->pixels = stbi_load(path, &t->width, &t->height, &t->channels, 0);
+  if(!t->pixels) {
+    printf("Failed to load texture: %s\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  unsigned int threads = (unsigned int) sysconf(_SC_NPROCESSORS_ONLN);
+  int frames = 100;
+  int width = 800;
+  int height = 600;
+  const char* out = "swraster.ppm";
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--frames") && i + 1 < argc) {
+      frames = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--size") && i + 1 < argc) {
+      sscanf(argv[++i], "%dx%d", &width, &height);
+    }
+    else if(!strcmp(argv[i], "--out") && i + 1 < argc) {
+      out = argv[++i];
+    }
+    else {
+      printf("usage: swraster [--threads N] [--frames N] [--size WxH] [--out image.ppm]\n");
+      return 1;
+    }
+  }
+
+  Raster r;
+  rasterInit(&r, width, height, threads);
+
+  // same textures and flip flags as main.c, paths relative to the build directory
+  RasterTexture container = {0}, smiley = {0};
+  if(loadTexture(&container, "../assets/container.jpg", 0) != 0 || loadTexture(&smiley, "../assets/awesomeface.png", 1) != 0) {
+    stbi_image_free((void*) container.pixels);
+    rasterFree(&r);
+    return 1;
+  }
+  rasterSetTexture(&r, 0, &container);
+  rasterSetTexture(&r, 1, &smiley);
+
+  // camera setup from src/coordinate_systems/many_cubes
+  mat4 view;
+  glm_translate_make(view, (vec3) {0.0f, 0.0f, -3.0f});
+
+  mat4 projection;
+  glm_perspective(glm_rad(45.0f), (float) width / (float) height, 0.1f, 100.0f, projection);
+
+  double start = timingNow();
+  for(int frame = 0; frame < frames; frame++) {
+    rasterClear(&r, 0.0f, 0.0f, 0.0f, 1.0f);
+
+    for(unsigned int i = 0; i < CUBE_POSITION_COUNT; i++) {
+      mat4 model;
+      glm_translate_make(model, cubePositions[i]);
+      glm_rotate(model, glm_rad(20.0f * (float) i), (vec3) {1.0f, 0.3f, 0.5f});
+      rasterDrawArrays(&r, cubeVertices, 0, CUBE_VERTEX_COUNT, model, view, projection);
+    }
+
+    rasterFlush(&r);
+  }
+  double elapsed = timingNow() - start;
+
+  printf("%d frames at %dx%d on %u threads\n", frames, width, height, r.threadCount);
+  printf("frame time:   %8.3f ms\n", elapsed * 1000.0 / frames);
+  printf("triangles:    %8.3f Mtri/s (%llu submitted, %llu tile bins)\n",
+      r.stats.trianglesSubmitted / elapsed * 1e-6, r.stats.trianglesSubmitted, r.stats.trianglesBinned);
+  printf("fragments:    %8.3f Mpix/s (%llu shaded)\n", r.stats.pixelsShaded / elapsed * 1e-6, r.stats.pixelsShaded);
+
+  rasterWritePPM(&r, out);
+
+  stbi_image_free((void*) container.pixels);
+  stbi_image_free((void*) smiley.pixels);
+  rasterFree(&r);
+  return 0;
+}
@@ -0,0 +1,77 @@
+// offline check of the texture format decisions in texture.c, no GL context needed.
+// sweeps every channel count over awkward row widths, then reads the headers of the given
+// images and reports what each would be stored as against the old always-RGB upload
+//
+// usage:
+//   texformat [image ...]
+
+#include "texture.h"
+#include "stb_image.h"
+#include <stdio.h>
+#include <glad/glad.h>
+
+// a decision is wrong when it loses channels, mislabels the row alignment or costs more than RGBA8
+static int checkFormat(int channels, int width, int srgb, TextureFormat* f) {
+  int failures = 0;
+  size_t rowSize = (size_t) width * f->channels;
+
+  if(f->channels < channels) {
+    printf("FAIL: %d channels stored in %s\n", channels, textureFormatName(f->internalFormat));
+    failures++;
+  }
+  if(rowSize % f->alignment != 0 || (f->alignment < 8 && rowSize % (f->alignment * 2) == 0)) {
+    printf("FAIL: %d channels x %d wide, rows of %zu bytes with unpack alignment %d\n", channels, width, rowSize, f->alignment);
+    failures++;
+  }
+  if(f->bytesPerTexel > 4) {
+    printf("FAIL: %d channels at %d bytes a texel\n", channels, f->bytesPerTexel);
+    failures++;
+  }
+  if(channels >= 3 && srgb != (f->internalFormat == GL_SRGB8_ALPHA8)) {
+    printf("FAIL: %d channel color image stored as %s with sRGB %s\n", channels, textureFormatName(f->internalFormat), srgb ? "on" : "off");
+    failures++;
+  }
+  return failures;
+}
+
+int main(int argc, char** argv) {
+  int failures = 0;
+  int cases = 0;
+  const int widths[] = {1, 2, 3, 5, 6, 7, 64, 511, 512, 1023};
+
+  for(int srgb = 0; srgb <= 1; srgb++) {
+    textureSetSRGB(srgb);
+    for(int channels = 1; channels <= 4; channels++) {
+      for(unsigned int w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+        TextureFormat f;
+        textureChooseFormat(channels, widths[w], &f);
+        failures += checkFormat(channels, widths[w], srgb, &f);
+        cases++;
+      }
+    }
+  }
+  printf("format decisions: %d cases, %d failures\n", cases, failures);
+
+  textureSetSRGB(1);
+  for(int i = 1; i < argc; i++) {
+    int width, height, channels;
+    if(!stbi_info(argv[i], &width, &height, &channels)) {
+      printf("FAIL: %s is not a readable image\n", argv[i]);
+      failures++;
+      continue;
+    }
+
+    TextureFormat f;
+    textureChooseFormat(channels, width, &f);
+    failures += checkFormat(channels, width, 1, &f);
+
+    // the old path asked for GL_RGB, which drivers keep as four bytes a texel
+    TextureFormat old = {GL_RGB8, GL_RGB, 3, 4, 4};
+    printf("%s: %dx%d, %d channels -> %s, alignment %d, %.1f KB with mips (was %.1f KB as RGB%s)\n",
+        argv[i], width, height, channels, textureFormatName(f.internalFormat), f.alignment,
+        textureFormatBytes(&f, width, height) / 1024.0, textureFormatBytes(&old, width, height) / 1024.0,
+        channels == 4 || channels == 2 ? ", alpha dropped" : "");
+  }
+
+  return failures ? 1 : 0;
+}
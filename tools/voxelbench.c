@@ -0,0 +1,193 @@
+// meshes a generated voxel world with the greedy chunk mesher (src/voxel.h) and reports
+// chunks meshed per second on one thread and on the job pool, the geometry saved over
+// drawing every voxel as a 36 vertex cube, and the cost of remeshing after a single edit
+//
+// usage:
+//   voxelbench [--chunks N] [--height N] [--threads N] [--rounds N] [--edits N]
+
+#include "voxel.h"
+#include "jobs.h"
+#include "timing.h"
+#include "cube.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct ChunkJob {
+  VoxelWorld* world;
+  int x;
+  int y;
+  int z;
+} ChunkJob;
+
+static void meshJob(void* arg) {
+  ChunkJob* job = arg;
+  voxelChunkMesh(job->world, job->x, job->y, job->z);
+}
+
+static void invalidateAll(VoxelWorld* w, unsigned int chunkCount) {
+  for(unsigned int i = 0; i < chunkCount; i++) {
+    voxelChunkInvalidate(&w->chunks[i]);
+  }
+}
+
+int main(int argc, char** argv) {
+  int chunks = 8;
+  int height = 2;
+  unsigned int threads = (unsigned int) sysconf(_SC_NPROCESSORS_ONLN);
+  int rounds = 5;
+  int edits = 1000;
+
+  for(int i = 1; i < argc; i++) {
+    if(!strcmp(argv[i], "--chunks") && i + 1 < argc) {
+      chunks = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--height") && i + 1 < argc) {
+      height = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--threads") && i + 1 < argc) {
+      threads = (unsigned int) atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--rounds") && i + 1 < argc) {
+      rounds = atoi(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "--edits") && i + 1 < argc) {
+      edits = atoi(argv[++i]);
+    }
+    else {
+      printf("usage: voxelbench [--chunks N] [--height N] [--threads N] [--rounds N] [--edits N]\n");
+      return 1;
+    }
+  }
+  if(chunks <= 0 || height <= 0 || rounds <= 0 || threads == 0) {
+    printf("usage: voxelbench [--chunks N] [--height N] [--threads N] [--rounds N] [--edits N]\n");
+    return 1;
+  }
+
+  VoxelWorld world;
+  voxelWorldInit(&world, chunks, height, chunks);
+  unsigned int chunkCount = (unsigned int) (chunks * height * chunks);
+
+  double start = timingNow();
+  voxelWorldGenerate(&world);
+  printf("world: %dx%dx%d chunks of %d^3 voxels, generated in %.1f ms\n", chunks, height, chunks, VOXEL_CHUNK_SIZE, (timingNow() - start) * 1000.0);
+
+  ChunkJob* jobs = malloc(chunkCount * sizeof(ChunkJob));
+  for(int z = 0; z < chunks; z++) {
+    for(int y = 0; y < height; y++) {
+      for(int x = 0; x < chunks; x++) {
+        ChunkJob* job = &jobs[(z * height + y) * chunks + x];
+        job->world = &world;
+        job->x = x;
+        job->y = y;
+        job->z = z;
+      }
+    }
+  }
+
+  // single threaded, every slice of every chunk from scratch
+  double best = 1e30;
+  for(int round = 0; round < rounds; round++) {
+    invalidateAll(&world, chunkCount);
+    start = timingNow();
+    for(unsigned int i = 0; i < chunkCount; i++) {
+      meshJob(&jobs[i]);
+    }
+    double elapsed = timingNow() - start;
+    best = elapsed < best ? elapsed : best;
+  }
+  printf("1 thread: %.1f ms per world, %.0f chunks/s\n", best * 1000.0, chunkCount / best);
+
+  Jobs pool;
+  jobsInit(&pool, threads);
+  best = 1e30;
+  for(int round = 0; round < rounds; round++) {
+    invalidateAll(&world, chunkCount);
+    start = timingNow();
+    for(unsigned int i = 0; i < chunkCount; i++) {
+      jobsSubmit(&pool, meshJob, &jobs[i]);
+    }
+    jobsWait(&pool);
+    double elapsed = timingNow() - start;
+    best = elapsed < best ? elapsed : best;
+  }
+  printf("%u threads: %.1f ms per world, %.0f chunks/s\n", threads, best * 1000.0, chunkCount / best);
+  jobsFree(&pool);
+
+  // geometry against one 36 vertex cube per solid voxel, and against plain face culling
+  unsigned long long solid = 0, faces = 0, quads = 0;
+  int sizeX = chunks * VOXEL_CHUNK_SIZE, sizeY = height * VOXEL_CHUNK_SIZE;
+  for(int z = 0; z < sizeX; z++) {
+    for(int y = 0; y < sizeY; y++) {
+      for(int x = 0; x < sizeX; x++) {
+        if(!voxelWorldGet(&world, x, y, z)) {
+          continue;
+        }
+        solid++;
+        faces += !voxelWorldGet(&world, x + 1, y, z) + !voxelWorldGet(&world, x - 1, y, z)
+            + !voxelWorldGet(&world, x, y + 1, z) + !voxelWorldGet(&world, x, y - 1, z)
+            + !voxelWorldGet(&world, x, y, z + 1) + !voxelWorldGet(&world, x, y, z - 1);
+      }
+    }
+  }
+  for(unsigned int i = 0; i < chunkCount; i++) {
+    quads += world.chunks[i].quadCount;
+  }
+  double cubeBytes = (double) solid * CUBE_VERTEX_COUNT * CUBE_VERTEX_STRIDE * sizeof(float);
+  double meshBytes = (double) quads * 4 * sizeof(uint32_t);
+  printf("geometry: %llu solid voxels, %llu visible faces, %llu greedy quads (%.1f%% of the faces)\n",
+      solid, faces, quads, faces ? 100.0 * quads / faces : 0.0);
+  printf("geometry: %.1f MB as cubes, %.2f MB as packed quads (one shared index buffer), %.0fx less\n",
+      cubeBytes / (1024.0 * 1024.0), meshBytes / (1024.0 * 1024.0), meshBytes > 0.0 ? cubeBytes / meshBytes : 0.0);
+
+  // single voxel edits only remesh the slices they touch
+  Timing editTimes;
+  timingInit(&editTimes);
+  uint32_t seed = 987654321u;
+  unsigned long long slices = 0;
+  for(int edit = 0; edit < edits; edit++) {
+    seed = seed * 1664525u + 1013904223u;
+    int x = (int) ((seed >> 8) % (uint32_t) sizeX);
+    seed = seed * 1664525u + 1013904223u;
+    int y = (int) ((seed >> 8) % (uint32_t) sizeY);
+    seed = seed * 1664525u + 1013904223u;
+    int z = (int) ((seed >> 8) % (uint32_t) sizeX);
+
+    start = timingNow();
+    voxelWorldSet(&world, x, y, z, voxelWorldGet(&world, x, y, z) ? VOXEL_EMPTY : VOXEL_SMILEY);
+    for(int cz = z / VOXEL_CHUNK_SIZE - 1; cz <= z / VOXEL_CHUNK_SIZE + 1; cz++) {
+      for(int cy = y / VOXEL_CHUNK_SIZE - 1; cy <= y / VOXEL_CHUNK_SIZE + 1; cy++) {
+        for(int cx = x / VOXEL_CHUNK_SIZE - 1; cx <= x / VOXEL_CHUNK_SIZE + 1; cx++) {
+          if(voxelWorldChunk(&world, cx, cy, cz)) {
+            slices += voxelChunkMesh(&world, cx, cy, cz);
+          }
+        }
+      }
+    }
+    timingAdd(&editTimes, (timingNow() - start) * 1000.0);
+  }
+  if(edits > 0) {
+    printf("edits: %.1f slices remeshed per edit out of %d per chunk\n", (double) slices / edits, VOXEL_DIRECTIONS * VOXEL_CHUNK_SIZE);
+    timingReport(&editTimes, "edit remesh");
+  }
+  timingFree(&editTimes);
+
+  // the incremental result has to match meshing from scratch
+  unsigned int mismatched = 0;
+  uint32_t* incremental = malloc(VOXEL_MAX_QUADS * 4 * sizeof(uint32_t));
+  for(unsigned int i = 0; i < chunkCount; i++) {
+    VoxelChunk* c = &world.chunks[i];
+    unsigned int count = c->quadCount;
+    memcpy(incremental, c->vertices, count * 4 * sizeof(uint32_t));
+    voxelChunkInvalidate(c);
+    meshJob(&jobs[i]);
+    mismatched += count != c->quadCount || memcmp(incremental, c->vertices, count * 4 * sizeof(uint32_t)) != 0;
+  }
+  printf("check: %u of %u chunks differ from a full remesh\n", mismatched, chunkCount);
+
+  free(incremental);
+  free(jobs);
+  voxelWorldFree(&world);
+  return mismatched ? 1 : 0;
+}